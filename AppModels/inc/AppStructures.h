@@ -1,7 +1,10 @@
 #pragma once
 
 #include <MyD3D12Lib/BaseApp.h>
+#include <MyD3D12Lib/D3D12Utils.h>
+#include <MyD3D12Lib/DescriptorIndexAllocator.h>
 #include <MyD3D12Lib/MeshGeometry.h>
+#include <MyD3D12Lib/ResidencyManager.h>
 
 #include <DirectXMath.h>
 using namespace DirectX;
@@ -59,19 +62,42 @@ struct MaterialConstants {
 	XMFLOAT4 DiffuseAlbedo;
 	XMFLOAT3 FresnelR0;
 	float Roughness;
+	// texture is slice of array, texture coordinates are scaled by xy and offset by zw
+	XMFLOAT4 TexTransform;
+	uint32_t TexArrayIndex;
+};
+
+// for bindless path objects and materials are elements of structured buffers, layouts match Bindless.hlsli
+struct ObjectData {
+	XMMATRIX ModelMatrix = XMMatrixIdentity();
+	XMMATRIX ModelMatrixInvTrans = XMMatrixIdentity();
+	uint32_t MaterialIndex = 0;
+	uint32_t Pad[3];
+};
+
+struct MaterialData {
+	XMFLOAT4 DiffuseAlbedo;
+	XMFLOAT3 FresnelR0;
+	float Roughness;
+	XMFLOAT4 TexTransform;
+	uint32_t TexArrayIndex;
+	// slot in textures table of frame
+	uint32_t TextureIndex;
+	uint32_t Pad[2];
 };
 
 struct Material {
 	std::string Name;
 
-	uint32_t CBIndex = -1;
-	uint32_t NumDirtyFrames = m_NumBackBuffers;
+	uint32_t CBIndex = UINT32_MAX;
 
 	std::string TextureName = "default";
 
 	XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
 	XMFLOAT3 FresnelR0 = { 0.0f, 0.0f, 0.0f };
 	float Roughness = 1.0f;
+
+	bool IsAlphaTested = false;
 };
 
 struct RenderItem {
@@ -79,18 +105,27 @@ struct RenderItem {
 
 	XMMATRIX m_ModelMatrix = XMMatrixIdentity();
 	XMMATRIX m_ModelMatrixInvTrans = XMMatrixIdentity();
-	uint32_t m_NumDirtyFramse = m_NumBackBuffers;
+	// maps quantized positions to model space, identity for float vertexes
+	XMMATRIX m_PosDequantMatrix = XMMatrixIdentity();
 
 	MeshGeometry* m_MeshGeo = nullptr;
 	Material* m_Material = nullptr;
 
+	// world space bounding sphere, used for texture streaming priorities
+	XMFLOAT3 m_BoundsCenter = { 0.0f, 0.0f, 0.0f };
+	float m_BoundsRadius = 0.0f;
+	// texture coordinates per world space unit, used for mip streaming
+	float m_UVDensity = 0.0f;
+	// index buffer of geometry, vertex buffers are shared by all geometries
+	uint32_t m_GeometryResidencyId = ResidencyManager::InvalidId;
+
 	uint32_t m_IndexCount = 0;
 	uint32_t m_StartIndexLocation = 0;
 	uint32_t m_BaseVertexLocation = 0;
 
 	D3D12_PRIMITIVE_TOPOLOGY m_PrivitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-	uint32_t m_CBIndex = -1;
+	uint32_t m_CBIndex = UINT32_MAX;
 };
 
 struct Texture {
@@ -99,5 +134,22 @@ struct Texture {
 
 	ComPtr<ID3D12Resource> Resource;
 	ComPtr<ID3D12Resource> UploadResource;
-	uint32_t SRVHeapIndex = -1;
+	// view in CPU only heap, it is default one until texture is resident
+	// frames use its copies in shader visible heap, so it is rewritten in place when mips are changed
+	uint32_t SRVStagingIndex = DescriptorIndexAllocator::InvalidIndex;
+	// copy of view for current frame, textures with the same view share it
+	uint32_t SRVHeapIndex = DescriptorIndexAllocator::InvalidIndex;
+	// packed texture is part of array or atlas, view is shared by whole group
+	uint32_t ArrayIndex = 0;
+	XMFLOAT4 UVTransform = { 1.0f, 1.0f, 0.0f, 0.0f };
+
+	// for mip streaming: decoded mips, first of them in resource and resource with other mips while it is uploaded
+	DecodedTexture Source;
+	uint32_t FirstMip = 0;
+	ComPtr<ID3D12Resource> PendingResource;
+	uint32_t PendingFirstMip = 0;
+	uint64_t PendingFenceValue = 0;
+
+	// registered when resource is created, aliases share id of canonical texture
+	uint32_t ResidencyId = ResidencyManager::InvalidId;
 };
\ No newline at end of file
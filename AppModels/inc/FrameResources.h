@@ -9,9 +9,9 @@ class FrameResources {
 public:
 	FrameResources(
 		ComPtr<ID3D12Device> device, 
-		UINT numPassConstants, 
-		UINT numObjectConstants,
-		UINT numMaterialConstants
+		UINT numPassConstants,
+		UINT numObjects = 0,
+		UINT numMaterials = 0
 	);
 
 	FrameResources(const FrameResources& other) = delete;
@@ -19,7 +19,10 @@ public:
 
 	~FrameResources();
 
+	// objects and materials constants are allocated each frame from upload allocator
 	std::unique_ptr<UploadBuffer<PassConstants>> m_PassConstantsBuffer;
-	std::unique_ptr<UploadBuffer<ObjectConstants>> m_ObjectsConstantsBuffer;
-	std::unique_ptr<UploadBuffer<MaterialConstants>> m_MaterialsConstantsBuffer;
+
+	// for bindless path objects and materials data indexed in shaders, they are created only if there are any
+	std::unique_ptr<UploadBuffer<ObjectData>> m_ObjectsBuffer;
+	std::unique_ptr<UploadBuffer<MaterialData>> m_MaterialsBuffer;
 };
\ No newline at end of file
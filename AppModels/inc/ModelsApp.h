@@ -3,12 +3,30 @@
 #include <AppStructures.h>
 #include <FrameResources.h>
 #include <ShadowMap.h>
+#include <MyD3D12Lib/AssetPackage.h>
 #include <MyD3D12Lib/BaseApp.h>
+#include <MyD3D12Lib/BindlessRemap.h>
 #include <MyD3D12Lib/Camera.h>
+#include <MyD3D12Lib/D3D12Utils.h>
+#include <MyD3D12Lib/DescriptorAllocator.h>
+#include <MyD3D12Lib/FramePacer.h>
+#include <MyD3D12Lib/GeometryPacker.h>
 #include <MyD3D12Lib/MeshGeometry.h>
+#include <MyD3D12Lib/MipStreaming.h>
+#include <MyD3D12Lib/RenderGraph.h>
+#include <MyD3D12Lib/RenderGraphResources.h>
+#include <MyD3D12Lib/ResidencyManager.h>
+#include <MyD3D12Lib/ResourceStateTracker.h>
 #include <MyD3D12Lib/Shaker.h>
+#include <MyD3D12Lib/TexturePacker.h>
+#include <MyD3D12Lib/TextureStreamer.h>
+#include <MyD3D12Lib/ThreadPool.h>
 #include <MyD3D12Lib/Timer.h>
+#include <MyD3D12Lib/UploadAllocator.h>
+#include <MyD3D12Lib/UploadBatcher.h>
 #include <MyD3D12Lib/UploadBuffer.h>
+#include <MyD3D12Lib/VertexQuantization.h>
+#include <MyD3D12Lib/VertexWelder.h>
 
 #include <DirectXMath.h>
 using namespace DirectX;
@@ -39,34 +57,46 @@ private:
 	virtual void OnMouseUp(WPARAM wParam, int x, int y) override;
 	virtual void OnMouseMove(WPARAM wParam, int x, int y) override;
 
+	void WaitForFrameSlot();
 	void UpdatePassConstants();
 	void UpdateMaterialsConstants();
 	void UpdateObjectsConstants();
+	void UpdateTexturesPriorities();
+	void UpdateTexturesStreaming();
+	void UpdateResidencyBudget();
+	void TrackRenderTargets(uint32_t& residencyId, ResidencyCategory category, const std::vector<ID3D12Resource*>& resources);
+	void TrackBaseResourcesStates();
+	uint64_t ExecuteTrackedCommandList(ComPtr<ID3D12GraphicsCommandList> commandList);
 
+	// list of open batch of copy queue, batch is submitted before upload which doesn`t fit it
+	ComPtr<ID3D12GraphicsCommandList> GetUploadCommandList(uint64_t size, uint64_t& batch);
+	void SubmitUploads();
+	// next list executed by direct queue waits on GPU for batch, if it is not finished yet
+	void WaitForUploads(uint64_t batch);
+
+	void BuildFrameGraph(ComPtr<ID3D12GraphicsCommandList> commandList);
+	void UpdateFrameGraphResources();
+
+	// pass which writes depth first clears it
 	void RenderGeometry(
 		ComPtr<ID3D12GraphicsCommandList> commandList,
 		ComPtr<ID3D12PipelineState> pso,
-		ID3D12Resource* rtBuffer,
 		D3D12_CPU_DESCRIPTOR_HANDLE rtv,
-		D3D12_RESOURCE_STATES rtBufferPrevState,
-		std::array<FLOAT, 4> rtClearValue
+		std::array<FLOAT, 4> rtClearValue,
+		bool clearDepth
 	);
 
-	void RenderRenderItem(ComPtr<ID3D12GraphicsCommandList> commandList, RenderItem* ri);
+	void RenderRenderItems(ComPtr<ID3D12GraphicsCommandList> commandList, const std::vector<RenderItem*>& renderItems);
+	void RenderRenderItem(ComPtr<ID3D12GraphicsCommandList> commandList, RenderItem* ri, uint32_t& boundTextureIndex);
+	void SetBindlessResources(ComPtr<ID3D12GraphicsCommandList> commandList, uint32_t texturesRootParameter);
 
-	void RenderSobelFilter(
-		ComPtr<ID3D12GraphicsCommandList> commandList,
-		ID3D12Resource* rtBuffer,
-		D3D12_CPU_DESCRIPTOR_HANDLE rtv
-	);
+	void RenderSobelFilter(ComPtr<ID3D12GraphicsCommandList> commandList, D3D12_CPU_DESCRIPTOR_HANDLE rtv);
 
-	void RenderSSAO(ComPtr<ID3D12GraphicsCommandList> commandList);
+	void RenderSSAO(ComPtr<ID3D12GraphicsCommandList> commandList, D3D12_CPU_DESCRIPTOR_HANDLE rtv);
 
 	void RenderBlur(
 		ComPtr<ID3D12GraphicsCommandList> commandList,
-		ComPtr<ID3D12Resource> rtBuffer,
 		D3D12_CPU_DESCRIPTOR_HANDLE rtv,
-		ComPtr<ID3D12Resource> srBuffer,
 		D3D12_GPU_DESCRIPTOR_HANDLE srv,
 		bool isHorizontal
 	);
@@ -76,23 +106,32 @@ private:
 	void InitSceneState();
 	void BuildLights();
 	void BuildTextures(ComPtr<ID3D12GraphicsCommandList> commandList);
+	// files of scene folder are read from asset package if it has them, pool decompresses chunks of big files
+	uint32_t FindInAssetPackage(const std::filesystem::path& fileName) const;
+	std::vector<uint8_t> ReadSceneFile(const std::filesystem::path& fileName, ThreadPool* pool = nullptr) const;
+	std::filesystem::file_time_type GetSceneFileTime(const std::filesystem::path& fileName) const;
+	DecodedTexture LoadBakedTexture(const Texture& texture, const MipGenerationDesc& mipDesc, ThreadPool& pool);
+	void PackTextures(ComPtr<ID3D12GraphicsCommandList> commandList, const TextureStreamer<DecodedTexture>::LoadFunction& load);
 	void BuildGeometry(ComPtr<ID3D12GraphicsCommandList> commandList);
 	void BuildMaterials();
 	void BuildRenderItems();
 	void BuildRecursivelyRenderItems(aiNode* node, XMMATRIX modelMatrix);
 	void BuildFrameResources();
 	void BuildSRViews();
-	void BuildCBViews();
+	// range of shader visible views is replaced by new one if submitted frames can read it, old one is freed when they are finished
+	uint32_t RenewSRViews(DescriptorRange& range, uint64_t& rangeFrame);
+	void CreateTextureSRView(ID3D12Resource* resource, uint32_t stagingIndex);
+	void UpdateTexturesViews();
 	void BuildRootSignature();
 	void BuildPipelineStateObject();
 
 	// for Sobel filter
-	void UpdateSobelFrameTexture();
+	void UpdateSobelViews();
 	void BuildSobelRootSignature();
 	void BuildSobelPipelineStateObject();
 
 	// for SSAO
-	void UpdateSSAOBuffersAndViews();
+	void UpdateSSAOViews();
 	void BuildSSAORootSignature();
 	void BuildSSAOPipelineStateObject();
 	void BuildRandomMapBufferAndDirections(ComPtr<ID3D12GraphicsCommandList> commandList);
@@ -116,22 +155,122 @@ private:
 	Timer m_Timer;
 	Shaker m_Shaker;
 	std::filesystem::path m_SceneFolder;
+	// package made by AssetPacker in scene folder replaces loose files, baked textures stay outside of it
+	std::unique_ptr<AssetPackage> m_AssetPackage;
+	std::filesystem::file_time_type m_AssetPackageTime;
 	const aiScene* m_Scene;
 	const uint32_t m_NumDirectionalAndSpotLights = 4;
 
 	std::unordered_map<std::string, std::unique_ptr<Texture>> m_Textures;
+	// textures with same content are loaded once and shared by all their names
+	TextureRegistry m_TextureRegistry;
+	// mip chains are generated on CPU while loading
+	bool m_GenerateMips = true;
+	// textures with mips are baked to block compressed DDS files next to scene and loaded from them later
+	// high quality uses BC7, otherwise BC1 for opaque textures and BC3 for textures with alpha
+	bool m_BakeTextures = true;
+	bool m_BakeHighQuality = false;
+	// textures are streamed after initialization, materials use default texture until theirs is resident
+	// loads are prioritized by screen size of render items using texture
+	std::vector<Texture*> m_StreamedTextures;
+	std::vector<MipGenerationDesc> m_StreamedMipsDescs;
+	std::unordered_map<std::string, uint32_t> m_StreamedTexturesIds;
+	std::vector<std::pair<Texture*, Texture*>> m_TexturesAliases;
+	uint32_t m_MaxTextureUploadsPerFrame = 4;
+	// uploads are recorded into lists of copy queue, small uploads of frame are submitted together
+	std::unique_ptr<UploadBatcher> m_UploadBatcher;
+	ComPtr<ID3D12GraphicsCommandList> m_UploadCommandList;
+	uint64_t m_MaxUploadBatchSize = 64ull << 20;
+	uint32_t m_MaxUploadBatchUploads = 32;
+	uint32_t m_NumResidentTextures = 0;
+	// only mips needed for current view are resident, finest needed mip is estimated from texel density on screen
+	// mips are streamed in and out under memory budget, replaced resources are released when frames using them are finished
+	bool m_StreamMips = true;
+	uint64_t m_TexturesMemoryBudget = 128ull << 20;
+	float m_MipsHysteresis = 0.5f;
+	std::unique_ptr<MipBudgetSolver> m_MipBudgetSolver;
+	// required mips for texture with one texel, log2 of texture size is added to them
+	std::vector<float> m_UnitRequiredMips;
+	// textures are loaded at initialization instead of streaming and packed, same sized ones into arrays, small ones into atlases
+	// materials address their texture by array index and texture coordinates transform, so draws share few views
+	bool m_PackTextures = false;
+	TexturePackingDesc m_TexturePackingDesc;
+	std::vector<Texture*> m_TexturesGroups;
+	// destroyed before textures and registry used by loads, destruction cancels pending loads
+	std::unique_ptr<ThreadPool> m_TexturesLoadPool;
+	std::unique_ptr<TextureStreamer<DecodedTexture>> m_TextureStreamer;
 	std::unordered_map<std::string, std::unique_ptr<MeshGeometry>> m_Geometries;
+	// GPU memory is accounted by category, least recently used meshes and textures are evicted over budget
+	// render targets are accounted but never evicted, budget 0 means budget given by OS for adapter
+	uint64_t m_GPUMemoryBudget = 0;
+	uint64_t m_FrameIndex = 0;
+	std::unique_ptr<ResidencyManager> m_ResidencyManager;
+	uint32_t m_VertexBuffersResidencyId = ResidencyManager::InvalidId;
+	uint32_t m_FrameGraphResidencyId = ResidencyManager::InvalidId;
+	uint32_t m_SSAOResidencyId = ResidencyManager::InvalidId;
+	uint32_t m_ShadowMapsResidencyId = ResidencyManager::InvalidId;
+	std::unordered_map<std::string, MeshGeometry*> m_MeshesGeometries;
+	std::unordered_map<std::string, uint32_t> m_GeometriesResidencyIds;
+
+	// meshes with more than 2^16 vertexes are split in chunks to keep 16 bit indexes
+	bool m_SplitLargeMeshes = true;
+	std::unordered_map<std::string, std::vector<std::string>> m_MeshesParts;
+
+	// identical and near identical vertexes are welded at import
+	bool m_WeldVertexes = true;
+	WeldEpsilons m_WeldEpsilons = { 1e-5f, 1e-3f, 1e-5f };
+
+	// vertexes are stored in 16 bytes compact format, positions are dequantized by model matrix
+	bool m_UseCompactVertexes = true;
+	std::unordered_map<std::string, PositionDequantization> m_MeshesDequantizations;
+	std::unordered_map<std::string, float> m_MeshesUVDensities;
 	std::vector<std::unique_ptr<Material>> m_Materials;
 	std::vector<std::unique_ptr<RenderItem>> m_RenderItems;
+
+	// render items grouped by pipeline they need in depth only passes
+	enum class RenderLayer { Opaque = 0, AlphaTested, Count };
+	std::vector<RenderItem*> m_RenderItemsLayers[static_cast<uint32_t>(RenderLayer::Count)];
+
+	// number of frames in flight is set at startup, it doesn`t depend on number of back buffers
+	// CPU waits only for frame which used frame resources of slot, or for queued frames in latency mode
+	uint32_t m_NumFramesInFlight = 3;
+	FramePacingMode m_FramePacingMode = FramePacingMode::Throughput;
+	std::unique_ptr<FramePacer> m_FramePacer;
+	uint64_t m_LoggedNumStalls = 0;
+	double m_LoggedStallTime = 0.0;
 	std::vector<std::unique_ptr<FrameResources>> m_FramesResources;
 	FrameResources* m_CurrentFrameResources;
 
+	// objects and materials constants are written each frame and bound as root CBVs, addresses are indexed by CBIndex
+	std::unique_ptr<UploadAllocator> m_ConstantsAllocator;
+	std::vector<D3D12_GPU_VIRTUAL_ADDRESS> m_ObjectsConstantsAddresses;
+	std::vector<D3D12_GPU_VIRTUAL_ADDRESS> m_MaterialsConstantsAddresses;
+	uint64_t m_LastFrameConstantsSize = 0;
+
+	// effects views are persistent ranges, textures views are copied into ring of frame from staging heap
+	std::unique_ptr<DescriptorAllocator> m_CBV_SRVDescAllocator;
+	std::unique_ptr<DescriptorAllocator> m_TexturesViewsAllocator;
 	ComPtr<ID3D12DescriptorHeap> m_CBV_SRVDescHeap;
-	uint32_t m_TexturesViewsStartIndex;
-	uint32_t m_ObjectConstantsViewsStartIndex;
-	uint32_t m_PassConstantsViewsStartIndex;
-	uint32_t m_MaterialConstantsViewsStartIndex;
-	uint32_t m_NextCBV_SRVDescHeapIndex = 0;
+
+	// for bindless path textures views of frame form one table, objects and materials are structured buffers of frame
+	// draw sets only index of object, object refers to material and material to slot of its texture, it needs resource binding tier 2
+	bool m_Bindless = false;
+	BindlessRemap m_TexturesViewsRemap;
+	uint32_t m_TexturesTableIndex = DescriptorIndexAllocator::InvalidIndex;
+
+	// passes declare states they need, barriers between them are collected and issued by one call
+	// barriers of first uses in list depend on lists submitted before, so they are resolved at submission
+	ResourceStates m_ResourceStates;
+	ResourceStateTracker m_StateTracker;
+	uint32_t m_LastFrameNumBarriers = 0;
+	uint32_t m_LastFrameNumBarrierCalls = 0;
+	uint32_t m_LastFrameNumResolvedBarriers = 0;
+
+	// frame is render graph built each frame, passes whose results are not used are culled, e.g. SSAO passes without SSAO
+	// effects render targets are transients of graph, ones with non-overlapping lifetimes share memory of one heap
+	// barriers derived by graph are collected by state tracker
+	RenderGraph m_FrameGraph;
+	std::unique_ptr<RenderGraphResources> m_FrameGraphResources;
 
 	std::unordered_map<std::string, ComPtr<ID3D12RootSignature>> m_RootSignatures;
 	std::unordered_map<std::string, ComPtr<ID3D12PipelineState>> m_PSOs;
@@ -140,21 +279,29 @@ private:
 	bool m_IsSobelFilter = false;
 	static const uint32_t m_NumSobelRTV = 1;
 	static const uint32_t m_NumSobelSRV = 1;
-	ComPtr<ID3D12Resource> m_SobelFrameTextureBuffer;
+	// transient of frame graph, it is InvalidIndex without Sobel filter
+	uint32_t m_SobelFrameTexture = RenderGraph::InvalidIndex;
 	uint32_t m_SobelTextureRTVIndex;
 	uint32_t m_SobelTextureSRVIndex;
+	DescriptorRange m_SobelTextureSRVRange;
+	// number of frames submitted when range was allocated, frames after it can read views
+	uint64_t m_SobelTextureSRVFrame = 0;
 
 	// for SSAO
 	bool m_IsOnlySSAO = false;
 	static const uint32_t m_NumSSAO_RTV = 3;
 	static const uint32_t m_NumSSAO_SRV = 5;
-	ComPtr<ID3D12Resource> m_NormalMapBuffer;
-	ComPtr<ID3D12Resource> m_OcclusionMapBuffer0;
-	ComPtr<ID3D12Resource> m_OcclusionMapBuffer1;
+	// transients of frame graph
+	uint32_t m_NormalMap = RenderGraph::InvalidIndex;
+	uint32_t m_OcclusionMap0 = RenderGraph::InvalidIndex;
+	uint32_t m_OcclusionMap1 = RenderGraph::InvalidIndex;
 	ComPtr<ID3D12Resource> m_RandomMapBuffer;
+	PlacedAllocation m_RandomMapAllocation;
 	ComPtr<ID3D12Resource> m_RandomMapUploadBuffer;
 	uint32_t m_SSAO_RTV_StartIndex;
 	uint32_t m_SSAO_SRV_StartIndex;
+	DescriptorRange m_SSAO_SRVRange;
+	uint64_t m_SSAO_SRVFrame = 0;
 	std::array<FLOAT, 4> m_NormalMapBufferClearValue = { 0.0f, 0.0f, 0.0f, 0.0f };
 	uint32_t m_OcclusionMapWidth;
 	uint32_t m_OcclusionMapHeight;
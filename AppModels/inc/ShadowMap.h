@@ -1,5 +1,7 @@
 #pragma once
 
+#include <MyD3D12Lib/ResourceHeapAllocator.h>
+
 #include <d3d12.h>
 
 #include <wrl.h>
@@ -8,12 +10,13 @@
 
 class ShadowMap {
 public:
-	ShadowMap(ID3D12Device2* device, uint32_t width, uint32_t height);
+	// resource is placed into heap of allocator, allocator should outlive shadow map
+	ShadowMap(ID3D12Device2* device, ResourceHeapAllocator& allocator, uint32_t width, uint32_t height);
 
 	ShadowMap(const ShadowMap& other) = delete;
 	ShadowMap& operator=(const ShadowMap& other) = delete;
 
-	~ShadowMap() = default;
+	~ShadowMap();
 
 	ID3D12Resource* GetResource() const;
 
@@ -36,7 +39,9 @@ private:
 
 private:
 	ID3D12Device2* m_Device;
+	ResourceHeapAllocator& m_Allocator;
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_Resource;
+	PlacedAllocation m_Allocation;
 
 	D3D12_CPU_DESCRIPTOR_HANDLE m_CpuDsv;
 	D3D12_CPU_DESCRIPTOR_HANDLE m_CpuSrv;
@@ -0,0 +1,42 @@
+// for bindless path draw sets only index of object, object refers to material and material refers to texture
+// objects and materials are structured buffers of frame, textures are views of frame in one unbounded range
+
+struct ObjectData
+{
+    matrix ModelMatrix;
+    matrix ModelMatrixInvTrans;
+    uint MaterialIndex;
+    uint3 Pad;
+};
+
+struct MaterialData
+{
+    float4 DiffuseAlbedo;
+    float3 FresnelR0;
+    float Roughness;
+    float4 TexTransform;
+    uint TexArrayIndex;
+    uint TextureIndex;
+    uint2 Pad;
+};
+
+cbuffer DrawConstants : register(b4)
+{
+    uint ObjectIndex;
+};
+
+StructuredBuffer<ObjectData> Objects : register(t0, space1);
+StructuredBuffer<MaterialData> Materials : register(t1, space1);
+Texture2DArray Textures[] : register(t0, space2);
+
+MaterialConstants GetMaterialConstants(MaterialData data)
+{
+    MaterialConstants mat;
+    mat.DiffuseAlbedo = data.DiffuseAlbedo;
+    mat.FresnelR0 = data.FresnelR0;
+    mat.Roughness = data.Roughness;
+    mat.TexTransform = data.TexTransform;
+    mat.TexArrayIndex = data.TexArrayIndex;
+
+    return mat;
+}
@@ -39,4 +39,17 @@ struct MaterialConstants
     float4 DiffuseAlbedo;
     float3 FresnelR0;
     float Roughness;
+    float4 TexTransform;
+    uint TexArrayIndex;
 };
+
+// texture can be packed into atlas, so texture coordinates are wrapped before transform to it
+// gradients are taken before wrap, so mip selection doesn`t jump on wrap seams
+float4 SampleMaterialTexture(Texture2DArray tex, SamplerState s, MaterialConstants mat, float2 texC)
+{
+    float2 atlasTexC = frac(texC) * mat.TexTransform.xy + mat.TexTransform.zw;
+    float2 dx = ddx(texC) * mat.TexTransform.xy;
+    float2 dy = ddy(texC) * mat.TexTransform.xy;
+
+    return tex.SampleGrad(s, float3(atlasTexC, mat.TexArrayIndex), dx, dy);
+}
@@ -14,9 +14,14 @@
 #include "GeoUtils.hlsli"
 
 ConstantBuffer<PassConstants> PassConstantsCB : register(b1);
-ConstantBuffer<MaterialConstants> MaterilaConstantsCB : register(b2);
 
-Texture2D Texture : register(t0);
+#ifdef BINDLESS
+    #include "Bindless.hlsli"
+#else
+    ConstantBuffer<MaterialConstants> MaterilaConstantsCB : register(b2);
+    Texture2DArray Texture : register(t0);
+#endif
+
 Texture2D OcclusionMap : register(t1);
 Texture2D ShadowMap[NUM_DIR_LIGHTS + NUM_POINT_LIGHTS] : register(t2);
 
@@ -55,8 +60,16 @@ float CalcShadowFactor(float3 posW, int index) {
 float4 main(VertexOut pin) : SV_Target
 {
     // init material from MaterialConstants and texture
+#ifdef BINDLESS
+    MaterialData materialData = Materials[Objects[ObjectIndex].MaterialIndex];
+    MaterialConstants MaterilaConstantsCB = GetMaterialConstants(materialData);
+    float4 textureColor = SampleMaterialTexture(Textures[materialData.TextureIndex], LinearWrapSampler, MaterilaConstantsCB, pin.TexC);
+#else
+    float4 textureColor = SampleMaterialTexture(Texture, LinearWrapSampler, MaterilaConstantsCB, pin.TexC);
+#endif
+
     Material mat = {
-        MaterilaConstantsCB.DiffuseAlbedo * Texture.Sample(LinearWrapSampler, pin.TexC),
+        MaterilaConstantsCB.DiffuseAlbedo * textureColor,
         MaterilaConstantsCB.FresnelR0,
         1 - MaterilaConstantsCB.Roughness
     };
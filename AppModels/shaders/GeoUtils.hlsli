@@ -1,3 +1,26 @@
+#ifdef COMPACT_VERTEX
+// positions are UNORM relative to mesh bounding box, dequantized by model matrix
+// normals are octahedral encoded
+struct VertexIn
+{
+    float4 Pos : POSITION;
+    float2 Norm : NORM;
+    float2 TexC : TEXCOORD;
+};
+
+struct PositionVertexIn
+{
+    float4 Pos : POSITION;
+};
+
+float3 DecodeNorm(float2 e)
+{
+    float3 n = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy += n.xy >= 0.0f ? -t : t;
+    return normalize(n);
+}
+#else
 struct VertexIn
 {
     float3 Pos : POSITION;
@@ -5,6 +28,17 @@ struct VertexIn
     float2 TexC : TEXCOORD;
 };
 
+struct PositionVertexIn
+{
+    float3 Pos : POSITION;
+};
+
+float3 DecodeNorm(float3 n)
+{
+    return n;
+}
+#endif
+
 struct VertexOut
 {
     float4 PosH : SV_Position;
@@ -1,17 +1,22 @@
 #include "Common.hlsli"
 #include "GeoUtils.hlsli"
 
-ConstantBuffer<ObjectConstants> ObjectConstantsCB : register(b0);
+#ifdef BINDLESS
+    #include "Bindless.hlsli"
+    #define ObjectConstantsCB Objects[ObjectIndex]
+#else
+    ConstantBuffer<ObjectConstants> ObjectConstantsCB : register(b0);
+#endif
 ConstantBuffer<PassConstants> PassConstantsCB :register(b1);
 
 VertexOut main(VertexIn vin)
 {
     VertexOut vout;
     
-    vout.Norm = normalize(mul((float3x3)ObjectConstantsCB.ModelMatrixInvTrans, vin.Norm));
+    vout.Norm = normalize(mul((float3x3)ObjectConstantsCB.ModelMatrixInvTrans, DecodeNorm(vin.Norm)));
     vout.TexC = vin.TexC;
     
-    float4 posW = mul(ObjectConstantsCB.ModelMatrix, float4(vin.Pos, 1.0f));
+    float4 posW = mul(ObjectConstantsCB.ModelMatrix, float4(vin.Pos.xyz, 1.0f));
     vout.PosW = posW.xyz;
 
     vout.PosH = mul(PassConstantsCB.ViewProj, posW);
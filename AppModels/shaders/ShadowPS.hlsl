@@ -1,14 +1,26 @@
 #include "Common.hlsli"
 #include "GeoUtils.hlsli"
 
-ConstantBuffer<MaterialConstants> MaterialConstantsCB : register(b2);
+#ifdef BINDLESS
+    #include "Bindless.hlsli"
+#else
+    ConstantBuffer<MaterialConstants> MaterialConstantsCB : register(b2);
+    Texture2DArray Texture : register(t0);
+#endif
 
-Texture2D Texture : register(t0);
 SamplerState LinearWrapSampler : register(s0);
 
 void main(VertexOut pin)
 {
-    float4 diffuseAlbedo = MaterialConstantsCB.DiffuseAlbedo * Texture.Sample(LinearWrapSampler, pin.TexC);
+#ifdef BINDLESS
+    MaterialData materialData = Materials[Objects[ObjectIndex].MaterialIndex];
+    MaterialConstants MaterialConstantsCB = GetMaterialConstants(materialData);
+    float4 textureColor = SampleMaterialTexture(Textures[materialData.TextureIndex], LinearWrapSampler, MaterialConstantsCB, pin.TexC);
+#else
+    float4 textureColor = SampleMaterialTexture(Texture, LinearWrapSampler, MaterialConstantsCB, pin.TexC);
+#endif
+
+    float4 diffuseAlbedo = MaterialConstantsCB.DiffuseAlbedo * textureColor;
     
     #ifdef ALPHA_TEST
         clip(diffuseAlbedo.a - 0.1f);
@@ -1,7 +1,12 @@
 #include "Common.hlsli"
 #include "GeoUtils.hlsli"
 
-ConstantBuffer<ObjectConstants> ObjectConstantsCB : register(b0);
+#ifdef BINDLESS
+    #include "Bindless.hlsli"
+    #define ObjectConstantsCB Objects[ObjectIndex]
+#else
+    ConstantBuffer<ObjectConstants> ObjectConstantsCB : register(b0);
+#endif
 ConstantBuffer<PassConstants> PassConstantsCB : register(b1);
 
 cbuffer LightConstants : register(b3)
@@ -9,12 +14,18 @@ cbuffer LightConstants : register(b3)
     int LightIndex;
 };
 
+#ifdef POSITION_ONLY
+// for depth only rendering without pixel shader
+VertexOut main(PositionVertexIn vin) {
+    VertexOut vout = (VertexOut)0;
+#else
 VertexOut main(VertexIn vin) {
     VertexOut vout;
     
     vout.TexC = vin.TexC;
-    vout.Norm = vin.Norm;
-    float4 posW = mul(ObjectConstantsCB.ModelMatrix, float4(vin.Pos, 1.0f));
+    vout.Norm = DecodeNorm(vin.Norm);
+#endif
+    float4 posW = mul(ObjectConstantsCB.ModelMatrix, float4(vin.Pos.xyz, 1.0f));
     vout.PosW = posW.xyz;
     vout.PosH = mul(PassConstantsCB.Lights[LightIndex].LightViewProj, posW);
     
@@ -2,13 +2,19 @@
 
 FrameResources::FrameResources(
 	ComPtr<ID3D12Device> device, 
-	UINT numPassConstants, 
-	UINT numObjectConstants,
-	UINT numMaterialConstants) 
+	UINT numPassConstants,
+	UINT numObjects,
+	UINT numMaterials)
 {
 	m_PassConstantsBuffer = std::make_unique<UploadBuffer<PassConstants>>(device, numPassConstants, true);
-	m_ObjectsConstantsBuffer = std::make_unique<UploadBuffer<ObjectConstants>>(device, numObjectConstants, true);
-	m_MaterialsConstantsBuffer = std::make_unique <UploadBuffer<MaterialConstants>>(device, numMaterialConstants, true);
+
+	if (numObjects > 0) {
+		m_ObjectsBuffer = std::make_unique<UploadBuffer<ObjectData>>(device, numObjects, false);
+	}
+
+	if (numMaterials > 0) {
+		m_MaterialsBuffer = std::make_unique<UploadBuffer<MaterialData>>(device, numMaterials, false);
+	}
 }
 
 FrameResources::~FrameResources() {}
\ No newline at end of file
@@ -1,16 +1,85 @@
 #include <ModelsApp.h>
+#include <MyD3D12Lib/BlockCompression.h>
 #include <MyD3D12Lib/D3D12Utils.h>
+#include <MyD3D12Lib/DDSWriter.h>
 #include <MyD3D12Lib/Helpers.h>
+#include <MyD3D12Lib/MeshSplitter.h>
+#include <MyD3D12Lib/VertexStreams.h>
 
 #include <d3dx12.h>
 #include <DirectXPackedVector.h>
 
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/Importer.hpp>
+#include <assimp/MemoryIOWrapper.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <assimp/mesh.h>
+#include <assimp/GltfMaterial.h>
 
+#include <algorithm>
 #include <array>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+
+namespace {
+	// importer reads scene and its buffers from asset package, files missing in package are read from disk
+	class PackageIOSystem : public Assimp::DefaultIOSystem {
+	public:
+		PackageIOSystem(const AssetPackage& package, const std::filesystem::path& folder) :
+			m_Package(package),
+			m_Folder(std::filesystem::absolute(folder).lexically_normal())
+		{
+		}
+
+		bool Exists(const char* pFile) const override {
+			return Find(pFile) != AssetPackage::InvalidIndex || Assimp::DefaultIOSystem::Exists(pFile);
+		}
+
+		Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb") override {
+			uint32_t index = Find(pFile);
+
+			if (index == AssetPackage::InvalidIndex) {
+				return Assimp::DefaultIOSystem::Open(pFile, pMode);
+			}
+
+			// stream owns buffer, so it is allocated as array
+			uint64_t size = m_Package.GetFileSize(index);
+			uint8_t* data = new uint8_t[size];
+			m_Package.Read(index, 0, size, data);
+
+			return new Assimp::MemoryIOStream(data, size, true);
+		}
+
+	private:
+		uint32_t Find(const char* pFile) const {
+			std::filesystem::path path = std::filesystem::absolute(pFile).lexically_normal();
+			return m_Package.Find(path.lexically_relative(m_Folder).generic_string());
+		}
+
+		const AssetPackage& m_Package;
+		std::filesystem::path m_Folder;
+	};
+
+	// copy of defines ending with null define, BINDLESS is appended for bindless path
+	std::vector<D3D_SHADER_MACRO> GetDefines(const D3D_SHADER_MACRO* defines, bool isBindless) {
+		std::vector<D3D_SHADER_MACRO> result;
+
+		for (; defines != NULL && defines->Name != NULL; ++defines) {
+			result.push_back(*defines);
+		}
+
+		if (isBindless) {
+			result.push_back({ "BINDLESS", "1" });
+		}
+
+		result.push_back({ NULL, NULL });
+
+		return result;
+	}
+}
 
 ModelsApp::ModelsApp(HINSTANCE hInstance) : BaseApp(hInstance) {
 	Initialize();
@@ -29,6 +98,15 @@ bool ModelsApp::Initialize() {
 	std::filesystem::path scenePath = m_SceneFolder;
 	scenePath += "Sponza.gltf";
 
+	std::filesystem::path packagePath = m_SceneFolder;
+	packagePath += "Sponza.pak";
+
+	if (std::filesystem::exists(packagePath)) {
+		m_AssetPackage = std::make_unique<AssetPackage>(packagePath);
+		m_AssetPackageTime = std::filesystem::last_write_time(packagePath);
+		importer.SetIOHandler(new PackageIOSystem(*m_AssetPackage, m_SceneFolder));
+	}
+
 	m_Scene = importer.ReadFile(
 		scenePath.string(),
 		aiProcess_MakeLeftHanded | aiProcess_FlipWindingOrder | aiProcess_FlipUVs
@@ -38,13 +116,39 @@ bool ModelsApp::Initialize() {
 
 	InitSceneState();
 
-	ComPtr<ID3D12GraphicsCommandList> commandList = m_DirectCommandQueue->GetCommandList();
+	// resources are registered as they are created
+	m_ResidencyManager = std::make_unique<ResidencyManager>(0);
+	UpdateResidencyBudget();
 
-	BuildTextures(commandList);
+	// meshes, default texture and random vectors are copied while pipelines are built
+	m_UploadBatcher = std::make_unique<UploadBatcher>(m_MaxUploadBatchSize, m_MaxUploadBatchUploads);
+
+	uint64_t uploadBatch;
+	ComPtr<ID3D12GraphicsCommandList> uploadCommandList = GetUploadCommandList(0, uploadBatch);
+
+	BuildTextures(uploadCommandList);
 	BuildLights();
-	BuildGeometry(commandList);
+	BuildGeometry(uploadCommandList);
 	BuildMaterials();
 	BuildRenderItems();
+
+	SubmitUploads();
+
+	// textures start loading while pipelines are built, first frame doesn`t wait for them
+	UpdateTexturesPriorities();
+
+	// unbounded textures table can be partially initialized only with resource binding tier 2
+	if (m_Bindless) {
+		D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+
+		if (FAILED(m_Device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) ||
+			options.ResourceBindingTier < D3D12_RESOURCE_BINDING_TIER_2)
+		{
+			::OutputDebugString("bindless path needs resource binding tier 2, descriptor tables per draw are used\n");
+			m_Bindless = false;
+		}
+	}
+
 	BuildFrameResources();
 	BuildRootSignature();
 
@@ -53,24 +157,20 @@ bool ModelsApp::Initialize() {
 
 	BuildPipelineStateObject();
 
-	// count size for CBV and SRV descriptor heap
-	uint32_t numCBVandSRVforRenderItems = 0;
-
-	numCBVandSRVforRenderItems += 1; // for pass constants
-	numCBVandSRVforRenderItems += m_RenderItems.size(); // for object constants
-	numCBVandSRVforRenderItems += m_Materials.size(); // for material constants
-	numCBVandSRVforRenderItems *= m_NumBackBuffers; // repeat all prev constants for each back buffer
-	numCBVandSRVforRenderItems += m_Textures.size(); // for textures
-
-	m_CBV_SRVDescHeap = CreateDescriptorHeap(
+	// constants are bound as root CBVs, so heap doesn`t depend on number of render items
+	// ring partition of each frame fits all textures views
+	// effects views are renewed at most once per submitted frame, so frames in flight and current one can use different ranges, one more set is spare
+	m_CBV_SRVDescAllocator = std::make_unique<DescriptorAllocator>(
 		m_Device,
-		numCBVandSRVforRenderItems + m_NumSobelSRV + m_NumSSAO_SRV + m_NumShadowMaps,
 		D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
-		D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE
+		(m_NumSobelSRV + m_NumSSAO_SRV) * (m_NumFramesInFlight + 2) + m_NumShadowMaps,
+		true,
+		m_TexturesViewsAllocator->GetIndexAllocator().GetNumDescriptors(),
+		m_NumFramesInFlight
 	);
+	m_CBV_SRVDescHeap = m_CBV_SRVDescAllocator->GetHeap();
 
 	BuildSRViews();
-	BuildCBViews();
 
 	// recreate rtv descriptro heap for effects
 	m_RTVDescHeap = CreateDescriptorHeap(
@@ -80,63 +180,78 @@ bool ModelsApp::Initialize() {
 		D3D12_DESCRIPTOR_HEAP_FLAG_NONE
 	);
 	UpdateBackBuffersView();
+	TrackBaseResourcesStates();
+
+	// effects render targets are created when frame graph is compiled first time
+	m_FrameGraphResources = std::make_unique<RenderGraphResources>(m_Device);
 
 	// for Sobel filter
 	m_SobelTextureRTVIndex = m_NumBackBuffers;
-	m_SobelTextureSRVIndex = m_NextCBV_SRVDescHeapIndex;
-	m_NextCBV_SRVDescHeapIndex += m_NumSobelSRV;
-	UpdateSobelFrameTexture();
+	m_SobelTextureSRVRange = m_CBV_SRVDescAllocator->Allocate(m_NumSobelSRV);
+	m_SobelTextureSRVIndex = m_SobelTextureSRVRange.Index;
 	BuildSobelRootSignature();
 	BuildSobelPipelineStateObject();
 
 	// for SSAO
 	m_SSAO_RTV_StartIndex = m_SobelTextureRTVIndex + m_NumSobelRTV;
-	m_SSAO_SRV_StartIndex = m_NextCBV_SRVDescHeapIndex;
-	m_NextCBV_SRVDescHeapIndex += m_NumSSAO_SRV;
+	m_SSAO_SRVRange = m_CBV_SRVDescAllocator->Allocate(m_NumSSAO_SRV);
+	m_SSAO_SRV_StartIndex = m_SSAO_SRVRange.Index;
 	BuildSSAORootSignature();
 	BuildSSAOPipelineStateObject();
-	BuildRandomMapBufferAndDirections(commandList);
-	UpdateSSAOBuffersAndViews();
+	uploadCommandList = GetUploadCommandList(0, uploadBatch);
+	BuildRandomMapBufferAndDirections(uploadCommandList);
+	SubmitUploads();
+	UpdateSSAOViews();
 	InitBlurWeights();
 
 	// for Shadow maps
 	BuildShadowMaps();
 
-	// wait while all data loaded
-	uint32_t fenceValue = m_DirectCommandQueue->ExecuteCommandList(commandList);
-	m_DirectCommandQueue->WaitForFenceValue(fenceValue);
-
-	// release upload heaps after vertexes, indexes, textures and random vectors loading
-	for (auto& it : m_Geometries) {
-		it.second->DisposeUploaders();
-	}
-
-	for (auto& it : m_Textures) {
-		it.second->UploadResource = nullptr;
-	}
-
-	m_RandomMapUploadBuffer = nullptr;
-
 	// load data for all frames
 
-	for (uint32_t i = 0; i < m_NumBackBuffers; ++i) {
+	for (uint32_t i = 0; i < m_NumFramesInFlight; ++i) {
 		m_CurrentFrameResources = m_FramesResources[i].get();
 
 		UpdatePassConstants();
-		UpdateMaterialsConstants();
-		UpdateObjectsConstants();
 	}
 
 	// render shadow maps since they don't changes throught time
-	commandList = m_DirectCommandQueue->GetCommandList();
+	// they use textures views of current frame, so first frame waits for them before it rewrites views
+	m_CurrentFrameResources = m_FramesResources[m_FramePacer->GetFrameSlot()].get();
+
+	UpdateTexturesViews();
+	UpdateMaterialsConstants();
+	UpdateObjectsConstants();
+
+	ComPtr<ID3D12GraphicsCommandList> commandList = m_DirectCommandQueue->GetCommandList();
 	RenderShadowMaps(commandList);
-	m_DirectCommandQueue->ExecuteCommandList(commandList);
+
+	// shadow maps use meshes, waiting for the last batch waits for all batches before it
+	WaitForUploads(uploadBatch);
+
+	uint64_t fenceValue = ExecuteTrackedCommandList(commandList);
+	m_ConstantsAllocator->Retire(fenceValue);
+	m_DirectCommandQueue->WaitForFenceValue(fenceValue);
+
+	// release upload heaps after vertexes, indexes, default texture and random vectors loading
+	for (auto& it : m_Geometries) {
+		it.second->DisposeUploaders();
+	}
+
+	m_Textures["default"]->UploadResource = nullptr;
+
+	for (Texture* group : m_TexturesGroups) {
+		group->UploadResource = nullptr;
+	}
+
+	m_RandomMapUploadBuffer = nullptr;
 
 	return true;
 }
 
 void ModelsApp::OnUpdate() {
-	m_CurrentFrameResources = m_FramesResources[m_CurrentBackBufferIndex].get();
+	WaitForFrameSlot();
+	m_CurrentFrameResources = m_FramesResources[m_FramePacer->GetFrameSlot()].get();
 
 	m_Timer.Tick();
 
@@ -152,12 +267,151 @@ void ModelsApp::OnUpdate() {
 		::sprintf_s(buffer, 500, "camear position: %f %f %f\n", cameraPos.x, cameraPos.y, cameraPos.z);
 		::OutputDebugString(buffer);
 
+		// budget given by OS changes with other applications
+		UpdateResidencyBudget();
+
+		auto toMB = [](uint64_t size) { return static_cast<uint32_t>(size >> 20); };
+
+		::sprintf_s(
+			buffer, 500,
+			"memory: meshes %u MB, textures %u MB, shadow maps %u MB, SSAO %u MB, other %u MB, resident %u MB of %u MB, %llu evictions, %llu restores\n",
+			toMB(m_ResidencyManager->GetSize(ResidencyCategory::Meshes)),
+			toMB(m_ResidencyManager->GetSize(ResidencyCategory::Textures)),
+			toMB(m_ResidencyManager->GetSize(ResidencyCategory::ShadowMaps)),
+			toMB(m_ResidencyManager->GetSize(ResidencyCategory::SSAO)),
+			toMB(m_ResidencyManager->GetSize(ResidencyCategory::Other)),
+			toMB(m_ResidencyManager->GetResidentSize()),
+			toMB(m_ResidencyManager->GetBudget()),
+			m_ResidencyManager->GetNumEvictions(),
+			m_ResidencyManager->GetNumRestores()
+		);
+		::OutputDebugString(buffer);
+
+		ResourceHeapsStats heapsStats = m_ResourceHeapAllocator->GetStats();
+
+		::sprintf_s(
+			buffer, 500,
+			"heaps: %u heaps of %u MB, %u resources %u MB, %u free blocks, largest %u MB, fragmentation %.2f\n",
+			heapsStats.NumHeaps,
+			toMB(heapsStats.HeapsSize),
+			heapsStats.NumPlacedResources,
+			toMB(heapsStats.UsedSize),
+			heapsStats.NumFreeBlocks,
+			toMB(heapsStats.LargestFreeBlock),
+			heapsStats.Fragmentation
+		);
+		::OutputDebugString(buffer);
+
+		const DescriptorIndexAllocator& descriptors = m_CBV_SRVDescAllocator->GetIndexAllocator();
+		const DescriptorIndexAllocator& stagingDescriptors = m_TexturesViewsAllocator->GetIndexAllocator();
+
+		::sprintf_s(
+			buffer, 500,
+			"descriptors: %u of %u persistent, %u pending, %u of %u in frame ring, %u of %u textures staging views\n",
+			descriptors.GetNumUsed(),
+			descriptors.GetNumDescriptors(),
+			descriptors.GetNumPending(),
+			m_CBV_SRVDescAllocator->GetRing().GetNumUsed(),
+			m_CBV_SRVDescAllocator->GetRing().GetNumDescriptorsPerFrame(),
+			stagingDescriptors.GetNumUsed(),
+			stagingDescriptors.GetNumDescriptors()
+		);
+		::OutputDebugString(buffer);
+
+		::sprintf_s(
+			buffer, 500,
+			"barriers: %u in %u calls, %u resolved at submission by last frame\n",
+			m_LastFrameNumBarriers,
+			m_LastFrameNumBarrierCalls,
+			m_LastFrameNumResolvedBarriers
+		);
+		::OutputDebugString(buffer);
+
+		::sprintf_s(
+			buffer, 500,
+			"uploads: %u in %u batches of copy queue, direct queue waited for %u of them\n",
+			static_cast<uint32_t>(m_UploadBatcher->GetNumUploads()),
+			static_cast<uint32_t>(m_UploadBatcher->GetNumSubmittedBatches()),
+			static_cast<uint32_t>(m_UploadBatcher->GetNumConsumerWaits())
+		);
+		::OutputDebugString(buffer);
+
+		::sprintf_s(
+			buffer, 500,
+			"deferred releases: %u pending, %u released\n",
+			m_DeferredReleaseQueue->GetNumPending(),
+			static_cast<uint32_t>(m_DeferredReleaseQueue->GetNumReleased())
+		);
+		::OutputDebugString(buffer);
+
+		::sprintf_s(
+			buffer, 500,
+			"frame pacing: %u frames in flight, %s mode, %u stalls for %f ms\n",
+			m_FramePacer->GetNumFramesInFlight(),
+			m_FramePacer->GetMode() == FramePacingMode::Latency ? "latency" : "throughput",
+			static_cast<uint32_t>(m_FramePacer->GetNumStalls() - m_LoggedNumStalls),
+			(m_FramePacer->GetStallTime() - m_LoggedStallTime) * 1000.0
+		);
+		::OutputDebugString(buffer);
+
+		m_LoggedNumStalls = m_FramePacer->GetNumStalls();
+		m_LoggedStallTime = m_FramePacer->GetStallTime();
+
+		uint32_t numExecutedPasses = static_cast<uint32_t>(m_FrameGraph.GetCompiledPasses().size());
+
+		::sprintf_s(
+			buffer, 500,
+			"frame graph: %u of %u passes, transients %u MB in heap of %u MB\n",
+			numExecutedPasses,
+			m_FrameGraph.GetNumPasses(),
+			static_cast<uint32_t>(m_FrameGraph.GetTransientsSize() >> 20),
+			static_cast<uint32_t>(m_FrameGraphResources->GetHeapSize() >> 20)
+		);
+		::OutputDebugString(buffer);
+
+		const LinearAllocator& constantsPages = m_ConstantsAllocator->GetLinearAllocator();
+
+		::sprintf_s(
+			buffer, 500,
+			"constants: %u pages of %u KB, %u free, %u KB written by last frame\n",
+			constantsPages.GetNumPages(),
+			static_cast<uint32_t>(constantsPages.GetPageSize() >> 10),
+			constantsPages.GetNumFreePages(),
+			static_cast<uint32_t>(m_LastFrameConstantsSize >> 10)
+		);
+		::OutputDebugString(buffer);
+
 		m_Timer.StartMeasurement();
 	}
+
+	// pages of constants used by finished frames are reused
+	m_ConstantsAllocator->ReleaseCompleted(m_DirectCommandQueue->GetCompletedFenceValue());
+	m_DeferredReleaseQueue->ReleaseCompleted(m_DirectCommandQueue->GetCompletedFenceValue());
 	
 	UpdatePassConstants();
+
+	UpdateTexturesPriorities();
+	UpdateTexturesStreaming();
+	UpdateTexturesViews();
+
+	// materials refer to slots of textures views of frame, so they are written after views
 	UpdateMaterialsConstants();
 	UpdateObjectsConstants();
+
+	m_CBV_SRVDescAllocator->ReleaseCompleted(m_DirectCommandQueue->GetCompletedFenceValue());
+}
+
+void ModelsApp::WaitForFrameSlot() {
+	uint64_t fenceValue = m_FramePacer->GetWaitFenceValue();
+
+	if (m_DirectCommandQueue->IsFenceComplite(fenceValue)) {
+		return;
+	}
+
+	auto waitStart = std::chrono::steady_clock::now();
+	m_DirectCommandQueue->WaitForFenceValue(fenceValue);
+
+	m_FramePacer->AddStall(std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart).count());
 }
 
 void ModelsApp::UpdatePassConstants() {
@@ -206,62 +460,562 @@ void ModelsApp::UpdatePassConstants() {
 }
 
 void ModelsApp::UpdateMaterialsConstants() {
+	// constants are written to memory of frame, so they are written for each frame
 	for (auto& it : m_Materials) {
-		if (it->NumDirtyFrames > 0) {
-			m_CurrentFrameResources->m_MaterialsConstantsBuffer->CopyData(
-				it->CBIndex,
-				{
-					it->DiffuseAlbedo,
-					it->FresnelR0,
-					it->Roughness
-				}
-			);
+		const Texture* tex = m_Textures[it->TextureName].get();
+
+		if (m_Bindless) {
+			m_CurrentFrameResources->m_MaterialsBuffer->CopyData(it->CBIndex, {
+				it->DiffuseAlbedo,
+				it->FresnelR0,
+				it->Roughness,
+				tex->UVTransform,
+				tex->ArrayIndex,
+				m_TexturesViewsRemap.GetSlot(tex->SRVStagingIndex)
+			});
+
+			// draws don`t look up textures, so textures of all materials are kept resident
+			if (tex->ResidencyId != ResidencyManager::InvalidId) {
+				m_ResidencyManager->MarkUsed(tex->ResidencyId, m_FrameIndex);
+			}
 
-			--it->NumDirtyFrames;
+			continue;
 		}
+
+		m_MaterialsConstantsAddresses[it->CBIndex] = m_ConstantsAllocator->AllocateConstants<MaterialConstants>({
+			it->DiffuseAlbedo,
+			it->FresnelR0,
+			it->Roughness,
+			tex->UVTransform,
+			tex->ArrayIndex
+		});
 	}
 }
 
 void ModelsApp::UpdateObjectsConstants() {
 	for (auto& it : m_RenderItems) {
-		if (it->m_NumDirtyFramse > 0) {
-			m_CurrentFrameResources->m_ObjectsConstantsBuffer->CopyData(
-				it->m_CBIndex,
-				{
-					it->m_ModelMatrix,
-					it->m_ModelMatrixInvTrans
-				}
+		if (m_Bindless) {
+			m_CurrentFrameResources->m_ObjectsBuffer->CopyData(it->m_CBIndex, {
+				XMMatrixMultiply(it->m_PosDequantMatrix, it->m_ModelMatrix),
+				it->m_ModelMatrixInvTrans,
+				it->m_Material->CBIndex
+			});
+
+			continue;
+		}
+
+		m_ObjectsConstantsAddresses[it->m_CBIndex] = m_ConstantsAllocator->AllocateConstants<ObjectConstants>({
+			XMMatrixMultiply(it->m_PosDequantMatrix, it->m_ModelMatrix),
+			it->m_ModelMatrixInvTrans
+		});
+	}
+}
+
+void ModelsApp::UpdateTexturesPriorities() {
+	// packed textures are resident from initialization
+	if (!m_TextureStreamer) {
+		return;
+	}
+
+	// priority is part of screen covered by bounding spheres of render items using texture
+	float tanHalfFoV = std::tan(XMConvertToRadians(m_Camera.GetFoV()) / 2.0f);
+	XMVECTOR cameraPos = m_Camera.GetCameraPos();
+
+	std::vector<float> priorities(m_StreamedTextures.size(), 0.0f);
+	std::fill(m_UnitRequiredMips.begin(), m_UnitRequiredMips.end(), FLT_MAX);
+
+	for (auto& ri : m_RenderItems) {
+		auto idIt = m_StreamedTexturesIds.find(ri->m_Material->TextureName);
+
+		if (idIt == m_StreamedTexturesIds.end()) {
+			continue;
+		}
+
+		float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&ri->m_BoundsCenter) - cameraPos));
+
+		// camera inside of sphere sees it on whole screen
+		float screenRadius = 1.0f;
+
+		if (distance > ri->m_BoundsRadius) {
+			screenRadius = (std::min)(ri->m_BoundsRadius / (distance * tanHalfFoV), 1.0f);
+		}
+
+		float& priority = priorities[idIt->second];
+		priority = (std::max)(priority, screenRadius * screenRadius);
+
+		// nearest point of bounding sphere needs the finest mip, near plane limits it
+		float& requiredMip = m_UnitRequiredMips[idIt->second];
+		requiredMip = (std::min)(requiredMip, ComputeRequiredMip(
+			ri->m_UVDensity,
+			1.0f,
+			(std::max)(distance - ri->m_BoundsRadius, 0.1f),
+			static_cast<float>(m_ClientHeight),
+			tanHalfFoV
+		));
+	}
+
+	// texture with the same content is needed wherever its aliases are
+	for (auto& [alias, canonical] : m_TexturesAliases) {
+		uint32_t aliasId = m_StreamedTexturesIds[alias->Name];
+		uint32_t canonicalId = m_StreamedTexturesIds[canonical->Name];
+
+		m_UnitRequiredMips[canonicalId] = (std::min)(m_UnitRequiredMips[canonicalId], m_UnitRequiredMips[aliasId]);
+	}
+
+	// only pending textures are affected, priority of queued texture is updated only if changed
+	for (uint32_t i = 0; i < priorities.size(); ++i) {
+		m_TextureStreamer->Request(i, priorities[i]);
+	}
+}
+
+void ModelsApp::UpdateTexturesStreaming() {
+	if (!m_TextureStreamer) {
+		return;
+	}
+
+	uint64_t completedUploadFenceValue = m_CopyCommandQueue->GetCompletedFenceValue();
+
+	m_UploadBatcher->ReleaseCompleted(completedUploadFenceValue);
+
+	// switch views of textures which upload is finished on GPU
+	// views are switched after copy queue finished upload, so direct queue doesn`t wait for it
+	for (uint32_t id : m_TextureStreamer->TakeResident(completedUploadFenceValue)) {
+		Texture* tex = m_StreamedTextures[id];
+
+		tex->UploadResource = nullptr;
+
+		if (tex->Resource) {
+			tex->SRVStagingIndex = m_TexturesViewsAllocator->Allocate(1).Index;
+			CreateTextureSRView(tex->Resource.Get(), tex->SRVStagingIndex);
+		}
+		else {
+			// alias uses view of texture with same content, canonical texture is already loaded
+			m_TexturesAliases.emplace_back(tex, m_Textures[m_TextureRegistry.Resolve(tex->Name)].get());
+		}
+
+		++m_NumResidentTextures;
+
+		if (m_NumResidentTextures == m_StreamedTextures.size()) {
+			char buffer[500];
+			::sprintf_s(buffer, 500, "textures: %u streamed in %.2f s, %u unique, %u aliases share them, %u KB saved\n",
+				m_NumResidentTextures, m_Timer.GetTotalTime(),
+				m_TextureRegistry.GetNumContents(), m_TextureRegistry.GetNumAliases(),
+				static_cast<uint32_t>(m_TextureRegistry.GetSavedBytes() / 1024)
 			);
+			::OutputDebugString(buffer);
+		}
+	}
+
+	// switch views of textures which mips are changed
+	for (Texture* tex : m_StreamedTextures) {
+		if (!tex->PendingResource || tex->PendingFenceValue > completedUploadFenceValue) {
+			continue;
+		}
 
-			--it->m_NumDirtyFramse;
+		// frames in flight use copies of staging view, so it is rewritten at once
+		CreateTextureSRView(tex->PendingResource.Get(), tex->SRVStagingIndex);
+
+		// old resource is released when frames in flight are finished
+		m_DeferredReleaseQueue->Push(m_DirectCommandQueue->Signal(), [resource = std::move(tex->Resource)]() mutable {
+			resource.Reset();
+		});
+
+		tex->Resource = std::move(tex->PendingResource);
+		tex->FirstMip = tex->PendingFirstMip;
+		tex->UploadResource = nullptr;
+
+		// evicted texture stays evicted with new resource, so it is restored on next use as usual
+		if (!m_ResidencyManager->IsResident(tex->ResidencyId)) {
+			EvictResources(m_Device, { tex->Resource.Get() });
+		}
+
+		m_ResidencyManager->Resize(tex->ResidencyId, GetResourceAllocationSize(m_Device, tex->Resource.Get()));
+	}
+
+	for (auto& [alias, canonical] : m_TexturesAliases) {
+		alias->SRVStagingIndex = canonical->SRVStagingIndex;
+		alias->ResidencyId = canonical->ResidencyId;
+	}
+
+	// loaded textures keep decoded mips, aliases have nothing to upload and are resident at once
+	auto loaded = m_TextureStreamer->TakeLoaded(m_MaxTextureUploadsPerFrame);
+	std::vector<uint32_t> uploadedIds;
+
+	for (auto& [id, decoded] : loaded) {
+		if (decoded.Subresources.empty()) {
+			m_TextureStreamer->OnUploadSubmitted(id, 0);
+			continue;
+		}
+
+		if (m_StreamMips) {
+			std::vector<uint64_t> mipsSizes;
+
+			for (const D3D12_SUBRESOURCE_DATA& subresource : decoded.Subresources) {
+				mipsSizes.push_back(subresource.SlicePitch);
+			}
+
+			m_MipBudgetSolver->SetTextureMips(id, mipsSizes, GetMaxFirstMip(decoded.Desc));
+		}
+
+		m_StreamedTextures[id]->Source = std::move(decoded);
+		uploadedIds.push_back(id);
+	}
+
+	// first mips are chosen for all textures together, so newly loaded ones are uploaded with them at once
+	std::vector<uint32_t> firstMips(m_StreamedTextures.size(), 0);
+
+	if (m_StreamMips) {
+		std::vector<float> requiredMips(m_StreamedTextures.size(), FLT_MAX);
+
+		for (uint32_t i = 0; i < m_StreamedTextures.size(); ++i) {
+			const D3D12_RESOURCE_DESC& desc = m_StreamedTextures[i]->Source.Desc;
+
+			if (m_MipBudgetSolver->HasMips(i) && m_UnitRequiredMips[i] != FLT_MAX) {
+				float textureSize = std::sqrt(static_cast<float>(desc.Width) * static_cast<float>(desc.Height));
+				requiredMips[i] = m_UnitRequiredMips[i] + std::log2(textureSize);
+			}
+		}
+
+		firstMips = m_MipBudgetSolver->Solve(requiredMips);
+	}
+
+	std::vector<uint64_t> uploadedBatches;
+	uint32_t numUploads = 0;
+
+	for (uint32_t id : uploadedIds) {
+		Texture* tex = m_StreamedTextures[id];
+
+		uploadedBatches.push_back(0);
+		ComPtr<ID3D12GraphicsCommandList> commandList = GetUploadCommandList(GetTextureDataSize(tex->Source), uploadedBatches.back());
+
+		if (m_StreamMips) {
+			tex->FirstMip = firstMips[id];
+			tex->Resource = RecordTextureMipsUpdate(m_Device, commandList, tex->Source, tex->FirstMip, nullptr, 0, tex->UploadResource);
 		}
+		else {
+			tex->Resource = tex->Source.Resource;
+			RecordTextureUpload(m_Device, commandList, tex->Source, tex->UploadResource);
+			tex->Source = DecodedTexture();
+		}
+
+		// callbacks take resource at the moment of call, since it is replaced when mips change
+		tex->ResidencyId = m_ResidencyManager->Register(
+			ResidencyCategory::Textures,
+			GetResourceAllocationSize(m_Device, tex->Resource.Get()),
+			true,
+			m_FrameIndex,
+			[this, tex]() { EvictResources(m_Device, { tex->Resource.Get() }); },
+			[this, tex]() { MakeResourcesResident(m_Device, { tex->Resource.Get() }); }
+		);
+
+		++numUploads;
+	}
+
+	// resident textures which need other mips are recreated, retained mips are copied on GPU
+	// aliases, textures which are not resident yet and textures with unfinished update are skipped
+	std::vector<Texture*> updatedTextures;
+	std::vector<uint64_t> updatedBatches;
+	uint32_t defaultViewIndex = m_Textures["default"]->SRVStagingIndex;
+
+	for (uint32_t i = 0; m_StreamMips && i < m_StreamedTextures.size() && numUploads < m_MaxTextureUploadsPerFrame; ++i) {
+		Texture* tex = m_StreamedTextures[i];
+
+		if (!tex->Resource || tex->SRVStagingIndex == defaultViewIndex || tex->PendingResource) {
+			continue;
+		}
+
+		if (firstMips[i] == tex->FirstMip) {
+			continue;
+		}
+
+		updatedBatches.push_back(0);
+		ComPtr<ID3D12GraphicsCommandList> commandList = GetUploadCommandList(GetTextureDataSize(tex->Source), updatedBatches.back());
+
+		// retained mips are copied from current resource
+		m_ResidencyManager->MarkUsed(tex->ResidencyId, m_FrameIndex);
+
+		tex->PendingFirstMip = firstMips[i];
+		tex->PendingResource = RecordTextureMipsUpdate(
+			m_Device, commandList,
+			tex->Source, tex->PendingFirstMip,
+			tex->Resource.Get(), tex->FirstMip,
+			tex->UploadResource
+		);
+
+		updatedTextures.push_back(tex);
+		++numUploads;
+	}
+
+	if (numUploads == 0) {
+		return;
+	}
+
+	// uploads of frame are submitted together, views are switched when fence of their batch is passed
+	SubmitUploads();
+
+	for (uint32_t i = 0; i < uploadedIds.size(); ++i) {
+		m_TextureStreamer->OnUploadSubmitted(uploadedIds[i], m_UploadBatcher->GetFenceValue(uploadedBatches[i]));
+	}
+
+	for (uint32_t i = 0; i < updatedTextures.size(); ++i) {
+		updatedTextures[i]->PendingFenceValue = m_UploadBatcher->GetFenceValue(updatedBatches[i]);
+	}
+}
+
+void ModelsApp::UpdateResidencyBudget() {
+	uint64_t budget = m_GPUMemoryBudget;
+
+	if (budget == 0) {
+		DXGI_QUERY_VIDEO_MEMORY_INFO memoryInfo;
+		ThrowIfFailed(m_Adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &memoryInfo));
+		budget = memoryInfo.Budget;
+	}
+
+	m_ResidencyManager->SetBudget(budget);
+}
+
+void ModelsApp::TrackRenderTargets(uint32_t& residencyId, ResidencyCategory category, const std::vector<ID3D12Resource*>& resources) {
+	uint64_t size = 0;
+
+	for (ID3D12Resource* resource : resources) {
+		size += GetResourceAllocationSize(m_Device, resource);
+	}
+
+	// render targets are recreated on resize, so they are registered once and resized later
+	if (residencyId == ResidencyManager::InvalidId) {
+		residencyId = m_ResidencyManager->Register(category, size, false, m_FrameIndex);
+	}
+	else {
+		m_ResidencyManager->Resize(residencyId, size);
+	}
+}
+
+void ModelsApp::TrackBaseResourcesStates() {
+	for (uint32_t i = 0; i < m_NumBackBuffers; ++i) {
+		m_ResourceStates.SetState(m_BackBuffers[i].Get(), D3D12_RESOURCE_STATE_PRESENT);
+	}
+
+	m_ResourceStates.SetState(m_DSBuffer.Get(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+}
+
+uint64_t ModelsApp::ExecuteTrackedCommandList(ComPtr<ID3D12GraphicsCommandList> commandList) {
+	// barriers of first uses are recorded to list executed just before, so they see states left by all lists submitted before
+	// both lists are submitted together with one signal
+	std::vector<D3D12_RESOURCE_BARRIER> barriers;
+	ComPtr<ID3D12GraphicsCommandList> barriersList;
+
+	if (m_StateTracker.ResolvePendingBarriers(m_ResourceStates, barriers) > 0) {
+		barriersList = m_DirectCommandQueue->GetCommandList();
+		barriersList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+	}
+
+	m_StateTracker.CommitFinalStates(m_ResourceStates);
+
+	m_LastFrameNumBarriers = m_StateTracker.GetNumBarriers();
+	m_LastFrameNumBarrierCalls = m_StateTracker.GetNumBarrierCalls();
+	m_LastFrameNumResolvedBarriers = static_cast<uint32_t>(barriers.size());
+
+	m_StateTracker.Reset();
+
+	if (barriersList) {
+		return m_DirectCommandQueue->ExecuteCommandLists({ barriersList, commandList });
+	}
+
+	return m_DirectCommandQueue->ExecuteCommandList(commandList);
+}
+
+ComPtr<ID3D12GraphicsCommandList> ModelsApp::GetUploadCommandList(uint64_t size, uint64_t& batch) {
+	if (m_UploadBatcher->IsFull(size)) {
+		SubmitUploads();
+	}
+
+	if (!m_UploadCommandList) {
+		m_UploadCommandList = m_CopyCommandQueue->GetCommandList();
+	}
+
+	batch = m_UploadBatcher->Add(size);
+
+	return m_UploadCommandList;
+}
+
+void ModelsApp::SubmitUploads() {
+	if (!m_UploadCommandList) {
+		return;
+	}
+
+	m_UploadBatcher->Submit(m_CopyCommandQueue->ExecuteCommandList(m_UploadCommandList));
+	m_UploadCommandList = nullptr;
+}
+
+void ModelsApp::WaitForUploads(uint64_t batch) {
+	if (batch == m_UploadBatcher->GetOpenBatch()) {
+		SubmitUploads();
+	}
+
+	uint64_t fenceValue = m_UploadBatcher->RequireBatch(batch, m_CopyCommandQueue->GetCompletedFenceValue());
+
+	if (fenceValue > 0) {
+		m_DirectCommandQueue->Wait(*m_CopyCommandQueue, fenceValue);
 	}
 }
 
 void ModelsApp::OnRender() {
 	ComPtr<ID3D12GraphicsCommandList> commandList = m_DirectCommandQueue->GetCommandList();
 
-	ID3D12Resource* mainRTBuffer = m_BackBuffers[m_CurrentBackBufferIndex].Get();
+	// render shadow maps
+	//RenderShadowMaps(commandList);
+
+	BuildFrameGraph(commandList);
+	m_FrameGraph.Compile();
+
+	// transients are placed again only when effects are switched or window is resized
+	if (m_FrameGraphResources->IsLayoutChanged(m_FrameGraph)) {
+		UpdateFrameGraphResources();
+	}
+
+	m_FrameGraphResources->Execute(m_FrameGraph, m_StateTracker, commandList.Get());
+
+	// Present
+	{
+		// resources used by this frame and frames in flight are kept resident
+		m_ResidencyManager->EnforceBudget(m_FramePacer->GetFirstUnfinishedFrame());
+		++m_FrameIndex;
+
+		uint64_t fenceValue = ExecuteTrackedCommandList(commandList);
+		m_FramePacer->EndFrame(fenceValue);
+		m_LastFrameConstantsSize = m_ConstantsAllocator->GetLinearAllocator().GetUsedSize();
+		m_ConstantsAllocator->Retire(fenceValue);
+
+		UINT syncInterval = m_Vsync ? 1 : 0;
+		UINT flags = m_AllowTearing && !m_Vsync ? DXGI_PRESENT_ALLOW_TEARING : 0;
+		ThrowIfFailed(m_SwapChain->Present(syncInterval, flags));
+
+		// next frame waits for its frame slot, DXGI limits queued presents by itself
+		m_CurrentBackBufferIndex = m_SwapChain->GetCurrentBackBufferIndex();
+	}
+}
+
+void ModelsApp::BuildFrameGraph(ComPtr<ID3D12GraphicsCommandList> commandList) {
+	m_FrameGraph.Reset();
+
+	// resources living between frames are imported in states frames leave them in
+	uint32_t backBuffer = m_FrameGraphResources->Import(
+		m_FrameGraph,
+		m_BackBuffers[m_CurrentBackBufferIndex].Get(),
+		D3D12_RESOURCE_STATE_PRESENT
+	);
+
+	uint32_t depthBuffer = m_FrameGraphResources->Import(m_FrameGraph, m_DSBuffer.Get(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
+	std::vector<uint32_t> shadowMaps;
+
+	for (auto& shadowMap : m_ShadowMaps) {
+		shadowMaps.push_back(m_FrameGraphResources->Import(m_FrameGraph, shadowMap->GetResource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+	}
+
+	// effects render targets are declared each frame, only ones used by executed passes get memory
+	CD3DX12_RESOURCE_DESC normalMapDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+		DXGI_FORMAT_R16G16B16A16_FLOAT,
+		m_ClientWidth,
+		m_ClientHeight
+	);
+
+	normalMapDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+	CD3DX12_CLEAR_VALUE normalMapClearValue{ DXGI_FORMAT_R16G16B16A16_FLOAT , m_NormalMapBufferClearValue.data() };
+
+	m_NormalMap = m_FrameGraphResources->CreateTransient(m_FrameGraph, normalMapDesc, &normalMapClearValue);
+
+	m_OcclusionMapWidth = m_ClientWidth / 2;
+	m_OcclusionMapHeight = m_ClientHeight / 2;
+
+	CD3DX12_RESOURCE_DESC occlusionMapDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+		DXGI_FORMAT_R16_UNORM,
+		m_OcclusionMapWidth,
+		m_OcclusionMapHeight
+	);
+
+	occlusionMapDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+	m_OcclusionMap0 = m_FrameGraphResources->CreateTransient(m_FrameGraph, occlusionMapDesc);
+	m_OcclusionMap1 = m_FrameGraphResources->CreateTransient(m_FrameGraph, occlusionMapDesc);
+
+	m_SobelFrameTexture = RenderGraph::InvalidIndex;
+
+	if (m_IsSobelFilter) {
+		CD3DX12_RESOURCE_DESC sobelTextureDesc = CD3DX12_RESOURCE_DESC::Tex2D(m_BackBuffersFormat, m_ClientWidth, m_ClientHeight);
+		sobelTextureDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+		CD3DX12_CLEAR_VALUE sobelTextureClearValue{ m_BackBuffersFormat , m_BackGroundColor.data() };
+
+		m_SobelFrameTexture = m_FrameGraphResources->CreateTransient(m_FrameGraph, sobelTextureDesc, &sobelTextureClearValue);
+	}
+
+	// get RTV's
 	CD3DX12_CPU_DESCRIPTOR_HANDLE mainRTV(
 		m_RTVDescHeap->GetCPUDescriptorHandleForHeapStart(),
 		m_CurrentBackBufferIndex, m_RTVDescSize
 	);
 
-	// clear depth stenicl buffer
-	commandList->ClearDepthStencilView(
-		m_DSVDescHeap->GetCPUDescriptorHandleForHeapStart(),
-		D3D12_CLEAR_FLAG_DEPTH,
-		m_DepthClearValue,
-		m_SteniclClearValue,
-		0, NULL
+	CD3DX12_CPU_DESCRIPTOR_HANDLE sobelTexRTV(
+		m_RTVDescHeap->GetCPUDescriptorHandleForHeapStart(),
+		m_SobelTextureRTVIndex, m_RTVDescSize
 	);
 
-	// render shadow maps
-	//RenderShadowMaps(commandList);
+	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvDescHandle(
+		m_RTVDescHeap->GetCPUDescriptorHandleForHeapStart(),
+		m_SSAO_RTV_StartIndex, m_RTVDescSize
+	);
 
-	if (m_DrawingType == DrawingType::SSAO) {
-		// render occlusion map 
-		RenderSSAO(commandList);
+	D3D12_CPU_DESCRIPTOR_HANDLE normalMapRTV = rtvDescHandle;
+	D3D12_CPU_DESCRIPTOR_HANDLE occlusionMap0RTV = rtvDescHandle.Offset(m_RTVDescSize);
+	D3D12_CPU_DESCRIPTOR_HANDLE occlusionMap1RTV = rtvDescHandle.Offset(m_RTVDescSize);
+
+	// get SRV's when passes are executed, views are renewed if transients are placed again
+	auto getOcclusionMapSRV = [this](uint32_t map) -> D3D12_GPU_DESCRIPTOR_HANDLE {
+		return CD3DX12_GPU_DESCRIPTOR_HANDLE(
+			m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
+			m_SSAO_SRV_StartIndex + 3 + map, m_CBV_SRV_UAVDescSize
+		);
+	};
+
+	// draw normal map, SSAO passes are culled if geometry doesn`t read occlusion map
+	uint32_t pass = m_FrameGraph.AddPass("SSAONormals", [this, commandList, normalMapRTV]() {
+		ComPtr<ID3D12PipelineState> pso = m_IsInverseDepth ? m_PSOs["ssaoNormInverseDepth"] : m_PSOs["ssaoNormStraightDepth"];
+		RenderGeometry(commandList, pso, normalMapRTV, m_NormalMapBufferClearValue, true);
+	});
+
+	m_FrameGraph.Write(pass, m_NormalMap, D3D12_RESOURCE_STATE_RENDER_TARGET);
+	m_FrameGraph.Write(pass, depthBuffer, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
+	for (uint32_t shadowMap : shadowMaps) {
+		m_FrameGraph.Read(pass, shadowMap, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
+
+	// draw occlusion map
+	pass = m_FrameGraph.AddPass("SSAO", [this, commandList, occlusionMap0RTV]() {
+		RenderSSAO(commandList, occlusionMap0RTV);
+	});
+
+	m_FrameGraph.Read(pass, m_NormalMap, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	m_FrameGraph.Read(pass, depthBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	m_FrameGraph.Write(pass, m_OcclusionMap0, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+	// blur occlusion map
+	for (int i = 0; i < 2; ++i) {
+		pass = m_FrameGraph.AddPass("BlurVertical", [this, commandList, occlusionMap1RTV, getOcclusionMapSRV]() {
+			RenderBlur(commandList, occlusionMap1RTV, getOcclusionMapSRV(0), false);
+		});
+
+		m_FrameGraph.Read(pass, m_OcclusionMap0, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		m_FrameGraph.Write(pass, m_OcclusionMap1, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+		pass = m_FrameGraph.AddPass("BlurHorizontal", [this, commandList, occlusionMap0RTV, getOcclusionMapSRV]() {
+			RenderBlur(commandList, occlusionMap0RTV, getOcclusionMapSRV(1), true);
+		});
+
+		m_FrameGraph.Read(pass, m_OcclusionMap1, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		m_FrameGraph.Write(pass, m_OcclusionMap0, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	}
 
 	// render geometry
@@ -282,71 +1036,81 @@ void ModelsApp::OnRender() {
 				break;
 		}
 
+		// with SSAO geometry is tested against depth of normal map pass
+		bool isSSAO = m_DrawingType == DrawingType::SSAO;
+
 		// for Sobel filter render geometry in intermediate texture
-		if (m_IsSobelFilter) {
-			CD3DX12_CPU_DESCRIPTOR_HANDLE sobelTexRTV(
-				m_RTVDescHeap->GetCPUDescriptorHandleForHeapStart(),
-				m_SobelTextureRTVIndex, m_RTVDescSize
-			);
+		D3D12_CPU_DESCRIPTOR_HANDLE rtv = m_IsSobelFilter ? sobelTexRTV : mainRTV;
 
-			RenderGeometry(
-				commandList, pso,
-				m_SobelFrameTextureBuffer.Get(), sobelTexRTV, 
-				D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-				m_BackGroundColor
-			);
+		pass = m_FrameGraph.AddPass("Geometry", [this, commandList, pso, rtv, isSSAO]() {
+			RenderGeometry(commandList, pso, rtv, m_BackGroundColor, !isSSAO);
+		});
+
+		if (isSSAO) {
+			m_FrameGraph.ReadWrite(pass, depthBuffer, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+			m_FrameGraph.Read(pass, m_OcclusionMap0, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 		}
 		else {
-			RenderGeometry(
-				commandList, pso,
-				mainRTBuffer, mainRTV,
-				D3D12_RESOURCE_STATE_PRESENT,
-				m_BackGroundColor
-			);
+			m_FrameGraph.Write(pass, depthBuffer, D3D12_RESOURCE_STATE_DEPTH_WRITE);
 		}
+
+		for (uint32_t shadowMap : shadowMaps) {
+			m_FrameGraph.Read(pass, shadowMap, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		}
+
+		m_FrameGraph.Write(pass, m_IsSobelFilter ? m_SobelFrameTexture : backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	}
 
 	if (m_IsSobelFilter) {
 		// apply Sobel filter
-		RenderSobelFilter(commandList, mainRTBuffer, mainRTV);
+		pass = m_FrameGraph.AddPass("Sobel", [this, commandList, mainRTV]() {
+			RenderSobelFilter(commandList, mainRTV);
+		});
+
+		m_FrameGraph.Read(pass, m_SobelFrameTexture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		m_FrameGraph.Write(pass, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	}
 
-	// Present
-	{
-		CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-			mainRTBuffer,
-			D3D12_RESOURCE_STATE_RENDER_TARGET,
-			D3D12_RESOURCE_STATE_PRESENT
-		);
+	// back buffer is presented after graph is executed
+	pass = m_FrameGraph.AddPass("Present", nullptr, true);
+	m_FrameGraph.Read(pass, backBuffer, D3D12_RESOURCE_STATE_PRESENT);
+}
 
-		commandList->ResourceBarrier(1, &barrier);
+void ModelsApp::UpdateFrameGraphResources() {
+	// previous transients can be used by frames in flight, so they are released after them
+	m_FrameGraphResources->UpdateLayout(m_FrameGraph, m_ResourceStates, *m_DeferredReleaseQueue, m_DirectCommandQueue->Signal());
 
-		m_BackBuffersFenceValues[m_CurrentBackBufferIndex] = m_DirectCommandQueue->ExecuteCommandList(commandList);
+	UpdateSobelViews();
+	UpdateSSAOViews();
 
-		UINT syncInterval = m_Vsync ? 1 : 0;
-		UINT flags = m_AllowTearing && !m_Vsync ? DXGI_PRESENT_ALLOW_TEARING : 0;
-		ThrowIfFailed(m_SwapChain->Present(syncInterval, flags));
+	// transients share memory of heap, so heap is tracked instead of them
+	uint64_t heapSize = m_FrameGraphResources->GetHeapSize();
 
-		m_CurrentBackBufferIndex = m_SwapChain->GetCurrentBackBufferIndex();
-		m_DirectCommandQueue->WaitForFenceValue(m_BackBuffersFenceValues[m_CurrentBackBufferIndex]);
+	if (m_FrameGraphResidencyId == ResidencyManager::InvalidId) {
+		m_FrameGraphResidencyId = m_ResidencyManager->Register(ResidencyCategory::Other, heapSize, false, m_FrameIndex);
+	}
+	else {
+		m_ResidencyManager->Resize(m_FrameGraphResidencyId, heapSize);
 	}
 }
 
 void ModelsApp::RenderGeometry(
 	ComPtr<ID3D12GraphicsCommandList> commandList,
 	ComPtr<ID3D12PipelineState> pso,
-	ID3D12Resource* rtBuffer,
 	D3D12_CPU_DESCRIPTOR_HANDLE rtv,
-	D3D12_RESOURCE_STATES rtBufferPrevState,
-	std::array<FLOAT, 4> rtClearValue)
+	std::array<FLOAT, 4> rtClearValue,
+	bool clearDepth)
 {
-	CD3DX12_RESOURCE_BARRIER rtBarrier = CD3DX12_RESOURCE_BARRIER::Transition(
-		rtBuffer,
-		rtBufferPrevState,
-		D3D12_RESOURCE_STATE_RENDER_TARGET
-	);
+	if (clearDepth) {
+		commandList->ClearDepthStencilView(
+			m_DSVDescHeap->GetCPUDescriptorHandleForHeapStart(),
+			D3D12_CLEAR_FLAG_DEPTH,
+			m_DepthClearValue,
+			m_SteniclClearValue,
+			0, NULL
+		);
+	}
 
-	commandList->ResourceBarrier(1, &rtBarrier);
 	commandList->ClearRenderTargetView(rtv, rtClearValue.data(), 0, NULL);
 
 	// set root signature
@@ -369,13 +1133,9 @@ void ModelsApp::RenderGeometry(
 	}
 
 	// set pass constants
-	commandList->SetGraphicsRootDescriptorTable(
+	commandList->SetGraphicsRootConstantBufferView(
 		1,
-		CD3DX12_GPU_DESCRIPTOR_HANDLE(
-			m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
-			m_PassConstantsViewsStartIndex + m_CurrentBackBufferIndex,
-			m_CBV_SRV_UAVDescSize
-		)
+		m_CurrentFrameResources->m_PassConstantsBuffer->Get()->GetGPUVirtualAddress()
 	);
 
 	// set shadow maps
@@ -384,6 +1144,10 @@ void ModelsApp::RenderGeometry(
 		m_ShadowMaps[0]->GetSrv()
 	);
 
+	if (m_Bindless) {
+		SetBindlessResources(commandList, 6);
+	}
+
 	commandList->SetPipelineState(pso.Get());
 
 	// set Rasterizer Stage
@@ -394,41 +1158,78 @@ void ModelsApp::RenderGeometry(
 	commandList->OMSetRenderTargets(1, &rtv, FALSE, &m_DSVDescHeap->GetCPUDescriptorHandleForHeapStart());
 
 	// draw render items
-	for (uint32_t i = 0; i < m_RenderItems.size(); ++i) {
-		RenderRenderItem(commandList, m_RenderItems[i].get());
+	for (auto& renderItems : m_RenderItemsLayers) {
+		RenderRenderItems(commandList, renderItems);
 	}
 }
 
-void ModelsApp::RenderRenderItem(ComPtr<ID3D12GraphicsCommandList> commandList, RenderItem* ri) {
-	auto mat = ri->m_Material;
+void ModelsApp::RenderRenderItems(ComPtr<ID3D12GraphicsCommandList> commandList, const std::vector<RenderItem*>& renderItems) {
+	MeshGeometry* boundGeo = nullptr;
+	D3D12_PRIMITIVE_TOPOLOGY boundTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	uint32_t boundTextureIndex = DescriptorIndexAllocator::InvalidIndex;
 
-	// set Input-Assembler state
-	commandList->IASetVertexBuffers(0, 1, &ri->m_MeshGeo->VertexBufferView());
-	commandList->IASetIndexBuffer(&ri->m_MeshGeo->IndexBufferView());
-	commandList->IASetPrimitiveTopology(ri->m_PrivitiveType);
+	for (uint32_t i = 0; i < renderItems.size(); ++i) {
+		RenderItem* ri = renderItems[i];
 
-	// set object and material constants and texture
-	CD3DX12_GPU_DESCRIPTOR_HANDLE objCBDescHandle(
-		m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
-		m_ObjectConstantsViewsStartIndex + m_CurrentBackBufferIndex * m_RenderItems.size() + ri->m_CBIndex,
-		m_CBV_SRV_UAVDescSize
-	);
+		// set Input-Assembler state only then it changes, all geometries share position and vertex buffers
+		// position only pipelines just don't fetch from second slot
+		if (boundGeo == nullptr) {
+			D3D12_VERTEX_BUFFER_VIEW vbvs[] = {
+				ri->m_MeshGeo->PositionBufferView(),
+				ri->m_MeshGeo->VertexBufferView()
+			};
 
-	CD3DX12_GPU_DESCRIPTOR_HANDLE matCBDescHandle(
-		m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
-		m_MaterialConstantsViewsStartIndex + m_CurrentBackBufferIndex * m_Materials.size() + mat->CBIndex,
-		m_CBV_SRV_UAVDescSize
-	);
+			commandList->IASetVertexBuffers(0, _countof(vbvs), vbvs);
+			m_ResidencyManager->MarkUsed(m_VertexBuffersResidencyId, m_FrameIndex);
+		}
 
-	CD3DX12_GPU_DESCRIPTOR_HANDLE textureDescHandle(
-		m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
-		m_TexturesViewsStartIndex + m_Textures[mat->TextureName]->SRVHeapIndex,
-		m_CBV_SRV_UAVDescSize
-	);
+		if (ri->m_MeshGeo != boundGeo) {
+			commandList->IASetIndexBuffer(&ri->m_MeshGeo->IndexBufferView());
+			m_ResidencyManager->MarkUsed(ri->m_GeometryResidencyId, m_FrameIndex);
+			boundGeo = ri->m_MeshGeo;
+		}
+
+		if (ri->m_PrivitiveType != boundTopology) {
+			commandList->IASetPrimitiveTopology(ri->m_PrivitiveType);
+			boundTopology = ri->m_PrivitiveType;
+		}
+
+		RenderRenderItem(commandList, ri, boundTextureIndex);
+	}
+}
+
+void ModelsApp::RenderRenderItem(ComPtr<ID3D12GraphicsCommandList> commandList, RenderItem* ri, uint32_t& boundTextureIndex) {
+	if (m_Bindless) {
+		// object refers to its material and material to its texture, so only index of object is set
+		commandList->SetGraphicsRoot32BitConstant(0, ri->m_CBIndex, 0);
+	}
+	else {
+		auto mat = ri->m_Material;
+
+		// set texture
+		Texture* tex = m_Textures[mat->TextureName].get();
+
+		CD3DX12_GPU_DESCRIPTOR_HANDLE textureDescHandle(
+			m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
+			tex->SRVHeapIndex,
+			m_CBV_SRV_UAVDescSize
+		);
+
+		// texture which is not uploaded yet uses default one
+		if (tex->ResidencyId != ResidencyManager::InvalidId) {
+			m_ResidencyManager->MarkUsed(tex->ResidencyId, m_FrameIndex);
+		}
 
-	commandList->SetGraphicsRootDescriptorTable(0, objCBDescHandle);
-	commandList->SetGraphicsRootDescriptorTable(2, matCBDescHandle);
-	commandList->SetGraphicsRootDescriptorTable(3, textureDescHandle);
+		// object and material constants are bound by addresses, without descriptors
+		commandList->SetGraphicsRootConstantBufferView(0, m_ObjectsConstantsAddresses[ri->m_CBIndex]);
+		commandList->SetGraphicsRootConstantBufferView(2, m_MaterialsConstantsAddresses[mat->CBIndex]);
+
+		// textures packed together and aliases share view
+		if (tex->SRVHeapIndex != boundTextureIndex) {
+			commandList->SetGraphicsRootDescriptorTable(3, textureDescHandle);
+			boundTextureIndex = tex->SRVHeapIndex;
+		}
+	}
 
 	// draw
 	commandList->DrawIndexedInstanced(
@@ -440,26 +1241,25 @@ void ModelsApp::RenderRenderItem(ComPtr<ID3D12GraphicsCommandList> commandList,
 	);
 }
 
-void ModelsApp::RenderSobelFilter(
-	ComPtr<ID3D12GraphicsCommandList> commandList,
-	ID3D12Resource* rtBuffer,
-	D3D12_CPU_DESCRIPTOR_HANDLE rtv) 
-{
-	CD3DX12_RESOURCE_BARRIER sobelTexBarrier = CD3DX12_RESOURCE_BARRIER::Transition(
-		m_SobelFrameTextureBuffer.Get(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+void ModelsApp::SetBindlessResources(ComPtr<ID3D12GraphicsCommandList> commandList, uint32_t texturesRootParameter) {
+	// objects and materials buffers are root SRVs, textures views of frame are one table
+	commandList->SetGraphicsRootShaderResourceView(
+		2,
+		m_CurrentFrameResources->m_ObjectsBuffer->Get()->GetGPUVirtualAddress()
 	);
 
-	CD3DX12_RESOURCE_BARRIER rtBufferBarrier = CD3DX12_RESOURCE_BARRIER::Transition(
-		rtBuffer,
-		D3D12_RESOURCE_STATE_PRESENT,
-		D3D12_RESOURCE_STATE_RENDER_TARGET
+	commandList->SetGraphicsRootShaderResourceView(
+		3,
+		m_CurrentFrameResources->m_MaterialsBuffer->Get()->GetGPUVirtualAddress()
 	);
 
-	D3D12_RESOURCE_BARRIER bariers[] = { sobelTexBarrier, rtBufferBarrier };
-	commandList->ResourceBarrier(_countof(bariers), bariers);
+	commandList->SetGraphicsRootDescriptorTable(
+		texturesRootParameter,
+		m_CBV_SRVDescAllocator->GetGPUHandle(m_TexturesTableIndex)
+	);
+}
 
+void ModelsApp::RenderSobelFilter(ComPtr<ID3D12GraphicsCommandList> commandList, D3D12_CPU_DESCRIPTOR_HANDLE rtv) {
 	// unbind all resources from pipeline
 	commandList->ClearState(NULL);
 
@@ -495,62 +1295,15 @@ void ModelsApp::RenderSobelFilter(
 	commandList->DrawInstanced(6, 1, 0, 0);
 }
 
-void ModelsApp::RenderSSAO(ComPtr<ID3D12GraphicsCommandList> commandList) {
-	// get RTV's
-	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvDescHandle(
-		m_RTVDescHeap->GetCPUDescriptorHandleForHeapStart(),
-		m_SSAO_RTV_StartIndex, m_RTVDescSize
-	);
-
-	D3D12_CPU_DESCRIPTOR_HANDLE normalMapRTV = rtvDescHandle;
-	D3D12_CPU_DESCRIPTOR_HANDLE occlusionMap0RTV = rtvDescHandle.Offset(m_RTVDescSize);
-	D3D12_CPU_DESCRIPTOR_HANDLE occlusionMap1RTV = rtvDescHandle.Offset(m_RTVDescSize);
-
-	// get SRV's
-	CD3DX12_GPU_DESCRIPTOR_HANDLE srvDescHandle(
+void ModelsApp::RenderSSAO(ComPtr<ID3D12GraphicsCommandList> commandList, D3D12_CPU_DESCRIPTOR_HANDLE rtv) {
+	// normal, depth and random maps SRV's
+	CD3DX12_GPU_DESCRIPTOR_HANDLE normalMapSRV(
 		m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
 		m_SSAO_SRV_StartIndex, m_CBV_SRV_UAVDescSize
-	);
-
-	D3D12_GPU_DESCRIPTOR_HANDLE normalMapSRV = srvDescHandle;
-	D3D12_GPU_DESCRIPTOR_HANDLE occlusionMap0SRV = srvDescHandle.Offset(3 * m_CBV_SRV_UAVDescSize);
-	D3D12_GPU_DESCRIPTOR_HANDLE occlusionMap1SRV = srvDescHandle.Offset(m_CBV_SRV_UAVDescSize);
-
-	// draw normal map
-	{
-		ComPtr<ID3D12PipelineState> pso = m_IsInverseDepth ? m_PSOs["ssaoNormInverseDepth"] : m_PSOs["ssaoNormStraightDepth"];
-
-		RenderGeometry(
-			commandList, pso, 
-			m_NormalMapBuffer.Get(), normalMapRTV, 
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-			m_NormalMapBufferClearValue
-		);
-	}
+	);
 
 	// draw occlusion map
 	{
-		CD3DX12_RESOURCE_BARRIER normalMapBarrir = CD3DX12_RESOURCE_BARRIER::Transition(
-			m_NormalMapBuffer.Get(),
-			D3D12_RESOURCE_STATE_RENDER_TARGET,
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-		);
-
-		CD3DX12_RESOURCE_BARRIER dsMapBarrier = CD3DX12_RESOURCE_BARRIER::Transition(
-			m_DSBuffer.Get(),
-			D3D12_RESOURCE_STATE_DEPTH_WRITE,
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-		);
-
-		CD3DX12_RESOURCE_BARRIER occlusionMap0Barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-			m_OcclusionMapBuffer0.Get(),
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-			D3D12_RESOURCE_STATE_RENDER_TARGET
-		);
-
-		CD3DX12_RESOURCE_BARRIER barriers[] = { normalMapBarrir, dsMapBarrier, occlusionMap0Barrier };
-		commandList->ResourceBarrier(_countof(barriers), barriers);
-
 		// unbind all resources from pipeline
 		commandList->ClearState(NULL);
 
@@ -562,13 +1315,9 @@ void ModelsApp::RenderSSAO(ComPtr<ID3D12GraphicsCommandList> commandList) {
 		commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
 		// set pass constants
-		commandList->SetGraphicsRootDescriptorTable(
+		commandList->SetGraphicsRootConstantBufferView(
 			2,
-			CD3DX12_GPU_DESCRIPTOR_HANDLE(
-				m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
-				m_PassConstantsViewsStartIndex + m_CurrentBackBufferIndex,
-				m_CBV_SRV_UAVDescSize
-			)
+			m_CurrentFrameResources->m_PassConstantsBuffer->Get()->GetGPUVirtualAddress()
 		);
 
 		// set normal, depth and random map as SRV
@@ -589,7 +1338,7 @@ void ModelsApp::RenderSSAO(ComPtr<ID3D12GraphicsCommandList> commandList) {
 		commandList->RSSetViewports(1, &curViewPort);
 
 		// set Output Mergere Stage
-		commandList->OMSetRenderTargets(1, &occlusionMap0RTV, FALSE, NULL);
+		commandList->OMSetRenderTargets(1, &rtv, FALSE, NULL);
 
 		// set Input Asembler Stage
 		commandList->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -597,67 +1346,32 @@ void ModelsApp::RenderSSAO(ComPtr<ID3D12GraphicsCommandList> commandList) {
 		// draw
 		commandList->DrawInstanced(6, 1, 0, 0);
 	}
-
-	// blur occlusion map
-	{
-		commandList->SetGraphicsRoot32BitConstant(3, m_BlurRadius, 0);
-		commandList->SetGraphicsRoot32BitConstants(3, 11, m_BlurWeights, 1);
-
-		for (int i = 0; i < 2; ++i) {
-			RenderBlur(commandList, m_OcclusionMapBuffer1, occlusionMap1RTV, m_OcclusionMapBuffer0, occlusionMap0SRV, false);
-			RenderBlur(commandList, m_OcclusionMapBuffer0, occlusionMap0RTV, m_OcclusionMapBuffer1, occlusionMap1SRV, true);
-		}
-	}
-
-	// return ds buffer in write state and occlusion map in sr state
-	{
-		CD3DX12_RESOURCE_BARRIER occlusionMap0Barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-			m_OcclusionMapBuffer0.Get(),
-			D3D12_RESOURCE_STATE_RENDER_TARGET,
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-		);
-
-		CD3DX12_RESOURCE_BARRIER dsMapBarrier = CD3DX12_RESOURCE_BARRIER::Transition(
-			m_DSBuffer.Get(),
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-			D3D12_RESOURCE_STATE_DEPTH_WRITE
-		);
-
-		CD3DX12_RESOURCE_BARRIER barriers[] = {
-			occlusionMap0Barrier,
-			dsMapBarrier,
-		};
-
-		commandList->ResourceBarrier(_countof(barriers), barriers);
-	}
 }
 
 void ModelsApp::RenderBlur(
 	ComPtr<ID3D12GraphicsCommandList> commandList,
-	ComPtr<ID3D12Resource> rtBuffer,
 	D3D12_CPU_DESCRIPTOR_HANDLE rtv,
-	ComPtr<ID3D12Resource> srBuffer,
 	D3D12_GPU_DESCRIPTOR_HANDLE srv,
 	bool isHorizontal)
 {
-	CD3DX12_RESOURCE_BARRIER occlusionMap1Barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-		rtBuffer.Get(),
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		D3D12_RESOURCE_STATE_RENDER_TARGET
-	);
+	// each blur is pass of frame graph, so it sets whole pipeline state
+	commandList->SetGraphicsRootSignature(m_RootSignatures["SSAO"].Get());
 
-	CD3DX12_RESOURCE_BARRIER occlusionMap0Barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-		srBuffer.Get(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-	);
+	ID3D12DescriptorHeap* descriptorHeaps[] = { m_CBV_SRVDescHeap.Get() };
+	commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
-	CD3DX12_RESOURCE_BARRIER barriers[] = {
-		occlusionMap0Barrier,
-		occlusionMap1Barrier
-	};
+	commandList->SetGraphicsRoot32BitConstant(3, m_BlurRadius, 0);
+	commandList->SetGraphicsRoot32BitConstants(3, 11, m_BlurWeights, 1);
+
+	D3D12_VIEWPORT curViewPort = m_ViewPort;
+	curViewPort.Width = m_OcclusionMapWidth;
+	curViewPort.Height = m_OcclusionMapHeight;
+
+	commandList->RSSetScissorRects(1, &m_ScissorRect);
+	commandList->RSSetViewports(1, &curViewPort);
+
+	commandList->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-	commandList->ResourceBarrier(_countof(barriers), barriers);
 	commandList->SetGraphicsRoot32BitConstant(3, isHorizontal, 12);
 	commandList->SetGraphicsRootDescriptorTable(1, srv);
 	commandList->SetPipelineState(m_PSOs["Blur"].Get());
@@ -669,13 +1383,8 @@ void ModelsApp::RenderShadowMaps(ComPtr<ID3D12GraphicsCommandList> commandList)
 	for (uint32_t i = 0; i < m_ShadowMaps.size(); ++i) {
 		auto shadowMap = m_ShadowMaps[i].get();
 
-		CD3DX12_RESOURCE_BARRIER rtBarrier = CD3DX12_RESOURCE_BARRIER::Transition(
-			shadowMap->GetResource(),
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-			D3D12_RESOURCE_STATE_DEPTH_WRITE
-		);
-
-		commandList->ResourceBarrier(1, &rtBarrier);
+		m_StateTracker.Transition(shadowMap->GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+		m_StateTracker.FlushBarriers(commandList.Get());
 
 		commandList->ClearDepthStencilView(
 			m_ShadowMaps[i]->GetDsv(),
@@ -689,44 +1398,53 @@ void ModelsApp::RenderShadowMaps(ComPtr<ID3D12GraphicsCommandList> commandList)
 		ID3D12DescriptorHeap* descriptorHeaps[] = { m_CBV_SRVDescHeap.Get() };
 		commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
-		commandList->SetGraphicsRootDescriptorTable(
+		commandList->SetGraphicsRootConstantBufferView(
 			1,
-			CD3DX12_GPU_DESCRIPTOR_HANDLE(
-				m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
-				m_PassConstantsViewsStartIndex + m_CurrentBackBufferIndex,
-				m_CBV_SRV_UAVDescSize
-			)
+			m_CurrentFrameResources->m_PassConstantsBuffer->Get()->GetGPUVirtualAddress()
 		);
 
 		commandList->SetGraphicsRoot32BitConstant(4, i, 0);
 
+		if (m_Bindless) {
+			SetBindlessResources(commandList, 5);
+		}
+
 		commandList->RSSetViewports(1, &shadowMap->GetViewPort());
 		commandList->RSSetScissorRects(1, &shadowMap->GetScissorRect());
 
 		commandList->OMSetRenderTargets(0, NULL, false, &shadowMap->GetDsv());
 
-		commandList->SetPipelineState(m_PSOs["shadowMaps"].Get());
+		// opaque items need only positions, alpha tested items need texture coordinates for clipping
+		commandList->SetPipelineState(m_PSOs["shadowMapsPositionOnly"].Get());
+		RenderRenderItems(commandList, m_RenderItemsLayers[static_cast<uint32_t>(RenderLayer::Opaque)]);
 
-		// draw render items
-		for (uint32_t i = 0; i < m_RenderItems.size(); ++i) {
-			RenderRenderItem(commandList, m_RenderItems[i].get());
-		}
+		commandList->SetPipelineState(m_PSOs["shadowMaps"].Get());
+		RenderRenderItems(commandList, m_RenderItemsLayers[static_cast<uint32_t>(RenderLayer::AlphaTested)]);
 
-		rtBarrier = CD3DX12_RESOURCE_BARRIER::Transition(
-			shadowMap->GetResource(),
-			D3D12_RESOURCE_STATE_DEPTH_WRITE,
-			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-		);
+		// map is read only by later passes, so its transition overlaps with rendering of next maps
+		m_StateTracker.BeginTransition(shadowMap->GetResource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
 
-		commandList->ResourceBarrier(1, &rtBarrier);
+	for (auto& shadowMap : m_ShadowMaps) {
+		m_StateTracker.Transition(shadowMap->GetResource(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 	}
+
+	m_StateTracker.FlushBarriers(commandList.Get());
 }
 
 void ModelsApp::OnResize() {
+	// resources of base app are recreated, so their states are tracked again
+	for (uint32_t i = 0; i < m_NumBackBuffers; ++i) {
+		m_ResourceStates.Remove(m_BackBuffers[i].Get());
+	}
+
+	m_ResourceStates.Remove(m_DSBuffer.Get());
+
 	BaseApp::OnResize();
+	TrackBaseResourcesStates();
 
-	UpdateSobelFrameTexture();
-	UpdateSSAOBuffersAndViews();
+	// transients of frame graph are recreated with new size by next frame
+	UpdateSSAOViews();
 }
 
 void ModelsApp::OnKeyPressed(WPARAM wParam) {
@@ -747,9 +1465,11 @@ void ModelsApp::OnKeyPressed(WPARAM wParam) {
 			m_DepthClearValue = 1.0f;
 		}
 
-		m_DirectCommandQueue->Flush();
+		// old depth buffer and views are released when frames in flight are finished
+		m_ResourceStates.Remove(m_DSBuffer.Get());
 		ResizeDSBuffer();
-		UpdateSSAOBuffersAndViews();
+		m_ResourceStates.SetState(m_DSBuffer.Get(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+		UpdateSSAOViews();
 		break;
 	case '3':
 		m_IsSobelFilter = !m_IsSobelFilter;
@@ -772,6 +1492,10 @@ void ModelsApp::OnKeyPressed(WPARAM wParam) {
 	case '6':
 		m_IsOnlySSAO = !m_IsOnlySSAO;
 		break;
+	case '7':
+		m_FramePacingMode = m_FramePacingMode == FramePacingMode::Throughput ? FramePacingMode::Latency : FramePacingMode::Throughput;
+		m_FramePacer->SetMode(m_FramePacingMode);
+		break;
 	case 'W':
 	case 'S':
 	case 'A':
@@ -779,7 +1503,11 @@ void ModelsApp::OnKeyPressed(WPARAM wParam) {
 		m_Camera.MoveCamera(wParam);
 		break;
 	case 'R':
-		m_DirectCommandQueue->Flush();
+		// frames in flight keep old PSOs until they are finished
+		m_DeferredReleaseQueue->Push(m_DirectCommandQueue->Signal(), [psos = m_PSOs]() mutable {
+			psos.clear();
+		});
+
 		BuildPipelineStateObject();
 		BuildSobelPipelineStateObject();
 		BuildSSAOPipelineStateObject();
@@ -942,104 +1670,768 @@ void ModelsApp::BuildLights() {
 	}
 }
 
-void ModelsApp::BuildTextures(ComPtr<ID3D12GraphicsCommandList> commandList) {
-	for (uint32_t i = 0; i < m_Scene->mNumMaterials; ++i) {
-		aiString textureRelPath;
-		m_Scene->mMaterials[i]->GetTexture(aiTextureType_DIFFUSE, 0, &textureRelPath);
+void ModelsApp::BuildTextures(ComPtr<ID3D12GraphicsCommandList> commandList) {
+	// placeholder for materials without texture and for textures which are not streamed yet
+	{
+		auto tex = std::make_unique<Texture>();
+		tex->Name = "default";
+
+		DecodedTexture decoded = CreateSolidColorTexture(m_Device, 255, 255, 255, 255, true);
+		tex->Resource = decoded.Resource;
+		RecordTextureUpload(m_Device, commandList, decoded, tex->UploadResource);
+
+		tex->ResidencyId = m_ResidencyManager->Register(
+			ResidencyCategory::Textures,
+			GetResourceAllocationSize(m_Device, tex->Resource.Get()),
+			false,
+			m_FrameIndex
+		);
+
+		m_Textures[tex->Name] = std::move(tex);
+	}
+
+	for (uint32_t i = 0; i < m_Scene->mNumMaterials; ++i) {
+		aiString textureRelPath;
+		m_Scene->mMaterials[i]->GetTexture(aiTextureType_DIFFUSE, 0, &textureRelPath);
+
+		if (textureRelPath.length == 0) {
+			continue;
+		}
+
+		// alpha tested textures keep coverage in mips
+		aiString alphaMode("OPAQUE");
+		m_Scene->mMaterials[i]->Get(AI_MATKEY_GLTF_ALPHAMODE, alphaMode);
+
+		float alphaCoverageReference = std::string(alphaMode.C_Str()) == "MASK" ? 0.1f : 0.0f;
+
+		// materials can share texture
+		std::string textureName = textureRelPath.C_Str();
+
+		auto loadedIt = m_StreamedTexturesIds.find(textureName);
+
+		if (loadedIt != m_StreamedTexturesIds.end()) {
+			MipGenerationDesc& mipDesc = m_StreamedMipsDescs[loadedIt->second];
+			mipDesc.AlphaCoverageReference = (std::max)(mipDesc.AlphaCoverageReference, alphaCoverageReference);
+			continue;
+		}
+
+		std::filesystem::path textureAbsPath = m_SceneFolder;
+		textureAbsPath += textureRelPath.C_Str();
+
+		auto tex = std::make_unique<Texture>();
+
+		tex->Name = textureName;
+		tex->FileName = textureAbsPath;
+
+		m_StreamedTexturesIds[textureName] = static_cast<uint32_t>(m_StreamedTextures.size());
+		m_StreamedTextures.push_back(tex.get());
+		m_Textures[textureName] = std::move(tex);
+
+		// diffuse textures are in sRGB
+		MipGenerationDesc mipDesc;
+		mipDesc.Filter = MipFilter::Kaiser;
+		mipDesc.IsSRGB = true;
+		mipDesc.AlphaCoverageReference = alphaCoverageReference;
+
+		m_StreamedMipsDescs.push_back(mipDesc);
+	}
+
+	// textures views are kept in CPU only heap and copied to shader visible one each frame
+	// default texture, each streamed texture and each group of packed textures take one view at most
+	m_TexturesViewsAllocator = std::make_unique<DescriptorAllocator>(
+		m_Device,
+		D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+		1 + m_StreamedTextures.size(),
+		false
+	);
+	m_Textures["default"]->SRVStagingIndex = m_TexturesViewsAllocator->Allocate(1).Index;
+	m_TexturesViewsRemap = BindlessRemap(m_TexturesViewsAllocator->GetIndexAllocator().GetNumDescriptors());
+
+	// files are read, decoded and mipmapped on workers, uploads are recorded in OnUpdate
+	// WIC needs COM initialized on each worker
+	m_TexturesLoadPool = std::make_unique<ThreadPool>(
+		0,
+		[]() { ::CoInitializeEx(NULL, COINIT_MULTITHREADED); },
+		[]() { ::CoUninitialize(); }
+	);
+
+	auto load = [this](uint32_t id, const std::atomic<bool>& isCanceled) {
+		const Texture& texture = *m_StreamedTextures[id];
+		DecodedTexture decoded;
+
+		if (m_BakeTextures && m_GenerateMips) {
+			decoded = LoadBakedTexture(texture, m_StreamedMipsDescs[id], *m_TexturesLoadPool);
+		}
+		else {
+			std::vector<uint8_t> fileData = ReadSceneFile(texture.FileName, m_TexturesLoadPool.get());
+			decoded = DecodeWICTextureFromMemory(
+				m_Device,
+				fileData.data(), fileData.size(),
+				m_GenerateMips ? &m_StreamedMipsDescs[id] : nullptr
+			);
+		}
+
+		// canceled texture is not registered, so its aliases don`t wait for it
+		if (isCanceled) {
+			return DecodedTexture();
+		}
+
+		// alias of already loaded content is dropped before upload
+		TextureContentKey key = ComputeTextureContentKey(decoded);
+
+		if (m_TextureRegistry.Register(texture.Name, key, GetTextureDataSize(decoded)) != texture.Name) {
+			decoded = DecodedTexture();
+		}
+
+		// resource with only needed mips is created on upload, packed textures are copied to resources of their groups
+		if (m_StreamMips || m_PackTextures) {
+			decoded.Resource = nullptr;
+		}
+
+		return decoded;
+	};
+
+	if (m_PackTextures) {
+		PackTextures(commandList, load);
+		return;
+	}
+
+	m_MipBudgetSolver = std::make_unique<MipBudgetSolver>(m_StreamedTextures.size(), m_TexturesMemoryBudget, m_MipsHysteresis);
+	m_UnitRequiredMips.assign(m_StreamedTextures.size(), FLT_MAX);
+
+	// decoded textures waiting for upload are limited by number of concurrent loads to bound memory
+	m_TextureStreamer = std::make_unique<TextureStreamer<DecodedTexture>>(
+		*m_TexturesLoadPool,
+		static_cast<uint32_t>(m_StreamedTextures.size()),
+		m_TexturesLoadPool->GetNumThreads(),
+		load
+	);
+}
+
+uint32_t ModelsApp::FindInAssetPackage(const std::filesystem::path& fileName) const {
+	if (!m_AssetPackage) {
+		return AssetPackage::InvalidIndex;
+	}
+
+	std::filesystem::path folder = std::filesystem::absolute(m_SceneFolder).lexically_normal();
+	std::filesystem::path path = std::filesystem::absolute(fileName).lexically_normal();
+
+	return m_AssetPackage->Find(path.lexically_relative(folder).generic_string());
+}
+
+std::vector<uint8_t> ModelsApp::ReadSceneFile(const std::filesystem::path& fileName, ThreadPool* pool) const {
+	uint32_t index = FindInAssetPackage(fileName);
+
+	if (index == AssetPackage::InvalidIndex) {
+		return ReadFileData(fileName);
+	}
+
+	return m_AssetPackage->ReadFile(index, pool);
+}
+
+std::filesystem::file_time_type ModelsApp::GetSceneFileTime(const std::filesystem::path& fileName) const {
+	// packed file is as old as package
+	if (FindInAssetPackage(fileName) != AssetPackage::InvalidIndex) {
+		return m_AssetPackageTime;
+	}
+
+	return std::filesystem::last_write_time(fileName);
+}
+
+DecodedTexture ModelsApp::LoadBakedTexture(const Texture& texture, const MipGenerationDesc& mipDesc, ThreadPool& pool) {
+	std::filesystem::path bakedFileName = m_SceneFolder;
+	bakedFileName += "baked/";
+	bakedFileName += texture.Name;
+	bakedFileName += m_BakeHighQuality ? ".bc7.dds" : ".bc.dds";
+
+	// baked file is valid while it is newer than source texture
+	std::error_code error;
+	auto bakedTime = std::filesystem::last_write_time(bakedFileName, error);
+
+	if (!error && bakedTime >= GetSceneFileTime(texture.FileName)) {
+		return DecodeDDSTextureFromMappedFile(m_Device, bakedFileName);
+	}
+
+	std::vector<uint8_t> fileData = ReadSceneFile(texture.FileName, &pool);
+	DecodedTexture decoded = DecodeWICTextureFromMemory(m_Device, fileData.data(), fileData.size(), &mipDesc);
+
+	// block compressed texture size should be multiple of block size
+	const MipLevel& topLevel = decoded.Mips.Levels[0];
+
+	if (topLevel.Width % 4 != 0 || topLevel.Height % 4 != 0) {
+		return decoded;
+	}
+
+	BlockFormat format = BlockFormat::BC7;
+
+	if (!m_BakeHighQuality) {
+		bool hasAlpha = false;
+
+		for (size_t i = 3; i < static_cast<size_t>(topLevel.Width) * topLevel.Height * 4 && !hasAlpha; i += 4) {
+			hasAlpha = decoded.Mips.Data[i] != 255;
+		}
+
+		format = hasAlpha ? BlockFormat::BC3 : BlockFormat::BC1;
+	}
+
+	// blocks are encoded on the same pool, calling worker takes part in encoding
+	CompressedMipChain compressed = CompressMipChain(decoded.Mips, format, &pool);
+
+	const char* formatNames[] = { "BC1", "BC3", "BC5", "BC7" };
+
+	char buffer[500];
+	::sprintf_s(buffer, 500, "textures: %s baked to %s, PSNR %.2f dB\n",
+		texture.Name.c_str(), formatNames[static_cast<uint32_t>(format)],
+		ComputeCompressionPSNR(decoded.Mips, compressed)
+	);
+	::OutputDebugString(buffer);
+
+	std::filesystem::create_directories(bakedFileName.parent_path(), error);
+	WriteFileData(bakedFileName, BuildDDSFile(compressed));
+
+	// baked file is loaded the same way as cached one
+	return DecodeDDSTextureFromMappedFile(m_Device, bakedFileName);
+}
+
+void ModelsApp::PackTextures(ComPtr<ID3D12GraphicsCommandList> commandList, const TextureStreamer<DecodedTexture>::LoadFunction& load) {
+	// textures are loaded on workers, loads of baked textures spread over them too
+	std::vector<DecodedTexture> decoded(m_StreamedTextures.size());
+	std::atomic<bool> isCanceled(false);
+
+	m_TexturesLoadPool->ParallelFor(static_cast<uint32_t>(decoded.size()), [&](uint32_t id) {
+		decoded[id] = load(id, isCanceled);
+	});
+
+	// aliases have nothing to pack, they take placement of texture with same content
+	std::vector<uint32_t> packedIds;
+	std::vector<TexturePackingItem> items;
+
+	for (uint32_t id = 0; id < decoded.size(); ++id) {
+		if (decoded[id].Subresources.empty()) {
+			continue;
+		}
+
+		const D3D12_RESOURCE_DESC& desc = decoded[id].Desc;
+
+		TexturePackingItem item;
+		item.Width = static_cast<uint32_t>(desc.Width);
+		item.Height = desc.Height;
+		item.Format = static_cast<uint32_t>(desc.Format);
+		item.MipLevels = desc.MipLevels;
+		item.BlockSize = IsBlockCompressedFormat(desc.Format) ? 4 : 1;
+
+		packedIds.push_back(id);
+		items.push_back(item);
+	}
+
+	TexturePackingPlan plan = PlanTexturePacking(items, m_TexturePackingDesc);
+
+	// bytes of texel or format block, taken from top mip of any item of group
+	std::vector<uint32_t> elementSizes(plan.Groups.size(), 0);
+
+	for (uint32_t i = 0; i < items.size(); ++i) {
+		uint32_t numElements = (items[i].Width + items[i].BlockSize - 1) / items[i].BlockSize;
+		elementSizes[plan.Placements[i].Group] = static_cast<uint32_t>(decoded[packedIds[i]].Subresources[0].RowPitch / numElements);
+	}
+
+	std::vector<DecodedTexture> groupsTextures(plan.Groups.size());
+	uint32_t numAtlases = 0;
+
+	for (uint32_t i = 0; i < plan.Groups.size(); ++i) {
+		const TextureGroup& group = plan.Groups[i];
+		DecodedTexture& groupTexture = groupsTextures[i];
+
+		groupTexture.Desc = CD3DX12_RESOURCE_DESC::Tex2D(
+			static_cast<DXGI_FORMAT>(group.Format),
+			group.Width, group.Height,
+			static_cast<UINT16>(group.ArraySize),
+			static_cast<UINT16>(group.MipLevels)
+		);
+
+		ThrowIfFailed(m_Device->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+			D3D12_HEAP_FLAG_NONE,
+			&groupTexture.Desc,
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			nullptr,
+			IID_PPV_ARGS(&groupTexture.Resource)
+		));
+
+		groupTexture.Subresources.resize(group.ArraySize * group.MipLevels);
+
+		// array slices are uploaded from decoded textures, atlas pages are composed on CPU
+		if (group.Type != TextureGroupType::Atlas) {
+			continue;
+		}
+
+		++numAtlases;
+
+		// sides of atlas mips are multiples of block, space out of items and gutters stays zero
+		size_t dataSize = 0;
+
+		for (uint32_t mip = 0; mip < group.MipLevels; ++mip) {
+			size_t rowPitch = static_cast<size_t>((group.Width >> mip) / group.BlockSize) * elementSizes[i];
+			dataSize += rowPitch * ((group.Height >> mip) / group.BlockSize) * group.ArraySize;
+		}
+
+		groupTexture.Data = std::make_unique<uint8_t[]>(dataSize);
+
+		uint8_t* data = groupTexture.Data.get();
+
+		for (uint32_t page = 0; page < group.ArraySize; ++page) {
+			for (uint32_t mip = 0; mip < group.MipLevels; ++mip) {
+				D3D12_SUBRESOURCE_DATA& subresource = groupTexture.Subresources[page * group.MipLevels + mip];
+
+				subresource.pData = data;
+				subresource.RowPitch = static_cast<LONG_PTR>((group.Width >> mip) / group.BlockSize) * elementSizes[i];
+				subresource.SlicePitch = subresource.RowPitch * ((group.Height >> mip) / group.BlockSize);
+
+				data += subresource.SlicePitch;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < items.size(); ++i) {
+		const TexturePlacement& placement = plan.Placements[i];
+		const TextureGroup& group = plan.Groups[placement.Group];
+		DecodedTexture& groupTexture = groupsTextures[placement.Group];
+		const DecodedTexture& source = decoded[packedIds[i]];
+
+		for (uint32_t mip = 0; mip < group.MipLevels; ++mip) {
+			D3D12_SUBRESOURCE_DATA& subresource = groupTexture.Subresources[placement.ArrayIndex * group.MipLevels + mip];
+
+			if (group.Type == TextureGroupType::Array) {
+				subresource = source.Subresources[mip];
+				continue;
+			}
+
+			CopyTextureToAtlasMip(
+				group, placement, mip,
+				static_cast<const uint8_t*>(source.Subresources[mip].pData), source.Subresources[mip].RowPitch,
+				static_cast<uint8_t*>(const_cast<void*>(subresource.pData)), subresource.RowPitch,
+				elementSizes[placement.Group]
+			);
+		}
+	}
+
+	// data is copied to upload buffers while recording, so decoded textures can be released after it
+	for (uint32_t i = 0; i < plan.Groups.size(); ++i) {
+		auto tex = std::make_unique<Texture>();
+		Texture* group = tex.get();
+
+		tex->Name = "textureGroup" + std::to_string(i);
+		tex->Resource = groupsTextures[i].Resource;
+		// group takes staging view which would be taken by one of its textures
+		tex->SRVStagingIndex = m_TexturesViewsAllocator->Allocate(1).Index;
+
+		RecordTextureUpload(m_Device, commandList, groupsTextures[i], tex->UploadResource);
+
+		tex->ResidencyId = m_ResidencyManager->Register(
+			ResidencyCategory::Textures,
+			GetResourceAllocationSize(m_Device, tex->Resource.Get()),
+			true,
+			m_FrameIndex,
+			[this, group]() { EvictResources(m_Device, { group->Resource.Get() }); },
+			[this, group]() { MakeResourcesResident(m_Device, { group->Resource.Get() }); }
+		);
+
+		m_TexturesGroups.push_back(group);
+		m_Textures[tex->Name] = std::move(tex);
+	}
+
+	for (uint32_t i = 0; i < items.size(); ++i) {
+		const TexturePlacement& placement = plan.Placements[i];
+		Texture* tex = m_StreamedTextures[packedIds[i]];
+		const Texture* group = m_TexturesGroups[placement.Group];
+
+		tex->SRVStagingIndex = group->SRVStagingIndex;
+		tex->ResidencyId = group->ResidencyId;
+		tex->ArrayIndex = placement.ArrayIndex;
+		tex->UVTransform = XMFLOAT4(placement.UVScale[0], placement.UVScale[1], placement.UVOffset[0], placement.UVOffset[1]);
+	}
+
+	for (uint32_t id = 0; id < decoded.size(); ++id) {
+		if (!decoded[id].Subresources.empty()) {
+			continue;
+		}
+
+		Texture* alias = m_StreamedTextures[id];
+		const Texture* canonical = m_Textures[m_TextureRegistry.Resolve(alias->Name)].get();
+
+		alias->SRVStagingIndex = canonical->SRVStagingIndex;
+		alias->ResidencyId = canonical->ResidencyId;
+		alias->ArrayIndex = canonical->ArrayIndex;
+		alias->UVTransform = canonical->UVTransform;
+	}
+
+	char buffer[500];
+	::sprintf_s(buffer, 500, "textures: %u packed into %u arrays and %u atlases, %.1f%% of their area used\n",
+		static_cast<uint32_t>(items.size()),
+		static_cast<uint32_t>(plan.Groups.size()) - numAtlases, numAtlases,
+		100.0 * static_cast<double>(plan.ItemsArea) / static_cast<double>((std::max)(plan.GroupsArea, uint64_t(1)))
+	);
+	::OutputDebugString(buffer);
+}
+
+void ModelsApp::BuildGeometry(ComPtr<ID3D12GraphicsCommandList> commandList) {
+	// all meshes are packed in one shared vertex buffer and two shared index buffers (16 and 32 bit)
+	GeometryPacker packer;
+
+	uint32_t totalNumVertexes = 0;
+	uint32_t totalNumIndexes[static_cast<uint32_t>(IndexPool::Count)] = {};
+
+	auto makeVertex = [](aiMesh* mesh, uint32_t j) {
+		aiVector3D vertexPos = mesh->mVertices[j];
+		aiVector3D vertexTexC = mesh->mTextureCoords[0][j];
+		aiVector3D vertexNorm = mesh->mNormals[j];
+
+		return Vertex{
+			XMFLOAT3(vertexPos.x, vertexPos.y, vertexPos.z),
+			XMFLOAT3(vertexNorm.x, vertexNorm.y, vertexNorm.z),
+			XMFLOAT2(vertexTexC.x, vertexTexC.y)
+		};
+	};
+
+	// duplicated vertexes are welded, welded indexes are kept for packing
+	std::vector<std::vector<uint32_t>> meshesVertexes(m_Scene->mNumMeshes);
+	std::vector<std::vector<uint32_t>> meshesIndexes(m_Scene->mNumMeshes);
+
+	// meshes too large for 16 bit indexes are split in chunks if allowed
+	std::vector<std::vector<MeshChunk>> meshesChunks(m_Scene->mNumMeshes);
+	uint32_t numSplitMeshes = 0;
+	uint32_t numChunks = 0;
+	uint32_t numWeldedVertexes = 0;
+
+	for (uint32_t i = 0; i < m_Scene->mNumMeshes; ++i) {
+		aiMesh* mesh = m_Scene->mMeshes[i];
+		std::vector<uint32_t>& meshVertexes = meshesVertexes[i];
+		std::vector<uint32_t>& meshIndexes = meshesIndexes[i];
+
+		meshIndexes.reserve(mesh->mNumFaces * 3);
+
+		for (uint32_t j = 0; j < mesh->mNumFaces; ++j) {
+			aiFace face = mesh->mFaces[j];
+
+			assert(face.mNumIndices == 3 && "Faces not traingles!");
+
+			meshIndexes.insert(meshIndexes.end(), face.mIndices, face.mIndices + face.mNumIndices);
+		}
+
+		// texture coordinates density for mip streaming
+		float uvDensity = 0.0f;
+
+		if (mesh->HasTextureCoords(0)) {
+			uvDensity = ComputeMeshUVDensity(
+				&mesh->mVertices[0].x, 3,
+				&mesh->mTextureCoords[0][0].x, 3,
+				meshIndexes.data(), meshIndexes.size()
+			);
+		}
+
+		m_MeshesUVDensities[mesh->mName.C_Str()] = uvDensity;
+
+		if (m_WeldVertexes) {
+			std::vector<Vertex> sourceVertexes(mesh->mNumVertices);
+
+			for (uint32_t j = 0; j < mesh->mNumVertices; ++j) {
+				sourceVertexes[j] = makeVertex(mesh, j);
+			}
+
+			VertexStreamDesc stream;
+			stream.Data = sourceVertexes.data();
+			stream.ByteStride = sizeof(Vertex);
+			stream.PositionOffset = offsetof(Vertex, Position);
+			stream.NormOffset = offsetof(Vertex, Norm);
+			stream.TexCOffset = offsetof(Vertex, TexC);
+
+			WeldResult weld = WeldVertexes(stream, mesh->mNumVertices, m_WeldEpsilons);
+			RemapIndexes(meshIndexes.data(), meshIndexes.size(), weld.Remap);
+			meshVertexes = std::move(weld.Vertexes);
+
+			// log memory saved by welding
+			uint32_t numWelded = mesh->mNumVertices - meshVertexes.size();
+			numWeldedVertexes += numWelded;
+
+			if (numWelded > 0) {
+				char buffer[500];
+				::sprintf_s(
+					buffer, 500, "welding: mesh %s %u -> %u vertexes, %u bytes saved\n",
+					mesh->mName.C_Str(), mesh->mNumVertices, static_cast<uint32_t>(meshVertexes.size()),
+					static_cast<uint32_t>(numWelded * sizeof(Vertex))
+				);
+				::OutputDebugString(buffer);
+			}
+		} else {
+			meshVertexes.resize(mesh->mNumVertices);
+
+			for (uint32_t j = 0; j < mesh->mNumVertices; ++j) {
+				meshVertexes[j] = j;
+			}
+		}
+
+		uint32_t numVertexes = meshVertexes.size();
+		IndexPool pool = GeometryPacker::ChoosePool(numVertexes);
+
+		if (m_SplitLargeMeshes && pool == IndexPool::Index32) {
+			meshesChunks[i] = SplitMesh(meshIndexes.data(), meshIndexes.size(), numVertexes, GeometryPacker::MaxIndex16Vertexes);
+
+			for (auto& chunk : meshesChunks[i]) {
+				totalNumVertexes += chunk.Vertexes.size();
+				totalNumIndexes[static_cast<uint32_t>(IndexPool::Index16)] += chunk.Indexes.size() + 1;
+			}
+
+			++numSplitMeshes;
+			numChunks += meshesChunks[i].size();
 
-		if (textureRelPath.length == 0) {
 			continue;
 		}
 
-		std::filesystem::path textureAbsPath = m_SceneFolder;
-		textureAbsPath += textureRelPath.C_Str();
+		// one extra index per mesh for alignment padding
+		totalNumVertexes += numVertexes;
+		totalNumIndexes[static_cast<uint32_t>(pool)] += meshIndexes.size() + 1;
+	}
 
-		auto tex = std::make_unique<Texture>();
+	packer.Reserve(
+		totalNumVertexes,
+		totalNumIndexes[static_cast<uint32_t>(IndexPool::Index16)],
+		totalNumIndexes[static_cast<uint32_t>(IndexPool::Index32)]
+	);
 
-		tex->Name = textureRelPath.C_Str();
-		tex->FileName = textureAbsPath;
+	std::vector<Vertex> vertexes;
+	std::vector<uint16_t> indexes16;
+	std::vector<uint32_t> indexes32;
 
-		CreateWICTextureFromFile(
-			m_Device,
-			commandList,
-			tex->FileName,
-			tex->Resource,
-			tex->UploadResource
-		);
+	vertexes.reserve(packer.GetVertexCapacity());
+	indexes16.reserve(packer.GetIndexCapacity(IndexPool::Index16));
+	indexes32.reserve(packer.GetIndexCapacity(IndexPool::Index32));
 
-		m_Textures[tex->Name] = std::move(tex);
-	}
-}
+	std::vector<std::pair<std::string, PackedMesh>> packedMeshes;
+	packedMeshes.reserve(m_Scene->mNumMeshes);
 
-void ModelsApp::BuildGeometry(ComPtr<ID3D12GraphicsCommandList> commandList) {
 	for (uint32_t i = 0; i < m_Scene->mNumMeshes; ++i) {
-		auto geo = std::make_unique<MeshGeometry>();
 		aiMesh* mesh = m_Scene->mMeshes[i];
+		std::string meshName = mesh->mName.C_Str();
+		const std::vector<uint32_t>& meshVertexes = meshesVertexes[i];
+		const std::vector<uint32_t>& meshIndexes = meshesIndexes[i];
+
+		// each chunk of split mesh is separate packed mesh with own draw args
+		if (!meshesChunks[i].empty()) {
+			for (uint32_t k = 0; k < meshesChunks[i].size(); ++k) {
+				const MeshChunk& chunk = meshesChunks[i][k];
+				std::string chunkName = meshName + "#" + std::to_string(k);
+
+				PackedMesh packed = packer.AddMesh(chunk.Vertexes.size(), chunk.Indexes.size(), IndexPool::Index16);
 
-		uint32_t numVertexes = mesh->mNumVertices;
-		std::vector<Vertex> vertexes;
-		vertexes.reserve(numVertexes);
+				vertexes.resize(packed.BaseVertexLocation);
 
-		for (uint32_t j = 0; j < numVertexes; ++j) {
-			aiVector3D vertexPos = mesh->mVertices[j];
-			aiVector3D vertexTexC = mesh->mTextureCoords[0][j];
-			aiVector3D vertexNorm = mesh->mNormals[j];
+				for (uint32_t vertex : chunk.Vertexes) {
+					vertexes.push_back(makeVertex(mesh, meshVertexes[vertex]));
+				}
+
+				indexes16.resize(packed.StartIndexLocation);
+				indexes16.insert(indexes16.end(), chunk.Indexes.begin(), chunk.Indexes.end());
+
+				packedMeshes.emplace_back(chunkName, packed);
+				m_MeshesParts[meshName].push_back(chunkName);
+			}
 
-			vertexes.push_back({
-				XMFLOAT3(vertexPos.x, vertexPos.y, vertexPos.z),
-				XMFLOAT3(vertexNorm.x, vertexNorm.y, vertexNorm.z),
-				XMFLOAT2(vertexTexC.x, vertexTexC.y)
-				});
+			// chunks are not needed anymore
+			meshesChunks[i] = {};
+
+			continue;
 		}
 
-		uint32_t numIndexes = mesh->mNumFaces * 3;
-		std::vector<uint16_t> indexes;
-		indexes.reserve(numIndexes);
+		uint32_t numVertexes = meshVertexes.size();
+		uint32_t numIndexes = meshIndexes.size();
 
-		for (uint32_t j = 0; j < mesh->mNumFaces; ++j) {
-			aiFace face = mesh->mFaces[j];
+		PackedMesh packed = packer.AddMesh(numVertexes, numIndexes);
 
-			assert(face.mNumIndices == 3 && "Faces not traingles!");
+		// vertexes
+		vertexes.resize(packed.BaseVertexLocation);
+
+		for (uint32_t vertex : meshVertexes) {
+			vertexes.push_back(makeVertex(mesh, vertex));
+		}
+
+		// indexes are local for mesh, BaseVertexLocation is added while drawing
+		if (packed.Pool == IndexPool::Index16) {
+			indexes16.resize(packed.StartIndexLocation);
 
-			for (uint32_t k = 0; k < face.mNumIndices; ++k) {
-				indexes.push_back(face.mIndices[k]);
+			for (uint32_t index : meshIndexes) {
+				indexes16.push_back(static_cast<uint16_t>(index));
 			}
+		} else {
+			indexes32.resize(packed.StartIndexLocation);
+			indexes32.insert(indexes32.end(), meshIndexes.begin(), meshIndexes.end());
 		}
 
-		uint32_t vbByteSize = sizeof(Vertex) * vertexes.size();
-		uint32_t ibByteSize = sizeof(uint16_t) * indexes.size();
+		packedMeshes.emplace_back(meshName, packed);
+		m_MeshesParts[meshName].push_back(meshName);
+	}
 
-		geo->VertexBufferGPU = CreateGPUResourceAndLoadData(
-			m_Device,
-			commandList,
-			geo->VertexBufferUploader,
-			vertexes.data(),
-			vbByteSize
-		);
+	// one position buffer and one attributes buffer for all meshes
+	ComPtr<ID3D12Resource> positionBufferGPU;
+	ComPtr<ID3D12Resource> positionBufferUploader;
+	ComPtr<ID3D12Resource> vertexBufferGPU;
+	ComPtr<ID3D12Resource> vertexBufferUploader;
+	const void* vbData = vertexes.data();
+	uint32_t vbByteStride = sizeof(Vertex);
+	uint32_t positionOffset = offsetof(Vertex, Position);
+	uint32_t positionByteStride = sizeof(Vertex::Position);
+
+	// each mesh is quantized relative to its own bounding box
+	std::vector<CompactVertex> compactVertexes;
+
+	if (m_UseCompactVertexes) {
+		compactVertexes.resize(vertexes.size());
+
+		for (auto& it : packedMeshes) {
+			VertexStreamDesc stream;
+			stream.Data = vertexes.data() + it.second.BaseVertexLocation;
+			stream.ByteStride = sizeof(Vertex);
+			stream.PositionOffset = offsetof(Vertex, Position);
+			stream.NormOffset = offsetof(Vertex, Norm);
+			stream.TexCOffset = offsetof(Vertex, TexC);
+
+			PositionDequantization dequantization = ComputePositionDequantization(stream, it.second.VertexCount);
+
+			EncodeCompactVertexes(
+				stream,
+				it.second.VertexCount,
+				dequantization,
+				compactVertexes.data() + it.second.BaseVertexLocation
+			);
+
+			m_MeshesDequantizations[it.first] = dequantization;
+		}
+
+		vbData = compactVertexes.data();
+		vbByteStride = sizeof(CompactVertex);
+		positionOffset = offsetof(CompactVertex, Position);
+		positionByteStride = sizeof(CompactVertex::Position);
+	}
+
+	// positions are split in separate stream, so depth only passes fetch only them
+	uint32_t attributesByteStride = vbByteStride - positionByteStride;
+	std::vector<uint8_t> positions(positionByteStride * vertexes.size());
+	std::vector<uint8_t> attributes(attributesByteStride * vertexes.size());
+
+	SplitVertexStreams(
+		vbData,
+		vertexes.size(),
+		vbByteStride,
+		positionOffset,
+		positionByteStride,
+		positions.data(),
+		attributes.data()
+	);
+
+	uint32_t pbByteSize = positions.size();
+	uint32_t vbByteSize = attributes.size();
+
+	positionBufferGPU = CreateGPUResourceAndLoadData(
+		m_Device,
+		commandList,
+		positionBufferUploader,
+		positions.data(),
+		pbByteSize
+	);
+
+	vertexBufferGPU = CreateGPUResourceAndLoadData(
+		m_Device,
+		commandList,
+		vertexBufferUploader,
+		attributes.data(),
+		vbByteSize
+	);
+
+	m_VertexBuffersResidencyId = m_ResidencyManager->Register(
+		ResidencyCategory::Meshes,
+		GetResourceAllocationSize(m_Device, positionBufferGPU.Get()) + GetResourceAllocationSize(m_Device, vertexBufferGPU.Get()),
+		true,
+		m_FrameIndex,
+		[this, positionBufferGPU, vertexBufferGPU]() { EvictResources(m_Device, { positionBufferGPU.Get(), vertexBufferGPU.Get() }); },
+		[this, positionBufferGPU, vertexBufferGPU]() { MakeResourcesResident(m_Device, { positionBufferGPU.Get(), vertexBufferGPU.Get() }); }
+	);
+
+	// one geometry for each index pool, all geometries share vertex buffer
+	auto buildPoolGeometry = [&](IndexPool pool, const std::string& name, const void* indexesData, uint32_t numIndexes) {
+		if (numIndexes == 0) {
+			return;
+		}
+
+		auto geo = std::make_unique<MeshGeometry>();
+		uint32_t ibByteSize = GeometryPacker::GetIndexByteStride(pool) * numIndexes;
 
 		geo->IndexBufferGPU = CreateGPUResourceAndLoadData(
 			m_Device,
 			commandList,
 			geo->IndexBufferUploader,
-			indexes.data(),
+			indexesData,
 			ibByteSize
 		);
 
-		geo->name = mesh->mName.C_Str();
+		geo->name = name;
+		geo->PositionBufferGPU = positionBufferGPU;
+		geo->PositionBufferUploader = positionBufferUploader;
+		geo->PositionBufferByteSize = pbByteSize;
+		geo->PositionByteStride = positionByteStride;
+		geo->VertexBufferGPU = vertexBufferGPU;
+		geo->VertexBufferUploader = vertexBufferUploader;
 		geo->VertexBufferByteSize = vbByteSize;
-		geo->VertexByteStride = sizeof(Vertex);
+		geo->VertexByteStride = attributesByteStride;
 		geo->IndexBufferByteSize = ibByteSize;
-		geo->IndexBufferFormat = DXGI_FORMAT_R16_UINT;
+		geo->IndexBufferFormat = pool == IndexPool::Index16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+		ComPtr<ID3D12Resource> indexBufferGPU = geo->IndexBufferGPU;
+
+		m_GeometriesResidencyIds[name] = m_ResidencyManager->Register(
+			ResidencyCategory::Meshes,
+			GetResourceAllocationSize(m_Device, indexBufferGPU.Get()),
+			true,
+			m_FrameIndex,
+			[this, indexBufferGPU]() { EvictResources(m_Device, { indexBufferGPU.Get() }); },
+			[this, indexBufferGPU]() { MakeResourcesResident(m_Device, { indexBufferGPU.Get() }); }
+		);
 
-		SubmeshGeometry submesh;
-		submesh.IndexCount = numIndexes;
-		submesh.BaseVertexLocation = 0;
-		submesh.StartIndexLocation = 0;
+		for (auto& it : packedMeshes) {
+			if (it.second.Pool != pool) {
+				continue;
+			}
+
+			SubmeshGeometry submesh;
+			submesh.IndexCount = it.second.IndexCount;
+			submesh.StartIndexLocation = it.second.StartIndexLocation;
+			submesh.BaseVertexLocation = it.second.BaseVertexLocation;
 
-		geo->DrawArgs[mesh->mName.C_Str()] = submesh;
+			geo->DrawArgs[it.first] = submesh;
+			m_MeshesGeometries[it.first] = geo.get();
+		}
 
 		m_Geometries[geo->name] = std::move(geo);
-	}
+	};
+
+	buildPoolGeometry(IndexPool::Index16, "sceneIndex16", indexes16.data(), indexes16.size());
+	buildPoolGeometry(IndexPool::Index32, "sceneIndex32", indexes32.data(), indexes32.size());
+
+	// log geometry memory footprint
+	char buffer[500];
+	::sprintf_s(
+		buffer, 500,
+		"geometry: %u vertexes, positions %u KiB, attributes %u KiB, 16 bit indexes %u KiB, 32 bit indexes %u KiB\n",
+		static_cast<uint32_t>(vertexes.size()),
+		pbByteSize / 1024,
+		vbByteSize / 1024,
+		static_cast<uint32_t>(indexes16.size() * sizeof(uint16_t) / 1024),
+		static_cast<uint32_t>(indexes32.size() * sizeof(uint32_t) / 1024)
+	);
+	::OutputDebugString(buffer);
+
+	::sprintf_s(buffer, 500, "geometry: %u meshes split in %u chunks of 16 bit indexes\n", numSplitMeshes, numChunks);
+	::OutputDebugString(buffer);
+
+	::sprintf_s(buffer, 500, "geometry: %u vertexes welded\n", numWeldedVertexes);
+	::OutputDebugString(buffer);
 }
 
 void ModelsApp::BuildMaterials() {
@@ -1056,14 +2448,21 @@ void ModelsApp::BuildMaterials() {
 		aimat->Get(AI_MATKEY_COLOR_SPECULAR, specularColor);
 		float shininess = 0.0f;
 		aimat->Get(AI_MATKEY_SHININESS, shininess);
+		aiString alphaMode("OPAQUE");
+		aimat->Get(AI_MATKEY_GLTF_ALPHAMODE, alphaMode);
 
 		auto mat = std::make_unique<Material>();
 		
 		mat->CBIndex = i;
-		mat->TextureName = texturePath.C_Str();
+		// aliases are resolved when texture is streamed, material without texture keeps default one
+		if (texturePath.length != 0) {
+			mat->TextureName = texturePath.C_Str();
+		}
+
 		mat->DiffuseAlbedo = XMFLOAT4(diffuseColor.r, diffuseColor.g, diffuseColor.b, 1.0f);
 		mat->FresnelR0 = XMFLOAT3(specularColor.r, specularColor.g, specularColor.b);
 		mat->Roughness = 0.99f - shininess;
+		mat->IsAlphaTested = std::string(alphaMode.C_Str()) == "MASK";
 
 		m_Materials.push_back(std::move(mat));
 	}
@@ -1071,6 +2470,25 @@ void ModelsApp::BuildMaterials() {
 
 void ModelsApp::BuildRenderItems() {
 	BuildRecursivelyRenderItems(m_Scene->mRootNode, XMMatrixIdentity());
+
+	// group render items by geometry to switch index buffer as rarely as possible
+	// packed textures don`t change views later, so items are grouped by them too
+	std::stable_sort(
+		m_RenderItems.begin(), m_RenderItems.end(),
+		[this](const std::unique_ptr<RenderItem>& a, const std::unique_ptr<RenderItem>& b) {
+			if (a->m_MeshGeo->IndexBufferFormat != b->m_MeshGeo->IndexBufferFormat) {
+				return a->m_MeshGeo->IndexBufferFormat < b->m_MeshGeo->IndexBufferFormat;
+			}
+
+			return m_PackTextures &&
+				m_Textures[a->m_Material->TextureName]->SRVStagingIndex < m_Textures[b->m_Material->TextureName]->SRVStagingIndex;
+		}
+	);
+
+	for (auto& ri : m_RenderItems) {
+		RenderLayer layer = ri->m_Material->IsAlphaTested ? RenderLayer::AlphaTested : RenderLayer::Opaque;
+		m_RenderItemsLayers[static_cast<uint32_t>(layer)].push_back(ri.get());
+	}
 }
 
 void ModelsApp::BuildRecursivelyRenderItems(aiNode* node, XMMATRIX modelMatrix) {
@@ -1091,24 +2509,66 @@ void ModelsApp::BuildRecursivelyRenderItems(aiNode* node, XMMATRIX modelMatrix)
 		modelMatrix
 	));
 
-	for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
-		auto ri = std::make_unique<RenderItem>();
+	// bounding sphere radius is scaled by the largest axis scale
+	float maxScale = (std::max)({
+		XMVectorGetX(XMVector3Length(modelMatrix.r[0])),
+		XMVectorGetX(XMVector3Length(modelMatrix.r[1])),
+		XMVectorGetX(XMVector3Length(modelMatrix.r[2]))
+	});
 
+	for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
 		aiMesh* curMesh = m_Scene->mMeshes[node->mMeshes[i]];
-		std::string curMeshName = curMesh->mName.C_Str();
 
-		auto curGeo = m_Geometries[curMeshName].get();
+		// chunks of split mesh share bounding sphere of whole mesh
+		XMVECTOR boundsMin = XMVectorReplicate(FLT_MAX);
+		XMVECTOR boundsMax = XMVectorReplicate(-FLT_MAX);
+
+		for (uint32_t j = 0; j < curMesh->mNumVertices; ++j) {
+			const aiVector3D& pos = curMesh->mVertices[j];
+			XMVECTOR curPos = XMVectorSet(pos.x, pos.y, pos.z, 1.0f);
+
+			boundsMin = XMVectorMin(boundsMin, curPos);
+			boundsMax = XMVectorMax(boundsMax, curPos);
+		}
+
+		XMFLOAT3 boundsCenter;
+		XMStoreFloat3(&boundsCenter, XMVector3TransformCoord(0.5f * (boundsMin + boundsMax), modelMatrix));
+		float boundsRadius = 0.5f * maxScale * XMVectorGetX(XMVector3Length(boundsMax - boundsMin));
 
-		ri->m_ModelMatrix = modelMatrix;
-		ri->m_ModelMatrixInvTrans = modelMatrixInvTrans;
-		ri->m_MeshGeo = curGeo;
-		ri->m_Material = m_Materials[curMesh->mMaterialIndex].get();
-		ri->m_IndexCount = curGeo->DrawArgs[curMeshName].IndexCount;
-		ri->m_StartIndexLocation = curGeo->DrawArgs[curMeshName].StartIndexLocation;
-		ri->m_BaseVertexLocation = curGeo->DrawArgs[curMeshName].BaseVertexLocation;
-		ri->m_CBIndex = m_RenderItems.size();
+		// texture coordinates per world unit become sparser when mesh is scaled up
+		float uvDensity = m_MeshesUVDensities[curMesh->mName.C_Str()] / maxScale;
 
-		m_RenderItems.push_back(std::move(ri));
+		// split meshes have render item for each chunk
+		for (const std::string& curMeshName : m_MeshesParts[curMesh->mName.C_Str()]) {
+			auto ri = std::make_unique<RenderItem>();
+
+			auto curGeo = m_MeshesGeometries[curMeshName];
+
+			ri->m_ModelMatrix = modelMatrix;
+			ri->m_ModelMatrixInvTrans = modelMatrixInvTrans;
+			ri->m_MeshGeo = curGeo;
+			ri->m_GeometryResidencyId = m_GeometriesResidencyIds[curGeo->name];
+
+			if (m_UseCompactVertexes) {
+				const PositionDequantization& dequantization = m_MeshesDequantizations[curMeshName];
+
+				ri->m_PosDequantMatrix = XMMatrixMultiply(
+					XMMatrixScaling(dequantization.Scale[0], dequantization.Scale[1], dequantization.Scale[2]),
+					XMMatrixTranslation(dequantization.Offset[0], dequantization.Offset[1], dequantization.Offset[2])
+				);
+			}
+
+			ri->m_Material = m_Materials[curMesh->mMaterialIndex].get();
+			ri->m_BoundsCenter = boundsCenter;
+			ri->m_BoundsRadius = boundsRadius;
+			ri->m_UVDensity = uvDensity;
+			ri->m_IndexCount = curGeo->DrawArgs[curMeshName].IndexCount;
+			ri->m_StartIndexLocation = curGeo->DrawArgs[curMeshName].StartIndexLocation;
+			ri->m_BaseVertexLocation = curGeo->DrawArgs[curMeshName].BaseVertexLocation;
+			ri->m_CBIndex = m_RenderItems.size();
+
+			m_RenderItems.push_back(std::move(ri));
+		}
 	}
 
 	for (uint32_t i = 0; i < node->mNumChildren; ++i) {
@@ -1117,142 +2577,90 @@ void ModelsApp::BuildRecursivelyRenderItems(aiNode* node, XMMATRIX modelMatrix)
 }
 
 void ModelsApp::BuildFrameResources() {
-	m_FramesResources.reserve(m_NumBackBuffers);
+	m_FramePacer = std::make_unique<FramePacer>(m_NumFramesInFlight, m_FramePacingMode);
+	m_FramesResources.reserve(m_NumFramesInFlight);
 
-	for (uint32_t i = 0; i < m_NumBackBuffers; ++i) {
+	for (uint32_t i = 0; i < m_NumFramesInFlight; ++i) {
 		m_FramesResources.push_back(std::make_unique<FrameResources>(
 			m_Device,
-			1, 
-			m_RenderItems.size(),
-			m_Materials.size()
+			1,
+			m_Bindless ? static_cast<UINT>(m_RenderItems.size()) : 0,
+			m_Bindless ? static_cast<UINT>(m_Materials.size()) : 0
 		));
 	}
+
+	m_ConstantsAllocator = std::make_unique<UploadAllocator>(m_Device);
+	m_ObjectsConstantsAddresses.resize(m_RenderItems.size());
+	m_MaterialsConstantsAddresses.resize(m_Materials.size());
 }
 
 void ModelsApp::BuildSRViews() {
-	m_TexturesViewsStartIndex = m_NextCBV_SRVDescHeapIndex;
-
-	D3D12_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
-
-	viewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	viewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	viewDesc.Texture2D.MostDetailedMip = 0;
-	viewDesc.Texture2D.ResourceMinLODClamp = 0.0f;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE descHandle(m_CBV_SRVDescHeap->GetCPUDescriptorHandleForHeapStart());
+	// streamed textures use default view until they are resident, then they allocate their own
+	Texture* defaultTexture = m_Textures["default"].get();
+	CreateTextureSRView(defaultTexture->Resource.Get(), defaultTexture->SRVStagingIndex);
 
-	size_t i = m_TexturesViewsStartIndex;
-	for (auto& it : m_Textures) {
-		it.second->SRVHeapIndex = i;
-		ID3D12Resource* curTexBuffer = it.second->Resource.Get();
-
-		viewDesc.Format = curTexBuffer->GetDesc().Format;
-		viewDesc.Texture2D.MipLevels = curTexBuffer->GetDesc().MipLevels;
-
-		m_Device->CreateShaderResourceView(curTexBuffer, &viewDesc, descHandle);
-
-		descHandle.Offset(m_CBV_SRV_UAVDescSize);
-		++i;
+	for (Texture* group : m_TexturesGroups) {
+		CreateTextureSRView(group->Resource.Get(), group->SRVStagingIndex);
 	}
 
-	m_NextCBV_SRVDescHeapIndex += m_Textures.size();
-}
-
-void ModelsApp::BuildCBViews() {
-	// for object constants
-	m_ObjectConstantsViewsStartIndex = m_NextCBV_SRVDescHeapIndex;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE descHandle(
-		m_CBV_SRVDescHeap->GetCPUDescriptorHandleForHeapStart(),
-		m_ObjectConstantsViewsStartIndex,
-		m_CBV_SRV_UAVDescSize
-	);
-
-	uint32_t objectConstansElementByteSize = m_FramesResources[0]->m_ObjectsConstantsBuffer->GetElementByteSize();
-
-	for (uint32_t i = 0; i < m_NumBackBuffers; ++i) {
-		auto objectsConstantsBuffer = m_FramesResources[i]->m_ObjectsConstantsBuffer->Get();
-		D3D12_GPU_VIRTUAL_ADDRESS objectConstantsBufferGPUAdress = objectsConstantsBuffer->GetGPUVirtualAddress();
-
-		for (uint32_t j = 0; j < m_RenderItems.size(); ++j) {
-			D3D12_CONSTANT_BUFFER_VIEW_DESC CBViewDesc;
-
-			CBViewDesc.BufferLocation = objectConstantsBufferGPUAdress;
-			CBViewDesc.SizeInBytes = objectConstansElementByteSize;
-
-			m_Device->CreateConstantBufferView(
-				&CBViewDesc,
-				descHandle
-			);
-
-			descHandle.Offset(m_CBV_SRV_UAVDescSize);
-			objectConstantsBufferGPUAdress += objectConstansElementByteSize;
+	// packed textures already share views of their groups
+	for (Texture* tex : m_StreamedTextures) {
+		if (tex->SRVStagingIndex == DescriptorIndexAllocator::InvalidIndex) {
+			tex->SRVStagingIndex = defaultTexture->SRVStagingIndex;
 		}
 	}
+}
 
-	m_NextCBV_SRVDescHeapIndex += m_NumBackBuffers * m_RenderItems.size();
-
-	// for pass constants
-	m_PassConstantsViewsStartIndex =m_NextCBV_SRVDescHeapIndex;
-	uint32_t passConstansElementByteSize = m_FramesResources[0]->m_PassConstantsBuffer->GetElementByteSize();
+void ModelsApp::CreateTextureSRView(ID3D12Resource* resource, uint32_t stagingIndex) {
+	D3D12_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
 
-	for (uint32_t i = 0; i < m_NumBackBuffers; ++i) {
-		auto passConstantsBuffer = m_FramesResources[i]->m_PassConstantsBuffer->Get();
+	// all textures are sampled as arrays, single texture is array of one slice
+	D3D12_RESOURCE_DESC desc = resource->GetDesc();
 
-		D3D12_CONSTANT_BUFFER_VIEW_DESC CBViewDesc;
+	viewDesc.Format = desc.Format;
+	viewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+	viewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	viewDesc.Texture2DArray.MostDetailedMip = 0;
+	viewDesc.Texture2DArray.MipLevels = desc.MipLevels;
+	viewDesc.Texture2DArray.FirstArraySlice = 0;
+	viewDesc.Texture2DArray.ArraySize = desc.DepthOrArraySize;
+	viewDesc.Texture2DArray.PlaneSlice = 0;
+	viewDesc.Texture2DArray.ResourceMinLODClamp = 0.0f;
+
+	m_Device->CreateShaderResourceView(resource, &viewDesc, m_TexturesViewsAllocator->GetCPUHandle(stagingIndex));
+}
 
-		CBViewDesc.BufferLocation = passConstantsBuffer->GetGPUVirtualAddress();
-		CBViewDesc.SizeInBytes = passConstansElementByteSize;
+void ModelsApp::UpdateTexturesViews() {
+	// partition of current frame is free, frame which used it before is finished
+	m_CBV_SRVDescAllocator->BeginFrame(m_FramePacer->GetFrameSlot());
 
-		m_Device->CreateConstantBufferView(
-			&CBViewDesc,
-			descHandle
-		);
+	// each used staging view is copied once into slot of textures table, textures sharing it share the slot
+	m_TexturesViewsRemap.Clear();
 
-		descHandle.Offset(m_CBV_SRV_UAVDescSize);
+	for (auto& it : m_Textures) {
+		m_TexturesViewsRemap.Add(it.second->SRVStagingIndex);
 	}
 
-	m_NextCBV_SRVDescHeapIndex += m_NumBackBuffers;
-
-	// for material constants
-	m_MaterialConstantsViewsStartIndex = m_NextCBV_SRVDescHeapIndex;
-	uint32_t materialConstantsElementByteSize = m_FramesResources[0]->m_MaterialsConstantsBuffer->GetElementByteSize();
-
-	for (uint32_t i = 0; i < m_NumBackBuffers; ++i) {
-		auto materialConstantsBuffer = m_FramesResources[i]->m_MaterialsConstantsBuffer->Get();
-		D3D12_GPU_VIRTUAL_ADDRESS materialConstantsBufferGPUAdress = materialConstantsBuffer->GetGPUVirtualAddress();
-
-		for (uint32_t j = 0; j < m_Materials.size(); ++j) {
-			D3D12_CONSTANT_BUFFER_VIEW_DESC CBViewDesc;
+	m_TexturesTableIndex = m_CBV_SRVDescAllocator->AllocateRing(m_TexturesViewsRemap.GetNumSlots());
 
-			CBViewDesc.BufferLocation = materialConstantsBufferGPUAdress;
-			CBViewDesc.SizeInBytes = materialConstantsElementByteSize;
+	const std::vector<uint32_t>& stagingIndexes = m_TexturesViewsRemap.GetIds();
 
-			m_Device->CreateConstantBufferView(
-				&CBViewDesc,
-				descHandle
-			);
+	for (uint32_t slot = 0; slot < stagingIndexes.size(); ++slot) {
+		m_CBV_SRVDescAllocator->QueueCopy(m_TexturesViewsAllocator->GetCPUHandle(stagingIndexes[slot]), m_TexturesTableIndex + slot);
+	}
 
-			descHandle.Offset(m_CBV_SRV_UAVDescSize);
-			materialConstantsBufferGPUAdress += materialConstantsElementByteSize;
-		}
+	for (auto& it : m_Textures) {
+		Texture* tex = it.second.get();
+		tex->SRVHeapIndex = m_TexturesTableIndex + m_TexturesViewsRemap.GetSlot(tex->SRVStagingIndex);
 	}
 
-	m_NextCBV_SRVDescHeapIndex += m_NumBackBuffers * m_Materials.size();
+	m_CBV_SRVDescAllocator->FlushCopies();
 }
 
 void ModelsApp::BuildRootSignature() {
 	// init parameters
-	CD3DX12_ROOT_PARAMETER1 rootParameters[6];
-
-	CD3DX12_DESCRIPTOR_RANGE1 objConstsDescRange;
-	objConstsDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
-
-	CD3DX12_DESCRIPTOR_RANGE1 passConstsDescRange;
-	passConstsDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);
-
-	CD3DX12_DESCRIPTOR_RANGE1 matConstsDescRange;
-	matConstsDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 2);
+	CD3DX12_ROOT_PARAMETER1 rootParameters[7];
+	uint32_t numRootParameters = 6;
 
 	CD3DX12_DESCRIPTOR_RANGE1 texDescRange;
 	texDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
@@ -1263,10 +2671,27 @@ void ModelsApp::BuildRootSignature() {
 	CD3DX12_DESCRIPTOR_RANGE1 shadowMapsDescRange;
 	shadowMapsDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, m_NumShadowMaps, 2);
 
-	rootParameters[0].InitAsDescriptorTable(1, &objConstsDescRange);
-	rootParameters[1].InitAsDescriptorTable(1, &passConstsDescRange);
-	rootParameters[2].InitAsDescriptorTable(1, &matConstsDescRange);
-	rootParameters[3].InitAsDescriptorTable(1, &texDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
+	// table of all textures views of frame, views after used slots are not initialized
+	CD3DX12_DESCRIPTOR_RANGE1 texturesDescRange;
+	texturesDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 2, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE);
+
+	if (m_Bindless) {
+		// index of object, pass constants, objects and materials buffers, tables of effects and textures
+		rootParameters[0].InitAsConstants(1, 4);
+		rootParameters[1].InitAsConstantBufferView(1);
+		rootParameters[2].InitAsShaderResourceView(0, 1);
+		rootParameters[3].InitAsShaderResourceView(1, 1);
+		rootParameters[6].InitAsDescriptorTable(1, &texturesDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
+		numRootParameters = 7;
+	}
+	else {
+		// constants are root CBVs: object, pass and material
+		rootParameters[0].InitAsConstantBufferView(0);
+		rootParameters[1].InitAsConstantBufferView(1);
+		rootParameters[2].InitAsConstantBufferView(2);
+		rootParameters[3].InitAsDescriptorTable(1, &texDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
+	}
+
 	rootParameters[4].InitAsDescriptorTable(1, &occlusionMapDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
 	rootParameters[5].InitAsDescriptorTable(1, &shadowMapsDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
 
@@ -1300,7 +2725,7 @@ void ModelsApp::BuildRootSignature() {
 	D3D12_STATIC_SAMPLER_DESC samplers[] = { linearWrapSampler, pointBorderCompSampler };
 
 	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
-	rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, _countof(samplers), samplers, rootSignatureFlags);
+	rootSignatureDesc.Init_1_1(numRootParameters, rootParameters, _countof(samplers), samplers, rootSignatureFlags);
 
 	ComPtr<ID3DBlob> rootSignatureBlob;
 	ComPtr<ID3DBlob> errorBlob;
@@ -1325,15 +2750,28 @@ void ModelsApp::BuildRootSignature() {
 }
 
 void ModelsApp::BuildPipelineStateObject() {
-	// Create input layout
+	// Create input layout, positions are in slot 0 and other attributes are in slot 1
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs[]{
 		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"NORM", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+		{"NORM", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 1, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+	};
+
+	D3D12_INPUT_ELEMENT_DESC compactInputElementDescs[]{
+		{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"NORM", 0, DXGI_FORMAT_R16G16_SNORM, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 1, 4, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
 	};
 
 	D3D12_INPUT_LAYOUT_DESC inpuitLayout{ inputElementDescs, _countof(inputElementDescs) };
 
+	if (m_UseCompactVertexes) {
+		inpuitLayout = { compactInputElementDescs, _countof(compactInputElementDescs) };
+	}
+
+	// position is first element in both layouts
+	D3D12_INPUT_LAYOUT_DESC positionOnlyInputLayout{ inpuitLayout.pInputElementDescs, 1 };
+
 	// Create pipeline state object description
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc;
 
@@ -1352,7 +2790,10 @@ void ModelsApp::BuildPipelineStateObject() {
 	psoDesc.DSVFormat = m_DepthSencilViewFormat;
 	psoDesc.SampleDesc = { 1, 0 };
 
-	ComPtr<ID3DBlob> geoVertexShaderBlob = CompileShader(L"../../AppModels/shaders/GeoVertexShader.hlsl", "main", "vs_5_1");
+	D3D_SHADER_MACRO compactVertexDefines[] = { "COMPACT_VERTEX", "1", NULL, NULL };
+	const D3D_SHADER_MACRO* geoVertexDefines = m_UseCompactVertexes ? compactVertexDefines : NULL;
+
+	ComPtr<ID3DBlob> geoVertexShaderBlob = CompileShader(L"../../AppModels/shaders/GeoVertexShader.hlsl", "main", "vs_5_1", GetDefines(geoVertexDefines, m_Bindless).data());
 	
 	psoDesc.VS = {
 		reinterpret_cast<BYTE*>(geoVertexShaderBlob->GetBufferPointer()),
@@ -1366,7 +2807,7 @@ void ModelsApp::BuildPipelineStateObject() {
 		ComPtr<ID3D12PipelineState> inverseDepthPSO;
 
 		D3D_SHADER_MACRO geoDefines[] = { "ALPHA_TEST", "1", NULL, NULL };
-		ComPtr<ID3DBlob> geoPixelShaderBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", geoDefines);
+		ComPtr<ID3DBlob> geoPixelShaderBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", GetDefines(geoDefines, m_Bindless).data());
 
 		ordinarPsoDesc.PS = {
 			reinterpret_cast<BYTE*>(geoPixelShaderBlob->GetBufferPointer()),
@@ -1389,7 +2830,7 @@ void ModelsApp::BuildPipelineStateObject() {
 		ComPtr<ID3D12PipelineState> normInverseDepthPSO;
 
 		D3D_SHADER_MACRO normDefines[] = { "ALPHA_TEST", "1", "DRAW_NORMS", "1", NULL, NULL };
-		ComPtr<ID3DBlob> normPixelShaderBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", normDefines);
+		ComPtr<ID3DBlob> normPixelShaderBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", GetDefines(normDefines, m_Bindless).data());
 
 		normalsPsoDesc.PS = {
 			reinterpret_cast<BYTE*>(normPixelShaderBlob->GetBufferPointer()),
@@ -1412,7 +2853,7 @@ void ModelsApp::BuildPipelineStateObject() {
 		ComPtr<ID3D12PipelineState> ssaoPSO;
 
 		D3D_SHADER_MACRO ssaoDefines[] = { "ALPHA_TEST", "1", "SSAO", "1", NULL, NULL };
-		ComPtr<ID3DBlob> ssaoPixelShaderBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", ssaoDefines);
+		ComPtr<ID3DBlob> ssaoPixelShaderBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", GetDefines(ssaoDefines, m_Bindless).data());
 
 		ssaoPsoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_EQUAL;
 
@@ -1431,7 +2872,7 @@ void ModelsApp::BuildPipelineStateObject() {
 		ComPtr<ID3D12PipelineState> ssaoOnlyPSO;
 
 		D3D_SHADER_MACRO ssaoOnlyDefines[] = { "ALPHA_TEST", "1", "SSAO", "1", "SSAO_ONLY", "1", NULL, NULL };
-		ComPtr<ID3DBlob> ssaoOnlyPixelShaderBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", ssaoOnlyDefines);
+		ComPtr<ID3DBlob> ssaoOnlyPixelShaderBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", GetDefines(ssaoOnlyDefines, m_Bindless).data());
 
 		ssaoOnlyPsoDesc.PS = {
 			reinterpret_cast<BYTE*>(ssaoOnlyPixelShaderBlob->GetBufferPointer()),
@@ -1451,7 +2892,7 @@ void ModelsApp::BuildPipelineStateObject() {
 		ComPtr<ID3D12PipelineState> ssaoNormalsInversePSO;
 
 		D3D_SHADER_MACRO ssaoNormalsDefines[] = { "ALPHA_TEST", "1", "DRAW_NORMS", "1", "SSAO", "1", NULL, NULL };
-		ComPtr<ID3DBlob> ssaoNormalsPSBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", ssaoNormalsDefines);
+		ComPtr<ID3DBlob> ssaoNormalsPSBlob = CompileShader(L"../../AppModels/shaders/GeoPixelShader.hlsl", "main", "ps_5_1", GetDefines(ssaoNormalsDefines, m_Bindless).data());
 
 		ssaoNormalsPsoDesc.PS = {
 			reinterpret_cast<BYTE*>(ssaoNormalsPSBlob->GetBufferPointer()),
@@ -1476,8 +2917,12 @@ void ModelsApp::BuildPipelineStateObject() {
 		ComPtr<ID3D12PipelineState> shadowMapsPSO;
 
 		D3D_SHADER_MACRO shadowMapsDefines[] = { "ALPHA_TEST", "1", NULL, NULL};
-		ComPtr<ID3DBlob> shadowMapsPSBlob = CompileShader(L"../../AppModels/shaders/ShadowPS.hlsl", "main", "ps_5_1", shadowMapsDefines);
-		ComPtr<ID3DBlob> shadowMapsVSBlob = CompileShader(L"../../AppModels/shaders/ShadowVS.hlsl", "main", "vs_5_1", shadowMapsDefines);
+		D3D_SHADER_MACRO compactShadowMapsDefines[] = { "ALPHA_TEST", "1", "COMPACT_VERTEX", "1", NULL, NULL };
+		ComPtr<ID3DBlob> shadowMapsPSBlob = CompileShader(L"../../AppModels/shaders/ShadowPS.hlsl", "main", "ps_5_1", GetDefines(shadowMapsDefines, m_Bindless).data());
+		ComPtr<ID3DBlob> shadowMapsVSBlob = CompileShader(
+			L"../../AppModels/shaders/ShadowVS.hlsl", "main", "vs_5_1",
+			GetDefines(m_UseCompactVertexes ? compactShadowMapsDefines : shadowMapsDefines, m_Bindless).data()
+		);
 
 		shadowMapPsoDesc.PS = {
 			reinterpret_cast<BYTE*>(shadowMapsPSBlob->GetBufferPointer()),
@@ -1501,36 +2946,70 @@ void ModelsApp::BuildPipelineStateObject() {
 
 		ThrowIfFailed(m_Device->CreateGraphicsPipelineState(&shadowMapPsoDesc, IID_PPV_ARGS(&shadowMapsPSO)));
 		m_PSOs["shadowMaps"] = shadowMapsPSO;
+
+		// for opaque items depth only is needed, so only positions are fetched and pixel shader is skipped
+		ComPtr<ID3D12PipelineState> shadowMapsPositionOnlyPSO;
+
+		D3D_SHADER_MACRO positionOnlyDefines[] = { "POSITION_ONLY", "1", NULL, NULL };
+		D3D_SHADER_MACRO compactPositionOnlyDefines[] = { "POSITION_ONLY", "1", "COMPACT_VERTEX", "1", NULL, NULL };
+		ComPtr<ID3DBlob> shadowMapsPositionOnlyVSBlob = CompileShader(
+			L"../../AppModels/shaders/ShadowVS.hlsl", "main", "vs_5_1",
+			GetDefines(m_UseCompactVertexes ? compactPositionOnlyDefines : positionOnlyDefines, m_Bindless).data()
+		);
+
+		shadowMapPsoDesc.VS = {
+			reinterpret_cast<BYTE*>(shadowMapsPositionOnlyVSBlob->GetBufferPointer()),
+			shadowMapsPositionOnlyVSBlob->GetBufferSize()
+		};
+
+		shadowMapPsoDesc.PS = { NULL, 0 };
+		shadowMapPsoDesc.InputLayout = positionOnlyInputLayout;
+
+		ThrowIfFailed(m_Device->CreateGraphicsPipelineState(&shadowMapPsoDesc, IID_PPV_ARGS(&shadowMapsPositionOnlyPSO)));
+		m_PSOs["shadowMapsPositionOnly"] = shadowMapsPositionOnlyPSO;
 	}
 }
 
-void ModelsApp::UpdateSobelFrameTexture() {
-	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Tex2D(m_BackBuffersFormat, m_ClientWidth, m_ClientHeight);
-	resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+uint32_t ModelsApp::RenewSRViews(DescriptorRange& range, uint64_t& rangeFrame) {
+	// no submitted frame reads views of range, so they are rewritten in place
+	if (rangeFrame == m_FramePacer->GetNumFrames()) {
+		return range.Index;
+	}
 
-	CD3DX12_CLEAR_VALUE clearValue{ m_BackBuffersFormat , m_BackGroundColor.data() };
+	uint32_t count = range.Count;
 
-	ThrowIfFailed(m_Device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-		&resourceDesc,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		&clearValue,
-		IID_PPV_ARGS(&m_SobelFrameTextureBuffer)
-	));
+	m_CBV_SRVDescAllocator->Free(range, m_DirectCommandQueue->Signal());
+	range = m_CBV_SRVDescAllocator->Allocate(count);
+	rangeFrame = m_FramePacer->GetNumFrames();
+
+	return range.Index;
+}
+
+void ModelsApp::UpdateSobelViews() {
+	if (m_SobelFrameTexture == RenderGraph::InvalidIndex) {
+		return;
+	}
+
+	ID3D12Resource* sobelFrameTexture = m_FrameGraphResources->GetResource(m_SobelFrameTexture);
+
+	if (sobelFrameTexture == nullptr) {
+		return;
+	}
+
+	m_SobelTextureSRVIndex = RenewSRViews(m_SobelTextureSRVRange, m_SobelTextureSRVFrame);
 
 	m_Device->CreateRenderTargetView(
-		m_SobelFrameTextureBuffer.Get(),
+		sobelFrameTexture,
 		nullptr, 
 		CD3DX12_CPU_DESCRIPTOR_HANDLE(
 			m_RTVDescHeap->GetCPUDescriptorHandleForHeapStart(),
 			m_SobelTextureRTVIndex,
-			m_CBV_SRV_UAVDescSize
+			m_RTVDescSize
 		)
 	);
 
 	m_Device->CreateShaderResourceView(
-		m_SobelFrameTextureBuffer.Get(),
+		sobelFrameTexture,
 		nullptr, 
 		CD3DX12_CPU_DESCRIPTOR_HANDLE(
 			m_CBV_SRVDescHeap->GetCPUDescriptorHandleForHeapStart(),
@@ -1621,7 +3100,9 @@ void ModelsApp::BuildSobelPipelineStateObject() {
 	m_PSOs["Sobel"] = sobelPSO;
 }
 
-void ModelsApp::UpdateSSAOBuffersAndViews() {
+void ModelsApp::UpdateSSAOViews() {
+	m_SSAO_SRV_StartIndex = RenewSRViews(m_SSAO_SRVRange, m_SSAO_SRVFrame);
+
 	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvDescHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(
 		m_RTVDescHeap->GetCPUDescriptorHandleForHeapStart(),
 		m_SSAO_RTV_StartIndex,
@@ -1634,39 +3115,30 @@ void ModelsApp::UpdateSSAOBuffersAndViews() {
 		m_CBV_SRV_UAVDescSize
 	);
 
-	// create normal map buffer
-	CD3DX12_RESOURCE_DESC normalMapDesc = CD3DX12_RESOURCE_DESC::Tex2D(
-		DXGI_FORMAT_R16G16B16A16_FLOAT,
-		m_ClientWidth,
-		m_ClientHeight
-	);
-
-	normalMapDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
-
-	CD3DX12_CLEAR_VALUE normalMapClearValue{ DXGI_FORMAT_R16G16B16A16_FLOAT , m_NormalMapBufferClearValue.data() };
+	// transients are placed by frame graph, they have no views until SSAO passes are executed
+	auto getTransient = [this](uint32_t resource) -> ID3D12Resource* {
+		return resource != RenderGraph::InvalidIndex ? m_FrameGraphResources->GetResource(resource) : nullptr;
+	};
 
-	ThrowIfFailed(m_Device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-		&normalMapDesc,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		&normalMapClearValue,
-		IID_PPV_ARGS(&m_NormalMapBuffer)
-	));
+	ID3D12Resource* normalMap = getTransient(m_NormalMap);
+	ID3D12Resource* occlusionMap0 = getTransient(m_OcclusionMap0);
+	ID3D12Resource* occlusionMap1 = getTransient(m_OcclusionMap1);
 
-	// crate RTV for normal map buffer
-	m_Device->CreateRenderTargetView(
-		m_NormalMapBuffer.Get(),
-		nullptr,
-		rtvDescHandle
-	);
+	if (normalMap != nullptr) {
+		// crate RTV for normal map buffer
+		m_Device->CreateRenderTargetView(
+			normalMap,
+			nullptr,
+			rtvDescHandle
+		);
 
-	// create SRV for normal map buffer
-	m_Device->CreateShaderResourceView(
-		m_NormalMapBuffer.Get(),
-		nullptr,
-		srvDescHandle
-	);
+		// create SRV for normal map buffer
+		m_Device->CreateShaderResourceView(
+			normalMap,
+			nullptr,
+			srvDescHandle
+		);
+	}
 
 	// create SRV for depth buffer
 	D3D12_SHADER_RESOURCE_VIEW_DESC dsViewDesc = {};
@@ -1691,61 +3163,22 @@ void ModelsApp::UpdateSSAOBuffersAndViews() {
 		srvDescHandle.Offset(m_CBV_SRV_UAVDescSize)
 	);
 
-	// create occlusion maps buffers
-	m_OcclusionMapWidth = m_ClientWidth / 2;
-	m_OcclusionMapHeight = m_ClientHeight / 2;
-
-	CD3DX12_RESOURCE_DESC occlusionMapDesc = CD3DX12_RESOURCE_DESC::Tex2D(
-		DXGI_FORMAT_R16_UNORM,
-		m_OcclusionMapWidth,
-		m_OcclusionMapHeight
-	);
-
-	occlusionMapDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
-
-	ThrowIfFailed(m_Device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-		&occlusionMapDesc,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		NULL,
-		IID_PPV_ARGS(&m_OcclusionMapBuffer0)
-	));
-
-	ThrowIfFailed(m_Device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-		&occlusionMapDesc,
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
-		NULL,
-		IID_PPV_ARGS(&m_OcclusionMapBuffer1)
-	));
-
-	// create RTV's for occlusion maps buffers
-	m_Device->CreateRenderTargetView(
-		m_OcclusionMapBuffer0.Get(),
-		nullptr,
-		rtvDescHandle.Offset(m_RTVDescSize)
-	);
+	rtvDescHandle.Offset(m_RTVDescSize);
+	srvDescHandle.Offset(m_CBV_SRV_UAVDescSize);
 
-	m_Device->CreateRenderTargetView(
-		m_OcclusionMapBuffer1.Get(),
-		nullptr,
-		rtvDescHandle.Offset(m_RTVDescSize)
-	);
+	// create RTV's and SRV's for occlusion maps buffers
+	if (occlusionMap0 != nullptr) {
+		m_Device->CreateRenderTargetView(occlusionMap0, nullptr, rtvDescHandle);
+		m_Device->CreateShaderResourceView(occlusionMap0, nullptr, srvDescHandle);
+	}
 
-	// create SRV's for occlusion maps buffers
-	m_Device->CreateShaderResourceView(
-		m_OcclusionMapBuffer0.Get(),
-		nullptr,
-		srvDescHandle.Offset(m_CBV_SRV_UAVDescSize)
-	);
+	rtvDescHandle.Offset(m_RTVDescSize);
+	srvDescHandle.Offset(m_CBV_SRV_UAVDescSize);
 
-	m_Device->CreateShaderResourceView(
-		m_OcclusionMapBuffer1.Get(),
-		nullptr,
-		srvDescHandle.Offset(m_CBV_SRV_UAVDescSize)
-	);
+	if (occlusionMap1 != nullptr) {
+		m_Device->CreateRenderTargetView(occlusionMap1, nullptr, rtvDescHandle);
+		m_Device->CreateShaderResourceView(occlusionMap1, nullptr, srvDescHandle);
+	}
 }
 
 void ModelsApp::BuildSSAORootSignature() {
@@ -1757,12 +3190,9 @@ void ModelsApp::BuildSSAORootSignature() {
 	CD3DX12_DESCRIPTOR_RANGE1 occlusionMapDesRange;
 	occlusionMapDesRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 3);
 
-	CD3DX12_DESCRIPTOR_RANGE1 passConstantsDescRange;
-	passConstantsDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
-
 	rootParameters[0].InitAsDescriptorTable(1, &normalDepthRandomMapsDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
 	rootParameters[1].InitAsDescriptorTable(1, &occlusionMapDesRange, D3D12_SHADER_VISIBILITY_PIXEL);
-	rootParameters[2].InitAsDescriptorTable(1, &passConstantsDescRange);
+	rootParameters[2].InitAsConstantBufferView(0);
 	rootParameters[3].InitAsConstants(13, 1);
 
 	D3D12_ROOT_SIGNATURE_FLAGS rootSignatureFlags =
@@ -1932,14 +3362,13 @@ void ModelsApp::BuildRandomMapBufferAndDirections(ComPtr<ID3D12GraphicsCommandLi
 	}
 
 	// crate random vectors buffer and upload buffer
-	ThrowIfFailed(m_Device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, texWidth, texHeight, 1, 1),
+	m_RandomMapBuffer = m_ResourceHeapAllocator->CreateResource(
+		CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, texWidth, texHeight, 1, 1),
+		D3D12_HEAP_TYPE_DEFAULT,
 		D3D12_RESOURCE_STATE_COPY_DEST,
 		nullptr,
-		IID_PPV_ARGS(&m_RandomMapBuffer)
-	));
+		m_RandomMapAllocation
+	);
 
 	uint64_t uploadBufferSize = GetRequiredIntermediateSize(m_RandomMapBuffer.Get(), 0, 1);
 
@@ -1958,6 +3387,7 @@ void ModelsApp::BuildRandomMapBufferAndDirections(ComPtr<ID3D12GraphicsCommandLi
 	subResouceData.RowPitch = texWidth * sizeof(PackedVector::XMCOLOR);
 	subResouceData.SlicePitch = subResouceData.RowPitch * texHeight;
 
+	// list is of copy queue, map decays to common state after upload and is promoted when SSAO reads it
 	UpdateSubresources(
 		commandList.Get(),
 		m_RandomMapBuffer.Get(),
@@ -1966,13 +3396,8 @@ void ModelsApp::BuildRandomMapBufferAndDirections(ComPtr<ID3D12GraphicsCommandLi
 		&subResouceData
 	);
 
-	D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-		m_RandomMapBuffer.Get(),
-		D3D12_RESOURCE_STATE_COPY_DEST,
-		D3D12_RESOURCE_STATE_GENERIC_READ
-	);
-
-	commandList->ResourceBarrier(1, &barrier);
+	// other SSAO render targets are transients of frame graph, they are tracked with its heap
+	TrackRenderTargets(m_SSAOResidencyId, ResidencyCategory::SSAO, { m_RandomMapBuffer.Get() });
 
 	delete[] data;
 }
@@ -2003,48 +3428,59 @@ void ModelsApp::BuildShadowMaps() {
 		m_DSVDescSize
 	);
 
-	CD3DX12_CPU_DESCRIPTOR_HANDLE srvCpuDescHandle(
-		m_CBV_SRVDescHeap->GetCPUDescriptorHandleForHeapStart(),
-		m_NextCBV_SRVDescHeapIndex,
-		m_CBV_SRV_UAVDescSize
-	);
-
-	CD3DX12_GPU_DESCRIPTOR_HANDLE srvGpuDescHandle(
-		m_CBV_SRVDescHeap->GetGPUDescriptorHandleForHeapStart(),
-		m_NextCBV_SRVDescHeapIndex,
-		m_CBV_SRV_UAVDescSize
-	);
+	uint32_t srvIndex = m_CBV_SRVDescAllocator->Allocate(m_NumShadowMaps).Index;
+	CD3DX12_CPU_DESCRIPTOR_HANDLE srvCpuDescHandle(m_CBV_SRVDescAllocator->GetCPUHandle(srvIndex));
+	CD3DX12_GPU_DESCRIPTOR_HANDLE srvGpuDescHandle(m_CBV_SRVDescAllocator->GetGPUHandle(srvIndex));
 
 	for (uint32_t i = 0; i < m_NumShadowMaps; ++i) {
-		m_ShadowMaps.push_back(std::make_unique<ShadowMap>(m_Device.Get(), 2048, 2048));
+		m_ShadowMaps.push_back(std::make_unique<ShadowMap>(m_Device.Get(), *m_ResourceHeapAllocator, 2048, 2048));
 		m_ShadowMaps[i]->BuildDescriptors(dsvDescHandle, srvCpuDescHandle, srvGpuDescHandle);
 
 		dsvDescHandle.Offset(m_DSVDescSize);
 		srvCpuDescHandle.Offset(m_CBV_SRV_UAVDescSize);
 		srvGpuDescHandle.Offset(m_CBV_SRV_UAVDescSize);
 	}
-}
 
-void ModelsApp::BuildShadowMapsRootSignature() {
-	// init parameters
-	CD3DX12_ROOT_PARAMETER1 rootParameters[5];
+	std::vector<ID3D12Resource*> shadowMapsResources;
+
+	for (auto& shadowMap : m_ShadowMaps) {
+		shadowMapsResources.push_back(shadowMap->GetResource());
+	}
 
-	CD3DX12_DESCRIPTOR_RANGE1 objConstsDescRange;
-	objConstsDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
+	TrackRenderTargets(m_ShadowMapsResidencyId, ResidencyCategory::ShadowMaps, shadowMapsResources);
 
-	CD3DX12_DESCRIPTOR_RANGE1 passConstsDescRange;
-	passConstsDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);
+	for (ID3D12Resource* resource : shadowMapsResources) {
+		m_ResourceStates.SetState(resource, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
+}
 
-	CD3DX12_DESCRIPTOR_RANGE1 matConstsDescRange;
-	matConstsDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 2);
+void ModelsApp::BuildShadowMapsRootSignature() {
+	// init parameters
+	CD3DX12_ROOT_PARAMETER1 rootParameters[6];
+	uint32_t numRootParameters = 5;
 
 	CD3DX12_DESCRIPTOR_RANGE1 texDescRange;
 	texDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
 
-	rootParameters[0].InitAsDescriptorTable(1, &objConstsDescRange);
-	rootParameters[1].InitAsDescriptorTable(1, &passConstsDescRange);
-	rootParameters[2].InitAsDescriptorTable(1, &matConstsDescRange);
-	rootParameters[3].InitAsDescriptorTable(1, &texDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
+	CD3DX12_DESCRIPTOR_RANGE1 texturesDescRange;
+	texturesDescRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 2, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE);
+
+	if (m_Bindless) {
+		// same layout as geometry one, index of light stays in the same parameter
+		rootParameters[0].InitAsConstants(1, 4);
+		rootParameters[1].InitAsConstantBufferView(1);
+		rootParameters[2].InitAsShaderResourceView(0, 1);
+		rootParameters[3].InitAsShaderResourceView(1, 1);
+		rootParameters[5].InitAsDescriptorTable(1, &texturesDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
+		numRootParameters = 6;
+	}
+	else {
+		rootParameters[0].InitAsConstantBufferView(0);
+		rootParameters[1].InitAsConstantBufferView(1);
+		rootParameters[2].InitAsConstantBufferView(2);
+		rootParameters[3].InitAsDescriptorTable(1, &texDescRange, D3D12_SHADER_VISIBILITY_PIXEL);
+	}
+
 	rootParameters[4].InitAsConstants(1, 3);
 
 	// set access flags
@@ -2066,7 +3502,7 @@ void ModelsApp::BuildShadowMapsRootSignature() {
 	D3D12_STATIC_SAMPLER_DESC samplers[] = { linearWrapSampler };
 
 	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
-	rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, _countof(samplers), samplers, rootSignatureFlags);
+	rootSignatureDesc.Init_1_1(numRootParameters, rootParameters, _countof(samplers), samplers, rootSignatureFlags);
 
 	ComPtr<ID3DBlob> rootSignatureBlob;
 	ComPtr<ID3DBlob> errorBlob;
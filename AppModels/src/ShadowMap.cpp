@@ -3,8 +3,8 @@
 
 #include <d3dx12.h>
 
-ShadowMap::ShadowMap(ID3D12Device2* device, uint32_t width, uint32_t height) :
-	m_Device(device), m_Width(width), m_Height(height)
+ShadowMap::ShadowMap(ID3D12Device2* device, ResourceHeapAllocator& allocator, uint32_t width, uint32_t height) :
+	m_Device(device), m_Allocator(allocator), m_Width(width), m_Height(height)
 {
 	m_ViewPort = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(m_Width), static_cast<float>(m_Height));
 	m_ScissorRect = CD3DX12_RECT(0, 0, m_Width, m_Height);
@@ -12,6 +12,11 @@ ShadowMap::ShadowMap(ID3D12Device2* device, uint32_t width, uint32_t height) :
 	BuildResource();
 }
 
+ShadowMap::~ShadowMap() {
+	m_Resource.Reset();
+	m_Allocator.Free(m_Allocation);
+}
+
 void ShadowMap::BuildResource() {
 	D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(m_Format, m_Width, m_Height);
 
@@ -22,14 +27,17 @@ void ShadowMap::BuildResource() {
 	clearValue.DepthStencil.Depth = 1.0f;
 	clearValue.DepthStencil.Stencil = 0;
 
-	ThrowIfFailed(m_Device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_NONE,
-		&desc,
+	// previous resource is not used by GPU when shadow map is resized
+	m_Resource.Reset();
+	m_Allocator.Free(m_Allocation);
+
+	m_Resource = m_Allocator.CreateResource(
+		desc,
+		D3D12_HEAP_TYPE_DEFAULT,
 		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
 		&clearValue,
-		IID_PPV_ARGS(&m_Resource)
-	));
+		m_Allocation
+	);
 }
 
 void ShadowMap::BuildDescriptors(
@@ -0,0 +1,100 @@
+#include <MyD3D12Lib/AssetPackage.h>
+#include <MyD3D12Lib/ThreadPool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+	std::vector<uint8_t> ReadWholeFile(const std::filesystem::path& fileName) {
+		std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+
+		if (!file) {
+			throw std::exception();
+		}
+
+		std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(data.data()), data.size());
+
+		if (!file) {
+			throw std::exception();
+		}
+
+		return data;
+	}
+}
+
+// packs all files of folder, names in package are paths relative to folder with forward slashes
+// usage: AssetPacker <package> <folder> [excluded subfolders...]
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		std::printf("usage: AssetPacker <package> <folder> [excluded subfolders...]\n");
+		return 1;
+	}
+
+	std::filesystem::path packageFileName = std::filesystem::absolute(argv[1]);
+	std::filesystem::path folder = std::filesystem::absolute(argv[2]);
+
+	std::vector<std::filesystem::path> excludedFolders;
+
+	for (int i = 3; i < argc; ++i) {
+		excludedFolders.push_back(folder / argv[i]);
+	}
+
+	try {
+		auto start = std::chrono::steady_clock::now();
+
+		AssetPackageWriter writer;
+		uint64_t totalSize = 0;
+
+		std::filesystem::path tempFileName = packageFileName;
+		tempFileName += ".tmp";
+
+		for (auto it = std::filesystem::recursive_directory_iterator(folder); it != std::filesystem::recursive_directory_iterator(); ++it) {
+			const std::filesystem::path& path = it->path();
+
+			if (it->is_directory() && std::find(excludedFolders.begin(), excludedFolders.end(), path) != excludedFolders.end()) {
+				it.disable_recursion_pending();
+				continue;
+			}
+
+			// previous package and its temporary file are not packed into new one
+			if (!it->is_regular_file() || path == packageFileName || path == tempFileName) {
+				continue;
+			}
+
+			std::vector<uint8_t> data = ReadWholeFile(path);
+			totalSize += data.size();
+
+			writer.AddFile(std::filesystem::relative(path, folder).generic_string(), std::move(data));
+		}
+
+		ThreadPool pool;
+		writer.Write(packageFileName, &pool);
+
+		auto end = std::chrono::steady_clock::now();
+
+		AssetPackage package(packageFileName);
+
+		std::printf(
+			"%u files, %.2f MB -> %.2f MB compressed, %.2f MB package, %.0f ms\n",
+			package.GetNumFiles(),
+			totalSize / (1024.0 * 1024.0),
+			writer.GetCompressedSize() / (1024.0 * 1024.0),
+			std::filesystem::file_size(packageFileName) / (1024.0 * 1024.0),
+			std::chrono::duration<double, std::milli>(end - start).count()
+		);
+	}
+	catch (const std::exception&) {
+		std::printf("failed to pack %s\n", folder.string().c_str());
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
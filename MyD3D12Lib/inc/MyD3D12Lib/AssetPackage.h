@@ -0,0 +1,87 @@
+#pragma once
+
+#include <MyD3D12Lib/MappedFile.h>
+#include <MyD3D12Lib/ThreadPool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// package of many assets in one file, each asset is split into chunks compressed independently
+// chunks are aligned to 4 KiB, so they can be read through memory mapping and decompressed in parallel
+// table of contents is open addressing hash table of names, lookup doesn`t depend on number of assets
+
+// collects assets in memory and writes package
+class AssetPackageWriter {
+public:
+	// chunkSize is size of uncompressed chunk, it is granularity of random access reads
+	explicit AssetPackageWriter(uint32_t chunkSize = 64 * 1024);
+
+	AssetPackageWriter(const AssetPackageWriter& other) = delete;
+	AssetPackageWriter& operator=(const AssetPackageWriter& other) = delete;
+
+	// names are unique, e.g. paths relative to package root with forward slashes
+	void AddFile(const std::string& name, std::vector<uint8_t> data);
+
+	// chunks are compressed on pool if it is given, chunks which don`t shrink are stored as is
+	// file is written to temporary one which is renamed, so readers never see partial package
+	void Write(const std::filesystem::path& fileName, ThreadPool* pool = nullptr);
+
+	// size of compressed chunks of last written package
+	uint64_t GetCompressedSize() const;
+
+private:
+	struct File {
+		std::string Name;
+		std::vector<uint8_t> Data;
+	};
+
+	uint32_t m_ChunkSize;
+	std::vector<File> m_Files;
+	uint64_t m_CompressedSize = 0;
+};
+
+// read only view of package, reads are thread safe
+class AssetPackage {
+public:
+	static const uint32_t InvalidIndex = UINT32_MAX;
+
+	// throws if file can`t be mapped or is not valid package
+	explicit AssetPackage(const std::filesystem::path& fileName);
+
+	AssetPackage(const AssetPackage& other) = delete;
+	AssetPackage& operator=(const AssetPackage& other) = delete;
+
+	// returns InvalidIndex if there is no such asset
+	uint32_t Find(const std::string& name) const;
+
+	uint32_t GetNumFiles() const;
+	std::string GetFileName(uint32_t index) const;
+	uint64_t GetFileSize(uint32_t index) const;
+
+	// whole asset, chunks are decompressed on pool if it is given
+	std::vector<uint8_t> ReadFile(uint32_t index, ThreadPool* pool = nullptr) const;
+
+	// only chunks overlapping range are decompressed, throws if range is out of asset
+	void Read(uint32_t index, uint64_t offset, uint64_t size, uint8_t* dst) const;
+
+	// for streaming asset chunk by chunk, chunk is GetChunkSize() bytes except the last one
+	uint32_t GetChunkSize() const;
+	uint32_t GetNumChunks(uint32_t index) const;
+	void ReadChunk(uint32_t index, uint32_t chunk, uint8_t* dst) const;
+
+private:
+	friend class AssetPackageWriter;
+
+	struct Header;
+	struct FileEntry;
+	struct ChunkEntry;
+
+	const Header& GetHeader() const;
+	const FileEntry& GetFileEntry(uint32_t index) const;
+	const ChunkEntry& GetChunkEntry(uint32_t index) const;
+
+	MappedFile m_File;
+};
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <MyD3D12Lib/CommandQueue.h>
+#include <MyD3D12Lib/DeferredReleaseQueue.h>
+#include <MyD3D12Lib/ResourceHeapAllocator.h>
 
 #include <d3d12.h>
 #include <d3dx12.h>
@@ -18,6 +20,7 @@ using Microsoft::WRL::ComPtr;
 
 LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
 
+// depth of swap chain, number of frames CPU records ahead of GPU is set by app
 constexpr int32_t m_NumBackBuffers = 3;
 
 class BaseApp {
@@ -78,12 +81,18 @@ protected:
 	ComPtr<IDXGIAdapter4> m_Adapter;
 	ComPtr<ID3D12Device2> m_Device;
 	std::shared_ptr<CommandQueue> m_DirectCommandQueue;
+	// uploads are executed by copy queue, direct queue waits for them on GPU only where they are used
+	std::shared_ptr<CommandQueue> m_CopyCommandQueue;
+	// render targets and other not evictable resources are placed into shared heaps
+	std::unique_ptr<ResourceHeapAllocator> m_ResourceHeapAllocator;
+	// replaced resources and pipelines are released when frames in flight are finished, so GPU isn`t flushed
+	std::unique_ptr<DeferredReleaseQueue> m_DeferredReleaseQueue;
 	ComPtr<IDXGISwapChain4> m_SwapChain;
 	ComPtr<ID3D12Resource> m_BackBuffers[m_NumBackBuffers];
 	ComPtr<ID3D12Resource> m_DSBuffer;
+	PlacedAllocation m_DSBufferAllocation;
 	ComPtr<ID3D12DescriptorHeap> m_RTVDescHeap;
 	ComPtr<ID3D12DescriptorHeap> m_DSVDescHeap;
-	uint32_t m_BackBuffersFenceValues[m_NumBackBuffers];
 	uint32_t m_CurrentBackBufferIndex;
 	uint32_t m_RTVDescSize;
 	uint32_t m_CBV_SRV_UAVDescSize;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// dense remapping of sparse ids to slots of bindless table, e.g. of staging views to views of frame
+// slots are given in order of first use, clear takes time of number of used slots, not thread safe
+class BindlessRemap {
+public:
+	static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+	// ids are less than numIds
+	explicit BindlessRemap(uint32_t numIds = 0);
+
+	void Clear();
+
+	// returns slot of id, id which is not mapped yet takes next slot
+	uint32_t Add(uint32_t id);
+	// returns InvalidSlot if id is not mapped
+	uint32_t GetSlot(uint32_t id) const;
+
+	uint32_t GetNumSlots() const;
+	// id of each slot
+	const std::vector<uint32_t>& GetIds() const;
+
+private:
+	std::vector<uint32_t> m_Slots;
+	std::vector<uint32_t> m_Ids;
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <MyD3D12Lib/MipGenerator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// 4x4 pixels blocks, BC1 block is 8 bytes, others are 16 bytes
+// BC1 --- RGB, alpha is ignored, fast path for opaque textures
+// BC3 --- BC1 colors and interpolated alpha, fast path for textures with alpha
+// BC5 --- red and green channels, for tangent space normal maps
+// BC7 --- RGBA in mode 6, quality path
+enum class BlockFormat { BC1, BC3, BC5, BC7 };
+
+uint32_t GetBlockByteSize(BlockFormat format);
+
+// pixels are 16 RGBA8 pixels of block in row order
+void EncodeBC1Block(const uint8_t* pixels, uint8_t* block);
+void EncodeBC3Block(const uint8_t* pixels, uint8_t* block);
+void EncodeBC5Block(const uint8_t* pixels, uint8_t* block);
+void EncodeBC7Block(const uint8_t* pixels, uint8_t* block);
+
+// decoders are used for quality measurement, BC7 decoder supports only mode 6
+void DecodeBC1Block(const uint8_t* block, uint8_t* pixels);
+void DecodeBC3Block(const uint8_t* block, uint8_t* pixels);
+void DecodeBC5Block(const uint8_t* block, uint8_t* pixels);
+void DecodeBC7Block(const uint8_t* block, uint8_t* pixels);
+
+// rows of blocks are tightly packed, row pitch is number of blocks in row * block size
+struct CompressedLevel {
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t RowPitch = 0;
+	uint32_t NumRows = 0;
+	size_t Offset = 0;
+};
+
+struct CompressedMipChain {
+	BlockFormat Format = BlockFormat::BC1;
+	std::vector<uint8_t> Data;
+	std::vector<CompressedLevel> Levels;
+};
+
+// partial blocks on edges are padded with edge pixels
+// rows of blocks of all levels are encoded in parallel on pool if it is given
+CompressedMipChain CompressMipChain(const MipChain& chain, BlockFormat format, ThreadPool* pool = nullptr);
+
+// peak signal to noise ratio in dB over channels stored in format
+float ComputeCompressionPSNR(const MipChain& chain, const CompressedMipChain& compressed, uint32_t level = 0);
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <utility>
+#include <vector>
+
+// allocators of submitted lists are reused when fence value of their submission is completed, closed lists are reused at once
+// allocator of list being recorded is kept in side table, so it is found at submission without private data of list
+// lists submitted together share one fence value, so one signal covers all their allocators
+// it doesn`t depend on D3D12, so recycling can be run with simulated lists and fence, not thread safe
+template<class List, class Allocator>
+class CommandListPool {
+public:
+	// allocator which can be reset, false if GPU still uses allocators of all submissions
+	bool TakeAllocator(uint64_t completedFenceValue, Allocator& allocator) {
+		if (m_SubmittedAllocators.empty() || m_SubmittedAllocators.front().first > completedFenceValue) {
+			return false;
+		}
+
+		allocator = std::move(m_SubmittedAllocators.front().second);
+		m_SubmittedAllocators.pop_front();
+
+		return true;
+	}
+
+	// closed list which can be reset with other allocator
+	bool TakeList(List& list) {
+		if (m_FreeLists.empty()) {
+			return false;
+		}
+
+		list = std::move(m_FreeLists.back());
+		m_FreeLists.pop_back();
+
+		return true;
+	}
+
+	// list is recorded into allocator until it is submitted
+	void Open(const List& list, const Allocator& allocator) {
+		m_OpenLists.emplace_back(list, allocator);
+	}
+
+	// throws if any of lists isn`t open or it is given twice, queue checks lists before they are executed
+	void Validate(const List* lists, uint32_t numLists) const {
+		for (uint32_t i = 0; i < numLists; ++i) {
+			FindOpenList(lists[i]);
+
+			for (uint32_t j = 0; j < i; ++j) {
+				if (lists[j] == lists[i]) {
+					throw std::exception();
+				}
+			}
+		}
+	}
+
+	// lists are executed together in given order, fence value is signaled after the last of them
+	void Submit(const List* lists, uint32_t numLists, uint64_t fenceValue) {
+		assert((m_SubmittedAllocators.empty() || m_SubmittedAllocators.back().first <= fenceValue) && "Fence values should not decrease");
+
+		// pool isn`t changed if any of lists isn`t open
+		Validate(lists, numLists);
+
+		for (uint32_t i = 0; i < numLists; ++i) {
+			uint32_t index = FindOpenList(lists[i]);
+
+			m_SubmittedAllocators.emplace_back(fenceValue, std::move(m_OpenLists[index].second));
+			m_FreeLists.push_back(std::move(m_OpenLists[index].first));
+
+			// open lists are few, so order isn`t kept
+			if (index + 1 != m_OpenLists.size()) {
+				m_OpenLists[index] = std::move(m_OpenLists.back());
+			}
+
+			m_OpenLists.pop_back();
+		}
+
+		++m_NumSubmissions;
+		m_NumSubmittedLists += numLists;
+	}
+
+	uint32_t GetNumOpenLists() const {
+		return static_cast<uint32_t>(m_OpenLists.size());
+	}
+
+	uint32_t GetNumFreeLists() const {
+		return static_cast<uint32_t>(m_FreeLists.size());
+	}
+
+	// allocators waiting for fence values of their submissions
+	uint32_t GetNumSubmittedAllocators() const {
+		return static_cast<uint32_t>(m_SubmittedAllocators.size());
+	}
+
+	uint64_t GetNumSubmissions() const {
+		return m_NumSubmissions;
+	}
+
+	uint64_t GetNumSubmittedLists() const {
+		return m_NumSubmittedLists;
+	}
+
+private:
+	uint32_t FindOpenList(const List& list) const {
+		for (uint32_t i = 0; i < m_OpenLists.size(); ++i) {
+			if (m_OpenLists[i].first == list) {
+				return i;
+			}
+		}
+
+		// list isn`t taken from this pool or is already submitted
+		throw std::exception();
+	}
+
+	std::vector<std::pair<List, Allocator>> m_OpenLists;
+	std::vector<List> m_FreeLists;
+	// fence values are not decreasing, so allocators are completed in order
+	std::deque<std::pair<uint64_t, Allocator>> m_SubmittedAllocators;
+
+	uint64_t m_NumSubmissions = 0;
+	uint64_t m_NumSubmittedLists = 0;
+};
\ No newline at end of file
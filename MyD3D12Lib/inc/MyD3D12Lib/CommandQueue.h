@@ -1,5 +1,6 @@
 #pragma once
 
+#include <MyD3D12Lib/CommandListPool.h>
 #include <MyD3D12Lib/Helpers.h>
 
 #include <d3d12.h>
@@ -7,7 +8,7 @@
 #include <wrl.h>
 using Microsoft::WRL::ComPtr;
 
-#include <queue>
+#include <vector>
 
 class CommandQueue {
 public:
@@ -15,18 +16,26 @@ public:
 
 	~CommandQueue();
 
+	// list can be recorded by any thread, but it is taken and submitted by thread owning queue
 	ComPtr<ID3D12GraphicsCommandList> GetCommandList();
 
 	ComPtr<ID3D12CommandQueue> GetCommandQueue() const;
 
 	uint64_t ExecuteCommandList(ComPtr<ID3D12GraphicsCommandList> commandList);
+	// lists are executed by one call in given order and fence is signaled once after them
+	uint64_t ExecuteCommandLists(const std::vector<ComPtr<ID3D12GraphicsCommandList>>& commandLists);
 
 	bool IsFenceComplite(uint64_t fenceValue) const;
 
+	uint64_t GetCompletedFenceValue() const;
+
 	uint64_t Signal();
 
 	void WaitForFenceValue(uint64_t fenceValue);
 
+	// queue waits on GPU for fence value of other queue, CPU isn`t blocked
+	void Wait(const CommandQueue& other, uint64_t fenceValue);
+
 	void Flush();
 	
 	void CloseHandle();
@@ -36,16 +45,9 @@ private:
 
 	ComPtr<ID3D12GraphicsCommandList> CreateCommandList(ComPtr<ID3D12CommandAllocator> commandAllocator);
 
-	struct CommandAllocatorEntry {
-		ComPtr<ID3D12CommandAllocator> CommandAllocator;
-		uint64_t fenceValue;
-	};
-
-	using CommandAllocatorsQueue = std::queue<CommandAllocatorEntry>;
-	using CommandListQueue = std::queue < ComPtr<ID3D12GraphicsCommandList> >;
-
-	CommandAllocatorsQueue m_CommandAllocators;
-	CommandListQueue m_CommandLists;
+	CommandListPool<ComPtr<ID3D12GraphicsCommandList>, ComPtr<ID3D12CommandAllocator>> m_CommandListPool;
+	// lists of submission, kept to not allocate them each time
+	std::vector<ID3D12CommandList*> m_SubmittedLists;
 	D3D12_COMMAND_LIST_TYPE m_CommandListType;
 	ComPtr<ID3D12Device2> m_Device;
 	ComPtr<ID3D12CommandQueue> m_CommandQueue;
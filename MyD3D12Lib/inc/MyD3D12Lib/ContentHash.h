@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct Hash128 {
+	uint64_t Low = 0;
+	uint64_t High = 0;
+
+	bool operator==(const Hash128& other) const {
+		return Low == other.Low && High == other.High;
+	}
+
+	bool operator!=(const Hash128& other) const {
+		return !(*this == other);
+	}
+};
+
+// for unordered containers, hash is already well mixed
+struct Hash128Hasher {
+	size_t operator()(const Hash128& hash) const {
+		return static_cast<size_t>(hash.Low);
+	}
+};
+
+// fast non cryptographic hash for content deduplication, not for security
+// data is accumulated in 64 bytes stripes, AVX2 or SSE2 is used if supported by CPU
+// seed can be used to chain hashes of several buffers
+Hash128 ComputeContentHash(const void* data, size_t size, uint64_t seed = 0);
+
+// scalar reference version, results are equal
+Hash128 ComputeContentHashScalar(const void* data, size_t size, uint64_t seed = 0);
\ No newline at end of file
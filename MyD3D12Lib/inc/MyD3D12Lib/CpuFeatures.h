@@ -0,0 +1,15 @@
+#pragma once
+
+// SIMD paths are compiled with function level target attributes and selected at runtime
+#if defined(_MSC_VER)
+	#define SIMD_TARGET_AVX2
+	#define SIMD_TARGET_SSE41
+#else
+	#define SIMD_TARGET_AVX2 __attribute__((target("avx2,f16c,fma")))
+	#define SIMD_TARGET_SSE41 __attribute__((target("sse4.1")))
+#endif
+
+// AVX2 together with F16C and FMA, all of them present since Haswell
+bool IsAVX2Supported();
+
+bool IsSSE41Supported();
\ No newline at end of file
@@ -7,7 +7,15 @@
 #include <wrl.h>
 using Microsoft::WRL::ComPtr;
 
+#include <MyD3D12Lib/MappedFile.h>
+#include <MyD3D12Lib/MipGenerator.h>
+#include <MyD3D12Lib/ResourceHeapAllocator.h>
+#include <MyD3D12Lib/TextureRegistry.h>
+
+#include <filesystem>
+#include <memory>
 #include <string>
+#include <vector>
 
 // compile shader from file
 ComPtr<ID3DBlob> CompileShader(
@@ -17,7 +25,92 @@ ComPtr<ID3DBlob> CompileShader(
 	const D3D_SHADER_MACRO* defines = NULL
 );
 
+// residency
+// size of resource in video memory including alignment
+uint64_t GetResourceAllocationSize(ComPtr<ID3D12Device2> device, ID3D12Resource* resource);
+
+// null resources are skipped, content of evicted resources is kept by OS
+void EvictResources(ComPtr<ID3D12Device2> device, const std::vector<ID3D12Resource*>& resources);
+void MakeResourcesResident(ComPtr<ID3D12Device2> device, const std::vector<ID3D12Resource*>& resources);
+
 // texture loading
+// decoded texture, resource is created in copy destination state but not filled yet
+struct DecodedTexture {
+	ComPtr<ID3D12Resource> Resource;
+	// description of resource with all mips, it is kept if resource is released, e.g. for mip streaming
+	D3D12_RESOURCE_DESC Desc = {};
+	std::unique_ptr<uint8_t[]> Data;
+	// CPU generated mips, if requested
+	MipChain Mips;
+	// mapped file subresources point into, if texture is loaded from mapping
+	MappedFile Mapping;
+	std::vector<D3D12_SUBRESOURCE_DATA> Subresources;
+};
+
+std::vector<uint8_t> ReadFileData(const std::filesystem::path& fileName);
+// data is written to temporary file which is renamed, so readers never see partial file
+void WriteFileData(const std::filesystem::path& fileName, const std::vector<uint8_t>& data);
+
+// can be called from worker threads, COM should be initialized on calling thread
+// if mipDesc is given, texture is decoded to RGBA8 and full mip chain is generated on CPU
+DecodedTexture DecodeWICTextureFromMemory(
+	ComPtr<ID3D12Device2> device,
+	const uint8_t* data,
+	size_t dataSize,
+	const MipGenerationDesc* mipDesc = nullptr
+);
+
+DecodedTexture DecodeDDSTextureFromFile(
+	ComPtr<ID3D12Device2> device,
+	const std::filesystem::path& fileName
+);
+
+// file is mapped and subresources point into mapping, so data is copied only once into upload buffer
+// supports 2D textures, arrays and cube maps, throws for unsupported or broken files
+DecodedTexture DecodeDDSTextureFromMappedFile(
+	ComPtr<ID3D12Device2> device,
+	const std::filesystem::path& fileName
+);
+
+// 1x1 RGBA8 texture, e.g. placeholder for textures which are not loaded yet
+DecodedTexture CreateSolidColorTexture(
+	ComPtr<ID3D12Device2> device,
+	uint8_t r, uint8_t g, uint8_t b, uint8_t a,
+	bool isSRGB
+);
+
+// content hash of all subresources together with format and size
+TextureContentKey ComputeTextureContentKey(const DecodedTexture& texture);
+uint64_t GetTextureDataSize(const DecodedTexture& texture);
+
+// records copy of decoded data to texture and transition to pixel shader resource
+// list of copy queue records no barriers, texture decays to common state after it and is promoted when it is read
+void RecordTextureUpload(
+	ComPtr<ID3D12Device2> device,
+	ComPtr<ID3D12GraphicsCommandList> commandList,
+	const DecodedTexture& texture,
+	ComPtr<ID3D12Resource>& uploadResource
+);
+
+bool IsBlockCompressedFormat(DXGI_FORMAT format);
+
+// coarsest mip texture can start from, top mip of block compressed texture should be multiple of block size
+uint32_t GetMaxFirstMip(const D3D12_RESOURCE_DESC& desc);
+
+// creates texture with mips of decoded texture starting from firstMip and records their upload
+// mips present in resident resource, which starts from residentFirstMip, are copied on GPU instead of upload
+// resident resource should be in pixel shader resource state and is returned to it, new one ends in the same state
+// on copy queue resident resource should be in common state, no barriers are recorded and both resources decay to common state
+ComPtr<ID3D12Resource> RecordTextureMipsUpdate(
+	ComPtr<ID3D12Device2> device,
+	ComPtr<ID3D12GraphicsCommandList> commandList,
+	const DecodedTexture& texture,
+	uint32_t firstMip,
+	ID3D12Resource* residentResource,
+	uint32_t residentFirstMip,
+	ComPtr<ID3D12Resource>& uploadResource
+);
+
 void CreateDDSTextureFromFile(
 	ComPtr<ID3D12Device2> device,
 	ComPtr<ID3D12GraphicsCommandList> commandList,
@@ -59,12 +152,15 @@ ComPtr<IDXGISwapChain4> CreateSwapChain(
 	bool allowTearing
 );
 
+// buffer is placed into heap of allocator if it is given
 ComPtr<ID3D12Resource> CreateDepthStencilBuffer(
 	ComPtr<ID3D12Device2> device,
 	uint32_t width, uint32_t height,
 	DXGI_FORMAT bufferFormat, DXGI_FORMAT viewFormat,
 	float depthClearValue,
-	uint8_t stencilClearValue
+	uint8_t stencilClearValue,
+	ResourceHeapAllocator* allocator = nullptr,
+	PlacedAllocation* allocation = nullptr
 );
 
 ComPtr<ID3D12DescriptorHeap> CreateDescriptorHeap(
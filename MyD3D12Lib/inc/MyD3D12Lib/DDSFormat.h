@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+
+// DDS file layout: magic, header, optional DX10 header, subresources data
+// subresources are stored by array slices, all mips of slice one after another
+const uint32_t DDSMagic = 0x20534444; // "DDS "
+
+const uint32_t DDSFlagCaps = 0x1;
+const uint32_t DDSFlagHeight = 0x2;
+const uint32_t DDSFlagWidth = 0x4;
+const uint32_t DDSFlagPixelFormat = 0x1000;
+const uint32_t DDSFlagMipMapCount = 0x20000;
+const uint32_t DDSFlagLinearSize = 0x80000;
+const uint32_t DDSFlagDepth = 0x800000;
+
+const uint32_t DDSPixelFormatAlphaPixels = 0x1;
+const uint32_t DDSPixelFormatFourCC = 0x4;
+const uint32_t DDSPixelFormatRGB = 0x40;
+const uint32_t DDSPixelFormatLuminance = 0x20000;
+
+const uint32_t DDSCapsComplex = 0x8;
+const uint32_t DDSCapsTexture = 0x1000;
+const uint32_t DDSCapsMipMap = 0x400000;
+
+const uint32_t DDSCaps2CubeMap = 0x200;
+const uint32_t DDSCaps2CubeMapAllFaces = 0xFC00;
+const uint32_t DDSCaps2Volume = 0x200000;
+
+const uint32_t DDSDimensionTexture2D = 3;
+const uint32_t DDSDimensionTexture3D = 4;
+const uint32_t DDSMiscFlagTextureCube = 0x4;
+
+// DXGI format values stored in DDS files, equal to DXGI_FORMAT ones
+// defined here, so DDS parsing and writing don`t depend on Windows headers
+enum class DXGIFormat : uint32_t {
+	Unknown = 0,
+	R32G32B32A32Typeless = 1,
+	R32G32B32A32Float = 2,
+	R32G32B32A32Uint = 3,
+	R32G32B32A32Sint = 4,
+	R16G16B16A16Typeless = 9,
+	R16G16B16A16Float = 10,
+	R16G16B16A16Unorm = 11,
+	R16G16B16A16Uint = 12,
+	R16G16B16A16Snorm = 13,
+	R16G16B16A16Sint = 14,
+	R32G32Typeless = 15,
+	R32G32Float = 16,
+	R32G32Uint = 17,
+	R32G32Sint = 18,
+	R10G10B10A2Typeless = 23,
+	R10G10B10A2Unorm = 24,
+	R10G10B10A2Uint = 25,
+	R11G11B10Float = 26,
+	R8G8B8A8Typeless = 27,
+	R8G8B8A8Unorm = 28,
+	R8G8B8A8UnormSRGB = 29,
+	R8G8B8A8Uint = 30,
+	R8G8B8A8Snorm = 31,
+	R8G8B8A8Sint = 32,
+	R16G16Typeless = 33,
+	R16G16Float = 34,
+	R16G16Unorm = 35,
+	R16G16Uint = 36,
+	R16G16Snorm = 37,
+	R16G16Sint = 38,
+	R32Typeless = 39,
+	R32Float = 41,
+	R32Uint = 42,
+	R32Sint = 43,
+	R8G8Typeless = 48,
+	R8G8Unorm = 49,
+	R8G8Uint = 50,
+	R8G8Snorm = 51,
+	R8G8Sint = 52,
+	R16Typeless = 53,
+	R16Float = 54,
+	R16Unorm = 56,
+	R16Uint = 57,
+	R16Snorm = 58,
+	R16Sint = 59,
+	R8Typeless = 60,
+	R8Unorm = 61,
+	R8Uint = 62,
+	R8Snorm = 63,
+	R8Sint = 64,
+	A8Unorm = 65,
+	R9G9B9E5SharedExp = 67,
+	BC1Typeless = 70,
+	BC1Unorm = 71,
+	BC1UnormSRGB = 72,
+	BC2Typeless = 73,
+	BC2Unorm = 74,
+	BC2UnormSRGB = 75,
+	BC3Typeless = 76,
+	BC3Unorm = 77,
+	BC3UnormSRGB = 78,
+	BC4Typeless = 79,
+	BC4Unorm = 80,
+	BC4Snorm = 81,
+	BC5Typeless = 82,
+	BC5Unorm = 83,
+	BC5Snorm = 84,
+	B5G6R5Unorm = 85,
+	B5G5R5A1Unorm = 86,
+	B8G8R8A8Unorm = 87,
+	B8G8R8X8Unorm = 88,
+	B8G8R8A8Typeless = 90,
+	B8G8R8A8UnormSRGB = 91,
+	B8G8R8X8Typeless = 92,
+	B8G8R8X8UnormSRGB = 93,
+	BC6HTypeless = 94,
+	BC6HUF16 = 95,
+	BC6HSF16 = 96,
+	BC7Typeless = 97,
+	BC7Unorm = 98,
+	BC7UnormSRGB = 99
+};
+
+struct DDSPixelFormat {
+	uint32_t Size;
+	uint32_t Flags;
+	uint32_t FourCC;
+	uint32_t RGBBitCount;
+	uint32_t RBitMask;
+	uint32_t GBitMask;
+	uint32_t BBitMask;
+	uint32_t ABitMask;
+};
+
+struct DDSHeader {
+	uint32_t Size;
+	uint32_t Flags;
+	uint32_t Height;
+	uint32_t Width;
+	uint32_t PitchOrLinearSize;
+	uint32_t Depth;
+	uint32_t MipMapCount;
+	uint32_t Reserved1[11];
+	DDSPixelFormat PixelFormat;
+	uint32_t Caps;
+	uint32_t Caps2;
+	uint32_t Caps3;
+	uint32_t Caps4;
+	uint32_t Reserved2;
+};
+
+struct DDSHeaderDX10 {
+	uint32_t DXGIFormat;
+	uint32_t ResourceDimension;
+	uint32_t MiscFlag;
+	uint32_t ArraySize;
+	uint32_t MiscFlags2;
+};
+
+static_assert(sizeof(DDSHeader) == 124, "DDS header size is fixed by format");
+static_assert(sizeof(DDSHeaderDX10) == 20, "DDS DX10 header size is fixed by format");
+
+constexpr uint32_t MakeDDSFourCC(char a, char b, char c, char d) {
+	return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// subresource location inside DDS file, rows are rows of blocks for block compressed formats
+struct DDSSubresourceLayout {
+	size_t Offset = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t RowPitch = 0;
+	uint32_t NumRows = 0;
+	uint64_t SlicePitch = 0;
+};
+
+// Format is DXGI format value, ArraySize counts cube faces
+// subresources are in D3D12 order: mip + slice * MipLevels
+struct DDSTextureInfo {
+	uint32_t Format = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t MipLevels = 0;
+	uint32_t ArraySize = 0;
+	bool IsCubeMap = false;
+	std::vector<DDSSubresourceLayout> Subresources;
+};
+
+// parses header in place and computes layout of 2D textures, arrays and cube maps
+// legacy headers are supported for DXTn, ATI1/ATI2 and 8 bit per channel RGBA, BGRA and luminance
+// returns false for invalid, truncated or unsupported files, never reads outside of data
+bool ParseDDS(const uint8_t* data, size_t size, DDSTextureInfo& info);
\ No newline at end of file
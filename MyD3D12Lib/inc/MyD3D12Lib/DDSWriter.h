@@ -0,0 +1,12 @@
+#pragma once
+
+#include <MyD3D12Lib/BlockCompression.h>
+#include <MyD3D12Lib/DDSFormat.h>
+
+#include <cstdint>
+#include <vector>
+
+DXGIFormat GetBlockFormatDXGI(BlockFormat format);
+
+// DDS file with DX10 header, readable by DDS texture loader
+std::vector<uint8_t> BuildDDSFile(const CompressedMipChain& chain);
\ No newline at end of file
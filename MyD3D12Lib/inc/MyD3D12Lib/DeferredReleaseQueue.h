@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// objects replaced while frames in flight can use them are pushed with fence value of last submitted work
+// replacements are created at once, old objects are released when fence value is completed instead of waiting for idle GPU
+// any thread pushes without locks into intrusive stack, one thread takes it and releases completed objects
+// it doesn`t depend on D3D12, release function owns objects, they are released with it
+class DeferredReleaseQueue {
+public:
+	DeferredReleaseQueue() = default;
+	// pending objects are released, GPU should be idle
+	~DeferredReleaseQueue();
+
+	DeferredReleaseQueue(const DeferredReleaseQueue& other) = delete;
+	DeferredReleaseQueue& operator=(const DeferredReleaseQueue& other) = delete;
+
+	// lock free, can be called by any thread
+	void Push(uint64_t fenceValue, std::function<void()> release);
+
+	// only by one thread, returns number of released objects
+	uint32_t ReleaseCompleted(uint64_t completedFenceValue);
+	// only by one thread when GPU is idle
+	uint32_t ReleaseAll();
+
+	// objects taken by releasing thread, not counting ones pushed after last release
+	uint32_t GetNumPending() const;
+	uint64_t GetNumReleased() const;
+
+private:
+	struct Node {
+		uint64_t FenceValue;
+		std::function<void()> Release;
+		Node* Next;
+	};
+
+	void TakePushed();
+
+	std::atomic<Node*> m_Pushed{ nullptr };
+
+	// fence values of producers can come in any order, so all pending objects are checked
+	std::vector<std::pair<uint64_t, std::function<void()>>> m_Pending;
+	uint64_t m_NumReleased = 0;
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <MyD3D12Lib/DescriptorIndexAllocator.h>
+
+#include <d3d12.h>
+
+#include <wrl.h>
+using Microsoft::WRL::ComPtr;
+
+#include <cstdint>
+#include <vector>
+
+// descriptor heap with persistent ranges allocated from free lists and optional ring of per frame descriptors after them
+// CPU only heap is staging one, its descriptors are copied into ring of shader visible heap by one CopyDescriptors call
+// persistent ranges of shader visible heap are freed with fence value, not thread safe
+class DescriptorAllocator {
+public:
+	DescriptorAllocator(
+		ComPtr<ID3D12Device2> device,
+		D3D12_DESCRIPTOR_HEAP_TYPE type,
+		uint32_t numDescriptors,
+		bool isShaderVisible,
+		uint32_t numRingDescriptorsPerFrame = 0,
+		uint32_t numFrames = 0
+	);
+
+	DescriptorAllocator(const DescriptorAllocator& other) = delete;
+	DescriptorAllocator& operator=(const DescriptorAllocator& other) = delete;
+
+	// throws if there are no count adjacent free descriptors
+	DescriptorRange Allocate(uint32_t count);
+
+	// descriptors of shader visible heap may be read by frames in flight, so fence value of last of them is given
+	void Free(DescriptorRange& range, uint64_t fenceValue = 0);
+	void ReleaseCompleted(uint64_t completedFenceValue);
+
+	// partition of frame is reused, queued copies should be flushed before it
+	void BeginFrame(uint32_t frame);
+	// throws if partition of frame is full
+	uint32_t AllocateRing(uint32_t count);
+
+	// copies are made by FlushCopies, src is descriptor of CPU only heap
+	void QueueCopy(D3D12_CPU_DESCRIPTOR_HANDLE src, uint32_t dstIndex, uint32_t count = 1);
+	void FlushCopies();
+
+	ID3D12DescriptorHeap* GetHeap() const;
+	D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle(uint32_t index) const;
+	D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle(uint32_t index) const;
+
+	const DescriptorIndexAllocator& GetIndexAllocator() const;
+	const DescriptorRing& GetRing() const;
+
+private:
+	ComPtr<ID3D12Device2> m_Device;
+	D3D12_DESCRIPTOR_HEAP_TYPE m_Type;
+	ComPtr<ID3D12DescriptorHeap> m_Heap;
+	uint32_t m_DescriptorSize;
+
+	DescriptorIndexAllocator m_IndexAllocator;
+	DescriptorRing m_Ring;
+
+	std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_CopiesSrcs;
+	std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_CopiesDsts;
+	std::vector<UINT> m_CopiesSizes;
+};
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <MyD3D12Lib/TLSFAllocator.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct DescriptorRange {
+	uint32_t Index = UINT32_MAX;
+	uint32_t Count = 0;
+	// range in free lists, it is needed to free range in constant time
+	TLSFAllocation Allocation;
+
+	bool IsValid() const {
+		return Allocation.IsValid();
+	}
+};
+
+// indexes of descriptors in heap, free ranges are kept in lists by size classes, so any range can be freed
+// GPU can still read freed descriptors, so they are reused only after fence value given on free is completed
+// it manages indexes only, heap is not touched, not thread safe
+class DescriptorIndexAllocator {
+public:
+	// index of descriptor which is not allocated yet
+	static const uint32_t InvalidIndex = UINT32_MAX;
+
+	DescriptorIndexAllocator(uint32_t firstIndex, uint32_t numDescriptors);
+
+	// returns invalid range if there are no count adjacent free descriptors
+	DescriptorRange Allocate(uint32_t count);
+
+	// 0 fence value frees range at once, e.g. range of CPU only heap, range is invalid after it
+	void Free(DescriptorRange& range, uint64_t fenceValue = 0);
+
+	// returns number of reclaimed descriptors
+	uint32_t ReleaseCompleted(uint64_t completedFenceValue);
+
+	uint32_t GetFirstIndex() const;
+	uint32_t GetNumDescriptors() const;
+	// descriptors waiting for fence are used
+	uint32_t GetNumUsed() const;
+	uint32_t GetNumPending() const;
+	uint32_t GetNumAllocations() const;
+	float GetFragmentation() const;
+
+private:
+	uint32_t m_FirstIndex;
+	TLSFAllocator m_Allocator;
+
+	std::vector<std::pair<uint64_t, TLSFAllocation>> m_PendingFrees;
+	uint32_t m_NumPending = 0;
+};
+
+// linear allocator of descriptors used by one frame, region is split into partition per frame in flight
+// partition is reset when its frame starts again, so frame which used it before should be finished on GPU
+class DescriptorRing {
+public:
+	DescriptorRing(uint32_t firstIndex, uint32_t numDescriptorsPerFrame, uint32_t numFrames);
+
+	void BeginFrame(uint32_t frame);
+
+	// returns DescriptorIndexAllocator::InvalidIndex if partition of current frame is full
+	uint32_t Allocate(uint32_t count);
+
+	uint32_t GetNumDescriptorsPerFrame() const;
+	uint32_t GetNumFrames() const;
+	uint32_t GetNumUsed() const;
+
+private:
+	uint32_t m_FirstIndex;
+	uint32_t m_NumDescriptorsPerFrame;
+	uint32_t m_NumFrames;
+
+	uint32_t m_Frame = 0;
+	uint32_t m_NumUsed = 0;
+};
\ No newline at end of file
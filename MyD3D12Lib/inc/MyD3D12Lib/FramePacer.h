@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// throughput mode lets CPU record while GPU executes all other frames in flight
+// latency mode keeps one frame less in flight, so input is older by one frame, with two frames in flight CPU waits for previous frame
+enum class FramePacingMode {
+	Throughput = 0,
+	Latency
+};
+
+// frames in flight are independent of number of back buffers, each of them has slot of frame resources
+// CPU waits only when frame it records needs slot still used by GPU or when latency mode limits queued frames
+// pacer only decides which fence value should be completed, waiting is done by caller, it doesn`t depend on D3D12
+// fence values are of one queue which executes frames, not thread safe
+class FramePacer {
+public:
+	FramePacer(uint32_t numFramesInFlight, FramePacingMode mode = FramePacingMode::Throughput);
+
+	// slot of frame resources of frame which is recorded
+	uint32_t GetFrameSlot() const;
+	// fence value which should be completed before frame resources of slot are written, 0 if there is no such frame
+	uint64_t GetWaitFenceValue() const;
+	// frame is submitted, its slot is reused after fence value is completed
+	void EndFrame(uint64_t fenceValue);
+
+	// mode can be switched between frames, next frame waits by new mode
+	void SetMode(FramePacingMode mode);
+	FramePacingMode GetMode() const;
+
+	uint32_t GetNumFramesInFlight() const;
+	// number of submitted frames
+	uint64_t GetNumFrames() const;
+	// frames before it are finished on GPU when caller waited for fence value of current frame
+	uint64_t GetFirstUnfinishedFrame() const;
+
+	// time CPU waited for GPU before frame, it is measured by caller
+	void AddStall(double time);
+	uint64_t GetNumStalls() const;
+	double GetStallTime() const;
+
+private:
+	// frames which can be in flight when frame is recorded, including it, there is always at least the recorded one
+	uint32_t GetMaxQueuedFrames() const;
+
+	uint32_t m_NumFramesInFlight;
+	FramePacingMode m_Mode;
+	uint64_t m_NumFrames = 0;
+
+	// fence values of last frames, indexed by slot
+	std::vector<uint64_t> m_FenceValues;
+
+	uint64_t m_NumStalls = 0;
+	double m_StallTime = 0.0;
+};
\ No newline at end of file
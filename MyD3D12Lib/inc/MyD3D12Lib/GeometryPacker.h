@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// shared index buffers, meshes with more vertexes than 16 bit index can address go to 32 bit pool
+enum class IndexPool : uint32_t {
+	Index16 = 0,
+	Index32 = 1,
+	Count
+};
+
+struct PackedMesh {
+	IndexPool Pool = IndexPool::Index16;
+	uint32_t VertexCount = 0;
+	uint32_t IndexCount = 0;
+	uint32_t BaseVertexLocation = 0;
+	uint32_t StartIndexLocation = 0;
+};
+
+// plans placement of many meshes in few shared vertex and index buffers
+class GeometryPacker {
+public:
+	static constexpr uint32_t MaxIndex16Vertexes = 1u << 16;
+
+	explicit GeometryPacker(
+		uint32_t vertexAlignment = 1,
+		uint32_t indexAlignment = 2,
+		uint32_t minCapacity = 1024
+	);
+
+	static IndexPool ChoosePool(uint32_t numVertexes);
+	static uint32_t GetIndexByteStride(IndexPool pool);
+
+	// reserve exact capacity then all meshes are known beforehand
+	void Reserve(uint32_t numVertexes, uint32_t numIndexes16, uint32_t numIndexes32);
+
+	// returns mesh placement, capacity grows geometrically if mesh does not fit
+	PackedMesh AddMesh(uint32_t numVertexes, uint32_t numIndexes);
+	PackedMesh AddMesh(uint32_t numVertexes, uint32_t numIndexes, IndexPool pool);
+
+	uint32_t GetNumVertexes() const;
+	uint32_t GetNumIndexes(IndexPool pool) const;
+
+	uint32_t GetVertexCapacity() const;
+	uint32_t GetIndexCapacity(IndexPool pool) const;
+
+	// true if capacity changed since last call, then GPU buffers should be recreated
+	bool CheckAndResetGrown();
+
+	const std::vector<PackedMesh>& GetMeshes() const;
+
+	void Reset();
+
+private:
+	static uint32_t AlignUp(uint32_t value, uint32_t alignment);
+	uint32_t Grow(uint32_t capacity, uint32_t required) const;
+
+private:
+	uint32_t m_VertexAlignment;
+	uint32_t m_IndexAlignment;
+	uint32_t m_MinCapacity;
+
+	uint32_t m_NumVertexes = 0;
+	uint32_t m_VertexCapacity = 0;
+	uint32_t m_NumIndexes[static_cast<uint32_t>(IndexPool::Count)] = {};
+	uint32_t m_IndexCapacity[static_cast<uint32_t>(IndexPool::Count)] = {};
+	bool m_IsGrown = false;
+
+	std::vector<PackedMesh> m_Meshes;
+};
\ No newline at end of file
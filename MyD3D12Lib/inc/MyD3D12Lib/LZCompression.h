@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// byte oriented LZ77 codec in spirit of LZ4, tuned for decompression speed rather than ratio
+// block is sequence of literals and matches within 64 KiB window, blocks are independent of each other
+
+// compressed size never exceeds it, even for incompressible data
+size_t GetLZMaxCompressedSize(size_t size);
+
+// dst should have at least GetLZMaxCompressedSize(srcSize) bytes, returns compressed size
+size_t CompressLZ(const uint8_t* src, size_t srcSize, uint8_t* dst);
+
+// dstSize is exact size of decompressed data, throws if data is broken, never writes outside of dst
+void DecompressLZ(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
\ No newline at end of file
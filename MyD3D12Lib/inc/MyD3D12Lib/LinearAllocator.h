@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+struct LinearAllocation {
+	uint32_t Page = UINT32_MAX;
+	uint64_t Offset = 0;
+
+	bool IsValid() const {
+		return Page != UINT32_MAX;
+	}
+};
+
+// bump allocator of ranges in pages of the same size, e.g. of upload buffers with constants of frame
+// allocation which doesn`t fit into current page takes next free page or new one, page id equal to number of pages is new
+// pages used by frame are retired with its fence value and reused when it is completed
+// it manages offsets only, memory is not touched, not thread safe
+class LinearAllocator {
+public:
+	explicit LinearAllocator(uint64_t pageSize);
+
+	// alignment is power of two, size is not bigger than page
+	LinearAllocation Allocate(uint64_t size, uint64_t alignment);
+
+	// fence values are increasing, pages are reused after fence value is completed
+	void Retire(uint64_t fenceValue);
+	void ReleaseCompleted(uint64_t completedFenceValue);
+
+	uint64_t GetPageSize() const;
+	uint32_t GetNumPages() const;
+	uint32_t GetNumFreePages() const;
+	// bytes allocated since last retire, including alignment padding
+	uint64_t GetUsedSize() const;
+
+private:
+	uint64_t m_PageSize;
+	uint32_t m_NumPages = 0;
+
+	uint32_t m_CurrentPage = UINT32_MAX;
+	uint64_t m_CurrentOffset = 0;
+	uint64_t m_UsedSize = 0;
+
+	// pages filled since last retire, current page is not in them
+	std::vector<uint32_t> m_UsedPages;
+	std::vector<uint32_t> m_FreePages;
+	std::deque<std::pair<uint64_t, uint32_t>> m_RetiredPages;
+};
\ No newline at end of file
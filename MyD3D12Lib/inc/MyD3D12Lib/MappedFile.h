@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// read only memory mapping of whole file, pages are loaded by OS on first access
+class MappedFile {
+public:
+	MappedFile() = default;
+	// throws if file can`t be opened or mapped
+	explicit MappedFile(const std::filesystem::path& fileName);
+
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile& operator=(const MappedFile& other) = delete;
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	~MappedFile();
+
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+
+private:
+	void Close();
+
+	const uint8_t* m_Data = nullptr;
+	size_t m_Size = 0;
+
+#if defined(_WIN32)
+	void* m_FileHandle = nullptr;
+	void* m_MappingHandle = nullptr;
+#else
+	int m_FileDescriptor = -1;
+#endif
+};
\ No newline at end of file
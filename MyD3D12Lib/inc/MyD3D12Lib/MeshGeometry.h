@@ -20,12 +20,17 @@ struct SubmeshGeometry {
 struct MeshGeometry {
 	std::string name;
 
+	// optional position only stream, vertex buffer keeps other attributes then
+	ComPtr<ID3D12Resource> PositionBufferGPU = nullptr;
 	ComPtr<ID3D12Resource> VertexBufferGPU = nullptr;
 	ComPtr<ID3D12Resource> IndexBufferGPU = nullptr;
 
+	ComPtr<ID3D12Resource> PositionBufferUploader = nullptr;
 	ComPtr<ID3D12Resource> VertexBufferUploader = nullptr;
 	ComPtr<ID3D12Resource> IndexBufferUploader = nullptr;
 
+	uint32_t PositionByteStride = 0;
+	uint32_t PositionBufferByteSize = 0;
 	uint32_t VertexByteStride = 0;
 	uint32_t VertexBufferByteSize = 0;
 	DXGI_FORMAT IndexBufferFormat = DXGI_FORMAT_R16_UINT;
@@ -33,6 +38,8 @@ struct MeshGeometry {
 
 	std::unordered_map<std::string, SubmeshGeometry> DrawArgs;
 
+	D3D12_VERTEX_BUFFER_VIEW PositionBufferView() const;
+
 	D3D12_VERTEX_BUFFER_VIEW VertexBufferView() const;
 	
 	D3D12_INDEX_BUFFER_VIEW IndexBufferView() const;
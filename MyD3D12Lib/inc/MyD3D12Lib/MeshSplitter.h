@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// part of mesh addressable by 16 bit indexes
+struct MeshChunk {
+	// source vertexes indexes in order of first use by chunk triangles
+	std::vector<uint32_t> Vertexes;
+	// triangle list indexes local to chunk vertexes
+	std::vector<uint16_t> Indexes;
+};
+
+// greedily partitions triangle list in original order, so vertex cache locality is preserved
+// new chunk is started when next triangle doesn't fit in maxChunkVertexes
+// vertexes shared by triangles of different chunks are duplicated in each of them
+std::vector<MeshChunk> SplitMesh(
+	const uint32_t* indexes,
+	uint32_t numIndexes,
+	uint32_t numVertexes,
+	uint32_t maxChunkVertexes = 1u << 16
+);
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class MipFilter { Box, Kaiser };
+
+struct MipGenerationDesc {
+	MipFilter Filter = MipFilter::Box;
+	// color channels are filtered in linear space, alpha is always linear
+	bool IsSRGB = true;
+	// alpha test reference, alpha of each mip is rescaled to keep coverage of top level
+	// disabled if not positive
+	float AlphaCoverageReference = 0.0f;
+};
+
+// level rows are tightly packed, row pitch is Width * 4
+struct MipLevel {
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	size_t Offset = 0;
+};
+
+// RGBA8 mip chain, level 0 is source image
+struct MipChain {
+	std::vector<uint8_t> Data;
+	std::vector<MipLevel> Levels;
+};
+
+// full chain down to 1x1, each level size is max(1, size / 2)
+uint32_t GetNumMipLevels(uint32_t width, uint32_t height);
+
+// non power of two levels are filtered with fractional footprints, edges are clamped
+// numLevels equal to zero means full chain
+// SSE is used for horizontal pass, AVX2 for vertical pass if supported by CPU
+MipChain GenerateMipChain(
+	const uint8_t* pixels,
+	uint32_t width,
+	uint32_t height,
+	uint32_t rowPitch,
+	const MipGenerationDesc& desc,
+	uint32_t numLevels = 0
+);
+
+// scalar reference version
+MipChain GenerateMipChainScalar(
+	const uint8_t* pixels,
+	uint32_t width,
+	uint32_t height,
+	uint32_t rowPitch,
+	const MipGenerationDesc& desc,
+	uint32_t numLevels = 0
+);
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// square root of texture coordinates area per unit of model space area over all triangles
+// texels per model space unit are density multiplied by texture size, degenerate triangles are skipped
+// positions are float3 and texture coordinates are float2 with given strides, returns 0 for mesh without area
+float ComputeMeshUVDensity(
+	const float* positions,
+	uint32_t positionStride,
+	const float* texCoords,
+	uint32_t texCoordStride,
+	const uint32_t* indexes,
+	uint32_t numIndexes
+);
+
+// finest mip which still has at least one texel per screen pixel
+// textureSize is texels along one texture coordinate, screen height is in pixels
+// negative result means texture is magnified, callers should clamp it to their mip range
+float ComputeRequiredMip(
+	float uvDensity,
+	float textureSize,
+	float distance,
+	float screenHeight,
+	float tanHalfFoV
+);
+
+// chooses first resident mip for each texture so that all resident mips fit into budget
+// required mips are taken as is while they fit, otherwise mips which are least under resolved are dropped
+// mips are dropped only when required mip is coarser than resident one by hysteresis, so small camera moves don`t stream them in and out
+class MipBudgetSolver {
+public:
+	MipBudgetSolver(uint32_t numTextures, uint64_t budget, float hysteresis = 0.5f);
+
+	// mipsSizes are sizes of all mips from finest one, mips coarser than maxFirstMip are always resident
+	// e.g. block compressed texture can`t start from mip smaller than block
+	void SetTextureMips(uint32_t id, const std::vector<uint64_t>& mipsSizes, uint32_t maxFirstMip);
+
+	void SetBudget(uint64_t budget);
+
+	// requiredMips are computed for all textures each frame, FLT_MAX for textures which are not used
+	// returns first resident mip for each texture, textures without mips are left at 0
+	const std::vector<uint32_t>& Solve(const std::vector<float>& requiredMips);
+
+	uint32_t GetFirstMip(uint32_t id) const;
+	bool HasMips(uint32_t id) const;
+
+	// size of all textures with their current first mips
+	uint64_t GetResidentSize() const;
+
+private:
+	uint32_t GetHysteresisMip(uint32_t id, float requiredMip) const;
+
+	struct TextureMips {
+		// SizesFrom[i] is size of mips starting from i
+		std::vector<uint64_t> SizesFrom;
+		uint32_t MaxFirstMip = 0;
+	};
+
+	std::vector<TextureMips> m_Textures;
+	std::vector<float> m_RequiredMips;
+	std::vector<uint32_t> m_FirstMips;
+	uint64_t m_Budget;
+	float m_Hysteresis;
+};
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <MyD3D12Lib/ThreadPool.h>
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+// items are produced in parallel on thread pool and consumed on calling thread in index order
+// not more than maxInFlight items are produced but not consumed, so their memory is bounded
+// exception from produce or consume is rethrown on calling thread after all started tasks are finished
+template<class T>
+void RunOrderedPipeline(
+	ThreadPool& pool,
+	uint32_t numItems,
+	uint32_t maxInFlight,
+	std::function<T(uint32_t)> produce,
+	std::function<void(uint32_t, T&)> consume)
+{
+	assert(maxInFlight > 0 && "Pipeline window can`t be empty");
+
+	struct Slot {
+		std::optional<T> Value;
+		std::exception_ptr Error;
+		bool IsReady = false;
+	};
+
+	// ring of slots, item i is stored in slot i % maxInFlight
+	std::vector<Slot> slots(maxInFlight);
+	std::mutex mutex;
+	std::condition_variable isReady;
+
+	uint32_t numSubmitted = 0;
+	uint32_t numFinished = 0;
+
+	auto submit = [&](uint32_t itemIndex) {
+		pool.Submit([&, itemIndex]() {
+			std::optional<T> value;
+			std::exception_ptr error;
+
+			try {
+				value.emplace(produce(itemIndex));
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+
+			// notified under lock, local state of pipeline is destroyed right after last task is waited
+			std::lock_guard<std::mutex> lock(mutex);
+			Slot& slot = slots[itemIndex % maxInFlight];
+			slot.Value = std::move(value);
+			slot.Error = error;
+			slot.IsReady = true;
+			++numFinished;
+
+			isReady.notify_all();
+		});
+	};
+
+	std::exception_ptr error;
+
+	for (; numSubmitted < numItems && numSubmitted < maxInFlight; ++numSubmitted) {
+		submit(numSubmitted);
+	}
+
+	for (uint32_t i = 0; i < numItems && !error; ++i) {
+		Slot& slot = slots[i % maxInFlight];
+		std::optional<T> value;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			isReady.wait(lock, [&]() { return slot.IsReady; });
+
+			value = std::move(slot.Value);
+			error = slot.Error;
+			slot = Slot();
+		}
+
+		if (error) {
+			break;
+		}
+
+		try {
+			consume(i, *value);
+		}
+		catch (...) {
+			error = std::current_exception();
+			break;
+		}
+
+		// consumed item releases its slot for next one
+		value.reset();
+
+		if (numSubmitted < numItems) {
+			submit(numSubmitted++);
+		}
+	}
+
+	// tasks reference local state, so wait for all of them before leaving
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		isReady.wait(lock, [&]() { return numFinished == numSubmitted; });
+	}
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// frame described by passes which declare resources they read and write, it doesn`t depend on D3D12
+// states are values of D3D12_RESOURCE_STATES, graph only compares them
+// compile culls passes whose results are not used, orders passes, derives barriers and finds lifetimes of transient resources
+// transients with non-overlapping lifetimes share memory, their offsets are found by interval coloring
+// graph is rebuilt and compiled each frame, memory of containers is reused, not thread safe
+class RenderGraph {
+public:
+	static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+	using ExecuteFunction = std::function<void()>;
+
+	enum class BarrierType {
+		Transition = 0,
+		// split barrier is begun after pass and ended by transition before next pass using resource
+		BeginTransition,
+		EndTransition,
+		// transient becomes active in memory it shares with deactivated one, its content is undefined
+		Aliasing
+	};
+
+	struct Barrier {
+		BarrierType Type;
+		uint32_t Resource;
+		uint32_t StateBefore;
+		uint32_t StateAfter;
+		// resource which used memory of transient before, only for aliasing barriers
+		uint32_t AliasedResource;
+	};
+
+	// barriers of pass are issued before it, begun split barriers after it
+	struct CompiledPass {
+		uint32_t Pass;
+		uint32_t FirstBarrier;
+		uint32_t NumBarriers;
+		uint32_t NumAfterBarriers;
+	};
+
+	// passes, resources and compiled data of previous frame are cleared
+	void Reset();
+
+	// transient lives only between its first and last use in frame, it starts each frame in state of its first use
+	// size and alignment are of placed resource, alignment is power of two
+	uint32_t CreateTransient(uint64_t size, uint64_t alignment);
+	// imported resource lives outside of graph, e.g. back buffer, it is not aliased and its last content is output of graph
+	uint32_t Import(uint32_t state);
+
+	// pass with side effects is never culled, e.g. present
+	uint32_t AddPass(const std::string& name, ExecuteFunction execute, bool hasSideEffects = false);
+
+	// pass uses resource in one state, content written by pass doesn`t depend on previous one
+	void Read(uint32_t pass, uint32_t resource, uint32_t state);
+	void Write(uint32_t pass, uint32_t resource, uint32_t state);
+	// e.g. depth tested pass which keeps depth of previous passes
+	void ReadWrite(uint32_t pass, uint32_t resource, uint32_t state);
+
+	void Compile();
+
+	// passes which survived culling in order of execution
+	const std::vector<CompiledPass>& GetCompiledPasses() const;
+	const Barrier* GetBarriers(const CompiledPass& pass) const;
+	const Barrier* GetAfterBarriers(const CompiledPass& pass) const;
+	// transients which are not in state of their first use after frame are returned to it at the end
+	uint32_t GetNumFinalBarriers() const;
+	const Barrier* GetFinalBarriers() const;
+
+	void ExecutePass(uint32_t pass) const;
+	const std::string& GetPassName(uint32_t pass) const;
+	bool IsPassCulled(uint32_t pass) const;
+
+	uint32_t GetNumPasses() const;
+	uint32_t GetNumResources() const;
+	bool IsTransient(uint32_t resource) const;
+	// transient which is not used by any executed pass has no lifetime and memory
+	bool IsUsed(uint32_t resource) const;
+	// lifetime in indexes of compiled passes
+	uint32_t GetFirstUse(uint32_t resource) const;
+	uint32_t GetLastUse(uint32_t resource) const;
+	uint32_t GetInitialState(uint32_t resource) const;
+	uint64_t GetSize(uint32_t resource) const;
+	uint64_t GetOffset(uint32_t resource) const;
+
+	// size of memory of all used transients, alignment of its start is max alignment of transients
+	uint64_t GetHeapSize() const;
+	uint64_t GetHeapAlignment() const;
+	// size used transients would take without aliasing
+	uint64_t GetTransientsSize() const;
+
+private:
+	struct Resource {
+		bool IsTransient;
+		uint64_t Size;
+		uint64_t Alignment;
+		// state before graph for imported resource, state of first use for transient
+		uint32_t InitialState;
+
+		uint32_t FirstUse;
+		uint32_t LastUse;
+		uint64_t Offset;
+		uint32_t Slot;
+		// transient which used its memory before, the last one of frame for the first one
+		uint32_t AliasedResource;
+	};
+
+	struct Pass {
+		std::string Name;
+		ExecuteFunction Execute;
+		bool HasSideEffects;
+		bool IsCulled;
+		uint32_t CompiledIndex;
+		// range of accesses grouped by pass
+		uint32_t FirstAccess;
+		uint32_t NumAccesses;
+	};
+
+	struct Access {
+		uint32_t Pass;
+		uint32_t Resource;
+		uint32_t State;
+		bool IsRead;
+		bool IsWrite;
+		// transition to state of access is begun after previous access
+		bool IsSplit;
+		// neighbour accesses of the same resource, previous in order of declaration, next by executed pass
+		uint32_t Previous;
+		uint32_t Next;
+	};
+
+	// memory shared by transients with non-overlapping lifetimes, it is as big as the biggest of them
+	struct Slot {
+		uint64_t Size;
+		uint64_t Alignment;
+		uint64_t Offset;
+		uint32_t FirstResource;
+		uint32_t LastResource;
+	};
+
+	void AddAccess(uint32_t pass, uint32_t resource, uint32_t state, bool isRead, bool isWrite);
+
+	void GroupAccesses();
+	void SortPasses();
+	void CullPasses();
+	void ComputeLifetimes();
+	void AssignMemory();
+	void DeriveBarriers();
+
+	void AddBarrier(BarrierType type, uint32_t resource, uint32_t before, uint32_t after, uint32_t aliased = InvalidIndex);
+
+	std::vector<Resource> m_Resources;
+	std::vector<Pass> m_Passes;
+	std::vector<Access> m_DeclaredAccesses;
+
+	// compiled data
+	std::vector<Access> m_Accesses;
+	std::vector<uint32_t> m_Order;
+	std::vector<CompiledPass> m_CompiledPasses;
+	std::vector<Barrier> m_Barriers;
+	uint32_t m_FirstFinalBarrier = 0;
+	std::vector<Slot> m_Slots;
+	uint64_t m_HeapSize = 0;
+	uint64_t m_HeapAlignment = 1;
+	uint64_t m_TransientsSize = 0;
+
+	// scratch memory of compile
+	// dependencies are pairs of passes, successors of pass are grouped by it
+	std::vector<uint32_t> m_Dependencies;
+	std::vector<uint32_t> m_SuccessorsStarts;
+	std::vector<uint32_t> m_Successors;
+	std::vector<uint32_t> m_NumPredecessors;
+	std::vector<uint32_t> m_Ready;
+	std::vector<uint32_t> m_LastAccesses;
+	std::vector<bool> m_IsNeeded;
+	// used transients in order of first use and of last use
+	std::vector<uint32_t> m_Transients;
+	std::vector<uint32_t> m_EndingTransients;
+	std::vector<uint32_t> m_States;
+};
\ No newline at end of file
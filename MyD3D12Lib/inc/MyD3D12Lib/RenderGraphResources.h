@@ -0,0 +1,71 @@
+#pragma once
+
+#include <MyD3D12Lib/DeferredReleaseQueue.h>
+#include <MyD3D12Lib/RenderGraph.h>
+#include <MyD3D12Lib/ResourceStateTracker.h>
+
+#include <d3d12.h>
+
+#include <wrl.h>
+using Microsoft::WRL::ComPtr;
+
+#include <cstdint>
+#include <vector>
+
+// D3D12 resources of render graph, they are indexed by resources of graph
+// transients are placed into one heap at offsets found by compile, they are render targets and depth buffers, so heap works on resource heap tier 1
+// heap and transients are recreated only when layout of compiled graph changes, e.g. on resize or when passes are culled
+// imported resources and descs of transients are given again each frame when graph is built, not thread safe
+class RenderGraphResources {
+public:
+	explicit RenderGraphResources(ComPtr<ID3D12Device2> device);
+
+	RenderGraphResources(const RenderGraphResources& other) = delete;
+	RenderGraphResources& operator=(const RenderGraphResources& other) = delete;
+
+	uint32_t Import(RenderGraph& graph, ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+	// allocation info is queried only when desc of transient changes
+	uint32_t CreateTransient(RenderGraph& graph, const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clearValue = nullptr);
+
+	// placed transients don`t match compiled graph
+	bool IsLayoutChanged(const RenderGraph& graph) const;
+	// previous transients and their heap are released when fence value is completed, their states are replaced by states of new ones
+	void UpdateLayout(const RenderGraph& graph, ResourceStates& states, DeferredReleaseQueue& releaseQueue, uint64_t fenceValue);
+
+	// null for transient which is not used by executed passes
+	ID3D12Resource* GetResource(uint32_t resource) const;
+	uint64_t GetHeapSize() const;
+
+	// passes are executed in compiled order, their barriers are collected by tracker and flushed before each pass
+	// render targets and depth buffers are discarded before first use if they are just placed or activated by aliasing barriers
+	void Execute(const RenderGraph& graph, ResourceStateTracker& tracker, ID3D12GraphicsCommandList* commandList);
+
+private:
+	struct Resource {
+		ID3D12Resource* Imported = nullptr;
+
+		// desc of transient in current graph, its allocation info is cached
+		D3D12_RESOURCE_DESC Desc = {};
+		D3D12_CLEAR_VALUE ClearValue = {};
+		bool HasClearValue = false;
+		D3D12_RESOURCE_ALLOCATION_INFO Info = {};
+
+		// placed transient and desc, offset and state it is created with
+		ComPtr<ID3D12Resource> Placed;
+		D3D12_RESOURCE_DESC PlacedDesc = {};
+		D3D12_CLEAR_VALUE PlacedClearValue = {};
+		uint64_t PlacedOffset = 0;
+		D3D12_RESOURCE_STATES PlacedState = D3D12_RESOURCE_STATE_COMMON;
+		// content of transient is undefined until its first use initializes it
+		bool NeedsInitialization = false;
+	};
+
+	Resource& GetGraphResource(uint32_t resource);
+	void IssueBarriers(const RenderGraph::Barrier* barriers, uint32_t numBarriers, ResourceStateTracker& tracker) const;
+
+	ComPtr<ID3D12Device2> m_Device;
+	ComPtr<ID3D12Heap> m_Heap;
+	uint64_t m_HeapSize = 0;
+
+	std::vector<Resource> m_Resources;
+};
\ No newline at end of file
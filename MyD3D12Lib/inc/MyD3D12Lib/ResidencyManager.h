@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+enum class ResidencyCategory {
+	Meshes = 0,
+	Textures,
+	ShadowMaps,
+	SSAO,
+	Other,
+	Count
+};
+
+// accounts GPU memory of resources by category and keeps resident size under budget
+// resources are marked with frame they are used in, frames should not decrease
+// least recently used evictable resources are evicted when budget is exceeded, but never ones used by unfinished frames
+// evicted resource is restored when it is used again, not thread safe
+class ResidencyManager {
+public:
+	using ResidencyCallback = std::function<void()>;
+
+	// id of resource which is not registered yet
+	static const uint32_t InvalidId = UINT32_MAX;
+
+	explicit ResidencyManager(uint64_t budget);
+
+	ResidencyManager(const ResidencyManager& other) = delete;
+	ResidencyManager& operator=(const ResidencyManager& other) = delete;
+
+	// new resource is resident and counts as used in given frame
+	// evict and restore are needed only for evictable resources
+	uint32_t Register(
+		ResidencyCategory category,
+		uint64_t size,
+		bool isEvictable,
+		uint64_t frame,
+		ResidencyCallback evict = nullptr,
+		ResidencyCallback restore = nullptr
+	);
+
+	void Unregister(uint32_t id);
+
+	// e.g. resource is recreated with other size
+	void Resize(uint32_t id, uint64_t size);
+
+	// evicted resource is restored before it is used
+	void MarkUsed(uint32_t id, uint64_t frame);
+
+	// frames before firstUnfinishedFrame are finished on GPU, returns number of evicted resources
+	uint32_t EnforceBudget(uint64_t firstUnfinishedFrame);
+
+	void SetBudget(uint64_t budget);
+	uint64_t GetBudget() const;
+
+	// size of all registered resources of category, resident or not
+	uint64_t GetSize(ResidencyCategory category) const;
+	uint64_t GetResidentSize() const;
+	bool IsResident(uint32_t id) const;
+
+	uint64_t GetNumEvictions() const;
+	uint64_t GetNumRestores() const;
+
+private:
+	struct Entry {
+		ResidencyCategory Category = ResidencyCategory::Other;
+		uint64_t Size = 0;
+		uint64_t LastUsedFrame = 0;
+		bool IsEvictable = false;
+		bool IsResident = false;
+		bool IsRegistered = false;
+
+		// links of LRU list of resident evictable resources
+		uint32_t Prev = InvalidId;
+		uint32_t Next = InvalidId;
+
+		ResidencyCallback Evict;
+		ResidencyCallback Restore;
+	};
+
+	void LinkLast(uint32_t id);
+	void Unlink(uint32_t id);
+
+	std::vector<Entry> m_Entries;
+	std::vector<uint32_t> m_FreeIds;
+
+	// least recently used resource is first
+	uint32_t m_First = InvalidId;
+	uint32_t m_Last = InvalidId;
+
+	uint64_t m_Budget;
+	uint64_t m_ResidentSize = 0;
+	uint64_t m_Sizes[static_cast<uint32_t>(ResidencyCategory::Count)] = {};
+
+	uint64_t m_NumEvictions = 0;
+	uint64_t m_NumRestores = 0;
+};
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <MyD3D12Lib/TLSFAllocator.h>
+
+#include <d3d12.h>
+
+#include <wrl.h>
+using Microsoft::WRL::ComPtr;
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// place of placed resource, committed resource has no heap
+struct PlacedAllocation {
+	uint32_t Heap = UINT32_MAX;
+	TLSFAllocation Allocation;
+
+	bool IsPlaced() const {
+		return Heap != UINT32_MAX;
+	}
+};
+
+struct ResourceHeapsStats {
+	uint32_t NumHeaps = 0;
+	uint32_t NumPlacedResources = 0;
+	uint32_t NumFreeBlocks = 0;
+	uint64_t HeapsSize = 0;
+	uint64_t UsedSize = 0;
+	uint64_t LargestFreeBlock = 0;
+	// share of free space of heaps which is not in largest free block of its heap
+	float Fragmentation = 0.0f;
+};
+
+// reserves big heaps per heap type and resources class, resources are placed into them by TLSF allocator
+// on resource heap tier 1 buffers, render targets and other textures don`t share heaps
+// resources bigger than heap are created committed, empty heaps are released except last one of each kind
+// placed resources are not evicted one by one, so evictable resources should stay committed, not thread safe
+class ResourceHeapAllocator {
+public:
+	explicit ResourceHeapAllocator(ComPtr<ID3D12Device2> device, uint64_t heapSize = 64ull << 20);
+
+	ResourceHeapAllocator(const ResourceHeapAllocator& other) = delete;
+	ResourceHeapAllocator& operator=(const ResourceHeapAllocator& other) = delete;
+
+	ComPtr<ID3D12Resource> CreateResource(
+		const D3D12_RESOURCE_DESC& desc,
+		D3D12_HEAP_TYPE heapType,
+		D3D12_RESOURCE_STATES initialState,
+		const D3D12_CLEAR_VALUE* clearValue,
+		PlacedAllocation& allocation
+	);
+
+	// memory is reused at once, so resource should be released and GPU should be done with it
+	// allocation of committed resource is empty, freeing it does nothing
+	void Free(PlacedAllocation& allocation);
+
+	ResourceHeapsStats GetStats() const;
+
+private:
+	enum class ResourceClass {
+		All = 0,
+		Buffers,
+		Textures,
+		RenderTargets
+	};
+
+	struct Heap {
+		ComPtr<ID3D12Heap> Resource;
+		D3D12_HEAP_TYPE Type;
+		ResourceClass Class;
+		// offsets and sizes are in units of default placement alignment
+		TLSFAllocator Allocator;
+	};
+
+	ResourceClass GetResourceClass(const D3D12_RESOURCE_DESC& desc) const;
+	uint32_t CreateHeap(D3D12_HEAP_TYPE type, ResourceClass resourceClass);
+	bool IsLastHeapOfKind(uint32_t heap) const;
+
+	ComPtr<ID3D12Device2> m_Device;
+	uint64_t m_HeapSize;
+	D3D12_RESOURCE_HEAP_TIER m_HeapTier = D3D12_RESOURCE_HEAP_TIER_1;
+
+	// released heaps leave holes, so allocations keep their heaps indexes
+	std::vector<std::unique_ptr<Heap>> m_Heaps;
+};
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <d3d12.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// known states of resources between command lists, they are set when resources are created and when lists are submitted
+class ResourceStates {
+public:
+	void SetState(ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+	void Remove(ID3D12Resource* resource);
+
+	// returns false if resource is not tracked
+	bool GetState(ID3D12Resource* resource, D3D12_RESOURCE_STATES& state) const;
+
+private:
+	std::unordered_map<ID3D12Resource*, D3D12_RESOURCE_STATES> m_States;
+};
+
+// states of whole resources used by command list while it is recorded, not thread safe
+// transitions are collected and issued by one call at flush, transitions of the same resource between flushes are merged
+// state of resource before its first use in list is not known while list is recorded, its barrier is resolved at submission
+// split barrier is begun where resource is not needed anymore and ended by next transition of resource, both in the same list
+class ResourceStateTracker {
+public:
+	void Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+	// resource can`t be used until it is transitioned to state
+	void BeginTransition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+	// resource after takes over memory of placed resource before, barrier is issued in order with collected transitions
+	void AliasResources(ID3D12Resource* before, ID3D12Resource* after);
+
+	// does nothing if there are no collected barriers
+	void FlushBarriers(ID3D12GraphicsCommandList* commandList);
+
+	// barriers to states resources need at start of list, they are recorded to list executed just before it
+	// returns number of barriers
+	uint32_t ResolvePendingBarriers(const ResourceStates& states, std::vector<D3D12_RESOURCE_BARRIER>& barriers) const;
+	// states at end of list become known states, it is called when list is submitted
+	void CommitFinalStates(ResourceStates& states) const;
+	void Reset();
+
+	// barriers and calls issued by flushes since reset, without resolved ones
+	uint32_t GetNumBarriers() const;
+	uint32_t GetNumBarrierCalls() const;
+
+private:
+	struct ResourceState {
+		D3D12_RESOURCE_STATES State;
+		// collected barrier of resource which is not flushed yet
+		uint32_t BarrierIndex = UINT32_MAX;
+		// begun split barrier ends in State
+		bool IsSplit = false;
+		D3D12_RESOURCE_STATES SplitBefore = D3D12_RESOURCE_STATE_COMMON;
+	};
+
+	struct PendingBarrier {
+		ID3D12Resource* Resource;
+		D3D12_RESOURCE_STATES State;
+	};
+
+	void AddBarrier(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, D3D12_RESOURCE_BARRIER_FLAGS flags);
+
+	std::unordered_map<ID3D12Resource*, ResourceState> m_States;
+	std::vector<PendingBarrier> m_PendingBarriers;
+	std::vector<D3D12_RESOURCE_BARRIER> m_Barriers;
+	std::vector<bool> m_RemovedBarriers;
+
+	uint32_t m_NumBarriers = 0;
+	uint32_t m_NumBarrierCalls = 0;
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PackedRect {
+	uint32_t X = 0;
+	uint32_t Y = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+};
+
+// packs rectangles into fixed size bin, free space is kept as skyline of top edges of placed rectangles
+// each rectangle is placed where its top is the lowest, ties are broken by least area wasted under it
+// packing is better if rectangles are inserted from the highest one
+class SkylinePacker {
+public:
+	SkylinePacker(uint32_t width, uint32_t height);
+
+	// returns false if rectangle doesn`t fit, bin is not changed then
+	bool Insert(uint32_t width, uint32_t height, PackedRect& rect);
+
+	void Reset();
+
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	// top of the highest placed rectangle, bin can be cropped to it
+	uint32_t GetUsedHeight() const;
+	uint64_t GetUsedArea() const;
+	// used area relative to bin area
+	float GetOccupancy() const;
+
+private:
+	struct SkylineNode {
+		uint32_t X;
+		uint32_t Y;
+		uint32_t Width;
+	};
+
+	// top of rectangle placed at node and area wasted under it, false if it doesn`t fit
+	bool Fit(size_t nodeIndex, uint32_t width, uint32_t height, uint32_t& y, uint64_t& wastedArea) const;
+	void AddNode(size_t nodeIndex, uint32_t x, uint32_t y, uint32_t width);
+
+	uint32_t m_Width;
+	uint32_t m_Height;
+	uint32_t m_UsedHeight = 0;
+	uint64_t m_UsedArea = 0;
+
+	// nodes cover whole bin width from left to right
+	std::vector<SkylineNode> m_Skyline;
+};
\ No newline at end of file
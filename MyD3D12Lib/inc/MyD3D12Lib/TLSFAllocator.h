@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct TLSFAllocation {
+	uint64_t Offset = UINT64_MAX;
+	uint64_t Size = 0;
+	// block keeping allocation, it is needed to free allocation in constant time
+	uint32_t Block = UINT32_MAX;
+
+	bool IsValid() const {
+		return Block != UINT32_MAX;
+	}
+};
+
+// two level segregated fit allocator of ranges, e.g. of heap, allocation and free take constant time
+// free blocks are kept in lists by size classes, first level is power of two, second level splits it linearly into 32 classes
+// any block from found class fits request, so wasted space is bounded by 1/32 of size, neighbour free blocks are merged
+// it manages offsets only, memory is not touched, not thread safe
+class TLSFAllocator {
+public:
+	explicit TLSFAllocator(uint64_t size);
+
+	TLSFAllocator(const TLSFAllocator& other) = delete;
+	TLSFAllocator& operator=(const TLSFAllocator& other) = delete;
+
+	TLSFAllocator(TLSFAllocator&& other) = default;
+	TLSFAllocator& operator=(TLSFAllocator&& other) = default;
+
+	// alignment is power of two, returns invalid allocation if there is no free block big enough
+	TLSFAllocation Allocate(uint64_t size, uint64_t alignment = 1);
+	void Free(const TLSFAllocation& allocation);
+
+	uint64_t GetSize() const;
+	uint64_t GetUsedSize() const;
+	uint64_t GetFreeSize() const;
+	uint32_t GetNumAllocations() const;
+	uint32_t GetNumFreeBlocks() const;
+
+	// biggest allocation which surely succeeds, it is linear in number of free blocks of the highest class
+	uint64_t GetLargestFreeBlock() const;
+
+	// share of free space which is not in the largest free block, 0 for single free block
+	float GetFragmentation() const;
+
+private:
+	static const uint32_t InvalidBlock = UINT32_MAX;
+	static const uint32_t SecondLevelBits = 5;
+	static const uint32_t SecondLevelCount = 1 << SecondLevelBits;
+	static const uint32_t FirstLevelCount = 64 - SecondLevelBits + 1;
+
+	struct Block {
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+		bool IsFree = false;
+
+		// neighbours in memory
+		uint32_t PrevPhysical = InvalidBlock;
+		uint32_t NextPhysical = InvalidBlock;
+
+		// neighbours in free list of size class
+		uint32_t PrevFree = InvalidBlock;
+		uint32_t NextFree = InvalidBlock;
+	};
+
+	static void GetClass(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+	uint32_t FindFreeBlock(uint64_t size) const;
+	void InsertFreeBlock(uint32_t block);
+	void RemoveFreeBlock(uint32_t block);
+
+	// last size bytes of block are moved to free tail block
+	void SplitBlock(uint32_t block, uint32_t tail, uint64_t size);
+	// next block is merged into block
+	void MergeBlocks(uint32_t block, uint32_t next);
+
+	uint32_t CreateBlock();
+	void DestroyBlock(uint32_t block);
+
+	uint64_t m_Size;
+	uint64_t m_UsedSize = 0;
+	uint32_t m_NumAllocations = 0;
+	uint32_t m_NumFreeBlocks = 0;
+
+	std::vector<Block> m_Blocks;
+	std::vector<uint32_t> m_UnusedBlocks;
+
+	// bit of first level is set if any of its second level classes has free blocks
+	uint64_t m_FirstLevelBitmap = 0;
+	uint32_t m_SecondLevelBitmaps[FirstLevelCount] = {};
+	uint32_t m_FreeLists[FirstLevelCount][SecondLevelCount];
+};
\ No newline at end of file
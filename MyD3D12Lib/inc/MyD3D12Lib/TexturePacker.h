@@ -0,0 +1,82 @@
+#pragma once
+
+#include <MyD3D12Lib/SkylinePacker.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class TextureGroupType {
+	Array = 0,
+	Atlas
+};
+
+struct TexturePackingItem {
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	// any format id, e.g. DXGI_FORMAT, only textures with same format are packed together
+	uint32_t Format = 0;
+	uint32_t MipLevels = 1;
+	// texels along side of format block, e.g. 4 for block compressed formats
+	uint32_t BlockSize = 1;
+};
+
+struct TexturePackingDesc {
+	// textures with both sides not larger are packed into atlases
+	uint32_t MaxAtlasItemSize = 256;
+	uint32_t AtlasSize = 1024;
+	// atlas keeps only few mips, gutter around each item is one block wide at the last of them
+	uint32_t AtlasMipLevels = 3;
+	uint32_t MaxArraySize = 2048;
+};
+
+// texture array, atlas is array of pages with same size
+struct TextureGroup {
+	TextureGroupType Type = TextureGroupType::Array;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t Format = 0;
+	uint32_t MipLevels = 1;
+	uint32_t BlockSize = 1;
+	uint32_t ArraySize = 0;
+	// texels around each atlas item filled with its edge, so filtering and mips don`t bleed neighbours in
+	uint32_t Gutter = 0;
+};
+
+struct TexturePlacement {
+	uint32_t Group = 0;
+	uint32_t ArrayIndex = 0;
+	// item position in top mip of group without gutter
+	PackedRect Rect;
+	// group texture coordinates are item ones multiplied by scale plus offset
+	float UVScale[2] = { 1.0f, 1.0f };
+	float UVOffset[2] = { 0.0f, 0.0f };
+};
+
+struct TexturePackingPlan {
+	std::vector<TextureGroup> Groups;
+	// placement of each item in order of items
+	std::vector<TexturePlacement> Placements;
+
+	// top mips area of items and of groups they are packed in
+	uint64_t ItemsArea = 0;
+	uint64_t GroupsArea = 0;
+};
+
+// textures with same format, size and mips go to arrays, small ones with same format share atlases
+// atlas items should have sides multiple of gutter and at least atlas mips, otherwise they go to arrays
+// format with single atlas item puts it to array too
+TexturePackingPlan PlanTexturePacking(const std::vector<TexturePackingItem>& items, const TexturePackingDesc& desc);
+
+// copies mip of item into mip of its atlas page and fills gutter around it with edge elements
+// data is in elements, i.e. texels or format blocks of elementSize bytes
+void CopyTextureToAtlasMip(
+	const TextureGroup& group,
+	const TexturePlacement& placement,
+	uint32_t mip,
+	const uint8_t* srcData,
+	size_t srcRowPitch,
+	uint8_t* dstData,
+	size_t dstRowPitch,
+	uint32_t elementSize
+);
\ No newline at end of file
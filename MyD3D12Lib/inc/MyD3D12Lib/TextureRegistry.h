@@ -0,0 +1,56 @@
+#pragma once
+
+#include <MyD3D12Lib/ContentHash.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// identity of decoded texture, format is DXGI format value
+struct TextureContentKey {
+	Hash128 ContentHash;
+	uint32_t Format = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t MipLevels = 0;
+
+	bool operator==(const TextureContentKey& other) const {
+		return ContentHash == other.ContentHash
+			&& Format == other.Format
+			&& Width == other.Width
+			&& Height == other.Height
+			&& MipLevels == other.MipLevels;
+	}
+};
+
+struct TextureContentKeyHasher {
+	size_t operator()(const TextureContentKey& key) const {
+		return static_cast<size_t>(key.ContentHash.Low ^ (key.ContentHash.High >> 1) ^ key.Format);
+	}
+};
+
+// maps texture names to unique contents, textures with same content share one GPU resource and view
+// first registered name of content is canonical, others are its aliases
+// thread safe, textures can be registered from loading workers
+class TextureRegistry {
+public:
+	// returns canonical name for content, it is name itself if content is new
+	// byteSize is size of texture data, it is counted as saved for aliases
+	std::string Register(const std::string& name, const TextureContentKey& key, uint64_t byteSize);
+
+	// unknown names are returned as is
+	std::string Resolve(const std::string& name) const;
+
+	uint32_t GetNumContents() const;
+	uint32_t GetNumAliases() const;
+	uint64_t GetSavedBytes() const;
+
+private:
+	mutable std::mutex m_Mutex;
+
+	std::unordered_map<TextureContentKey, std::string, TextureContentKeyHasher> m_Contents;
+	std::unordered_map<std::string, std::string> m_Names;
+	uint32_t m_NumAliases = 0;
+	uint64_t m_SavedBytes = 0;
+};
\ No newline at end of file
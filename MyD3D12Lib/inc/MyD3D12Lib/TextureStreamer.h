@@ -0,0 +1,360 @@
+#pragma once
+
+#include <MyD3D12Lib/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+enum class StreamingState {
+	Unrequested = 0,
+	Pending,
+	Loading,
+	Loaded,
+	Uploading,
+	Resident,
+	Canceled,
+	Failed
+};
+
+// streams items with ids in [0, numItems) in background, items with bigger priority are loaded first
+// loaded items are taken by render thread, which records their upload and reports fence value of it
+// item becomes resident only when that fence is completed, so its view can be switched safely
+// everything but loading itself is done on calling thread, so GPU parts can be replaced by simulation
+template<class T>
+class TextureStreamer {
+public:
+	// load is called on pool, it should check isCanceled in long operations and can return anything after it is set
+	using LoadFunction = std::function<T(uint32_t id, const std::atomic<bool>& isCanceled)>;
+
+	TextureStreamer(ThreadPool& pool, uint32_t numItems, uint32_t maxConcurrentLoads, LoadFunction load) :
+		m_Pool(pool),
+		m_Items(numItems),
+		m_MaxConcurrentLoads(maxConcurrentLoads),
+		m_Load(std::move(load))
+	{
+		assert(maxConcurrentLoads > 0 && "Streamer should load at least one item at once");
+
+		for (auto& item : m_Items) {
+			item.IsCanceled = std::make_unique<std::atomic<bool>>(false);
+		}
+	}
+
+	TextureStreamer(const TextureStreamer& other) = delete;
+	TextureStreamer& operator=(const TextureStreamer& other) = delete;
+
+	// cancels pending loads and waits for running ones, their results are dropped
+	~TextureStreamer() {
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_IsStopping = true;
+		CancelAllLocked();
+		m_IsIdle.wait(lock, [this]() { return m_NumRunning == 0; });
+	}
+
+	// queues item or updates priority of queued one
+	// canceled items are queued again, loaded and resident items are left as is
+	void Request(uint32_t id, float priority) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		Item& item = m_Items[id];
+
+		switch (item.State) {
+		case StreamingState::Unrequested:
+		case StreamingState::Canceled:
+			item.State = StreamingState::Pending;
+			Enqueue(id, priority);
+			break;
+		case StreamingState::Pending:
+			if (priority != item.Priority) {
+				Enqueue(id, priority);
+			}
+			break;
+		case StreamingState::Loading:
+			// result of canceled load is dropped and item is loaded again
+			item.IsRequeued = item.IsCanceled->load();
+			item.Priority = priority;
+			break;
+		default:
+			break;
+		}
+
+		Pump();
+	}
+
+	// pending and loaded items are dropped at once, running load is asked to stop
+	// items which upload is already submitted are not affected
+	void Cancel(uint32_t id) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		CancelLocked(id);
+	}
+
+	void CancelAll() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		CancelAllLocked();
+	}
+
+	// returns up to maxCount loaded items in order of their completion
+	// exception from load is rethrown here, failed item is not loaded again
+	std::vector<std::pair<uint32_t, T>> TakeLoaded(uint32_t maxCount) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		std::vector<std::pair<uint32_t, T>> loaded;
+
+		while (!m_LoadedIds.empty() && loaded.size() < maxCount) {
+			uint32_t id = m_LoadedIds.front();
+			m_LoadedIds.pop_front();
+
+			Item& item = m_Items[id];
+
+			if (item.Error) {
+				// already taken items are returned first, error is rethrown on next call
+				if (!loaded.empty()) {
+					m_LoadedIds.push_front(id);
+					break;
+				}
+
+				std::exception_ptr error = item.Error;
+				item.Error = nullptr;
+				std::rethrow_exception(error);
+			}
+
+			// item was canceled after load
+			if (item.State != StreamingState::Loaded) {
+				continue;
+			}
+
+			item.State = StreamingState::Uploading;
+			item.FenceValue = UINT64_MAX;
+			loaded.emplace_back(id, std::move(*item.Value));
+			item.Value.reset();
+		}
+
+		return loaded;
+	}
+
+	// fence value is signaled after upload of item
+	void OnUploadSubmitted(uint32_t id, uint64_t fenceValue) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		Item& item = m_Items[id];
+
+		assert(item.State == StreamingState::Uploading && "Upload submitted for item which is not taken");
+
+		item.FenceValue = fenceValue;
+		m_UploadingIds.push_back(id);
+	}
+
+	// returns items which upload is completed on GPU, they are resident from now on
+	std::vector<uint32_t> TakeResident(uint64_t completedFenceValue) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		std::vector<uint32_t> resident;
+
+		auto isCompleted = [&](uint32_t id) {
+			if (m_Items[id].FenceValue > completedFenceValue) {
+				return false;
+			}
+
+			m_Items[id].State = StreamingState::Resident;
+			resident.push_back(id);
+
+			return true;
+		};
+
+		m_UploadingIds.erase(
+			std::remove_if(m_UploadingIds.begin(), m_UploadingIds.end(), isCompleted),
+			m_UploadingIds.end()
+		);
+
+		return resident;
+	}
+
+	StreamingState GetState(uint32_t id) const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Items[id].State;
+	}
+
+	// true if nothing is queued, loaded or waits for upload
+	bool IsIdle() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto isBusy = [](const Item& item) {
+			return item.State == StreamingState::Pending || item.State == StreamingState::Loading ||
+				item.State == StreamingState::Loaded || item.State == StreamingState::Uploading;
+		};
+
+		return std::none_of(m_Items.begin(), m_Items.end(), isBusy);
+	}
+
+private:
+	struct Item {
+		StreamingState State = StreamingState::Unrequested;
+		float Priority = 0.0f;
+		// queue entries with other version are outdated
+		uint32_t Version = 0;
+		uint64_t FenceValue = UINT64_MAX;
+		bool IsRequeued = false;
+		std::unique_ptr<std::atomic<bool>> IsCanceled;
+		std::optional<T> Value;
+		std::exception_ptr Error;
+	};
+
+	struct QueueEntry {
+		float Priority;
+		uint32_t Version;
+		uint32_t Id;
+
+		// items with equal priority are loaded in ids order
+		bool operator<(const QueueEntry& other) const {
+			return Priority < other.Priority || (Priority == other.Priority && Id > other.Id);
+		}
+	};
+
+	void Enqueue(uint32_t id, float priority) {
+		Item& item = m_Items[id];
+
+		item.Priority = priority;
+		++item.Version;
+
+		m_Queue.push({ priority, item.Version, id });
+
+		// outdated entries are removed lazily, rebuild queue if they take too much
+		if (m_Queue.size() > 2 * m_Items.size() + 16) {
+			std::vector<QueueEntry> entries;
+
+			while (!m_Queue.empty()) {
+				if (IsActual(m_Queue.top())) {
+					entries.push_back(m_Queue.top());
+				}
+
+				m_Queue.pop();
+			}
+
+			m_Queue = std::priority_queue<QueueEntry>(std::less<QueueEntry>(), std::move(entries));
+		}
+	}
+
+	bool IsActual(const QueueEntry& entry) const {
+		const Item& item = m_Items[entry.Id];
+		return item.State == StreamingState::Pending && item.Version == entry.Version;
+	}
+
+	// starts loads of most prioritized items while there are free slots
+	void Pump() {
+		while (!m_IsStopping && m_NumRunning < m_MaxConcurrentLoads && !m_Queue.empty()) {
+			QueueEntry entry = m_Queue.top();
+			m_Queue.pop();
+
+			if (!IsActual(entry)) {
+				continue;
+			}
+
+			Item& item = m_Items[entry.Id];
+
+			item.State = StreamingState::Loading;
+			item.IsCanceled->store(false);
+			item.IsRequeued = false;
+			++m_NumRunning;
+
+			uint32_t id = entry.Id;
+			const std::atomic<bool>* isCanceled = item.IsCanceled.get();
+
+			m_Pool.Submit([this, id, isCanceled]() {
+				std::optional<T> value;
+				std::exception_ptr error;
+
+				try {
+					value.emplace(m_Load(id, *isCanceled));
+				}
+				catch (...) {
+					error = std::current_exception();
+				}
+
+				OnLoadFinished(id, std::move(value), error);
+			});
+		}
+	}
+
+	void OnLoadFinished(uint32_t id, std::optional<T> value, std::exception_ptr error) {
+		// notified under lock, streamer can be destroyed right after waiting thread wakes up
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		Item& item = m_Items[id];
+
+		--m_NumRunning;
+
+		if (item.IsCanceled->load()) {
+			item.State = StreamingState::Canceled;
+
+			if (item.IsRequeued && !m_IsStopping) {
+				item.State = StreamingState::Pending;
+				Enqueue(id, item.Priority);
+			}
+		}
+		else if (error) {
+			item.State = StreamingState::Failed;
+			item.Error = error;
+			m_LoadedIds.push_back(id);
+		}
+		else {
+			item.State = StreamingState::Loaded;
+			item.Value = std::move(value);
+			m_LoadedIds.push_back(id);
+		}
+
+		item.IsRequeued = false;
+
+		Pump();
+		m_IsIdle.notify_all();
+	}
+
+	void CancelLocked(uint32_t id) {
+		Item& item = m_Items[id];
+
+		switch (item.State) {
+		case StreamingState::Pending:
+			item.State = StreamingState::Canceled;
+			break;
+		case StreamingState::Loading:
+			item.IsCanceled->store(true);
+			item.IsRequeued = false;
+			break;
+		case StreamingState::Loaded:
+			item.State = StreamingState::Canceled;
+			item.Value.reset();
+			break;
+		default:
+			break;
+		}
+	}
+
+	void CancelAllLocked() {
+		for (uint32_t id = 0; id < m_Items.size(); ++id) {
+			CancelLocked(id);
+		}
+
+		m_Queue = std::priority_queue<QueueEntry>();
+	}
+
+	ThreadPool& m_Pool;
+	std::vector<Item> m_Items;
+	uint32_t m_MaxConcurrentLoads;
+	LoadFunction m_Load;
+
+	std::priority_queue<QueueEntry> m_Queue;
+	std::deque<uint32_t> m_LoadedIds;
+	std::vector<uint32_t> m_UploadingIds;
+	uint32_t m_NumRunning = 0;
+	bool m_IsStopping = false;
+
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_IsIdle;
+};
\ No newline at end of file
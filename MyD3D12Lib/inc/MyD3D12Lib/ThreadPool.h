@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+	// onThreadStart and onThreadExit are called on each worker thread, e.g. for COM initialization
+	ThreadPool(
+		uint32_t numThreads = 0,
+		std::function<void()> onThreadStart = nullptr,
+		std::function<void()> onThreadExit = nullptr
+	);
+
+	ThreadPool(const ThreadPool& other) = delete;
+	ThreadPool& operator=(const ThreadPool& other) = delete;
+
+	// waits for all submitted tasks
+	~ThreadPool();
+
+	void Submit(std::function<void()> task);
+
+	// runs body for indexes in [0, count) on workers and calling thread, returns when all are done
+	// calling thread takes part, so it is safe to call from tasks of the same pool
+	// first exception from body is rethrown on calling thread
+	void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& body);
+
+	uint32_t GetNumThreads() const;
+
+private:
+	void WorkerLoop();
+
+	std::vector<std::thread> m_Threads;
+	std::queue<std::function<void()>> m_Tasks;
+	std::mutex m_Mutex;
+	std::condition_variable m_HasTasks;
+	bool m_IsStopping = false;
+
+	std::function<void()> m_OnThreadStart;
+	std::function<void()> m_OnThreadExit;
+};
\ No newline at end of file
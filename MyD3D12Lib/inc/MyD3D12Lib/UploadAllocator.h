@@ -0,0 +1,57 @@
+#pragma once
+
+#include <MyD3D12Lib/LinearAllocator.h>
+
+#include <d3d12.h>
+
+#include <wrl.h>
+using Microsoft::WRL::ComPtr;
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+struct UploadAllocation {
+	void* CPUAddress = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS GPUAddress = 0;
+};
+
+// linear allocator of upload memory written by CPU each frame, e.g. constants bound as root CBVs
+// pages are upload buffers mapped for whole lifetime, they are created when all pages are used by frames in flight
+// frame retires its pages with fence value of its command lists, not thread safe
+class UploadAllocator {
+public:
+	explicit UploadAllocator(ComPtr<ID3D12Device2> device, uint64_t pageSize = 64 * 1024);
+
+	UploadAllocator(const UploadAllocator& other) = delete;
+	UploadAllocator& operator=(const UploadAllocator& other) = delete;
+
+	~UploadAllocator();
+
+	// constant buffers are aligned to 256 bytes
+	UploadAllocation Allocate(uint64_t size, uint64_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	template<class T>
+	D3D12_GPU_VIRTUAL_ADDRESS AllocateConstants(const T& data) {
+		UploadAllocation allocation = Allocate(sizeof(T));
+		std::memcpy(allocation.CPUAddress, &data, sizeof(T));
+
+		return allocation.GPUAddress;
+	}
+
+	void Retire(uint64_t fenceValue);
+	void ReleaseCompleted(uint64_t completedFenceValue);
+
+	const LinearAllocator& GetLinearAllocator() const;
+
+private:
+	struct Page {
+		ComPtr<ID3D12Resource> Resource;
+		uint8_t* MappedData = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS GPUAddress = 0;
+	};
+
+	ComPtr<ID3D12Device2> m_Device;
+	LinearAllocator m_Allocator;
+	std::vector<Page> m_Pages;
+};
\ No newline at end of file
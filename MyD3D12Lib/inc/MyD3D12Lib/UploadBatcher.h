@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+// uploads are recorded into open batch, one list of copy queue, batch is submitted when it is full or when its uploads are needed
+// batches have increasing indexes, fence value of batch is known after it is submitted
+// queue using uploads waits on GPU only for batch which is not finished and which it doesn`t wait for already
+// it doesn`t depend on D3D12, fence values are of copy queue, not thread safe
+class UploadBatcher {
+public:
+	UploadBatcher(uint64_t maxBatchSize, uint32_t maxBatchUploads);
+
+	// upload doesn`t fit open batch, so batch should be submitted before upload is recorded, empty batch fits any upload
+	bool IsFull(uint64_t size) const;
+	// upload is added to open batch, returns its index
+	uint64_t Add(uint64_t size);
+
+	bool HasOpenUploads() const;
+	uint64_t GetOpenBatch() const;
+	// open batch is submitted, its fence value is signaled by copy queue after it
+	void Submit(uint64_t fenceValue);
+
+	// fence value of submitted batch, 0 if batch is finished and released
+	uint64_t GetFenceValue(uint64_t batch) const;
+
+	// fence value which consumer queue should wait for before it uses uploads of submitted batch, 0 if wait isn`t needed
+	// consumer is expected to wait for returned value, batches are finished in order of submission
+	uint64_t RequireBatch(uint64_t batch, uint64_t completedFenceValue);
+
+	// fence values of finished batches are released
+	void ReleaseCompleted(uint64_t completedFenceValue);
+
+	uint64_t GetNumSubmittedBatches() const;
+	uint64_t GetNumUploads() const;
+	uint64_t GetNumConsumerWaits() const;
+
+private:
+	uint64_t m_MaxBatchSize;
+	uint32_t m_MaxBatchUploads;
+
+	uint64_t m_OpenBatch = 0;
+	uint64_t m_OpenBatchSize = 0;
+	uint32_t m_OpenBatchUploads = 0;
+
+	// fence values of submitted batches which are not released, the first one is of m_FirstBatch
+	uint64_t m_FirstBatch = 0;
+	std::deque<uint64_t> m_FenceValues;
+
+	// the last fence value consumer waits for
+	uint64_t m_ConsumerFenceValue = 0;
+
+	uint64_t m_NumUploads = 0;
+	uint64_t m_NumConsumerWaits = 0;
+};
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+// compact 16 bytes vertex
+// Position --- xyz in UNORM16 relative to mesh bounding box, w is padding
+// Norm --- octahedral encoded normal in SNORM16
+// TexC --- half floats
+struct CompactVertex {
+	uint16_t Position[4];
+	int16_t Norm[2];
+	uint16_t TexC[2];
+};
+
+// position = Offset + Scale * unorm position
+struct PositionDequantization {
+	float Offset[3] = { 0.0f, 0.0f, 0.0f };
+	float Scale[3] = { 1.0f, 1.0f, 1.0f };
+};
+
+// interleaved float vertexes layout, position and norm are float3, texture coordinates are float2
+struct VertexStreamDesc {
+	const void* Data = nullptr;
+	uint32_t ByteStride = 0;
+	uint32_t PositionOffset = 0;
+	uint32_t NormOffset = 0;
+	uint32_t TexCOffset = 0;
+};
+
+PositionDequantization ComputePositionDequantization(const VertexStreamDesc& stream, uint32_t numVertexes);
+
+// batch encoding and decoding, AVX2 and F16C are used if supported by CPU
+void EncodeCompactVertexes(
+	const VertexStreamDesc& stream,
+	uint32_t numVertexes,
+	const PositionDequantization& dequantization,
+	CompactVertex* compactVertexes
+);
+
+// decode to separate streams: positions and norms are float3, texture coordinates are float2
+void DecodeCompactVertexes(
+	const CompactVertex* compactVertexes,
+	uint32_t numVertexes,
+	const PositionDequantization& dequantization,
+	float* positions,
+	float* norms,
+	float* texCs
+);
+
+// scalar reference versions
+void EncodeCompactVertexesScalar(
+	const VertexStreamDesc& stream,
+	uint32_t numVertexes,
+	const PositionDequantization& dequantization,
+	CompactVertex* compactVertexes
+);
+
+void DecodeCompactVertexesScalar(
+	const CompactVertex* compactVertexes,
+	uint32_t numVertexes,
+	const PositionDequantization& dequantization,
+	float* positions,
+	float* norms,
+	float* texCs
+);
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+void EncodeOctahedralNorm(const float norm[3], int16_t encoded[2]);
+void DecodeOctahedralNorm(const int16_t encoded[2], float norm[3]);
\ No newline at end of file
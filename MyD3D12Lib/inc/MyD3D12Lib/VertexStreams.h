@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// split interleaved vertexes into tightly packed position stream and attribute stream
+// position bytes are [positionOffset, positionOffset + positionByteSize) of each vertex
+// attribute stream keeps all other bytes in original order, its stride is byteStride - positionByteSize
+// both streams are indexed identically, so index buffer is shared between them
+void SplitVertexStreams(
+	const void* vertexes,
+	uint32_t numVertexes,
+	uint32_t byteStride,
+	uint32_t positionOffset,
+	uint32_t positionByteSize,
+	void* positions,
+	void* attributes
+);
\ No newline at end of file
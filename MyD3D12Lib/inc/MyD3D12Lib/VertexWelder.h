@@ -0,0 +1,32 @@
+#pragma once
+
+#include <MyD3D12Lib/VertexQuantization.h>
+
+#include <cstdint>
+#include <vector>
+
+// attributes closer than epsilon are snapped to the same grid cell and welded
+// zero epsilon welds only bit identical attributes
+struct WeldEpsilons {
+	float Position = 0.0f;
+	float Norm = 0.0f;
+	float TexC = 0.0f;
+};
+
+struct WeldResult {
+	// source vertex for each welded vertex, first occurrence is kept
+	std::vector<uint32_t> Vertexes;
+	// welded vertex for each source vertex
+	std::vector<uint32_t> Remap;
+};
+
+// open addressing hash table over quantized position, norm and texture coordinates keys
+// near identical vertexes lying in neighbouring grid cells are not welded
+WeldResult WeldVertexes(
+	const VertexStreamDesc& stream,
+	uint32_t numVertexes,
+	const WeldEpsilons& epsilons = WeldEpsilons()
+);
+
+// replace source vertexes indexes by welded ones in place
+void RemapIndexes(uint32_t* indexes, uint32_t numIndexes, const std::vector<uint32_t>& remap);
\ No newline at end of file
@@ -0,0 +1,439 @@
+#include <MyD3D12Lib/AssetPackage.h>
+
+#include <MyD3D12Lib/ContentHash.h>
+#include <MyD3D12Lib/LZCompression.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+
+// package layout: header, files entries, chunks entries, hash table, names, chunks data
+// all values are little endian, chunks data starts at 4 KiB boundaries
+struct AssetPackage::Header {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t ChunkSize;
+	uint32_t NumFiles;
+	uint32_t NumChunks;
+	uint32_t HashTableSize;
+	uint64_t FilesOffset;
+	uint64_t ChunksOffset;
+	uint64_t HashTableOffset;
+	uint64_t NamesOffset;
+	uint64_t NamesSize;
+};
+
+struct AssetPackage::FileEntry {
+	uint64_t NameHash;
+	uint64_t Size;
+	uint32_t NameOffset;
+	uint32_t NameLength;
+	uint32_t FirstChunk;
+	uint32_t NumChunks;
+};
+
+// chunk with equal sizes is stored without compression
+struct AssetPackage::ChunkEntry {
+	uint64_t Offset;
+	uint32_t CompressedSize;
+	uint32_t Size;
+};
+
+namespace {
+	const uint32_t PackageMagic = 0x4B415041; // "APAK"
+	const uint32_t PackageVersion = 1;
+	const uint64_t ChunkAlignment = 4096;
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	uint64_t HashName(const std::string& name) {
+		return ComputeContentHash(name.data(), name.size()).Low;
+	}
+
+	uint32_t GetHashTableSize(uint32_t numFiles) {
+		// table is at most half full, so probe sequences stay short
+		uint32_t size = 1;
+
+		while (size < 2 * static_cast<uint64_t>(numFiles)) {
+			size <<= 1;
+		}
+
+		return size;
+	}
+
+	template<typename T>
+	void WriteData(std::ofstream& file, const T* data, size_t count) {
+		file.write(reinterpret_cast<const char*>(data), sizeof(T) * count);
+	}
+
+	void WritePadding(std::ofstream& file, uint64_t size) {
+		static const char zeros[ChunkAlignment] = {};
+
+		while (size > 0) {
+			uint64_t writeSize = (std::min)(size, ChunkAlignment);
+			file.write(zeros, writeSize);
+			size -= writeSize;
+		}
+	}
+}
+
+AssetPackageWriter::AssetPackageWriter(uint32_t chunkSize) :
+	m_ChunkSize(chunkSize)
+{
+	if (m_ChunkSize == 0) {
+		throw std::exception();
+	}
+}
+
+void AssetPackageWriter::AddFile(const std::string& name, std::vector<uint8_t> data) {
+	m_Files.push_back({ name, std::move(data) });
+}
+
+void AssetPackageWriter::Write(const std::filesystem::path& fileName, ThreadPool* pool) {
+	using Header = AssetPackage::Header;
+	using FileEntry = AssetPackage::FileEntry;
+	using ChunkEntry = AssetPackage::ChunkEntry;
+
+	uint32_t numFiles = static_cast<uint32_t>(m_Files.size());
+
+	std::vector<FileEntry> files(numFiles);
+	std::string names;
+	uint32_t numChunks = 0;
+
+	for (uint32_t i = 0; i < numFiles; ++i) {
+		const File& file = m_Files[i];
+		FileEntry& entry = files[i];
+
+		entry.NameHash = HashName(file.Name);
+		entry.Size = file.Data.size();
+		entry.NameOffset = static_cast<uint32_t>(names.size());
+		entry.NameLength = static_cast<uint32_t>(file.Name.size());
+		entry.FirstChunk = numChunks;
+		entry.NumChunks = static_cast<uint32_t>((file.Data.size() + m_ChunkSize - 1) / m_ChunkSize);
+
+		names += file.Name;
+		numChunks += entry.NumChunks;
+	}
+
+	// slots keep file index + 1, zero is empty slot
+	uint32_t hashTableSize = GetHashTableSize(numFiles);
+	std::vector<uint32_t> hashTable(hashTableSize, 0);
+
+	for (uint32_t i = 0; i < numFiles; ++i) {
+		uint32_t slot = static_cast<uint32_t>(files[i].NameHash) & (hashTableSize - 1);
+
+		while (hashTable[slot] != 0) {
+			const File& other = m_Files[hashTable[slot] - 1];
+
+			if (other.Name == m_Files[i].Name) {
+				throw std::exception();
+			}
+
+			slot = (slot + 1) & (hashTableSize - 1);
+		}
+
+		hashTable[slot] = i + 1;
+	}
+
+	std::vector<ChunkEntry> chunks(numChunks);
+	std::vector<std::vector<uint8_t>> chunksData(numChunks);
+	std::vector<uint32_t> chunksFiles(numChunks);
+
+	for (uint32_t i = 0; i < numFiles; ++i) {
+		for (uint32_t j = 0; j < files[i].NumChunks; ++j) {
+			chunksFiles[files[i].FirstChunk + j] = i;
+		}
+	}
+
+	auto compressChunk = [&](uint32_t chunk) {
+		uint32_t fileIndex = chunksFiles[chunk];
+		const std::vector<uint8_t>& data = m_Files[fileIndex].Data;
+
+		uint64_t offset = static_cast<uint64_t>(chunk - files[fileIndex].FirstChunk) * m_ChunkSize;
+		uint32_t size = static_cast<uint32_t>((std::min)(static_cast<uint64_t>(m_ChunkSize), data.size() - offset));
+
+		std::vector<uint8_t>& compressed = chunksData[chunk];
+		compressed.resize(GetLZMaxCompressedSize(size));
+		compressed.resize(CompressLZ(data.data() + offset, size, compressed.data()));
+
+		if (compressed.size() >= size) {
+			compressed.assign(data.begin() + offset, data.begin() + offset + size);
+		}
+
+		chunks[chunk].CompressedSize = static_cast<uint32_t>(compressed.size());
+		chunks[chunk].Size = size;
+	};
+
+	if (pool != nullptr) {
+		pool->ParallelFor(numChunks, compressChunk);
+	}
+	else {
+		for (uint32_t i = 0; i < numChunks; ++i) {
+			compressChunk(i);
+		}
+	}
+
+	Header header = {};
+	header.Magic = PackageMagic;
+	header.Version = PackageVersion;
+	header.ChunkSize = m_ChunkSize;
+	header.NumFiles = numFiles;
+	header.NumChunks = numChunks;
+	header.HashTableSize = hashTableSize;
+	header.FilesOffset = sizeof(Header);
+	header.ChunksOffset = header.FilesOffset + sizeof(FileEntry) * files.size();
+	header.HashTableOffset = header.ChunksOffset + sizeof(ChunkEntry) * chunks.size();
+	header.NamesOffset = header.HashTableOffset + sizeof(uint32_t) * hashTable.size();
+	header.NamesSize = names.size();
+
+	uint64_t offset = AlignUp(header.NamesOffset + header.NamesSize, ChunkAlignment);
+	m_CompressedSize = 0;
+
+	for (ChunkEntry& chunk : chunks) {
+		chunk.Offset = offset;
+		offset = AlignUp(offset + chunk.CompressedSize, ChunkAlignment);
+		m_CompressedSize += chunk.CompressedSize;
+	}
+
+	std::filesystem::path tempFileName = fileName;
+	tempFileName += ".tmp";
+
+	{
+		std::ofstream file(tempFileName, std::ios::binary | std::ios::trunc);
+
+		if (!file) {
+			throw std::exception();
+		}
+
+		WriteData(file, &header, 1);
+		WriteData(file, files.data(), files.size());
+		WriteData(file, chunks.data(), chunks.size());
+		WriteData(file, hashTable.data(), hashTable.size());
+		WriteData(file, names.data(), names.size());
+
+		uint64_t position = header.NamesOffset + header.NamesSize;
+
+		for (uint32_t i = 0; i < numChunks; ++i) {
+			WritePadding(file, chunks[i].Offset - position);
+			WriteData(file, chunksData[i].data(), chunksData[i].size());
+			position = chunks[i].Offset + chunks[i].CompressedSize;
+		}
+
+		if (!file) {
+			throw std::exception();
+		}
+	}
+
+	std::filesystem::rename(tempFileName, fileName);
+}
+
+uint64_t AssetPackageWriter::GetCompressedSize() const {
+	return m_CompressedSize;
+}
+
+AssetPackage::AssetPackage(const std::filesystem::path& fileName) :
+	m_File(fileName)
+{
+	uint64_t fileSize = m_File.GetSize();
+
+	if (fileSize < sizeof(Header)) {
+		throw std::exception();
+	}
+
+	const Header& header = GetHeader();
+
+	if (header.Magic != PackageMagic || header.Version != PackageVersion || header.ChunkSize == 0) {
+		throw std::exception();
+	}
+
+	// tables lie one after another, so checking the last one bounds all of them
+	bool isTableValid =
+		header.FilesOffset == sizeof(Header) &&
+		header.ChunksOffset == header.FilesOffset + sizeof(FileEntry) * static_cast<uint64_t>(header.NumFiles) &&
+		header.HashTableOffset == header.ChunksOffset + sizeof(ChunkEntry) * static_cast<uint64_t>(header.NumChunks) &&
+		header.NamesOffset == header.HashTableOffset + sizeof(uint32_t) * static_cast<uint64_t>(header.HashTableSize) &&
+		header.NamesSize <= fileSize && header.NamesOffset <= fileSize - header.NamesSize &&
+		header.HashTableSize > header.NumFiles && (header.HashTableSize & (header.HashTableSize - 1)) == 0;
+
+	if (!isTableValid) {
+		throw std::exception();
+	}
+
+	for (uint32_t i = 0; i < header.NumFiles; ++i) {
+		const FileEntry& file = GetFileEntry(i);
+
+		bool isFileValid =
+			static_cast<uint64_t>(file.NameOffset) + file.NameLength <= header.NamesSize &&
+			static_cast<uint64_t>(file.FirstChunk) + file.NumChunks <= header.NumChunks &&
+			file.NumChunks == (file.Size + header.ChunkSize - 1) / header.ChunkSize;
+
+		if (!isFileValid) {
+			throw std::exception();
+		}
+
+		for (uint32_t j = 0; j < file.NumChunks; ++j) {
+			const ChunkEntry& chunk = GetChunkEntry(file.FirstChunk + j);
+			uint64_t chunkSize = (std::min)(static_cast<uint64_t>(header.ChunkSize), file.Size - static_cast<uint64_t>(j) * header.ChunkSize);
+
+			bool isChunkValid =
+				chunk.Size == chunkSize && chunk.CompressedSize <= chunk.Size &&
+				chunk.CompressedSize <= fileSize && chunk.Offset <= fileSize - chunk.CompressedSize;
+
+			if (!isChunkValid) {
+				throw std::exception();
+			}
+		}
+	}
+
+	const uint32_t* hashTable = reinterpret_cast<const uint32_t*>(m_File.GetData() + header.HashTableOffset);
+
+	for (uint32_t i = 0; i < header.HashTableSize; ++i) {
+		if (hashTable[i] > header.NumFiles) {
+			throw std::exception();
+		}
+	}
+}
+
+uint32_t AssetPackage::Find(const std::string& name) const {
+	const Header& header = GetHeader();
+	const uint32_t* hashTable = reinterpret_cast<const uint32_t*>(m_File.GetData() + header.HashTableOffset);
+	const char* names = reinterpret_cast<const char*>(m_File.GetData() + header.NamesOffset);
+
+	uint64_t hash = HashName(name);
+	uint32_t slot = static_cast<uint32_t>(hash) & (header.HashTableSize - 1);
+
+	// table always has empty slots, so probing ends
+	while (hashTable[slot] != 0) {
+		uint32_t index = hashTable[slot] - 1;
+		const FileEntry& file = GetFileEntry(index);
+
+		if (file.NameHash == hash && file.NameLength == name.size() && std::memcmp(names + file.NameOffset, name.data(), name.size()) == 0) {
+			return index;
+		}
+
+		slot = (slot + 1) & (header.HashTableSize - 1);
+	}
+
+	return InvalidIndex;
+}
+
+uint32_t AssetPackage::GetNumFiles() const {
+	return GetHeader().NumFiles;
+}
+
+std::string AssetPackage::GetFileName(uint32_t index) const {
+	const FileEntry& file = GetFileEntry(index);
+	const char* names = reinterpret_cast<const char*>(m_File.GetData() + GetHeader().NamesOffset);
+
+	return std::string(names + file.NameOffset, file.NameLength);
+}
+
+uint64_t AssetPackage::GetFileSize(uint32_t index) const {
+	return GetFileEntry(index).Size;
+}
+
+std::vector<uint8_t> AssetPackage::ReadFile(uint32_t index, ThreadPool* pool) const {
+	const FileEntry& file = GetFileEntry(index);
+	uint32_t chunkSize = GetChunkSize();
+
+	std::vector<uint8_t> data(file.Size);
+
+	auto readChunk = [&](uint32_t chunk) {
+		ReadChunk(index, chunk, data.data() + static_cast<size_t>(chunk) * chunkSize);
+	};
+
+	if (pool != nullptr && file.NumChunks > 1) {
+		pool->ParallelFor(file.NumChunks, readChunk);
+	}
+	else {
+		for (uint32_t i = 0; i < file.NumChunks; ++i) {
+			readChunk(i);
+		}
+	}
+
+	return data;
+}
+
+void AssetPackage::Read(uint32_t index, uint64_t offset, uint64_t size, uint8_t* dst) const {
+	const FileEntry& file = GetFileEntry(index);
+
+	if (offset > file.Size || size > file.Size - offset) {
+		throw std::exception();
+	}
+
+	if (size == 0) {
+		return;
+	}
+
+	uint32_t chunkSize = GetChunkSize();
+	uint32_t firstChunk = static_cast<uint32_t>(offset / chunkSize);
+	uint32_t lastChunk = static_cast<uint32_t>((offset + size - 1) / chunkSize);
+
+	std::vector<uint8_t> buffer;
+
+	for (uint32_t chunk = firstChunk; chunk <= lastChunk; ++chunk) {
+		uint64_t chunkStart = static_cast<uint64_t>(chunk) * chunkSize;
+		uint64_t chunkEnd = chunkStart + GetChunkEntry(file.FirstChunk + chunk).Size;
+
+		uint64_t start = (std::max)(offset, chunkStart);
+		uint64_t end = (std::min)(offset + size, chunkEnd);
+
+		// whole chunks are decompressed right into destination, partial ones through buffer
+		if (start == chunkStart && end == chunkEnd) {
+			ReadChunk(index, chunk, dst + (start - offset));
+		}
+		else {
+			buffer.resize(chunkEnd - chunkStart);
+			ReadChunk(index, chunk, buffer.data());
+			std::memcpy(dst + (start - offset), buffer.data() + (start - chunkStart), end - start);
+		}
+	}
+}
+
+uint32_t AssetPackage::GetChunkSize() const {
+	return GetHeader().ChunkSize;
+}
+
+uint32_t AssetPackage::GetNumChunks(uint32_t index) const {
+	return GetFileEntry(index).NumChunks;
+}
+
+void AssetPackage::ReadChunk(uint32_t index, uint32_t chunk, uint8_t* dst) const {
+	const FileEntry& file = GetFileEntry(index);
+
+	if (chunk >= file.NumChunks) {
+		throw std::exception();
+	}
+
+	const ChunkEntry& entry = GetChunkEntry(file.FirstChunk + chunk);
+	const uint8_t* src = m_File.GetData() + entry.Offset;
+
+	if (entry.CompressedSize == entry.Size) {
+		std::memcpy(dst, src, entry.Size);
+	}
+	else {
+		DecompressLZ(src, entry.CompressedSize, dst, entry.Size);
+	}
+}
+
+const AssetPackage::Header& AssetPackage::GetHeader() const {
+	return *reinterpret_cast<const Header*>(m_File.GetData());
+}
+
+const AssetPackage::FileEntry& AssetPackage::GetFileEntry(uint32_t index) const {
+	const Header& header = GetHeader();
+
+	if (index >= header.NumFiles) {
+		throw std::exception();
+	}
+
+	return reinterpret_cast<const FileEntry*>(m_File.GetData() + header.FilesOffset)[index];
+}
+
+const AssetPackage::ChunkEntry& AssetPackage::GetChunkEntry(uint32_t index) const {
+	const Header& header = GetHeader();
+	return reinterpret_cast<const ChunkEntry*>(m_File.GetData() + header.ChunksOffset)[index];
+}
\ No newline at end of file
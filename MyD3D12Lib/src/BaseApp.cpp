@@ -45,6 +45,11 @@ void BaseApp::Run() {
 
 	m_DirectCommandQueue->Flush();
 	m_DirectCommandQueue->CloseHandle();
+
+	m_CopyCommandQueue->Flush();
+	m_CopyCommandQueue->CloseHandle();
+
+	m_DeferredReleaseQueue->ReleaseAll();
 }
 
 LRESULT BaseApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
@@ -134,6 +139,10 @@ bool BaseApp::Initialize() {
 		CommandQueue(m_Device, D3D12_COMMAND_LIST_TYPE_DIRECT)
 	);
 
+	m_CopyCommandQueue = std::make_shared<CommandQueue>(
+		CommandQueue(m_Device, D3D12_COMMAND_LIST_TYPE_COPY)
+	);
+
 	// create swap chaine and init back buffers and it`s objects
 	m_SwapChain = CreateSwapChain(
 		m_DirectCommandQueue->GetCommandQueue(), 
@@ -152,23 +161,24 @@ bool BaseApp::Initialize() {
 	);
 
 	m_CurrentBackBufferIndex = m_SwapChain->GetCurrentBackBufferIndex();
-
-	for (UINT i = 0; i < m_NumBackBuffers; ++i) {
-		m_BackBuffersFenceValues[i] = 0;
-	}
 	
 	// init descriptors size
 	m_RTVDescSize = m_Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 	m_CBV_SRV_UAVDescSize = m_Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	m_DSVDescSize = m_Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
 
+	m_ResourceHeapAllocator = std::make_unique<ResourceHeapAllocator>(m_Device);
+	m_DeferredReleaseQueue = std::make_unique<DeferredReleaseQueue>();
+
 	// create ds buffer and init it`s objects
 	m_DSBuffer = CreateDepthStencilBuffer(
 		m_Device, 
 		m_ClientWidth, m_ClientHeight, 
 		m_DepthSencilBufferFormat, m_DepthSencilViewFormat,
 		m_DepthClearValue,
-		m_SteniclClearValue
+		m_SteniclClearValue,
+		m_ResourceHeapAllocator.get(),
+		&m_DSBufferAllocation
 	);
 
 	m_DSVDescHeap = CreateDescriptorHeap(
@@ -198,6 +208,7 @@ void BaseApp::OnResize() {
 		m_ClientWidth = std::max(1l, width);
 		m_ClientHeight = std::max(1l, height);
 
+		// swap chain buffers can be resized only when GPU doesn`t use them
 		m_DirectCommandQueue->Flush();
 
 		m_ViewPort = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(m_ClientWidth), static_cast<float>(m_ClientHeight));
@@ -336,14 +347,25 @@ void BaseApp::UpdateDSView() {
 }
 
 void BaseApp::ResizeDSBuffer() {
-	m_DSBuffer.Reset();
+	// old buffer can be used by frames in flight, so its memory is reused after they are finished
+	m_DeferredReleaseQueue->Push(
+		m_DirectCommandQueue->Signal(),
+		[this, buffer = std::move(m_DSBuffer), allocation = m_DSBufferAllocation]() mutable {
+			buffer.Reset();
+			m_ResourceHeapAllocator->Free(allocation);
+		}
+	);
+
+	m_DSBufferAllocation = PlacedAllocation();
 
 	m_DSBuffer = CreateDepthStencilBuffer(
 		m_Device,
 		m_ClientWidth, m_ClientHeight,
 		m_DepthSencilBufferFormat, m_DepthSencilViewFormat,
 		m_DepthClearValue,
-		m_SteniclClearValue
+		m_SteniclClearValue,
+		m_ResourceHeapAllocator.get(),
+		&m_DSBufferAllocation
 	);
 
 	UpdateDSView();
@@ -352,7 +374,6 @@ void BaseApp::ResizeDSBuffer() {
 void BaseApp::ResizeBackBuffers() {
 	for (uint32_t i = 0; i < m_NumBackBuffers; ++i) {
 		m_BackBuffers[i].Reset();
-		m_BackBuffersFenceValues[i] = m_BackBuffersFenceValues[m_CurrentBackBufferIndex];
 	}
 
 	DXGI_SWAP_CHAIN_DESC swapChainDesc = {};
@@ -0,0 +1,40 @@
+#include <MyD3D12Lib/BindlessRemap.h>
+
+#include <cassert>
+
+BindlessRemap::BindlessRemap(uint32_t numIds) :
+	m_Slots(numIds, InvalidSlot)
+{}
+
+void BindlessRemap::Clear() {
+	for (uint32_t id : m_Ids) {
+		m_Slots[id] = InvalidSlot;
+	}
+
+	m_Ids.clear();
+}
+
+uint32_t BindlessRemap::Add(uint32_t id) {
+	assert(id < m_Slots.size() && "Invalid id");
+
+	uint32_t& slot = m_Slots[id];
+
+	if (slot == InvalidSlot) {
+		slot = static_cast<uint32_t>(m_Ids.size());
+		m_Ids.push_back(id);
+	}
+
+	return slot;
+}
+
+uint32_t BindlessRemap::GetSlot(uint32_t id) const {
+	return id < m_Slots.size() ? m_Slots[id] : InvalidSlot;
+}
+
+uint32_t BindlessRemap::GetNumSlots() const {
+	return static_cast<uint32_t>(m_Ids.size());
+}
+
+const std::vector<uint32_t>& BindlessRemap::GetIds() const {
+	return m_Ids;
+}
\ No newline at end of file
@@ -0,0 +1,802 @@
+#include <MyD3D12Lib/BlockCompression.h>
+#include <MyD3D12Lib/ThreadPool.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+	const uint32_t BlockSize = 4;
+	const uint32_t NumBlockPixels = BlockSize * BlockSize;
+	const uint32_t NumChannels = 4;
+
+	// interpolation weights of BC7 4 bit indexes, in 1/64
+	const int32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// weights of second endpoint for BC1 indexes in 4 colors mode
+	const float BC1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	using EncodeBlockFunc = void (*)(const uint8_t*, uint8_t*);
+	using DecodeBlockFunc = void (*)(const uint8_t*, uint8_t*);
+
+	struct BitWriter {
+		uint8_t* Data;
+		uint32_t Position = 0;
+
+		void Write(uint32_t value, uint32_t numBits) {
+			for (uint32_t i = 0; i < numBits; ++i, ++Position) {
+				if ((value >> i) & 1) {
+					Data[Position >> 3] |= static_cast<uint8_t>(1 << (Position & 7));
+				}
+			}
+		}
+	};
+
+	struct BitReader {
+		const uint8_t* Data;
+		uint32_t Position = 0;
+
+		uint32_t Read(uint32_t numBits) {
+			uint32_t value = 0;
+
+			for (uint32_t i = 0; i < numBits; ++i, ++Position) {
+				value |= ((Data[Position >> 3] >> (Position & 7)) & 1) << i;
+			}
+
+			return value;
+		}
+	};
+
+	float Clamp255(float value) {
+		return std::clamp(value, 0.0f, 255.0f);
+	}
+
+	// principal axis of block colors by power iteration
+	void ComputePrincipalAxis(const uint8_t* pixels, uint32_t numChannels, float mean[4], float axis[4]) {
+		for (uint32_t c = 0; c < numChannels; ++c) {
+			float sum = 0.0f;
+
+			for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+				sum += pixels[p * NumChannels + c];
+			}
+
+			mean[c] = sum / NumBlockPixels;
+		}
+
+		float covariance[4][4] = {};
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			float d[4];
+
+			for (uint32_t c = 0; c < numChannels; ++c) {
+				d[c] = pixels[p * NumChannels + c] - mean[c];
+			}
+
+			for (uint32_t i = 0; i < numChannels; ++i) {
+				for (uint32_t j = 0; j < numChannels; ++j) {
+					covariance[i][j] += d[i] * d[j];
+				}
+			}
+		}
+
+		// iterations start from channel with largest variance
+		uint32_t maxChannel = 0;
+
+		for (uint32_t c = 0; c < numChannels; ++c) {
+			axis[c] = 0.0f;
+
+			if (covariance[c][c] > covariance[maxChannel][maxChannel]) {
+				maxChannel = c;
+			}
+		}
+
+		axis[maxChannel] = 1.0f;
+
+		for (uint32_t iter = 0; iter < 8; ++iter) {
+			float next[4] = {};
+			float length = 0.0f;
+
+			for (uint32_t i = 0; i < numChannels; ++i) {
+				for (uint32_t j = 0; j < numChannels; ++j) {
+					next[i] += covariance[i][j] * axis[j];
+				}
+
+				length += next[i] * next[i];
+			}
+
+			if (length < 1e-12f) {
+				break;
+			}
+
+			length = std::sqrt(length);
+
+			for (uint32_t c = 0; c < numChannels; ++c) {
+				axis[c] = next[c] / length;
+			}
+		}
+	}
+
+	// endpoints at extreme projections of block colors on principal axis
+	void ComputeAxisEndpoints(const uint8_t* pixels, uint32_t numChannels, float e0[4], float e1[4]) {
+		float mean[4];
+		float axis[4];
+		ComputePrincipalAxis(pixels, numChannels, mean, axis);
+
+		float minT = std::numeric_limits<float>::max();
+		float maxT = -std::numeric_limits<float>::max();
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			float t = 0.0f;
+
+			for (uint32_t c = 0; c < numChannels; ++c) {
+				t += (pixels[p * NumChannels + c] - mean[c]) * axis[c];
+			}
+
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		for (uint32_t c = 0; c < numChannels; ++c) {
+			e0[c] = Clamp255(mean[c] + axis[c] * minT);
+			e1[c] = Clamp255(mean[c] + axis[c] * maxT);
+		}
+	}
+
+	// least squares endpoints for fixed indexes, weights are of second endpoint
+	bool RefineEndpoints(
+		const uint8_t* pixels,
+		uint32_t numChannels,
+		const uint8_t* indexes,
+		const float* weights,
+		float e0[4], float e1[4])
+	{
+		float a = 0.0f;
+		float b = 0.0f;
+		float c = 0.0f;
+		float x0[4] = {};
+		float x1[4] = {};
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			float w = weights[indexes[p]];
+
+			a += (1.0f - w) * (1.0f - w);
+			b += (1.0f - w) * w;
+			c += w * w;
+
+			for (uint32_t ch = 0; ch < numChannels; ++ch) {
+				x0[ch] += (1.0f - w) * pixels[p * NumChannels + ch];
+				x1[ch] += w * pixels[p * NumChannels + ch];
+			}
+		}
+
+		float det = a * c - b * b;
+
+		if (std::fabs(det) < 1e-6f) {
+			return false;
+		}
+
+		for (uint32_t ch = 0; ch < numChannels; ++ch) {
+			e0[ch] = Clamp255((c * x0[ch] - b * x1[ch]) / det);
+			e1[ch] = Clamp255((a * x1[ch] - b * x0[ch]) / det);
+		}
+
+		return true;
+	}
+
+	// nearest palette entry for each pixel, returns squared error
+	uint32_t SelectIndexes(
+		const uint8_t* pixels,
+		uint32_t numChannels,
+		const int32_t (*palette)[4],
+		uint32_t paletteSize,
+		uint8_t* indexes)
+	{
+		uint32_t totalError = 0;
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			uint32_t bestError = std::numeric_limits<uint32_t>::max();
+
+			for (uint32_t k = 0; k < paletteSize; ++k) {
+				uint32_t error = 0;
+
+				for (uint32_t c = 0; c < numChannels; ++c) {
+					int32_t d = pixels[p * NumChannels + c] - palette[k][c];
+					error += d * d;
+				}
+
+				if (error < bestError) {
+					bestError = error;
+					indexes[p] = static_cast<uint8_t>(k);
+				}
+			}
+
+			totalError += bestError;
+		}
+
+		return totalError;
+	}
+
+	// palette entries lie on line, so nearest entry is found by projection and its neighbours are checked
+	uint32_t SelectIndexesOnLine(
+		const uint8_t* pixels,
+		uint32_t numChannels,
+		const int32_t (*palette)[4],
+		uint32_t paletteSize,
+		uint8_t* indexes)
+	{
+		float direction[4];
+		float lengthSq = 0.0f;
+
+		for (uint32_t c = 0; c < numChannels; ++c) {
+			direction[c] = static_cast<float>(palette[paletteSize - 1][c] - palette[0][c]);
+			lengthSq += direction[c] * direction[c];
+		}
+
+		float scale = lengthSq > 0.0f ? (paletteSize - 1) / lengthSq : 0.0f;
+		uint32_t totalError = 0;
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			const uint8_t* pixel = pixels + p * NumChannels;
+			float t = 0.0f;
+
+			for (uint32_t c = 0; c < numChannels; ++c) {
+				t += (pixel[c] - palette[0][c]) * direction[c];
+			}
+
+			int32_t center = static_cast<int32_t>(t * scale + 0.5f);
+			center = std::clamp(center, 0, static_cast<int32_t>(paletteSize - 1));
+
+			int32_t first = std::max(center - 1, 0);
+			int32_t last = std::min(center + 1, static_cast<int32_t>(paletteSize - 1));
+			uint32_t bestError = std::numeric_limits<uint32_t>::max();
+
+			for (int32_t k = first; k <= last; ++k) {
+				uint32_t error = 0;
+
+				for (uint32_t c = 0; c < numChannels; ++c) {
+					int32_t d = pixel[c] - palette[k][c];
+					error += d * d;
+				}
+
+				if (error < bestError) {
+					bestError = error;
+					indexes[p] = static_cast<uint8_t>(k);
+				}
+			}
+
+			totalError += bestError;
+		}
+
+		return totalError;
+	}
+
+	// BC1 colors
+
+	uint16_t PackRGB565(const float color[3]) {
+		uint32_t r = static_cast<uint32_t>(color[0] * 31.0f / 255.0f + 0.5f);
+		uint32_t g = static_cast<uint32_t>(color[1] * 63.0f / 255.0f + 0.5f);
+		uint32_t b = static_cast<uint32_t>(color[2] * 31.0f / 255.0f + 0.5f);
+
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	void UnpackRGB565(uint16_t packed, int32_t color[4]) {
+		int32_t r = (packed >> 11) & 31;
+		int32_t g = (packed >> 5) & 63;
+		int32_t b = packed & 31;
+
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+		color[3] = 255;
+	}
+
+	// 4 colors mode if c0 > c1, otherwise 3 colors and transparent black
+	void ComputeBC1Palette(uint16_t c0, uint16_t c1, int32_t palette[4][4]) {
+		UnpackRGB565(c0, palette[0]);
+		UnpackRGB565(c1, palette[1]);
+
+		for (uint32_t c = 0; c < 3; ++c) {
+			if (c0 > c1) {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+			}
+			else {
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+
+		palette[2][3] = 255;
+		palette[3][3] = c0 > c1 ? 255 : 0;
+	}
+
+	struct BC1Candidate {
+		uint16_t C0 = 0;
+		uint16_t C1 = 0;
+		uint8_t Indexes[NumBlockPixels] = {};
+		uint32_t Error = std::numeric_limits<uint32_t>::max();
+	};
+
+	// endpoints are ordered for 4 colors mode, equal endpoints use only first index
+	void EvaluateBC1(const uint8_t* pixels, const float e0[4], const float e1[4], BC1Candidate& best) {
+		BC1Candidate candidate;
+		candidate.C0 = PackRGB565(e0);
+		candidate.C1 = PackRGB565(e1);
+
+		if (candidate.C0 < candidate.C1) {
+			std::swap(candidate.C0, candidate.C1);
+		}
+
+		int32_t palette[4][4];
+		ComputeBC1Palette(candidate.C0, candidate.C1, palette);
+
+		uint32_t paletteSize = candidate.C0 == candidate.C1 ? 1 : 4;
+		candidate.Error = SelectIndexes(pixels, 3, palette, paletteSize, candidate.Indexes);
+
+		if (candidate.Error < best.Error) {
+			best = candidate;
+		}
+	}
+
+	void EncodeBC1Colors(const uint8_t* pixels, uint8_t* block) {
+		float e0[4];
+		float e1[4];
+		ComputeAxisEndpoints(pixels, 3, e0, e1);
+
+		BC1Candidate best;
+		EvaluateBC1(pixels, e0, e1, best);
+
+		// endpoints ordered by packed value, so weights are taken for swapped pair if needed
+		if (PackRGB565(e0) < PackRGB565(e1)) {
+			std::swap(e0, e1);
+		}
+
+		if (best.C0 != best.C1 && RefineEndpoints(pixels, 3, best.Indexes, BC1Weights, e0, e1)) {
+			EvaluateBC1(pixels, e0, e1, best);
+		}
+
+		uint32_t indexes = 0;
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			indexes |= static_cast<uint32_t>(best.Indexes[p]) << (2 * p);
+		}
+
+		block[0] = static_cast<uint8_t>(best.C0 & 0xFF);
+		block[1] = static_cast<uint8_t>(best.C0 >> 8);
+		block[2] = static_cast<uint8_t>(best.C1 & 0xFF);
+		block[3] = static_cast<uint8_t>(best.C1 >> 8);
+		std::memcpy(block + 4, &indexes, sizeof(indexes));
+	}
+
+	void DecodeBC1Colors(const uint8_t* block, uint8_t* pixels, bool allowTransparent) {
+		uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+		uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+
+		int32_t palette[4][4];
+		ComputeBC1Palette(c0, c1, palette);
+
+		// colors of BC3 block are always in 4 colors mode
+		if (!allowTransparent && c0 <= c1) {
+			for (uint32_t c = 0; c < 3; ++c) {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+			}
+
+			palette[3][3] = 255;
+		}
+
+		uint32_t indexes;
+		std::memcpy(&indexes, block + 4, sizeof(indexes));
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			const int32_t* color = palette[(indexes >> (2 * p)) & 3];
+
+			for (uint32_t c = 0; c < NumChannels; ++c) {
+				pixels[p * NumChannels + c] = static_cast<uint8_t>(color[c]);
+			}
+		}
+	}
+
+	// BC4 single channel blocks, used for BC3 alpha and BC5 channels
+
+	// 8 values mode if a0 > a1, otherwise 6 values with 0 and 255
+	void ComputeBC4Palette(int32_t a0, int32_t a1, int32_t palette[8]) {
+		palette[0] = a0;
+		palette[1] = a1;
+
+		if (a0 > a1) {
+			for (int32_t k = 1; k < 7; ++k) {
+				palette[k + 1] = ((7 - k) * a0 + k * a1 + 3) / 7;
+			}
+		}
+		else {
+			for (int32_t k = 1; k < 5; ++k) {
+				palette[k + 1] = ((5 - k) * a0 + k * a1 + 2) / 5;
+			}
+
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	void EncodeBC4Block(const uint8_t* pixels, uint32_t channel, uint8_t* block) {
+		int32_t minValue = 255;
+		int32_t maxValue = 0;
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			int32_t value = pixels[p * NumChannels + channel];
+			minValue = std::min(minValue, value);
+			maxValue = std::max(maxValue, value);
+		}
+
+		block[0] = static_cast<uint8_t>(maxValue);
+		block[1] = static_cast<uint8_t>(minValue);
+
+		int32_t palette[8];
+		ComputeBC4Palette(maxValue, minValue, palette);
+
+		uint64_t indexes = 0;
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			int32_t value = pixels[p * NumChannels + channel];
+			uint32_t bestIndex = 0;
+
+			// constant block uses only first index
+			for (uint32_t k = 1; k < 8 && maxValue != minValue; ++k) {
+				if (std::abs(value - palette[k]) < std::abs(value - palette[bestIndex])) {
+					bestIndex = k;
+				}
+			}
+
+			indexes |= static_cast<uint64_t>(bestIndex) << (3 * p);
+		}
+
+		for (uint32_t i = 0; i < 6; ++i) {
+			block[2 + i] = static_cast<uint8_t>(indexes >> (8 * i));
+		}
+	}
+
+	void DecodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* pixels) {
+		int32_t palette[8];
+		ComputeBC4Palette(block[0], block[1], palette);
+
+		uint64_t indexes = 0;
+
+		for (uint32_t i = 0; i < 6; ++i) {
+			indexes |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+		}
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			pixels[p * NumChannels + channel] = static_cast<uint8_t>(palette[(indexes >> (3 * p)) & 7]);
+		}
+	}
+
+	// BC7 mode 6: one subset, RGBA endpoints of 7 bits with unique p-bit, 4 bit indexes
+
+	struct BC7Candidate {
+		uint8_t Endpoints[2][4] = {};
+		uint8_t PBits[2] = {};
+		uint8_t Indexes[NumBlockPixels] = {};
+		uint32_t Error = std::numeric_limits<uint32_t>::max();
+	};
+
+	void ComputeBC7Palette(const int32_t e0[4], const int32_t e1[4], int32_t palette[16][4]) {
+		for (uint32_t k = 0; k < 16; ++k) {
+			for (uint32_t c = 0; c < NumChannels; ++c) {
+				palette[k][c] = ((64 - BC7Weights[k]) * e0[c] + BC7Weights[k] * e1[c] + 32) >> 6;
+			}
+		}
+	}
+
+	// all p-bits combinations are tried
+	void EvaluateBC7(const uint8_t* pixels, const float e0[4], const float e1[4], BC7Candidate& best) {
+		for (uint32_t pBits = 0; pBits < 4; ++pBits) {
+			BC7Candidate candidate;
+			candidate.PBits[0] = pBits & 1;
+			candidate.PBits[1] = pBits >> 1;
+
+			int32_t endpoints[2][4];
+
+			for (uint32_t c = 0; c < NumChannels; ++c) {
+				const float values[2] = { e0[c], e1[c] };
+
+				for (uint32_t e = 0; e < 2; ++e) {
+					int32_t quantized = static_cast<int32_t>(std::floor((values[e] - candidate.PBits[e]) / 2.0f + 0.5f));
+					quantized = std::clamp(quantized, 0, 127);
+
+					candidate.Endpoints[e][c] = static_cast<uint8_t>(quantized);
+					endpoints[e][c] = (quantized << 1) | candidate.PBits[e];
+				}
+			}
+
+			int32_t palette[16][4];
+			ComputeBC7Palette(endpoints[0], endpoints[1], palette);
+
+			candidate.Error = SelectIndexesOnLine(pixels, NumChannels, palette, 16, candidate.Indexes);
+
+			if (candidate.Error < best.Error) {
+				best = candidate;
+			}
+		}
+	}
+}
+
+uint32_t GetBlockByteSize(BlockFormat format) {
+	return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+void EncodeBC1Block(const uint8_t* pixels, uint8_t* block) {
+	EncodeBC1Colors(pixels, block);
+}
+
+void EncodeBC3Block(const uint8_t* pixels, uint8_t* block) {
+	EncodeBC4Block(pixels, 3, block);
+	EncodeBC1Colors(pixels, block + 8);
+}
+
+void EncodeBC5Block(const uint8_t* pixels, uint8_t* block) {
+	EncodeBC4Block(pixels, 0, block);
+	EncodeBC4Block(pixels, 1, block + 8);
+}
+
+void EncodeBC7Block(const uint8_t* pixels, uint8_t* block) {
+	float e0[4];
+	float e1[4];
+	ComputeAxisEndpoints(pixels, NumChannels, e0, e1);
+
+	BC7Candidate best;
+	EvaluateBC7(pixels, e0, e1, best);
+
+	float weights[16];
+
+	for (uint32_t k = 0; k < 16; ++k) {
+		weights[k] = BC7Weights[k] / 64.0f;
+	}
+
+	if (RefineEndpoints(pixels, NumChannels, best.Indexes, weights, e0, e1)) {
+		EvaluateBC7(pixels, e0, e1, best);
+	}
+
+	// most significant bit of anchor index is implicit zero
+	if (best.Indexes[0] >= 8) {
+		for (uint32_t c = 0; c < NumChannels; ++c) {
+			std::swap(best.Endpoints[0][c], best.Endpoints[1][c]);
+		}
+
+		std::swap(best.PBits[0], best.PBits[1]);
+
+		for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+			best.Indexes[p] = 15 - best.Indexes[p];
+		}
+	}
+
+	std::memset(block, 0, 16);
+	BitWriter writer{ block };
+
+	writer.Write(1 << 6, 7);
+
+	for (uint32_t c = 0; c < NumChannels; ++c) {
+		writer.Write(best.Endpoints[0][c], 7);
+		writer.Write(best.Endpoints[1][c], 7);
+	}
+
+	writer.Write(best.PBits[0], 1);
+	writer.Write(best.PBits[1], 1);
+
+	for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+		writer.Write(best.Indexes[p], p == 0 ? 3 : 4);
+	}
+}
+
+void DecodeBC1Block(const uint8_t* block, uint8_t* pixels) {
+	DecodeBC1Colors(block, pixels, true);
+}
+
+void DecodeBC3Block(const uint8_t* block, uint8_t* pixels) {
+	DecodeBC1Colors(block + 8, pixels, false);
+	DecodeBC4Block(block, 3, pixels);
+}
+
+void DecodeBC5Block(const uint8_t* block, uint8_t* pixels) {
+	DecodeBC4Block(block, 0, pixels);
+	DecodeBC4Block(block + 8, 1, pixels);
+
+	for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+		pixels[p * NumChannels + 2] = 0;
+		pixels[p * NumChannels + 3] = 255;
+	}
+}
+
+void DecodeBC7Block(const uint8_t* block, uint8_t* pixels) {
+	BitReader reader{ block };
+
+	if (reader.Read(7) != (1 << 6)) {
+		assert(false && "Only BC7 mode 6 is supported");
+		std::memset(pixels, 0, NumBlockPixels * NumChannels);
+		return;
+	}
+
+	int32_t endpoints[2][4];
+
+	for (uint32_t c = 0; c < NumChannels; ++c) {
+		endpoints[0][c] = reader.Read(7) << 1;
+		endpoints[1][c] = reader.Read(7) << 1;
+	}
+
+	uint32_t pBit0 = reader.Read(1);
+	uint32_t pBit1 = reader.Read(1);
+
+	for (uint32_t c = 0; c < NumChannels; ++c) {
+		endpoints[0][c] |= pBit0;
+		endpoints[1][c] |= pBit1;
+	}
+
+	int32_t palette[16][4];
+	ComputeBC7Palette(endpoints[0], endpoints[1], palette);
+
+	for (uint32_t p = 0; p < NumBlockPixels; ++p) {
+		uint32_t index = reader.Read(p == 0 ? 3 : 4);
+
+		for (uint32_t c = 0; c < NumChannels; ++c) {
+			pixels[p * NumChannels + c] = static_cast<uint8_t>(palette[index][c]);
+		}
+	}
+}
+
+namespace {
+	EncodeBlockFunc GetEncodeBlockFunc(BlockFormat format) {
+		switch (format) {
+		case BlockFormat::BC1: return EncodeBC1Block;
+		case BlockFormat::BC3: return EncodeBC3Block;
+		case BlockFormat::BC5: return EncodeBC5Block;
+		default: return EncodeBC7Block;
+		}
+	}
+
+	DecodeBlockFunc GetDecodeBlockFunc(BlockFormat format) {
+		switch (format) {
+		case BlockFormat::BC1: return DecodeBC1Block;
+		case BlockFormat::BC3: return DecodeBC3Block;
+		case BlockFormat::BC5: return DecodeBC5Block;
+		default: return DecodeBC7Block;
+		}
+	}
+
+	uint32_t GetNumStoredChannels(BlockFormat format) {
+		switch (format) {
+		case BlockFormat::BC1: return 3;
+		case BlockFormat::BC5: return 2;
+		default: return 4;
+		}
+	}
+
+	// edge pixels are repeated for partial blocks
+	void LoadBlock(const uint8_t* level, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* pixels) {
+		for (uint32_t y = 0; y < BlockSize; ++y) {
+			uint32_t srcY = std::min(blockY * BlockSize + y, height - 1);
+
+			for (uint32_t x = 0; x < BlockSize; ++x) {
+				uint32_t srcX = std::min(blockX * BlockSize + x, width - 1);
+
+				std::memcpy(
+					pixels + (y * BlockSize + x) * NumChannels,
+					level + (static_cast<size_t>(srcY) * width + srcX) * NumChannels,
+					NumChannels
+				);
+			}
+		}
+	}
+}
+
+CompressedMipChain CompressMipChain(const MipChain& chain, BlockFormat format, ThreadPool* pool) {
+	struct BlocksRow {
+		uint32_t Level;
+		uint32_t Row;
+	};
+
+	CompressedMipChain compressed;
+	compressed.Format = format;
+
+	uint32_t blockByteSize = GetBlockByteSize(format);
+	std::vector<BlocksRow> rows;
+	size_t offset = 0;
+
+	for (uint32_t i = 0; i < chain.Levels.size(); ++i) {
+		const MipLevel& level = chain.Levels[i];
+
+		CompressedLevel compressedLevel;
+		compressedLevel.Width = level.Width;
+		compressedLevel.Height = level.Height;
+		compressedLevel.RowPitch = (level.Width + BlockSize - 1) / BlockSize * blockByteSize;
+		compressedLevel.NumRows = (level.Height + BlockSize - 1) / BlockSize;
+		compressedLevel.Offset = offset;
+
+		offset += static_cast<size_t>(compressedLevel.RowPitch) * compressedLevel.NumRows;
+		compressed.Levels.push_back(compressedLevel);
+
+		for (uint32_t row = 0; row < compressedLevel.NumRows; ++row) {
+			rows.push_back({ i, row });
+		}
+	}
+
+	compressed.Data.resize(offset);
+
+	EncodeBlockFunc encodeBlock = GetEncodeBlockFunc(format);
+
+	auto encodeRow = [&](uint32_t i) {
+		const MipLevel& level = chain.Levels[rows[i].Level];
+		const CompressedLevel& compressedLevel = compressed.Levels[rows[i].Level];
+
+		const uint8_t* levelPixels = chain.Data.data() + level.Offset;
+		uint8_t* rowBlocks = compressed.Data.data() + compressedLevel.Offset + static_cast<size_t>(rows[i].Row) * compressedLevel.RowPitch;
+
+		uint32_t numBlocks = compressedLevel.RowPitch / blockByteSize;
+		uint8_t pixels[NumBlockPixels * NumChannels];
+
+		for (uint32_t blockX = 0; blockX < numBlocks; ++blockX) {
+			LoadBlock(levelPixels, level.Width, level.Height, blockX, rows[i].Row, pixels);
+			encodeBlock(pixels, rowBlocks + blockX * blockByteSize);
+		}
+	};
+
+	if (pool != nullptr) {
+		pool->ParallelFor(static_cast<uint32_t>(rows.size()), encodeRow);
+	}
+	else {
+		for (uint32_t i = 0; i < rows.size(); ++i) {
+			encodeRow(i);
+		}
+	}
+
+	return compressed;
+}
+
+float ComputeCompressionPSNR(const MipChain& chain, const CompressedMipChain& compressed, uint32_t level) {
+	assert(level < chain.Levels.size() && level < compressed.Levels.size() && "Level is out of chain");
+
+	const MipLevel& mipLevel = chain.Levels[level];
+	const CompressedLevel& compressedLevel = compressed.Levels[level];
+
+	DecodeBlockFunc decodeBlock = GetDecodeBlockFunc(compressed.Format);
+	uint32_t blockByteSize = GetBlockByteSize(compressed.Format);
+	uint32_t numChannels = GetNumStoredChannels(compressed.Format);
+
+	const uint8_t* levelPixels = chain.Data.data() + mipLevel.Offset;
+	uint8_t pixels[NumBlockPixels * NumChannels];
+	double squaredError = 0.0;
+
+	for (uint32_t blockY = 0; blockY < compressedLevel.NumRows; ++blockY) {
+		for (uint32_t blockX = 0; blockX < compressedLevel.RowPitch / blockByteSize; ++blockX) {
+			const uint8_t* block = compressed.Data.data() + compressedLevel.Offset
+				+ static_cast<size_t>(blockY) * compressedLevel.RowPitch + blockX * blockByteSize;
+
+			decodeBlock(block, pixels);
+
+			// padding pixels are skipped
+			uint32_t blockWidth = std::min(BlockSize, mipLevel.Width - blockX * BlockSize);
+			uint32_t blockHeight = std::min(BlockSize, mipLevel.Height - blockY * BlockSize);
+
+			for (uint32_t y = 0; y < blockHeight; ++y) {
+				for (uint32_t x = 0; x < blockWidth; ++x) {
+					size_t srcIndex = (static_cast<size_t>(blockY * BlockSize + y) * mipLevel.Width + blockX * BlockSize + x) * NumChannels;
+
+					for (uint32_t c = 0; c < numChannels; ++c) {
+						double d = static_cast<double>(levelPixels[srcIndex + c]) - pixels[(y * BlockSize + x) * NumChannels + c];
+						squaredError += d * d;
+					}
+				}
+			}
+		}
+	}
+
+	double meanError = squaredError / (static_cast<double>(mipLevel.Width) * mipLevel.Height * numChannels);
+
+	if (meanError == 0.0) {
+		return std::numeric_limits<float>::infinity();
+	}
+
+	return static_cast<float>(10.0 * std::log10(255.0 * 255.0 / meanError));
+}
\ No newline at end of file
@@ -27,25 +27,22 @@ ComPtr<ID3D12GraphicsCommandList> CommandQueue::GetCommandList() {
 	ComPtr<ID3D12CommandAllocator> commandAllocator;
 	ComPtr<ID3D12GraphicsCommandList> commandList;
 
-	if (!m_CommandAllocators.empty() && IsFenceComplite(m_CommandAllocators.front().fenceValue)) {
-		commandAllocator = m_CommandAllocators.front().CommandAllocator;
-		m_CommandAllocators.pop();
+	if (m_CommandListPool.TakeAllocator(GetCompletedFenceValue(), commandAllocator)) {
 		ThrowIfFailed(commandAllocator->Reset());
 	}
 	else {
 		commandAllocator = CreateCommandAllocator();
 	}
 
-	if (!m_CommandLists.empty()) {
-		commandList = m_CommandLists.front();
-		m_CommandLists.pop();
+	if (m_CommandListPool.TakeList(commandList)) {
 		ThrowIfFailed(commandList->Reset(commandAllocator.Get(), NULL));
 	}
 	else {
 		commandList = CreateCommandList(commandAllocator);
 	}
 
-	commandList->SetPrivateDataInterface(__uuidof(ID3D12CommandAllocator), commandAllocator.Get());
+	// allocator is found by list at submission
+	m_CommandListPool.Open(commandList, commandAllocator);
 
 	return commandList;
 }
@@ -55,26 +52,34 @@ ComPtr<ID3D12CommandQueue> CommandQueue::GetCommandQueue() const {
 }
 
 uint64_t CommandQueue::ExecuteCommandList(ComPtr<ID3D12GraphicsCommandList> commandList) {
-	commandList->Close();
-
-	ID3D12CommandAllocator* commandAllocator;
-	UINT dataSize = sizeof(commandAllocator);
+	// list which isn`t taken from this queue or is already submitted is rejected before GPU gets it
+	m_CommandListPool.Validate(&commandList, 1);
 
-	ThrowIfFailed(commandList->GetPrivateData(
-		__uuidof(ID3D12CommandAllocator),
-		&dataSize,
-		&commandAllocator
-	));
+	commandList->Close();
 
 	ID3D12CommandList* const pCommandLists[] = { commandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(1, pCommandLists);
 	uint64_t fenceValue = Signal();
 
+	m_CommandListPool.Submit(&commandList, 1, fenceValue);
+
+	return fenceValue;
+}
+
+uint64_t CommandQueue::ExecuteCommandLists(const std::vector<ComPtr<ID3D12GraphicsCommandList>>& commandLists) {
+	m_CommandListPool.Validate(commandLists.data(), static_cast<uint32_t>(commandLists.size()));
 
-	m_CommandAllocators.emplace(CommandAllocatorEntry{ commandAllocator, fenceValue });
-	m_CommandLists.push(commandList);
+	m_SubmittedLists.clear();
 
-	commandAllocator->Release();
+	for (const ComPtr<ID3D12GraphicsCommandList>& commandList : commandLists) {
+		commandList->Close();
+		m_SubmittedLists.push_back(commandList.Get());
+	}
+
+	m_CommandQueue->ExecuteCommandLists(static_cast<UINT>(m_SubmittedLists.size()), m_SubmittedLists.data());
+	uint64_t fenceValue = Signal();
+
+	m_CommandListPool.Submit(commandLists.data(), static_cast<uint32_t>(commandLists.size()), fenceValue);
 
 	return fenceValue;
 }
@@ -83,6 +88,10 @@ bool CommandQueue::IsFenceComplite(uint64_t fenceValue) const {
 	return m_Fence->GetCompletedValue() >= fenceValue;
 }
 
+uint64_t CommandQueue::GetCompletedFenceValue() const {
+	return m_Fence->GetCompletedValue();
+}
+
 uint64_t CommandQueue::Signal() {
 	uint64_t signalValue = ++m_FenceValue;
 	m_CommandQueue->Signal(m_Fence.Get(), signalValue);
@@ -96,6 +105,10 @@ void CommandQueue::WaitForFenceValue(uint64_t fenceValue) {
 	}
 }
 
+void CommandQueue::Wait(const CommandQueue& other, uint64_t fenceValue) {
+	ThrowIfFailed(m_CommandQueue->Wait(other.m_Fence.Get(), fenceValue));
+}
+
 void CommandQueue::Flush() {
 	WaitForFenceValue(Signal());
 }
@@ -0,0 +1,213 @@
+#include <MyD3D12Lib/ContentHash.h>
+#include <MyD3D12Lib/CpuFeatures.h>
+
+#include <immintrin.h>
+
+#include <cstring>
+
+namespace {
+	const uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+	const uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+	const uint32_t Prime32 = 0x9E3779B1u;
+
+	const uint32_t NumLanes = 8;
+	const size_t StripeSize = NumLanes * sizeof(uint64_t);
+	// accumulators are scrambled after each block of stripes to keep high bits mixed
+	const size_t StripesPerBlock = 16;
+
+	uint64_t Mix(uint64_t x) {
+		x ^= x >> 30;
+		x *= 0xBF58476D1CE4E5B9ull;
+		x ^= x >> 27;
+		x *= 0x94D049BB133111EBull;
+		x ^= x >> 31;
+		return x;
+	}
+
+	uint64_t Load64(const uint8_t* data) {
+		uint64_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	// stripe s of block is keyed by Keys[s, s + NumLanes), so equal stripes at different positions differ
+	// last NumLanes keys are used for scrambling
+	const uint32_t NumKeys = StripesPerBlock + NumLanes;
+
+	const uint64_t* GetScrambleKeys(const uint64_t* keys) {
+		return keys + StripesPerBlock;
+	}
+
+	struct HashState {
+		alignas(32) uint64_t Acc[NumLanes];
+		alignas(32) uint64_t Keys[NumKeys];
+
+		explicit HashState(uint64_t seed) {
+			for (uint32_t i = 0; i < NumLanes; ++i) {
+				Acc[i] = Mix(seed ^ (Prime2 * (i + 1)));
+			}
+
+			for (uint32_t i = 0; i < NumKeys; ++i) {
+				Keys[i] = Mix(seed + Prime1 * (i + 1));
+			}
+		}
+	};
+
+	// each lane gets product of keyed value halves and unkeyed value of neighbour lane
+	void AccumulateStripeScalar(HashState& state, const uint8_t* stripe, size_t stripeIndex) {
+		const uint64_t* keys = state.Keys + stripeIndex % StripesPerBlock;
+
+		for (uint32_t i = 0; i < NumLanes; ++i) {
+			uint64_t value = Load64(stripe + i * sizeof(uint64_t));
+			uint64_t keyed = value ^ keys[i];
+
+			state.Acc[i ^ 1] += value;
+			state.Acc[i] += (keyed & 0xFFFFFFFFull) * (keyed >> 32);
+		}
+	}
+
+	void ScrambleScalar(HashState& state) {
+		const uint64_t* keys = GetScrambleKeys(state.Keys);
+
+		for (uint32_t i = 0; i < NumLanes; ++i) {
+			uint64_t acc = state.Acc[i];
+			acc ^= acc >> 47;
+			acc ^= keys[i];
+			state.Acc[i] = acc * Prime32;
+		}
+	}
+
+	void AccumulateScalar(HashState& state, const uint8_t* data, size_t numStripes) {
+		for (size_t s = 0; s < numStripes; ++s) {
+			AccumulateStripeScalar(state, data + s * StripeSize, s);
+
+			if ((s + 1) % StripesPerBlock == 0) {
+				ScrambleScalar(state);
+			}
+		}
+	}
+
+	void AccumulateSSE2(HashState& state, const uint8_t* data, size_t numStripes) {
+		__m128i acc[4];
+		__m128i scrambleKeys[4];
+
+		for (uint32_t j = 0; j < 4; ++j) {
+			acc[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(state.Acc) + j);
+			scrambleKeys[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(GetScrambleKeys(state.Keys)) + j);
+		}
+
+		const __m128i prime = _mm_set1_epi32(static_cast<int>(Prime32));
+
+		for (size_t s = 0; s < numStripes; ++s) {
+			const __m128i* stripe = reinterpret_cast<const __m128i*>(data + s * StripeSize);
+			const __m128i* keys = reinterpret_cast<const __m128i*>(state.Keys + s % StripesPerBlock);
+
+			for (uint32_t j = 0; j < 4; ++j) {
+				__m128i value = _mm_loadu_si128(stripe + j);
+				__m128i keyed = _mm_xor_si128(value, _mm_loadu_si128(keys + j));
+				__m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+				__m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+
+				acc[j] = _mm_add_epi64(acc[j], _mm_add_epi64(product, swapped));
+			}
+
+			if ((s + 1) % StripesPerBlock == 0) {
+				for (uint32_t j = 0; j < 4; ++j) {
+					__m128i a = _mm_xor_si128(acc[j], _mm_srli_epi64(acc[j], 47));
+					a = _mm_xor_si128(a, scrambleKeys[j]);
+
+					// 64 bit by 32 bit multiplication from two 32 bit products
+					__m128i low = _mm_mul_epu32(a, prime);
+					__m128i high = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+					acc[j] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+				}
+			}
+		}
+
+		for (uint32_t j = 0; j < 4; ++j) {
+			_mm_store_si128(reinterpret_cast<__m128i*>(state.Acc) + j, acc[j]);
+		}
+	}
+
+	SIMD_TARGET_AVX2
+	void AccumulateAVX2(HashState& state, const uint8_t* data, size_t numStripes) {
+		__m256i acc[2];
+		__m256i scrambleKeys[2];
+
+		for (uint32_t j = 0; j < 2; ++j) {
+			acc[j] = _mm256_load_si256(reinterpret_cast<const __m256i*>(state.Acc) + j);
+			scrambleKeys[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(GetScrambleKeys(state.Keys)) + j);
+		}
+
+		const __m256i prime = _mm256_set1_epi32(static_cast<int>(Prime32));
+
+		for (size_t s = 0; s < numStripes; ++s) {
+			const __m256i* stripe = reinterpret_cast<const __m256i*>(data + s * StripeSize);
+			const __m256i* keys = reinterpret_cast<const __m256i*>(state.Keys + s % StripesPerBlock);
+
+			for (uint32_t j = 0; j < 2; ++j) {
+				__m256i value = _mm256_loadu_si256(stripe + j);
+				__m256i keyed = _mm256_xor_si256(value, _mm256_loadu_si256(keys + j));
+				__m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+				__m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+
+				acc[j] = _mm256_add_epi64(acc[j], _mm256_add_epi64(product, swapped));
+			}
+
+			if ((s + 1) % StripesPerBlock == 0) {
+				for (uint32_t j = 0; j < 2; ++j) {
+					__m256i a = _mm256_xor_si256(acc[j], _mm256_srli_epi64(acc[j], 47));
+					a = _mm256_xor_si256(a, scrambleKeys[j]);
+
+					__m256i low = _mm256_mul_epu32(a, prime);
+					__m256i high = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+					acc[j] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+				}
+			}
+		}
+
+		for (uint32_t j = 0; j < 2; ++j) {
+			_mm256_store_si256(reinterpret_cast<__m256i*>(state.Acc) + j, acc[j]);
+		}
+	}
+
+	using AccumulateFunc = void (*)(HashState&, const uint8_t*, size_t);
+
+	// full stripes are accumulated by given function, last partial stripe is zero padded
+	Hash128 ComputeHash(const void* data, size_t size, uint64_t seed, AccumulateFunc accumulate) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		HashState state(seed);
+
+		size_t numStripes = size / StripeSize;
+		accumulate(state, bytes, numStripes);
+
+		size_t tailSize = size - numStripes * StripeSize;
+
+		if (tailSize > 0) {
+			uint8_t tail[StripeSize] = {};
+			std::memcpy(tail, bytes + numStripes * StripeSize, tailSize);
+			AccumulateStripeScalar(state, tail, numStripes);
+		}
+
+		// size is mixed in, so zero padding differs from real zeros
+		Hash128 hash;
+		hash.Low = Mix(size * Prime1 ^ seed);
+		hash.High = Mix(~size * Prime2 + seed);
+
+		for (uint32_t i = 0; i < NumLanes; ++i) {
+			hash.Low = Mix(hash.Low ^ state.Acc[i]);
+			hash.High = Mix(hash.High + (state.Acc[i] ^ state.Keys[NumKeys - 1 - i]));
+		}
+
+		return hash;
+	}
+}
+
+Hash128 ComputeContentHash(const void* data, size_t size, uint64_t seed) {
+	AccumulateFunc accumulate = IsAVX2Supported() ? AccumulateAVX2 : AccumulateSSE2;
+	return ComputeHash(data, size, seed, accumulate);
+}
+
+Hash128 ComputeContentHashScalar(const void* data, size_t size, uint64_t seed) {
+	return ComputeHash(data, size, seed, AccumulateScalar);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include <MyD3D12Lib/CpuFeatures.h>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace {
+	struct CpuFeatures {
+		bool AVX2 = false;
+		bool SSE41 = false;
+
+		CpuFeatures() {
+#if defined(_MSC_VER)
+			int info[4];
+
+			__cpuid(info, 0);
+			int maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			bool sse41 = (info[2] & (1 << 19)) != 0;
+			bool fma = (info[2] & (1 << 12)) != 0;
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			bool f16c = (info[2] & (1 << 29)) != 0;
+
+			bool avx2 = false;
+
+			if (maxLeaf >= 7) {
+				__cpuidex(info, 7, 0);
+				avx2 = (info[1] & (1 << 5)) != 0;
+			}
+
+			// OS should save YMM registers on context switch
+			bool ymmEnabled = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+
+			SSE41 = sse41;
+			AVX2 = avx && avx2 && f16c && fma && ymmEnabled;
+#else
+			__builtin_cpu_init();
+
+			SSE41 = __builtin_cpu_supports("sse4.1");
+			AVX2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c") && __builtin_cpu_supports("fma");
+#endif
+		}
+	};
+
+	const CpuFeatures& GetCpuFeatures() {
+		static CpuFeatures features;
+		return features;
+	}
+}
+
+bool IsAVX2Supported() {
+	return GetCpuFeatures().AVX2;
+}
+
+bool IsSSE41Supported() {
+	return GetCpuFeatures().SSE41;
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <MyD3D12Lib/D3D12Utils.h>
 #include <MyD3D12Lib/Helpers.h>
+#include <MyD3D12Lib/DDSReader.h>
 
 #include <DirectXTK12/DDSTextureLoader.h>
 #include <DirectXTK12/WICTextureLoader.h>
@@ -7,6 +8,10 @@
 #include <d3dcompiler.h>
 #include <d3dx12.h>
 
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
 using namespace DirectX;
 
 // compile shader from file
@@ -47,27 +52,215 @@ ComPtr<ID3DBlob> CompileShader(
 }
 
 // texture loading
-void CreateDDSTextureFromFile(
+uint64_t GetResourceAllocationSize(ComPtr<ID3D12Device2> device, ID3D12Resource* resource) {
+	D3D12_RESOURCE_DESC desc = resource->GetDesc();
+	return device->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+}
+
+namespace {
+	std::vector<ID3D12Pageable*> GetPageables(const std::vector<ID3D12Resource*>& resources) {
+		std::vector<ID3D12Pageable*> pageables;
+
+		for (ID3D12Resource* resource : resources) {
+			if (resource != nullptr) {
+				pageables.push_back(resource);
+			}
+		}
+
+		return pageables;
+	}
+}
+
+void EvictResources(ComPtr<ID3D12Device2> device, const std::vector<ID3D12Resource*>& resources) {
+	std::vector<ID3D12Pageable*> pageables = GetPageables(resources);
+
+	if (!pageables.empty()) {
+		ThrowIfFailed(device->Evict(static_cast<UINT>(pageables.size()), pageables.data()));
+	}
+}
+
+void MakeResourcesResident(ComPtr<ID3D12Device2> device, const std::vector<ID3D12Resource*>& resources) {
+	std::vector<ID3D12Pageable*> pageables = GetPageables(resources);
+
+	if (!pageables.empty()) {
+		ThrowIfFailed(device->MakeResident(static_cast<UINT>(pageables.size()), pageables.data()));
+	}
+}
+
+std::vector<uint8_t> ReadFileData(const std::filesystem::path& fileName) {
+	std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+
+	if (!file) {
+		throw std::exception();
+	}
+
+	std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+
+	if (!file) {
+		throw std::exception();
+	}
+
+	return data;
+}
+
+void WriteFileData(const std::filesystem::path& fileName, const std::vector<uint8_t>& data) {
+	std::filesystem::path tempFileName = fileName;
+	tempFileName += ".tmp";
+
+	{
+		std::ofstream file(tempFileName, std::ios::binary | std::ios::trunc);
+
+		if (!file) {
+			throw std::exception();
+		}
+
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+		if (!file) {
+			throw std::exception();
+		}
+	}
+
+	std::filesystem::rename(tempFileName, fileName);
+}
+
+DecodedTexture DecodeWICTextureFromMemory(
 	ComPtr<ID3D12Device2> device,
-	ComPtr<ID3D12GraphicsCommandList> commandList,
-	std::wstring fileName,
-	ComPtr<ID3D12Resource> & resource,
-	ComPtr<ID3D12Resource> & uploadResource) 
+	const uint8_t* data,
+	size_t dataSize,
+	const MipGenerationDesc* mipDesc)
 {
-	std::unique_ptr<uint8_t[]> ddsData;
-	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+	DecodedTexture texture;
+	D3D12_SUBRESOURCE_DATA subresource;
 
-	ThrowIfFailed(LoadDDSTextureFromFile(
+	if (mipDesc == nullptr) {
+		ThrowIfFailed(LoadWICTextureFromMemory(
+			device.Get(),
+			data, dataSize,
+			&texture.Resource,
+			texture.Data, subresource
+		));
+
+		texture.Desc = texture.Resource->GetDesc();
+		texture.Subresources.push_back(subresource);
+
+		return texture;
+	}
+
+	// resource is created with full mip chain, only top level is decoded
+	ThrowIfFailed(LoadWICTextureFromMemoryEx(
 		device.Get(),
-		fileName.c_str(),
-		&resource,
-		ddsData, subresources
+		data, dataSize,
+		0,
+		D3D12_RESOURCE_FLAG_NONE,
+		WIC_LOADER_MIP_RESERVE | WIC_LOADER_FORCE_RGBA32,
+		&texture.Resource,
+		texture.Data, subresource
+	));
+
+	texture.Desc = texture.Resource->GetDesc();
+	const D3D12_RESOURCE_DESC& desc = texture.Desc;
+
+	MipChain chain = GenerateMipChain(
+		static_cast<const uint8_t*>(subresource.pData),
+		static_cast<uint32_t>(desc.Width),
+		desc.Height,
+		static_cast<uint32_t>(subresource.RowPitch),
+		*mipDesc,
+		desc.MipLevels
+	);
+
+	texture.Mips = std::move(chain);
+	texture.Data.reset();
+
+	for (const MipLevel& level : texture.Mips.Levels) {
+		D3D12_SUBRESOURCE_DATA levelData;
+		levelData.pData = texture.Mips.Data.data() + level.Offset;
+		levelData.RowPitch = level.Width * 4;
+		levelData.SlicePitch = levelData.RowPitch * level.Height;
+
+		texture.Subresources.push_back(levelData);
+	}
+
+	return texture;
+}
+
+DecodedTexture CreateSolidColorTexture(
+	ComPtr<ID3D12Device2> device,
+	uint8_t r, uint8_t g, uint8_t b, uint8_t a,
+	bool isSRGB)
+{
+	DecodedTexture texture;
+
+	ThrowIfFailed(device->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Tex2D(
+			isSRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM,
+			1, 1, 1, 1
+		),
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(&texture.Resource)
 	));
 
+	texture.Desc = texture.Resource->GetDesc();
+	texture.Data = std::make_unique<uint8_t[]>(4);
+	texture.Data[0] = r;
+	texture.Data[1] = g;
+	texture.Data[2] = b;
+	texture.Data[3] = a;
+
+	D3D12_SUBRESOURCE_DATA subresource;
+	subresource.pData = texture.Data.get();
+	subresource.RowPitch = 4;
+	subresource.SlicePitch = 4;
+
+	texture.Subresources.push_back(subresource);
+
+	return texture;
+}
+
+TextureContentKey ComputeTextureContentKey(const DecodedTexture& texture) {
+	const D3D12_RESOURCE_DESC& desc = texture.Desc;
+
+	TextureContentKey key;
+	key.Format = static_cast<uint32_t>(desc.Format);
+	key.Width = static_cast<uint32_t>(desc.Width);
+	key.Height = desc.Height;
+	key.MipLevels = desc.MipLevels;
+
+	// subresources are chained through seed
+	for (const D3D12_SUBRESOURCE_DATA& subresource : texture.Subresources) {
+		key.ContentHash = ComputeContentHash(subresource.pData, subresource.SlicePitch, key.ContentHash.Low ^ key.ContentHash.High);
+	}
+
+	return key;
+}
+
+uint64_t GetTextureDataSize(const DecodedTexture& texture) {
+	uint64_t size = 0;
+
+	for (const D3D12_SUBRESOURCE_DATA& subresource : texture.Subresources) {
+		size += subresource.SlicePitch;
+	}
+
+	return size;
+}
+
+void RecordTextureUpload(
+	ComPtr<ID3D12Device2> device,
+	ComPtr<ID3D12GraphicsCommandList> commandList,
+	const DecodedTexture& texture,
+	ComPtr<ID3D12Resource>& uploadResource)
+{
 	const UINT64 uploadBufferSize = GetRequiredIntermediateSize(
-		resource.Get(),
+		texture.Resource.Get(),
 		0,
-		static_cast<UINT>(subresources.size())
+		static_cast<UINT>(texture.Subresources.size())
 	);
 
 	ThrowIfFailed(device->CreateCommittedResource(
@@ -81,16 +274,21 @@ void CreateDDSTextureFromFile(
 
 	UpdateSubresources(
 		commandList.Get(),
-		resource.Get(),
+		texture.Resource.Get(),
 		uploadResource.Get(),
 		0,
 		0,
-		static_cast<UINT>(subresources.size()),
-		subresources.data()
+		static_cast<UINT>(texture.Subresources.size()),
+		texture.Subresources.data()
 	);
 
+	// copy queue can`t transition to shader resource states
+	if (commandList->GetType() == D3D12_COMMAND_LIST_TYPE_COPY) {
+		return;
+	}
+
 	CD3DX12_RESOURCE_BARRIER barier = CD3DX12_RESOURCE_BARRIER::Transition(
-		resource.Get(),
+		texture.Resource.Get(),
 		D3D12_RESOURCE_STATE_COPY_DEST,
 		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
 	);
@@ -98,47 +296,132 @@ void CreateDDSTextureFromFile(
 	commandList->ResourceBarrier(1, &barier);
 }
 
-void CreateWICTextureFromFile(
+bool IsBlockCompressedFormat(DXGI_FORMAT format) {
+	return
+		(format >= DXGI_FORMAT_BC1_TYPELESS && format <= DXGI_FORMAT_BC5_SNORM) ||
+		(format >= DXGI_FORMAT_BC6H_TYPELESS && format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+}
+
+uint32_t GetMaxFirstMip(const D3D12_RESOURCE_DESC& desc) {
+	uint32_t maxFirstMip = desc.MipLevels - 1;
+
+	if (!IsBlockCompressedFormat(desc.Format)) {
+		return maxFirstMip;
+	}
+
+	uint32_t mip = 0;
+
+	// next mip should be non empty and multiple of block size
+	while (mip < maxFirstMip) {
+		UINT64 width = desc.Width >> (mip + 1);
+		UINT height = desc.Height >> (mip + 1);
+
+		if (width == 0 || height == 0 || width % 4 != 0 || height % 4 != 0) {
+			break;
+		}
+
+		++mip;
+	}
+
+	return mip;
+}
+
+ComPtr<ID3D12Resource> RecordTextureMipsUpdate(
 	ComPtr<ID3D12Device2> device,
 	ComPtr<ID3D12GraphicsCommandList> commandList,
-	std::wstring fileName,
-	ComPtr<ID3D12Resource>& resource,
+	const DecodedTexture& texture,
+	uint32_t firstMip,
+	ID3D12Resource* residentResource,
+	uint32_t residentFirstMip,
 	ComPtr<ID3D12Resource>& uploadResource)
 {
-	std::unique_ptr<uint8_t[]> ddsData;
-	D3D12_SUBRESOURCE_DATA subresources;
+	assert(texture.Desc.DepthOrArraySize == 1 && "Only mips of single 2D texture can be streamed");
+	assert(firstMip < texture.Desc.MipLevels && "Texture should have at least one mip");
 
-	ThrowIfFailed(LoadWICTextureFromFile(
-		device.Get(),
-		fileName.c_str(),
-		&resource,
-		ddsData, subresources
-	));
+	uint32_t numMips = texture.Desc.MipLevels - firstMip;
 
-	const UINT64 uploadBufferSize = GetRequiredIntermediateSize(
-		resource.Get(),
-		0,
-		1
-	);
+	D3D12_RESOURCE_DESC desc = texture.Desc;
+	desc.Width = (std::max)(desc.Width >> firstMip, UINT64(1));
+	desc.Height = (std::max)(desc.Height >> firstMip, UINT(1));
+	desc.MipLevels = static_cast<UINT16>(numMips);
+
+	ComPtr<ID3D12Resource> resource;
 
 	ThrowIfFailed(device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
 		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
+		&desc,
+		D3D12_RESOURCE_STATE_COPY_DEST,
 		nullptr,
-		IID_PPV_ARGS(&uploadResource)
+		IID_PPV_ARGS(&resource)
 	));
 
-	UpdateSubresources(
-		commandList.Get(),
-		resource.Get(),
-		uploadResource.Get(),
-		0,
-		0,
-		1,
-		&subresources
-	);
+	// on copy queue resident resource is promoted to copy source from common state
+	bool isCopyQueue = commandList->GetType() == D3D12_COMMAND_LIST_TYPE_COPY;
+
+	// mips finer than resident ones are uploaded, others are copied from resident resource
+	uint32_t numUploadedMips = numMips;
+
+	if (residentResource != nullptr) {
+		numUploadedMips = residentFirstMip > firstMip ? (std::min)(residentFirstMip - firstMip, numMips) : 0;
+	}
+
+	if (numUploadedMips > 0) {
+		const UINT64 uploadBufferSize = GetRequiredIntermediateSize(resource.Get(), 0, numUploadedMips);
+
+		ThrowIfFailed(device->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(&uploadResource)
+		));
+
+		UpdateSubresources(
+			commandList.Get(),
+			resource.Get(),
+			uploadResource.Get(),
+			0,
+			0,
+			numUploadedMips,
+			texture.Subresources.data() + firstMip
+		);
+	}
+
+	if (numUploadedMips < numMips) {
+		CD3DX12_RESOURCE_BARRIER barier = CD3DX12_RESOURCE_BARRIER::Transition(
+			residentResource,
+			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+			D3D12_RESOURCE_STATE_COPY_SOURCE
+		);
+
+		if (!isCopyQueue) {
+			commandList->ResourceBarrier(1, &barier);
+		}
+
+		for (uint32_t mip = firstMip + numUploadedMips; mip < texture.Desc.MipLevels; ++mip) {
+			CD3DX12_TEXTURE_COPY_LOCATION dst(resource.Get(), mip - firstMip);
+			CD3DX12_TEXTURE_COPY_LOCATION src(residentResource, mip - residentFirstMip);
+
+			commandList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+		}
+
+		// resident resource is still used by frames recorded before views are switched
+		barier = CD3DX12_RESOURCE_BARRIER::Transition(
+			residentResource,
+			D3D12_RESOURCE_STATE_COPY_SOURCE,
+			D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+		);
+
+		if (!isCopyQueue) {
+			commandList->ResourceBarrier(1, &barier);
+		}
+	}
+
+	if (isCopyQueue) {
+		return resource;
+	}
 
 	CD3DX12_RESOURCE_BARRIER barier = CD3DX12_RESOURCE_BARRIER::Transition(
 		resource.Get(),
@@ -147,6 +430,103 @@ void CreateWICTextureFromFile(
 	);
 
 	commandList->ResourceBarrier(1, &barier);
+
+	return resource;
+}
+
+DecodedTexture DecodeDDSTextureFromFile(
+	ComPtr<ID3D12Device2> device,
+	const std::filesystem::path& fileName)
+{
+	DecodedTexture texture;
+
+	ThrowIfFailed(LoadDDSTextureFromFile(
+		device.Get(),
+		fileName.c_str(),
+		&texture.Resource,
+		texture.Data, texture.Subresources
+	));
+
+	texture.Desc = texture.Resource->GetDesc();
+
+	return texture;
+}
+
+DecodedTexture DecodeDDSTextureFromMappedFile(
+	ComPtr<ID3D12Device2> device,
+	const std::filesystem::path& fileName)
+{
+	DecodedTexture texture;
+	texture.Mapping = MappedFile(fileName);
+
+	DDSTextureInfo info;
+
+	if (!ParseDDS(texture.Mapping.GetData(), texture.Mapping.GetSize(), info)) {
+		throw std::exception();
+	}
+
+	ThrowIfFailed(device->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Tex2D(
+			static_cast<DXGI_FORMAT>(info.Format),
+			info.Width, info.Height,
+			static_cast<UINT16>(info.ArraySize),
+			static_cast<UINT16>(info.MipLevels)
+		),
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(&texture.Resource)
+	));
+
+	texture.Desc = texture.Resource->GetDesc();
+
+	for (const DDSSubresourceLayout& layout : info.Subresources) {
+		D3D12_SUBRESOURCE_DATA subresource;
+		subresource.pData = texture.Mapping.GetData() + layout.Offset;
+		subresource.RowPitch = layout.RowPitch;
+		subresource.SlicePitch = static_cast<LONG_PTR>(layout.SlicePitch);
+
+		texture.Subresources.push_back(subresource);
+	}
+
+	return texture;
+}
+
+void CreateDDSTextureFromFile(
+	ComPtr<ID3D12Device2> device,
+	ComPtr<ID3D12GraphicsCommandList> commandList,
+	std::wstring fileName,
+	ComPtr<ID3D12Resource> & resource,
+	ComPtr<ID3D12Resource> & uploadResource) 
+{
+	DecodedTexture texture = DecodeDDSTextureFromFile(device, fileName);
+
+	RecordTextureUpload(device, commandList, texture, uploadResource);
+	resource = texture.Resource;
+}
+
+void CreateWICTextureFromFile(
+	ComPtr<ID3D12Device2> device,
+	ComPtr<ID3D12GraphicsCommandList> commandList,
+	std::wstring fileName,
+	ComPtr<ID3D12Resource>& resource,
+	ComPtr<ID3D12Resource>& uploadResource)
+{
+	DecodedTexture texture;
+	D3D12_SUBRESOURCE_DATA subresource;
+
+	ThrowIfFailed(LoadWICTextureFromFile(
+		device.Get(),
+		fileName.c_str(),
+		&texture.Resource,
+		texture.Data, subresource
+	));
+
+	texture.Subresources.push_back(subresource);
+
+	RecordTextureUpload(device, commandList, texture, uploadResource);
+	resource = texture.Resource;
 }
 
 // compute projection matrix
@@ -362,7 +742,9 @@ ComPtr<ID3D12Resource> CreateDepthStencilBuffer(
 	uint32_t width, uint32_t height, 
 	DXGI_FORMAT bufferFormat, DXGI_FORMAT viewFormat, 
 	float depthClearValue, 
-	uint8_t stencilClearValue)
+	uint8_t stencilClearValue,
+	ResourceHeapAllocator* allocator,
+	PlacedAllocation* allocation)
 {
 	ComPtr<ID3D12Resource> depthStencilBuffer;
 
@@ -379,6 +761,10 @@ ComPtr<ID3D12Resource> CreateDepthStencilBuffer(
 	dsClearValue.Format = viewFormat;
 	dsClearValue.DepthStencil = { depthClearValue, stencilClearValue };
 
+	if (allocator != nullptr) {
+		return allocator->CreateResource(dsBufferDesc, D3D12_HEAP_TYPE_DEFAULT, D3D12_RESOURCE_STATE_DEPTH_WRITE, &dsClearValue, *allocation);
+	}
+
 	ThrowIfFailed(device->CreateCommittedResource(
 		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
 		D3D12_HEAP_FLAG_NONE,
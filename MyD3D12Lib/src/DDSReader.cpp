@@ -0,0 +1,296 @@
+#include <MyD3D12Lib/DDSReader.h>
+#include <MyD3D12Lib/DDSFormat.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	// D3D12 limits for 2D textures
+	const uint32_t MaxDimension = 16384;
+	const uint32_t MaxArraySize = 2048;
+	const uint32_t MaxMipLevels = 15;
+
+	struct FormatInfo {
+		// bytes per block for block compressed formats, bytes per pixel otherwise
+		uint32_t ByteSize = 0;
+		bool IsBlockCompressed = false;
+	};
+
+	// zero size for unsupported formats
+	FormatInfo GetFormatInfo(uint32_t format) {
+		switch (static_cast<DXGIFormat>(format)) {
+		case DXGIFormat::BC1Typeless:
+		case DXGIFormat::BC1Unorm:
+		case DXGIFormat::BC1UnormSRGB:
+		case DXGIFormat::BC4Typeless:
+		case DXGIFormat::BC4Unorm:
+		case DXGIFormat::BC4Snorm:
+			return { 8, true };
+
+		case DXGIFormat::BC2Typeless:
+		case DXGIFormat::BC2Unorm:
+		case DXGIFormat::BC2UnormSRGB:
+		case DXGIFormat::BC3Typeless:
+		case DXGIFormat::BC3Unorm:
+		case DXGIFormat::BC3UnormSRGB:
+		case DXGIFormat::BC5Typeless:
+		case DXGIFormat::BC5Unorm:
+		case DXGIFormat::BC5Snorm:
+		case DXGIFormat::BC6HTypeless:
+		case DXGIFormat::BC6HUF16:
+		case DXGIFormat::BC6HSF16:
+		case DXGIFormat::BC7Typeless:
+		case DXGIFormat::BC7Unorm:
+		case DXGIFormat::BC7UnormSRGB:
+			return { 16, true };
+
+		case DXGIFormat::R32G32B32A32Typeless:
+		case DXGIFormat::R32G32B32A32Float:
+		case DXGIFormat::R32G32B32A32Uint:
+		case DXGIFormat::R32G32B32A32Sint:
+			return { 16, false };
+
+		case DXGIFormat::R16G16B16A16Typeless:
+		case DXGIFormat::R16G16B16A16Float:
+		case DXGIFormat::R16G16B16A16Unorm:
+		case DXGIFormat::R16G16B16A16Uint:
+		case DXGIFormat::R16G16B16A16Snorm:
+		case DXGIFormat::R16G16B16A16Sint:
+		case DXGIFormat::R32G32Typeless:
+		case DXGIFormat::R32G32Float:
+		case DXGIFormat::R32G32Uint:
+		case DXGIFormat::R32G32Sint:
+			return { 8, false };
+
+		case DXGIFormat::R10G10B10A2Typeless:
+		case DXGIFormat::R10G10B10A2Unorm:
+		case DXGIFormat::R10G10B10A2Uint:
+		case DXGIFormat::R11G11B10Float:
+		case DXGIFormat::R8G8B8A8Typeless:
+		case DXGIFormat::R8G8B8A8Unorm:
+		case DXGIFormat::R8G8B8A8UnormSRGB:
+		case DXGIFormat::R8G8B8A8Uint:
+		case DXGIFormat::R8G8B8A8Snorm:
+		case DXGIFormat::R8G8B8A8Sint:
+		case DXGIFormat::R16G16Typeless:
+		case DXGIFormat::R16G16Float:
+		case DXGIFormat::R16G16Unorm:
+		case DXGIFormat::R16G16Uint:
+		case DXGIFormat::R16G16Snorm:
+		case DXGIFormat::R16G16Sint:
+		case DXGIFormat::R32Typeless:
+		case DXGIFormat::R32Float:
+		case DXGIFormat::R32Uint:
+		case DXGIFormat::R32Sint:
+		case DXGIFormat::R9G9B9E5SharedExp:
+		case DXGIFormat::B8G8R8A8Unorm:
+		case DXGIFormat::B8G8R8X8Unorm:
+		case DXGIFormat::B8G8R8A8Typeless:
+		case DXGIFormat::B8G8R8A8UnormSRGB:
+		case DXGIFormat::B8G8R8X8Typeless:
+		case DXGIFormat::B8G8R8X8UnormSRGB:
+			return { 4, false };
+
+		case DXGIFormat::R8G8Typeless:
+		case DXGIFormat::R8G8Unorm:
+		case DXGIFormat::R8G8Uint:
+		case DXGIFormat::R8G8Snorm:
+		case DXGIFormat::R8G8Sint:
+		case DXGIFormat::R16Typeless:
+		case DXGIFormat::R16Float:
+		case DXGIFormat::R16Unorm:
+		case DXGIFormat::R16Uint:
+		case DXGIFormat::R16Snorm:
+		case DXGIFormat::R16Sint:
+		case DXGIFormat::B5G6R5Unorm:
+		case DXGIFormat::B5G5R5A1Unorm:
+			return { 2, false };
+
+		case DXGIFormat::R8Typeless:
+		case DXGIFormat::R8Unorm:
+		case DXGIFormat::R8Uint:
+		case DXGIFormat::R8Snorm:
+		case DXGIFormat::R8Sint:
+		case DXGIFormat::A8Unorm:
+			return { 1, false };
+
+		default:
+			return {};
+		}
+	}
+
+	bool IsBitMask(const DDSPixelFormat& pixelFormat, uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+		return pixelFormat.RBitMask == r && pixelFormat.GBitMask == g && pixelFormat.BBitMask == b && pixelFormat.ABitMask == a;
+	}
+
+	// DXGI format for legacy header, unknown if not supported
+	DXGIFormat GetLegacyFormat(const DDSPixelFormat& pixelFormat) {
+		if (pixelFormat.Flags & DDSPixelFormatFourCC) {
+			switch (pixelFormat.FourCC) {
+			case MakeDDSFourCC('D', 'X', 'T', '1'): return DXGIFormat::BC1Unorm;
+			case MakeDDSFourCC('D', 'X', 'T', '2'): return DXGIFormat::BC2Unorm;
+			case MakeDDSFourCC('D', 'X', 'T', '3'): return DXGIFormat::BC2Unorm;
+			case MakeDDSFourCC('D', 'X', 'T', '4'): return DXGIFormat::BC3Unorm;
+			case MakeDDSFourCC('D', 'X', 'T', '5'): return DXGIFormat::BC3Unorm;
+			case MakeDDSFourCC('A', 'T', 'I', '1'): return DXGIFormat::BC4Unorm;
+			case MakeDDSFourCC('B', 'C', '4', 'U'): return DXGIFormat::BC4Unorm;
+			case MakeDDSFourCC('B', 'C', '4', 'S'): return DXGIFormat::BC4Snorm;
+			case MakeDDSFourCC('A', 'T', 'I', '2'): return DXGIFormat::BC5Unorm;
+			case MakeDDSFourCC('B', 'C', '5', 'U'): return DXGIFormat::BC5Unorm;
+			case MakeDDSFourCC('B', 'C', '5', 'S'): return DXGIFormat::BC5Snorm;
+			default: return DXGIFormat::Unknown;
+			}
+		}
+
+		if ((pixelFormat.Flags & DDSPixelFormatRGB) && pixelFormat.RGBBitCount == 32) {
+			if (IsBitMask(pixelFormat, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000)) {
+				return DXGIFormat::R8G8B8A8Unorm;
+			}
+
+			if (IsBitMask(pixelFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000)) {
+				return DXGIFormat::B8G8R8A8Unorm;
+			}
+
+			if (IsBitMask(pixelFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0)) {
+				return DXGIFormat::B8G8R8X8Unorm;
+			}
+		}
+
+		if ((pixelFormat.Flags & DDSPixelFormatLuminance) && pixelFormat.RGBBitCount == 8 && pixelFormat.RBitMask == 0xFF) {
+			return DXGIFormat::R8Unorm;
+		}
+
+		return DXGIFormat::Unknown;
+	}
+
+	uint32_t GetFullMipChainLength(uint32_t width, uint32_t height) {
+		uint32_t numLevels = 1;
+
+		while (width > 1 || height > 1) {
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+			++numLevels;
+		}
+
+		return numLevels;
+	}
+}
+
+bool ParseDDS(const uint8_t* data, size_t size, DDSTextureInfo& info) {
+	info = DDSTextureInfo();
+
+	if (data == nullptr || size < sizeof(DDSMagic) + sizeof(DDSHeader)) {
+		return false;
+	}
+
+	// file data can be unaligned, so headers are copied
+	uint32_t magic;
+	std::memcpy(&magic, data, sizeof(magic));
+
+	DDSHeader header;
+	std::memcpy(&header, data + sizeof(DDSMagic), sizeof(header));
+
+	if (magic != DDSMagic || header.Size != sizeof(DDSHeader) || header.PixelFormat.Size != sizeof(DDSPixelFormat)) {
+		return false;
+	}
+
+	size_t dataOffset = sizeof(DDSMagic) + sizeof(DDSHeader);
+	uint32_t arraySize = 1;
+
+	if ((header.PixelFormat.Flags & DDSPixelFormatFourCC) && header.PixelFormat.FourCC == MakeDDSFourCC('D', 'X', '1', '0')) {
+		if (size < dataOffset + sizeof(DDSHeaderDX10)) {
+			return false;
+		}
+
+		DDSHeaderDX10 headerDX10;
+		std::memcpy(&headerDX10, data + dataOffset, sizeof(headerDX10));
+		dataOffset += sizeof(DDSHeaderDX10);
+
+		if (headerDX10.ResourceDimension != DDSDimensionTexture2D) {
+			return false;
+		}
+
+		info.Format = headerDX10.DXGIFormat;
+		info.IsCubeMap = (headerDX10.MiscFlag & DDSMiscFlagTextureCube) != 0;
+		arraySize = headerDX10.ArraySize;
+
+		if (arraySize == 0 || arraySize > MaxArraySize) {
+			return false;
+		}
+	}
+	else {
+		if (header.Caps2 & DDSCaps2Volume) {
+			return false;
+		}
+
+		// only complete cube maps are supported
+		if (header.Caps2 & DDSCaps2CubeMap) {
+			if ((header.Caps2 & DDSCaps2CubeMapAllFaces) != DDSCaps2CubeMapAllFaces) {
+				return false;
+			}
+
+			info.IsCubeMap = true;
+		}
+
+		info.Format = static_cast<uint32_t>(GetLegacyFormat(header.PixelFormat));
+	}
+
+	FormatInfo formatInfo = GetFormatInfo(info.Format);
+
+	if (formatInfo.ByteSize == 0) {
+		return false;
+	}
+
+	if (header.Width == 0 || header.Height == 0 || header.Width > MaxDimension || header.Height > MaxDimension) {
+		return false;
+	}
+
+	info.Width = header.Width;
+	info.Height = header.Height;
+	info.MipLevels = std::max(1u, header.MipMapCount);
+	info.ArraySize = arraySize * (info.IsCubeMap ? 6 : 1);
+
+	if (info.MipLevels > std::min(MaxMipLevels, GetFullMipChainLength(info.Width, info.Height))) {
+		return false;
+	}
+
+	// sizes are bounded by limits above, so 64 bit offsets can`t overflow
+	uint64_t offset = dataOffset;
+	info.Subresources.reserve(static_cast<size_t>(info.ArraySize) * info.MipLevels);
+
+	for (uint32_t slice = 0; slice < info.ArraySize; ++slice) {
+		uint32_t width = info.Width;
+		uint32_t height = info.Height;
+
+		for (uint32_t mip = 0; mip < info.MipLevels; ++mip) {
+			DDSSubresourceLayout layout;
+			layout.Offset = static_cast<size_t>(offset);
+			layout.Width = width;
+			layout.Height = height;
+
+			if (formatInfo.IsBlockCompressed) {
+				layout.RowPitch = std::max(1u, (width + 3) / 4) * formatInfo.ByteSize;
+				layout.NumRows = std::max(1u, (height + 3) / 4);
+			}
+			else {
+				layout.RowPitch = width * formatInfo.ByteSize;
+				layout.NumRows = height;
+			}
+
+			layout.SlicePitch = static_cast<uint64_t>(layout.RowPitch) * layout.NumRows;
+			offset += layout.SlicePitch;
+
+			if (offset > size) {
+				info = DDSTextureInfo();
+				return false;
+			}
+
+			info.Subresources.push_back(layout);
+
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
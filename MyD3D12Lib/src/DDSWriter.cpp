@@ -0,0 +1,58 @@
+#include <MyD3D12Lib/DDSWriter.h>
+#include <MyD3D12Lib/DDSFormat.h>
+
+#include <cassert>
+#include <cstring>
+
+DXGIFormat GetBlockFormatDXGI(BlockFormat format) {
+	switch (format) {
+	case BlockFormat::BC1: return DXGIFormat::BC1Unorm;
+	case BlockFormat::BC3: return DXGIFormat::BC3Unorm;
+	case BlockFormat::BC5: return DXGIFormat::BC5Unorm;
+	default: return DXGIFormat::BC7Unorm;
+	}
+}
+
+std::vector<uint8_t> BuildDDSFile(const CompressedMipChain& chain) {
+	assert(!chain.Levels.empty() && "Mip chain is empty");
+
+	const CompressedLevel& topLevel = chain.Levels[0];
+
+	DDSHeader header = {};
+	header.Size = sizeof(DDSHeader);
+	header.Flags = DDSFlagCaps | DDSFlagHeight | DDSFlagWidth | DDSFlagPixelFormat | DDSFlagMipMapCount | DDSFlagLinearSize;
+	header.Height = topLevel.Height;
+	header.Width = topLevel.Width;
+	header.PitchOrLinearSize = topLevel.RowPitch * topLevel.NumRows;
+	header.MipMapCount = static_cast<uint32_t>(chain.Levels.size());
+	header.PixelFormat.Size = sizeof(DDSPixelFormat);
+	header.PixelFormat.Flags = DDSPixelFormatFourCC;
+	header.PixelFormat.FourCC = MakeDDSFourCC('D', 'X', '1', '0');
+	header.Caps = DDSCapsTexture;
+
+	if (chain.Levels.size() > 1) {
+		header.Caps |= DDSCapsComplex | DDSCapsMipMap;
+	}
+
+	DDSHeaderDX10 headerDX10 = {};
+	headerDX10.DXGIFormat = static_cast<uint32_t>(GetBlockFormatDXGI(chain.Format));
+	headerDX10.ResourceDimension = DDSDimensionTexture2D;
+	headerDX10.ArraySize = 1;
+
+	// levels are stored one after another without padding, as in compressed chain
+	std::vector<uint8_t> file(sizeof(DDSMagic) + sizeof(header) + sizeof(headerDX10) + chain.Data.size());
+	uint8_t* dst = file.data();
+
+	std::memcpy(dst, &DDSMagic, sizeof(DDSMagic));
+	dst += sizeof(DDSMagic);
+
+	std::memcpy(dst, &header, sizeof(header));
+	dst += sizeof(header);
+
+	std::memcpy(dst, &headerDX10, sizeof(headerDX10));
+	dst += sizeof(headerDX10);
+
+	std::memcpy(dst, chain.Data.data(), chain.Data.size());
+
+	return file;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include <MyD3D12Lib/DeferredReleaseQueue.h>
+
+DeferredReleaseQueue::~DeferredReleaseQueue() {
+	ReleaseAll();
+}
+
+void DeferredReleaseQueue::Push(uint64_t fenceValue, std::function<void()> release) {
+	Node* node = new Node{ fenceValue, std::move(release), m_Pushed.load(std::memory_order_relaxed) };
+
+	// node is published by release, so its content is seen by thread which takes stack
+	while (!m_Pushed.compare_exchange_weak(node->Next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+uint32_t DeferredReleaseQueue::ReleaseCompleted(uint64_t completedFenceValue) {
+	TakePushed();
+
+	uint32_t numReleased = 0;
+	uint32_t numKept = 0;
+
+	for (uint32_t i = 0; i < m_Pending.size(); ++i) {
+		auto& [fenceValue, release] = m_Pending[i];
+
+		if (fenceValue > completedFenceValue) {
+			if (i != numKept) {
+				m_Pending[numKept] = std::move(m_Pending[i]);
+			}
+
+			++numKept;
+			continue;
+		}
+
+		release();
+		release = nullptr;
+		++numReleased;
+	}
+
+	m_Pending.resize(numKept);
+	m_NumReleased += numReleased;
+
+	return numReleased;
+}
+
+uint32_t DeferredReleaseQueue::ReleaseAll() {
+	return ReleaseCompleted(UINT64_MAX);
+}
+
+uint32_t DeferredReleaseQueue::GetNumPending() const {
+	return static_cast<uint32_t>(m_Pending.size());
+}
+
+uint64_t DeferredReleaseQueue::GetNumReleased() const {
+	return m_NumReleased;
+}
+
+void DeferredReleaseQueue::TakePushed() {
+	Node* node = m_Pushed.exchange(nullptr, std::memory_order_acquire);
+
+	// stack is reversed, so objects of one producer are released in order of pushing
+	Node* reversed = nullptr;
+
+	while (node != nullptr) {
+		Node* next = node->Next;
+		node->Next = reversed;
+		reversed = node;
+		node = next;
+	}
+
+	while (reversed != nullptr) {
+		Node* next = reversed->Next;
+		m_Pending.emplace_back(reversed->FenceValue, std::move(reversed->Release));
+		delete reversed;
+		reversed = next;
+	}
+}
\ No newline at end of file
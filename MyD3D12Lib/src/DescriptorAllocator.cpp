@@ -0,0 +1,110 @@
+#include <MyD3D12Lib/DescriptorAllocator.h>
+#include <MyD3D12Lib/D3D12Utils.h>
+
+#include <d3dx12.h>
+
+#include <cassert>
+#include <exception>
+
+DescriptorAllocator::DescriptorAllocator(
+	ComPtr<ID3D12Device2> device,
+	D3D12_DESCRIPTOR_HEAP_TYPE type,
+	uint32_t numDescriptors,
+	bool isShaderVisible,
+	uint32_t numRingDescriptorsPerFrame,
+	uint32_t numFrames) :
+	m_Device(device),
+	m_Type(type),
+	m_IndexAllocator(0, numDescriptors),
+	m_Ring(numDescriptors, numRingDescriptorsPerFrame, numFrames)
+{
+	assert((isShaderVisible || numRingDescriptorsPerFrame == 0) && "Ring is copied to, so it should be in shader visible heap");
+
+	m_Heap = CreateDescriptorHeap(
+		m_Device,
+		numDescriptors + numRingDescriptorsPerFrame * numFrames,
+		m_Type,
+		isShaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE
+	);
+
+	m_DescriptorSize = m_Device->GetDescriptorHandleIncrementSize(m_Type);
+}
+
+DescriptorRange DescriptorAllocator::Allocate(uint32_t count) {
+	DescriptorRange range = m_IndexAllocator.Allocate(count);
+
+	if (!range.IsValid()) {
+		throw std::exception();
+	}
+
+	return range;
+}
+
+void DescriptorAllocator::Free(DescriptorRange& range, uint64_t fenceValue) {
+	m_IndexAllocator.Free(range, fenceValue);
+}
+
+void DescriptorAllocator::ReleaseCompleted(uint64_t completedFenceValue) {
+	m_IndexAllocator.ReleaseCompleted(completedFenceValue);
+}
+
+void DescriptorAllocator::BeginFrame(uint32_t frame) {
+	assert(m_CopiesDsts.empty() && "Copies into previous frame are not flushed");
+
+	m_Ring.BeginFrame(frame);
+}
+
+uint32_t DescriptorAllocator::AllocateRing(uint32_t count) {
+	uint32_t index = m_Ring.Allocate(count);
+
+	if (index == DescriptorIndexAllocator::InvalidIndex) {
+		throw std::exception();
+	}
+
+	return index;
+}
+
+void DescriptorAllocator::QueueCopy(D3D12_CPU_DESCRIPTOR_HANDLE src, uint32_t dstIndex, uint32_t count) {
+	m_CopiesSrcs.push_back(src);
+	m_CopiesDsts.push_back(GetCPUHandle(dstIndex));
+	m_CopiesSizes.push_back(count);
+}
+
+void DescriptorAllocator::FlushCopies() {
+	if (m_CopiesDsts.empty()) {
+		return;
+	}
+
+	// ranges of source and destination have the same sizes
+	UINT numRanges = static_cast<UINT>(m_CopiesDsts.size());
+
+	m_Device->CopyDescriptors(
+		numRanges, m_CopiesDsts.data(), m_CopiesSizes.data(),
+		numRanges, m_CopiesSrcs.data(), m_CopiesSizes.data(),
+		m_Type
+	);
+
+	m_CopiesSrcs.clear();
+	m_CopiesDsts.clear();
+	m_CopiesSizes.clear();
+}
+
+ID3D12DescriptorHeap* DescriptorAllocator::GetHeap() const {
+	return m_Heap.Get();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE DescriptorAllocator::GetCPUHandle(uint32_t index) const {
+	return CD3DX12_CPU_DESCRIPTOR_HANDLE(m_Heap->GetCPUDescriptorHandleForHeapStart(), index, m_DescriptorSize);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DescriptorAllocator::GetGPUHandle(uint32_t index) const {
+	return CD3DX12_GPU_DESCRIPTOR_HANDLE(m_Heap->GetGPUDescriptorHandleForHeapStart(), index, m_DescriptorSize);
+}
+
+const DescriptorIndexAllocator& DescriptorAllocator::GetIndexAllocator() const {
+	return m_IndexAllocator;
+}
+
+const DescriptorRing& DescriptorAllocator::GetRing() const {
+	return m_Ring;
+}
\ No newline at end of file
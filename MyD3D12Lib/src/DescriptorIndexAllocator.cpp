@@ -0,0 +1,123 @@
+#include <MyD3D12Lib/DescriptorIndexAllocator.h>
+
+#include <algorithm>
+#include <cassert>
+
+DescriptorIndexAllocator::DescriptorIndexAllocator(uint32_t firstIndex, uint32_t numDescriptors) :
+	m_FirstIndex(firstIndex),
+	m_Allocator(numDescriptors)
+{}
+
+DescriptorRange DescriptorIndexAllocator::Allocate(uint32_t count) {
+	assert(count > 0 && "Range should not be empty");
+
+	DescriptorRange range;
+	range.Allocation = m_Allocator.Allocate(count);
+
+	if (!range.Allocation.IsValid()) {
+		return DescriptorRange();
+	}
+
+	range.Index = m_FirstIndex + static_cast<uint32_t>(range.Allocation.Offset);
+	range.Count = count;
+
+	return range;
+}
+
+void DescriptorIndexAllocator::Free(DescriptorRange& range, uint64_t fenceValue) {
+	assert(range.IsValid() && "Invalid range");
+
+	if (fenceValue == 0) {
+		m_Allocator.Free(range.Allocation);
+	}
+	else {
+		m_PendingFrees.emplace_back(fenceValue, range.Allocation);
+		m_NumPending += range.Count;
+	}
+
+	range = DescriptorRange();
+}
+
+uint32_t DescriptorIndexAllocator::ReleaseCompleted(uint64_t completedFenceValue) {
+	uint32_t numReleased = 0;
+
+	auto isReleased = [&](const std::pair<uint64_t, TLSFAllocation>& pending) {
+		if (pending.first > completedFenceValue) {
+			return false;
+		}
+
+		m_Allocator.Free(pending.second);
+		numReleased += static_cast<uint32_t>(pending.second.Size);
+
+		return true;
+	};
+
+	m_PendingFrees.erase(
+		std::remove_if(m_PendingFrees.begin(), m_PendingFrees.end(), isReleased),
+		m_PendingFrees.end()
+	);
+
+	m_NumPending -= numReleased;
+
+	return numReleased;
+}
+
+uint32_t DescriptorIndexAllocator::GetFirstIndex() const {
+	return m_FirstIndex;
+}
+
+uint32_t DescriptorIndexAllocator::GetNumDescriptors() const {
+	return static_cast<uint32_t>(m_Allocator.GetSize());
+}
+
+uint32_t DescriptorIndexAllocator::GetNumUsed() const {
+	return static_cast<uint32_t>(m_Allocator.GetUsedSize());
+}
+
+uint32_t DescriptorIndexAllocator::GetNumPending() const {
+	return m_NumPending;
+}
+
+uint32_t DescriptorIndexAllocator::GetNumAllocations() const {
+	return m_Allocator.GetNumAllocations() - static_cast<uint32_t>(m_PendingFrees.size());
+}
+
+float DescriptorIndexAllocator::GetFragmentation() const {
+	return m_Allocator.GetFragmentation();
+}
+
+DescriptorRing::DescriptorRing(uint32_t firstIndex, uint32_t numDescriptorsPerFrame, uint32_t numFrames) :
+	m_FirstIndex(firstIndex),
+	m_NumDescriptorsPerFrame(numDescriptorsPerFrame),
+	m_NumFrames(numFrames)
+{}
+
+void DescriptorRing::BeginFrame(uint32_t frame) {
+	assert(frame < m_NumFrames && "Invalid frame");
+
+	m_Frame = frame;
+	m_NumUsed = 0;
+}
+
+uint32_t DescriptorRing::Allocate(uint32_t count) {
+	if (count > m_NumDescriptorsPerFrame - m_NumUsed) {
+		return DescriptorIndexAllocator::InvalidIndex;
+	}
+
+	uint32_t index = m_FirstIndex + m_Frame * m_NumDescriptorsPerFrame + m_NumUsed;
+	m_NumUsed += count;
+
+	return index;
+}
+
+uint32_t DescriptorRing::GetNumDescriptorsPerFrame() const {
+	return m_NumDescriptorsPerFrame;
+}
+
+uint32_t DescriptorRing::GetNumFrames() const {
+	return m_NumFrames;
+}
+
+uint32_t DescriptorRing::GetNumUsed() const {
+	return m_NumUsed;
+}
\ No newline at end of file
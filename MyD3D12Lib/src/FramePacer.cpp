@@ -0,0 +1,77 @@
+#include <MyD3D12Lib/FramePacer.h>
+
+#include <cassert>
+
+FramePacer::FramePacer(uint32_t numFramesInFlight, FramePacingMode mode) :
+	m_NumFramesInFlight(numFramesInFlight),
+	m_Mode(mode),
+	m_FenceValues(numFramesInFlight, 0)
+{
+	assert(numFramesInFlight > 0 && "There should be at least one frame in flight");
+}
+
+uint32_t FramePacer::GetFrameSlot() const {
+	return static_cast<uint32_t>(m_NumFrames % m_NumFramesInFlight);
+}
+
+uint64_t FramePacer::GetWaitFenceValue() const {
+	uint32_t maxQueuedFrames = GetMaxQueuedFrames();
+
+	if (m_NumFrames < maxQueuedFrames) {
+		return 0;
+	}
+
+	// slots keep fence values of last frames in flight, so frame which should be finished is still there
+	// in throughput mode it is previous frame of current slot
+	return m_FenceValues[(m_NumFrames - maxQueuedFrames) % m_NumFramesInFlight];
+}
+
+void FramePacer::EndFrame(uint64_t fenceValue) {
+	assert(fenceValue >= m_FenceValues[(m_NumFrames + m_NumFramesInFlight - 1) % m_NumFramesInFlight] && "Fence values should not decrease");
+
+	m_FenceValues[GetFrameSlot()] = fenceValue;
+	++m_NumFrames;
+}
+
+void FramePacer::SetMode(FramePacingMode mode) {
+	m_Mode = mode;
+}
+
+FramePacingMode FramePacer::GetMode() const {
+	return m_Mode;
+}
+
+uint32_t FramePacer::GetNumFramesInFlight() const {
+	return m_NumFramesInFlight;
+}
+
+uint64_t FramePacer::GetNumFrames() const {
+	return m_NumFrames;
+}
+
+uint64_t FramePacer::GetFirstUnfinishedFrame() const {
+	uint32_t maxQueuedFrames = GetMaxQueuedFrames();
+	return m_NumFrames >= maxQueuedFrames ? m_NumFrames - maxQueuedFrames + 1 : 0;
+}
+
+void FramePacer::AddStall(double time) {
+	++m_NumStalls;
+	m_StallTime += time;
+}
+
+uint64_t FramePacer::GetNumStalls() const {
+	return m_NumStalls;
+}
+
+double FramePacer::GetStallTime() const {
+	return m_StallTime;
+}
+
+uint32_t FramePacer::GetMaxQueuedFrames() const {
+	// frame which would be the oldest one in flight is finished before recording
+	if (m_Mode == FramePacingMode::Latency && m_NumFramesInFlight > 1) {
+		return m_NumFramesInFlight - 1;
+	}
+
+	return m_NumFramesInFlight;
+}
\ No newline at end of file
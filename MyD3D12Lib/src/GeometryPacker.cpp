@@ -0,0 +1,111 @@
+#include <MyD3D12Lib/GeometryPacker.h>
+
+#include <algorithm>
+#include <cassert>
+
+GeometryPacker::GeometryPacker(uint32_t vertexAlignment, uint32_t indexAlignment, uint32_t minCapacity) :
+	m_VertexAlignment(std::max(1u, vertexAlignment)),
+	m_IndexAlignment(std::max(1u, indexAlignment)),
+	m_MinCapacity(minCapacity)
+{}
+
+IndexPool GeometryPacker::ChoosePool(uint32_t numVertexes) {
+	// indexes are relative to BaseVertexLocation, so only mesh own size matters
+	return numVertexes <= MaxIndex16Vertexes ? IndexPool::Index16 : IndexPool::Index32;
+}
+
+uint32_t GeometryPacker::GetIndexByteStride(IndexPool pool) {
+	return pool == IndexPool::Index16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+void GeometryPacker::Reserve(uint32_t numVertexes, uint32_t numIndexes16, uint32_t numIndexes32) {
+	const uint32_t required[] = { numIndexes16, numIndexes32 };
+
+	if (numVertexes > m_VertexCapacity) {
+		m_VertexCapacity = numVertexes;
+		m_IsGrown = true;
+	}
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(IndexPool::Count); ++i) {
+		if (required[i] > m_IndexCapacity[i]) {
+			m_IndexCapacity[i] = required[i];
+			m_IsGrown = true;
+		}
+	}
+}
+
+PackedMesh GeometryPacker::AddMesh(uint32_t numVertexes, uint32_t numIndexes) {
+	return AddMesh(numVertexes, numIndexes, ChoosePool(numVertexes));
+}
+
+PackedMesh GeometryPacker::AddMesh(uint32_t numVertexes, uint32_t numIndexes, IndexPool pool) {
+	assert((pool == IndexPool::Index32 || numVertexes <= MaxIndex16Vertexes) && "Mesh can`t be addressed by 16 bit indexes");
+
+	uint32_t poolIndex = static_cast<uint32_t>(pool);
+
+	PackedMesh mesh;
+	mesh.Pool = pool;
+	mesh.VertexCount = numVertexes;
+	mesh.IndexCount = numIndexes;
+	mesh.BaseVertexLocation = AlignUp(m_NumVertexes, m_VertexAlignment);
+	mesh.StartIndexLocation = AlignUp(m_NumIndexes[poolIndex], m_IndexAlignment);
+
+	m_NumVertexes = mesh.BaseVertexLocation + numVertexes;
+	m_NumIndexes[poolIndex] = mesh.StartIndexLocation + numIndexes;
+
+	if (m_NumVertexes > m_VertexCapacity) {
+		m_VertexCapacity = Grow(m_VertexCapacity, m_NumVertexes);
+		m_IsGrown = true;
+	}
+
+	if (m_NumIndexes[poolIndex] > m_IndexCapacity[poolIndex]) {
+		m_IndexCapacity[poolIndex] = Grow(m_IndexCapacity[poolIndex], m_NumIndexes[poolIndex]);
+		m_IsGrown = true;
+	}
+
+	m_Meshes.push_back(mesh);
+
+	return mesh;
+}
+
+uint32_t GeometryPacker::GetNumVertexes() const {
+	return m_NumVertexes;
+}
+
+uint32_t GeometryPacker::GetNumIndexes(IndexPool pool) const {
+	return m_NumIndexes[static_cast<uint32_t>(pool)];
+}
+
+uint32_t GeometryPacker::GetVertexCapacity() const {
+	return m_VertexCapacity;
+}
+
+uint32_t GeometryPacker::GetIndexCapacity(IndexPool pool) const {
+	return m_IndexCapacity[static_cast<uint32_t>(pool)];
+}
+
+bool GeometryPacker::CheckAndResetGrown() {
+	bool isGrown = m_IsGrown;
+	m_IsGrown = false;
+	return isGrown;
+}
+
+const std::vector<PackedMesh>& GeometryPacker::GetMeshes() const {
+	return m_Meshes;
+}
+
+void GeometryPacker::Reset() {
+	m_NumVertexes = 0;
+	std::fill(std::begin(m_NumIndexes), std::end(m_NumIndexes), 0);
+	m_Meshes.clear();
+}
+
+uint32_t GeometryPacker::AlignUp(uint32_t value, uint32_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+uint32_t GeometryPacker::Grow(uint32_t capacity, uint32_t required) const {
+	// grow by half to amortize buffers recreation
+	uint32_t newCapacity = std::max(m_MinCapacity, capacity + capacity / 2);
+	return std::max(newCapacity, required);
+}
\ No newline at end of file
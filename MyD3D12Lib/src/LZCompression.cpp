@@ -0,0 +1,205 @@
+#include <MyD3D12Lib/LZCompression.h>
+
+#include <cstring>
+#include <exception>
+#include <vector>
+
+namespace {
+	const uint32_t MinMatchLength = 4;
+	const uint32_t MaxOffset = 65535;
+	const uint32_t HashBits = 14;
+
+	uint32_t Read32(const uint8_t* data) {
+		uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	uint32_t Hash(uint32_t value) {
+		return (value * 2654435761u) >> (32 - HashBits);
+	}
+
+	// lengths which don`t fit into token are continued in bytes of 255 and remainder
+	uint8_t* WriteLength(uint8_t* dst, size_t length) {
+		while (length >= 255) {
+			*dst++ = 255;
+			length -= 255;
+		}
+
+		*dst++ = static_cast<uint8_t>(length);
+		return dst;
+	}
+
+	uint8_t* WriteSequence(uint8_t* dst, const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength) {
+		uint8_t* token = dst++;
+
+		*token = static_cast<uint8_t>((numLiterals < 15 ? numLiterals : 15) << 4);
+
+		if (numLiterals >= 15) {
+			dst = WriteLength(dst, numLiterals - 15);
+		}
+
+		std::memcpy(dst, literals, numLiterals);
+		dst += numLiterals;
+
+		// last sequence has literals only
+		if (matchLength == 0) {
+			return dst;
+		}
+
+		*dst++ = static_cast<uint8_t>(offset);
+		*dst++ = static_cast<uint8_t>(offset >> 8);
+
+		size_t length = matchLength - MinMatchLength;
+		*token |= static_cast<uint8_t>(length < 15 ? length : 15);
+
+		if (length >= 15) {
+			dst = WriteLength(dst, length - 15);
+		}
+
+		return dst;
+	}
+
+	size_t ReadLength(const uint8_t*& src, const uint8_t* srcEnd, size_t length) {
+		if (length != 15) {
+			return length;
+		}
+
+		uint8_t byte;
+
+		do {
+			if (src == srcEnd) {
+				throw std::exception();
+			}
+
+			byte = *src++;
+			length += byte;
+		} while (byte == 255);
+
+		return length;
+	}
+}
+
+size_t GetLZMaxCompressedSize(size_t size) {
+	// token and length bytes of single literal run
+	return size + size / 255 + 16;
+}
+
+size_t CompressLZ(const uint8_t* src, size_t srcSize, uint8_t* dst) {
+	uint8_t* dstStart = dst;
+
+	const uint8_t* literals = src;
+	const uint8_t* srcEnd = src + srcSize;
+
+	if (srcSize >= MinMatchLength) {
+		// positions of last occurrences of 4 byte sequences
+		std::vector<uint32_t> table(1u << HashBits, UINT32_MAX);
+
+		const uint8_t* matchLimit = srcEnd - MinMatchLength;
+		const uint8_t* ip = src;
+		uint32_t numMisses = 0;
+
+		while (ip <= matchLimit) {
+			uint32_t sequence = Read32(ip);
+			uint32_t& entry = table[Hash(sequence)];
+
+			const uint8_t* candidate = entry != UINT32_MAX ? src + entry : nullptr;
+			entry = static_cast<uint32_t>(ip - src);
+
+			if (candidate == nullptr || static_cast<size_t>(ip - candidate) > MaxOffset || Read32(candidate) != sequence) {
+				// incompressible data is skipped faster the longer matches are not found
+				ip += 1 + (numMisses++ >> 6);
+				continue;
+			}
+
+			numMisses = 0;
+
+			// match is extended back over pending literals and forward as long as bytes are equal
+			while (ip > literals && candidate > src && ip[-1] == candidate[-1]) {
+				--ip;
+				--candidate;
+			}
+
+			const uint8_t* matchEnd = ip + MinMatchLength;
+			const uint8_t* candidateEnd = candidate + MinMatchLength;
+
+			while (matchEnd < srcEnd && *matchEnd == *candidateEnd) {
+				++matchEnd;
+				++candidateEnd;
+			}
+
+			dst = WriteSequence(dst, literals, ip - literals, ip - candidate, matchEnd - ip);
+
+			// positions inside match are hashed sparsely, so next match can refer into it
+			if (matchEnd - 2 > ip && matchEnd - 2 <= matchLimit) {
+				table[Hash(Read32(matchEnd - 2))] = static_cast<uint32_t>(matchEnd - 2 - src);
+			}
+
+			ip = matchEnd;
+			literals = ip;
+		}
+	}
+
+	dst = WriteSequence(dst, literals, srcEnd - literals, 0, 0);
+
+	return dst - dstStart;
+}
+
+void DecompressLZ(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+	const uint8_t* srcEnd = src + srcSize;
+	uint8_t* op = dst;
+	uint8_t* dstEnd = dst + dstSize;
+
+	while (true) {
+		if (src == srcEnd) {
+			throw std::exception();
+		}
+
+		uint8_t token = *src++;
+
+		size_t numLiterals = ReadLength(src, srcEnd, token >> 4);
+
+		if (numLiterals > static_cast<size_t>(srcEnd - src) || numLiterals > static_cast<size_t>(dstEnd - op)) {
+			throw std::exception();
+		}
+
+		std::memcpy(op, src, numLiterals);
+		op += numLiterals;
+		src += numLiterals;
+
+		// block ends with literals
+		if (src == srcEnd) {
+			break;
+		}
+
+		if (srcEnd - src < 2) {
+			throw std::exception();
+		}
+
+		size_t offset = src[0] | (static_cast<size_t>(src[1]) << 8);
+		src += 2;
+
+		size_t matchLength = ReadLength(src, srcEnd, token & 15) + MinMatchLength;
+
+		if (offset == 0 || offset > static_cast<size_t>(op - dst) || matchLength > static_cast<size_t>(dstEnd - op)) {
+			throw std::exception();
+		}
+
+		const uint8_t* match = op - offset;
+
+		// overlapping match repeats last offset bytes
+		if (offset >= matchLength) {
+			std::memcpy(op, match, matchLength);
+			op += matchLength;
+		}
+		else {
+			for (size_t i = 0; i < matchLength; ++i) {
+				*op++ = *match++;
+			}
+		}
+	}
+
+	if (op != dstEnd) {
+		throw std::exception();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include <MyD3D12Lib/LinearAllocator.h>
+
+#include <cassert>
+
+LinearAllocator::LinearAllocator(uint64_t pageSize) :
+	m_PageSize(pageSize)
+{}
+
+LinearAllocation LinearAllocator::Allocate(uint64_t size, uint64_t alignment) {
+	assert(size > 0 && size <= m_PageSize && "Allocation should fit into page");
+	assert((alignment & (alignment - 1)) == 0 && "Alignment should be power of two");
+
+	alignment = alignment > 0 ? alignment : 1;
+
+	uint64_t offset = (m_CurrentOffset + alignment - 1) & ~(alignment - 1);
+
+	// rest of full page is wasted, page starts aligned
+	if (m_CurrentPage == UINT32_MAX || offset + size > m_PageSize) {
+		if (m_CurrentPage != UINT32_MAX) {
+			m_UsedPages.push_back(m_CurrentPage);
+			m_UsedSize += m_PageSize - m_CurrentOffset;
+		}
+
+		if (!m_FreePages.empty()) {
+			m_CurrentPage = m_FreePages.back();
+			m_FreePages.pop_back();
+		}
+		else {
+			m_CurrentPage = m_NumPages++;
+		}
+
+		m_CurrentOffset = 0;
+		offset = 0;
+	}
+
+	m_UsedSize += offset + size - m_CurrentOffset;
+	m_CurrentOffset = offset + size;
+
+	LinearAllocation allocation;
+	allocation.Page = m_CurrentPage;
+	allocation.Offset = offset;
+
+	return allocation;
+}
+
+void LinearAllocator::Retire(uint64_t fenceValue) {
+	assert((m_RetiredPages.empty() || m_RetiredPages.back().first <= fenceValue) && "Fence values should increase");
+
+	if (m_CurrentPage != UINT32_MAX) {
+		m_UsedPages.push_back(m_CurrentPage);
+	}
+
+	for (uint32_t page : m_UsedPages) {
+		m_RetiredPages.emplace_back(fenceValue, page);
+	}
+
+	m_UsedPages.clear();
+	m_CurrentPage = UINT32_MAX;
+	m_CurrentOffset = 0;
+	m_UsedSize = 0;
+}
+
+void LinearAllocator::ReleaseCompleted(uint64_t completedFenceValue) {
+	while (!m_RetiredPages.empty() && m_RetiredPages.front().first <= completedFenceValue) {
+		m_FreePages.push_back(m_RetiredPages.front().second);
+		m_RetiredPages.pop_front();
+	}
+}
+
+uint64_t LinearAllocator::GetPageSize() const {
+	return m_PageSize;
+}
+
+uint32_t LinearAllocator::GetNumPages() const {
+	return m_NumPages;
+}
+
+uint32_t LinearAllocator::GetNumFreePages() const {
+	return static_cast<uint32_t>(m_FreePages.size());
+}
+
+uint64_t LinearAllocator::GetUsedSize() const {
+	return m_UsedSize;
+}
\ No newline at end of file
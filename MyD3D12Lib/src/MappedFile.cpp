@@ -0,0 +1,148 @@
+#include <MyD3D12Lib/MappedFile.h>
+
+#include <exception>
+#include <utility>
+
+#if defined(_WIN32)
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& fileName) {
+#if defined(_WIN32)
+	HANDLE file = ::CreateFileW(
+		fileName.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		NULL
+	);
+
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::exception();
+	}
+
+	m_FileHandle = file;
+
+	LARGE_INTEGER fileSize;
+
+	if (!::GetFileSizeEx(file, &fileSize)) {
+		Close();
+		throw std::exception();
+	}
+
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+
+	// empty file can`t be mapped
+	if (m_Size == 0) {
+		return;
+	}
+
+	m_MappingHandle = ::CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (m_MappingHandle == NULL) {
+		Close();
+		throw std::exception();
+	}
+
+	m_Data = static_cast<const uint8_t*>(::MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+	m_FileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+
+	if (m_FileDescriptor < 0) {
+		throw std::exception();
+	}
+
+	struct stat fileStat;
+
+	if (::fstat(m_FileDescriptor, &fileStat) != 0) {
+		Close();
+		throw std::exception();
+	}
+
+	m_Size = static_cast<size_t>(fileStat.st_size);
+
+	if (m_Size == 0) {
+		return;
+	}
+
+	void* data = ::mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0);
+	m_Data = data != MAP_FAILED ? static_cast<const uint8_t*>(data) : nullptr;
+#endif
+
+	if (m_Data == nullptr) {
+		Close();
+		throw std::exception();
+	}
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		Close();
+
+		std::swap(m_Data, other.m_Data);
+		std::swap(m_Size, other.m_Size);
+#if defined(_WIN32)
+		std::swap(m_FileHandle, other.m_FileHandle);
+		std::swap(m_MappingHandle, other.m_MappingHandle);
+#else
+		std::swap(m_FileDescriptor, other.m_FileDescriptor);
+#endif
+	}
+
+	return *this;
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+const uint8_t* MappedFile::GetData() const {
+	return m_Data;
+}
+
+size_t MappedFile::GetSize() const {
+	return m_Size;
+}
+
+void MappedFile::Close() {
+#if defined(_WIN32)
+	if (m_Data != nullptr) {
+		::UnmapViewOfFile(m_Data);
+	}
+
+	if (m_MappingHandle != nullptr) {
+		::CloseHandle(m_MappingHandle);
+	}
+
+	if (m_FileHandle != nullptr) {
+		::CloseHandle(m_FileHandle);
+	}
+
+	m_MappingHandle = nullptr;
+	m_FileHandle = nullptr;
+#else
+	if (m_Data != nullptr) {
+		::munmap(const_cast<uint8_t*>(m_Data), m_Size);
+	}
+
+	if (m_FileDescriptor >= 0) {
+		::close(m_FileDescriptor);
+	}
+
+	m_FileDescriptor = -1;
+#endif
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
\ No newline at end of file
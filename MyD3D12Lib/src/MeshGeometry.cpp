@@ -10,6 +10,15 @@ D3D12_INDEX_BUFFER_VIEW MeshGeometry::IndexBufferView() const {
 	return ibv;
 }
 
+D3D12_VERTEX_BUFFER_VIEW MeshGeometry::PositionBufferView() const {
+	D3D12_VERTEX_BUFFER_VIEW vbv;
+
+	vbv.BufferLocation = PositionBufferGPU->GetGPUVirtualAddress();
+	vbv.SizeInBytes = PositionBufferByteSize;
+	vbv.StrideInBytes = PositionByteStride;
+
+	return vbv;
+}
 
 D3D12_VERTEX_BUFFER_VIEW MeshGeometry::VertexBufferView() const {
 	D3D12_VERTEX_BUFFER_VIEW vbv;
@@ -22,6 +31,7 @@ D3D12_VERTEX_BUFFER_VIEW MeshGeometry::VertexBufferView() const {
 }
 
 void MeshGeometry::DisposeUploaders() {
+	PositionBufferUploader = nullptr;
 	VertexBufferUploader = nullptr;
 	IndexBufferUploader = nullptr;
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include <MyD3D12Lib/MeshSplitter.h>
+
+#include <cassert>
+
+std::vector<MeshChunk> SplitMesh(
+	const uint32_t* indexes,
+	uint32_t numIndexes,
+	uint32_t numVertexes,
+	uint32_t maxChunkVertexes)
+{
+	assert(numIndexes % 3 == 0 && "Indexes are not triangle list!");
+	assert(maxChunkVertexes >= 3 && maxChunkVertexes <= (1u << 16) && "Chunk can`t be addressed by 16 bit indexes");
+
+	const uint32_t notInChunk = UINT32_MAX;
+
+	std::vector<MeshChunk> chunks;
+
+	// local index of source vertex in current chunk, chunkIds tells which chunk local index belongs to
+	std::vector<uint32_t> localIndexes(numVertexes, notInChunk);
+	std::vector<uint32_t> chunkIds(numVertexes, notInChunk);
+
+	auto isInChunk = [&](uint32_t vertex) {
+		return chunkIds[vertex] == chunks.size() - 1;
+	};
+
+	for (uint32_t i = 0; i < numIndexes; i += 3) {
+		const uint32_t* triangle = indexes + i;
+
+		assert(triangle[0] < numVertexes && triangle[1] < numVertexes && triangle[2] < numVertexes && "Index out of range!");
+
+		uint32_t numNewVertexes = 0;
+
+		if (!chunks.empty()) {
+			for (uint32_t k = 0; k < 3; ++k) {
+				bool isRepeated = (k > 0 && triangle[k] == triangle[0]) || (k > 1 && triangle[k] == triangle[1]);
+				numNewVertexes += !isInChunk(triangle[k]) && !isRepeated;
+			}
+		}
+
+		if (chunks.empty() || chunks.back().Vertexes.size() + numNewVertexes > maxChunkVertexes) {
+			chunks.emplace_back();
+		}
+
+		MeshChunk& chunk = chunks.back();
+
+		for (uint32_t k = 0; k < 3; ++k) {
+			uint32_t vertex = triangle[k];
+
+			if (!isInChunk(vertex)) {
+				chunkIds[vertex] = static_cast<uint32_t>(chunks.size() - 1);
+				localIndexes[vertex] = static_cast<uint32_t>(chunk.Vertexes.size());
+				chunk.Vertexes.push_back(vertex);
+			}
+
+			chunk.Indexes.push_back(static_cast<uint16_t>(localIndexes[vertex]));
+		}
+	}
+
+	return chunks;
+}
\ No newline at end of file
@@ -0,0 +1,507 @@
+#include <MyD3D12Lib/MipGenerator.h>
+#include <MyD3D12Lib/CpuFeatures.h>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+	const uint32_t NumChannels = 4;
+	const uint32_t LinearToSRGBTableSize = 4096;
+
+	// taps of separable filter for each destination pixel
+	struct FilterWeights {
+		std::vector<uint32_t> TapsStart;
+		std::vector<uint32_t> SourceIndexes;
+		std::vector<float> Weights;
+	};
+
+	struct ConversionTables {
+		float SRGBToLinear[256];
+		uint8_t LinearToSRGB[LinearToSRGBTableSize];
+
+		ConversionTables() {
+			for (uint32_t i = 0; i < 256; ++i) {
+				float c = i / 255.0f;
+				SRGBToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			}
+
+			for (uint32_t i = 0; i < LinearToSRGBTableSize; ++i) {
+				float c = i / static_cast<float>(LinearToSRGBTableSize - 1);
+				float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+				LinearToSRGB[i] = static_cast<uint8_t>(s * 255.0f + 0.5f);
+			}
+		}
+	};
+
+	const ConversionTables& GetConversionTables() {
+		static ConversionTables tables;
+		return tables;
+	}
+
+	// modified Bessel function of first kind of zero order
+	float BesselI0(float x) {
+		float sum = 1.0f;
+		float term = 1.0f;
+		float halfX = x / 2.0f;
+
+		for (uint32_t k = 1; k < 20; ++k) {
+			term *= (halfX / k) * (halfX / k);
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	float Sinc(float x) {
+		const float pi = 3.14159265358979f;
+
+		if (std::fabs(x) < 1e-6f) {
+			return 1.0f;
+		}
+
+		return std::sin(pi * x) / (pi * x);
+	}
+
+	// windowed sinc, distance is in destination pixels
+	float KaiserWeight(float distance) {
+		const float width = 3.0f;
+		const float alpha = 4.0f;
+
+		float t = distance / width;
+
+		if (std::fabs(t) >= 1.0f) {
+			return 0.0f;
+		}
+
+		return Sinc(distance) * BesselI0(alpha * std::sqrt(1.0f - t * t)) / BesselI0(alpha);
+	}
+
+	FilterWeights ComputeFilterWeights(uint32_t srcSize, uint32_t dstSize, MipFilter filter) {
+		FilterWeights weights;
+		weights.TapsStart.reserve(dstSize + 1);
+
+		float ratio = srcSize / static_cast<float>(dstSize);
+
+		for (uint32_t x = 0; x < dstSize; ++x) {
+			weights.TapsStart.push_back(static_cast<uint32_t>(weights.Weights.size()));
+
+			float begin = x * ratio;
+			float end = (x + 1) * ratio;
+			float sum = 0.0f;
+
+			if (filter == MipFilter::Box) {
+				// source pixels are weighted by overlap with destination pixel footprint
+				int32_t first = static_cast<int32_t>(std::floor(begin));
+				int32_t last = static_cast<int32_t>(std::ceil(end)) - 1;
+
+				for (int32_t i = first; i <= last; ++i) {
+					float weight = std::min(end, i + 1.0f) - std::max(begin, static_cast<float>(i));
+
+					if (weight <= 0.0f) {
+						continue;
+					}
+
+					weights.SourceIndexes.push_back(std::clamp(i, 0, static_cast<int32_t>(srcSize) - 1));
+					weights.Weights.push_back(weight);
+					sum += weight;
+				}
+			} else {
+				float center = (begin + end) / 2.0f;
+				float radius = 3.0f * std::max(ratio, 1.0f);
+				int32_t first = static_cast<int32_t>(std::floor(center - radius));
+				int32_t last = static_cast<int32_t>(std::ceil(center + radius));
+
+				for (int32_t i = first; i <= last; ++i) {
+					float weight = KaiserWeight((i + 0.5f - center) / std::max(ratio, 1.0f));
+
+					if (weight == 0.0f) {
+						continue;
+					}
+
+					weights.SourceIndexes.push_back(std::clamp(i, 0, static_cast<int32_t>(srcSize) - 1));
+					weights.Weights.push_back(weight);
+					sum += weight;
+				}
+			}
+
+			uint32_t tapsStart = weights.TapsStart.back();
+
+			for (uint32_t i = tapsStart; i < weights.Weights.size(); ++i) {
+				weights.Weights[i] /= sum;
+			}
+		}
+
+		weights.TapsStart.push_back(static_cast<uint32_t>(weights.Weights.size()));
+
+		return weights;
+	}
+
+	void HorizontalPassScalar(
+		const float* src, uint32_t srcWidth, uint32_t height,
+		float* dst, uint32_t dstWidth,
+		const FilterWeights& weights)
+	{
+		for (uint32_t y = 0; y < height; ++y) {
+			const float* srcRow = src + static_cast<size_t>(y) * srcWidth * NumChannels;
+			float* dstRow = dst + static_cast<size_t>(y) * dstWidth * NumChannels;
+
+			for (uint32_t x = 0; x < dstWidth; ++x) {
+				float acc[NumChannels] = {};
+
+				for (uint32_t t = weights.TapsStart[x]; t < weights.TapsStart[x + 1]; ++t) {
+					const float* pixel = srcRow + weights.SourceIndexes[t] * NumChannels;
+
+					for (uint32_t c = 0; c < NumChannels; ++c) {
+						acc[c] += pixel[c] * weights.Weights[t];
+					}
+				}
+
+				for (uint32_t c = 0; c < NumChannels; ++c) {
+					dstRow[x * NumChannels + c] = acc[c];
+				}
+			}
+		}
+	}
+
+	void VerticalPassScalar(
+		const float* src, uint32_t width,
+		float* dst, uint32_t dstHeight,
+		const FilterWeights& weights)
+	{
+		size_t rowSize = static_cast<size_t>(width) * NumChannels;
+
+		for (uint32_t y = 0; y < dstHeight; ++y) {
+			float* dstRow = dst + y * rowSize;
+			std::fill(dstRow, dstRow + rowSize, 0.0f);
+
+			for (uint32_t t = weights.TapsStart[y]; t < weights.TapsStart[y + 1]; ++t) {
+				const float* srcRow = src + weights.SourceIndexes[t] * rowSize;
+				float weight = weights.Weights[t];
+
+				for (size_t i = 0; i < rowSize; ++i) {
+					dstRow[i] += srcRow[i] * weight;
+				}
+			}
+		}
+	}
+
+	// one pixel is one SSE register
+	void HorizontalPassSSE(
+		const float* src, uint32_t srcWidth, uint32_t height,
+		float* dst, uint32_t dstWidth,
+		const FilterWeights& weights)
+	{
+		for (uint32_t y = 0; y < height; ++y) {
+			const float* srcRow = src + static_cast<size_t>(y) * srcWidth * NumChannels;
+			float* dstRow = dst + static_cast<size_t>(y) * dstWidth * NumChannels;
+
+			for (uint32_t x = 0; x < dstWidth; ++x) {
+				__m128 acc = _mm_setzero_ps();
+
+				for (uint32_t t = weights.TapsStart[x]; t < weights.TapsStart[x + 1]; ++t) {
+					__m128 pixel = _mm_loadu_ps(srcRow + weights.SourceIndexes[t] * NumChannels);
+					acc = _mm_add_ps(acc, _mm_mul_ps(pixel, _mm_set1_ps(weights.Weights[t])));
+				}
+
+				_mm_storeu_ps(dstRow + x * NumChannels, acc);
+			}
+		}
+	}
+
+	// rows are accumulated with weights, so whole row is vectorized
+	void VerticalPassSSE(
+		const float* src, uint32_t width,
+		float* dst, uint32_t dstHeight,
+		const FilterWeights& weights)
+	{
+		size_t rowSize = static_cast<size_t>(width) * NumChannels;
+
+		for (uint32_t y = 0; y < dstHeight; ++y) {
+			float* dstRow = dst + y * rowSize;
+			std::fill(dstRow, dstRow + rowSize, 0.0f);
+
+			for (uint32_t t = weights.TapsStart[y]; t < weights.TapsStart[y + 1]; ++t) {
+				const float* srcRow = src + weights.SourceIndexes[t] * rowSize;
+				__m128 weight = _mm_set1_ps(weights.Weights[t]);
+
+				// row size is multiple of 4
+				for (size_t i = 0; i < rowSize; i += 4) {
+					__m128 acc = _mm_loadu_ps(dstRow + i);
+					acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(srcRow + i), weight));
+					_mm_storeu_ps(dstRow + i, acc);
+				}
+			}
+		}
+	}
+
+	SIMD_TARGET_AVX2
+	void VerticalPassAVX2(
+		const float* src, uint32_t width,
+		float* dst, uint32_t dstHeight,
+		const FilterWeights& weights)
+	{
+		size_t rowSize = static_cast<size_t>(width) * NumChannels;
+
+		for (uint32_t y = 0; y < dstHeight; ++y) {
+			float* dstRow = dst + y * rowSize;
+			std::fill(dstRow, dstRow + rowSize, 0.0f);
+
+			for (uint32_t t = weights.TapsStart[y]; t < weights.TapsStart[y + 1]; ++t) {
+				const float* srcRow = src + weights.SourceIndexes[t] * rowSize;
+				__m256 weight = _mm256_set1_ps(weights.Weights[t]);
+
+				size_t i = 0;
+
+				for (; i + 8 <= rowSize; i += 8) {
+					__m256 acc = _mm256_loadu_ps(dstRow + i);
+					acc = _mm256_fmadd_ps(_mm256_loadu_ps(srcRow + i), weight, acc);
+					_mm256_storeu_ps(dstRow + i, acc);
+				}
+
+				// odd width leaves one pixel
+				if (i < rowSize) {
+					__m128 acc = _mm_loadu_ps(dstRow + i);
+					acc = _mm_fmadd_ps(_mm_loadu_ps(srcRow + i), _mm256_castps256_ps128(weight), acc);
+					_mm_storeu_ps(dstRow + i, acc);
+				}
+			}
+		}
+	}
+
+	void ConvertToLinear(
+		const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch,
+		bool isSRGB,
+		float* dst)
+	{
+		const ConversionTables& tables = GetConversionTables();
+		const float* colorTable = tables.SRGBToLinear;
+		float linearTable[256];
+
+		if (!isSRGB) {
+			for (uint32_t i = 0; i < 256; ++i) {
+				linearTable[i] = i / 255.0f;
+			}
+
+			colorTable = linearTable;
+		}
+
+		for (uint32_t y = 0; y < height; ++y) {
+			const uint8_t* srcPixel = pixels + static_cast<size_t>(y) * rowPitch;
+			float* dstPixel = dst + static_cast<size_t>(y) * width * NumChannels;
+
+			for (uint32_t x = 0; x < width; ++x) {
+				dstPixel[0] = colorTable[srcPixel[0]];
+				dstPixel[1] = colorTable[srcPixel[1]];
+				dstPixel[2] = colorTable[srcPixel[2]];
+				dstPixel[3] = srcPixel[3] / 255.0f;
+
+				srcPixel += NumChannels;
+				dstPixel += NumChannels;
+			}
+		}
+	}
+
+	void ConvertFromLinearScalar(
+		const float* src, uint32_t numPixels,
+		bool isSRGB, float alphaScale,
+		uint8_t* dst)
+	{
+		const ConversionTables& tables = GetConversionTables();
+
+		for (uint32_t i = 0; i < numPixels * NumChannels; ++i) {
+			bool isColor = (i % NumChannels) != 3;
+			float value = std::clamp(isColor ? src[i] : src[i] * alphaScale, 0.0f, 1.0f);
+
+			if (isSRGB && isColor) {
+				dst[i] = tables.LinearToSRGB[static_cast<uint32_t>(value * (LinearToSRGBTableSize - 1) + 0.5f)];
+			} else {
+				dst[i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+			}
+		}
+	}
+
+	// pixel is clamped and scaled to table or byte range in one SSE register
+	void ConvertFromLinearSSE(
+		const float* src, uint32_t numPixels,
+		bool isSRGB, float alphaScale,
+		uint8_t* dst)
+	{
+		const ConversionTables& tables = GetConversionTables();
+
+		float colorRange = isSRGB ? static_cast<float>(LinearToSRGBTableSize - 1) : 255.0f;
+		const __m128 scale = _mm_setr_ps(colorRange, colorRange, colorRange, 255.0f * alphaScale);
+		const __m128 maxValue = _mm_setr_ps(colorRange, colorRange, colorRange, 255.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+
+		alignas(16) int32_t values[NumChannels];
+
+		for (uint32_t i = 0; i < numPixels; ++i) {
+			__m128 pixel = _mm_mul_ps(_mm_loadu_ps(src + i * NumChannels), scale);
+			pixel = _mm_min_ps(_mm_max_ps(pixel, _mm_setzero_ps()), maxValue);
+
+			_mm_store_si128(reinterpret_cast<__m128i*>(values), _mm_cvttps_epi32(_mm_add_ps(pixel, half)));
+
+			uint8_t* dstPixel = dst + i * NumChannels;
+
+			for (uint32_t c = 0; c < 3; ++c) {
+				dstPixel[c] = isSRGB ? tables.LinearToSRGB[values[c]] : static_cast<uint8_t>(values[c]);
+			}
+
+			dstPixel[3] = static_cast<uint8_t>(values[3]);
+		}
+	}
+
+	float ComputeAlphaCoverage(const float* pixels, uint32_t numPixels, float reference, float alphaScale) {
+		uint32_t numCovered = 0;
+
+		for (uint32_t i = 0; i < numPixels; ++i) {
+			numCovered += pixels[i * NumChannels + 3] * alphaScale > reference;
+		}
+
+		return numCovered / static_cast<float>(numPixels);
+	}
+
+	// binary search of alpha scale giving the same coverage as top level
+	float FindAlphaScale(const float* pixels, uint32_t numPixels, float reference, float targetCoverage) {
+		float minScale = 0.0f;
+		float maxScale = 4.0f;
+		float scale = 1.0f;
+
+		for (uint32_t i = 0; i < 12; ++i) {
+			float coverage = ComputeAlphaCoverage(pixels, numPixels, reference, scale);
+
+			if (coverage < targetCoverage) {
+				minScale = scale;
+			} else {
+				maxScale = scale;
+			}
+
+			scale = (minScale + maxScale) / 2.0f;
+		}
+
+		return scale;
+	}
+
+	MipChain GenerateMipChainImpl(
+		const uint8_t* pixels,
+		uint32_t width,
+		uint32_t height,
+		uint32_t rowPitch,
+		const MipGenerationDesc& desc,
+		uint32_t numLevels,
+		bool useSIMD)
+	{
+		assert(width > 0 && height > 0 && "Empty image");
+
+		uint32_t maxNumLevels = GetNumMipLevels(width, height);
+		numLevels = numLevels == 0 ? maxNumLevels : std::min(numLevels, maxNumLevels);
+
+		bool useAVX2 = useSIMD && IsAVX2Supported();
+		auto horizontalPass = useSIMD ? HorizontalPassSSE : HorizontalPassScalar;
+		auto verticalPass = useAVX2 ? VerticalPassAVX2 : useSIMD ? VerticalPassSSE : VerticalPassScalar;
+		auto convertFromLinear = useSIMD ? ConvertFromLinearSSE : ConvertFromLinearScalar;
+
+		MipChain chain;
+		chain.Levels.resize(numLevels);
+
+		size_t dataSize = 0;
+
+		for (uint32_t i = 0; i < numLevels; ++i) {
+			MipLevel& level = chain.Levels[i];
+			level.Width = std::max(1u, width >> i);
+			level.Height = std::max(1u, height >> i);
+			level.Offset = dataSize;
+
+			dataSize += static_cast<size_t>(level.Width) * level.Height * NumChannels;
+		}
+
+		chain.Data.resize(dataSize);
+
+		// top level is copied as is
+		for (uint32_t y = 0; y < height; ++y) {
+			std::copy(
+				pixels + static_cast<size_t>(y) * rowPitch,
+				pixels + static_cast<size_t>(y) * rowPitch + width * NumChannels,
+				chain.Data.data() + static_cast<size_t>(y) * width * NumChannels
+			);
+		}
+
+		// previous level is kept in linear float to avoid accumulating quantization error
+		std::vector<float> current(static_cast<size_t>(width) * height * NumChannels);
+		std::vector<float> horizontal;
+		std::vector<float> next;
+
+		ConvertToLinear(pixels, width, height, rowPitch, desc.IsSRGB, current.data());
+
+		bool isAlphaCoverage = desc.AlphaCoverageReference > 0.0f;
+		float targetCoverage = 0.0f;
+
+		if (isAlphaCoverage) {
+			targetCoverage = ComputeAlphaCoverage(current.data(), width * height, desc.AlphaCoverageReference, 1.0f);
+		}
+
+		for (uint32_t i = 1; i < numLevels; ++i) {
+			const MipLevel& srcLevel = chain.Levels[i - 1];
+			const MipLevel& dstLevel = chain.Levels[i];
+
+			FilterWeights horizontalWeights = ComputeFilterWeights(srcLevel.Width, dstLevel.Width, desc.Filter);
+			FilterWeights verticalWeights = ComputeFilterWeights(srcLevel.Height, dstLevel.Height, desc.Filter);
+
+			horizontal.resize(static_cast<size_t>(dstLevel.Width) * srcLevel.Height * NumChannels);
+			next.resize(static_cast<size_t>(dstLevel.Width) * dstLevel.Height * NumChannels);
+
+			horizontalPass(current.data(), srcLevel.Width, srcLevel.Height, horizontal.data(), dstLevel.Width, horizontalWeights);
+			verticalPass(horizontal.data(), dstLevel.Width, next.data(), dstLevel.Height, verticalWeights);
+
+			uint32_t numPixels = dstLevel.Width * dstLevel.Height;
+			float alphaScale = 1.0f;
+
+			if (isAlphaCoverage) {
+				alphaScale = FindAlphaScale(next.data(), numPixels, desc.AlphaCoverageReference, targetCoverage);
+			}
+
+			convertFromLinear(next.data(), numPixels, desc.IsSRGB, alphaScale, chain.Data.data() + dstLevel.Offset);
+
+			std::swap(current, next);
+		}
+
+		return chain;
+	}
+}
+
+uint32_t GetNumMipLevels(uint32_t width, uint32_t height) {
+	uint32_t numLevels = 1;
+
+	while (width > 1 || height > 1) {
+		width = std::max(1u, width / 2);
+		height = std::max(1u, height / 2);
+		++numLevels;
+	}
+
+	return numLevels;
+}
+
+MipChain GenerateMipChain(
+	const uint8_t* pixels,
+	uint32_t width,
+	uint32_t height,
+	uint32_t rowPitch,
+	const MipGenerationDesc& desc,
+	uint32_t numLevels)
+{
+	return GenerateMipChainImpl(pixels, width, height, rowPitch, desc, numLevels, true);
+}
+
+MipChain GenerateMipChainScalar(
+	const uint8_t* pixels,
+	uint32_t width,
+	uint32_t height,
+	uint32_t rowPitch,
+	const MipGenerationDesc& desc,
+	uint32_t numLevels)
+{
+	return GenerateMipChainImpl(pixels, width, height, rowPitch, desc, numLevels, false);
+}
\ No newline at end of file
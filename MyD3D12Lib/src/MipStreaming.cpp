@@ -0,0 +1,240 @@
+#include <MyD3D12Lib/MipStreaming.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <queue>
+
+float ComputeMeshUVDensity(
+	const float* positions,
+	uint32_t positionStride,
+	const float* texCoords,
+	uint32_t texCoordStride,
+	const uint32_t* indexes,
+	uint32_t numIndexes)
+{
+	double positionsArea = 0.0;
+	double texCoordsArea = 0.0;
+
+	for (uint32_t i = 0; i + 2 < numIndexes; i += 3) {
+		const float* p0 = positions + static_cast<size_t>(indexes[i]) * positionStride;
+		const float* p1 = positions + static_cast<size_t>(indexes[i + 1]) * positionStride;
+		const float* p2 = positions + static_cast<size_t>(indexes[i + 2]) * positionStride;
+
+		float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+		float cross[3] = {
+			e1[1] * e2[2] - e1[2] * e2[1],
+			e1[2] * e2[0] - e1[0] * e2[2],
+			e1[0] * e2[1] - e1[1] * e2[0]
+		};
+
+		float positionArea = 0.5f * std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+
+		const float* t0 = texCoords + static_cast<size_t>(indexes[i]) * texCoordStride;
+		const float* t1 = texCoords + static_cast<size_t>(indexes[i + 1]) * texCoordStride;
+		const float* t2 = texCoords + static_cast<size_t>(indexes[i + 2]) * texCoordStride;
+
+		float texCoordArea = 0.5f * std::abs((t1[0] - t0[0]) * (t2[1] - t0[1]) - (t2[0] - t0[0]) * (t1[1] - t0[1]));
+
+		// triangles collapsed in space or in texture don`t tell anything about density
+		if (positionArea <= FLT_MIN || texCoordArea <= FLT_MIN) {
+			continue;
+		}
+
+		positionsArea += positionArea;
+		texCoordsArea += texCoordArea;
+	}
+
+	if (positionsArea == 0.0) {
+		return 0.0f;
+	}
+
+	return static_cast<float>(std::sqrt(texCoordsArea / positionsArea));
+}
+
+float ComputeRequiredMip(
+	float uvDensity,
+	float textureSize,
+	float distance,
+	float screenHeight,
+	float tanHalfFoV)
+{
+	// texture without density is not sampled in any visible detail
+	if (uvDensity <= 0.0f) {
+		return FLT_MAX;
+	}
+
+	// pixels covered by model space unit at distance
+	float pixelsPerUnit = screenHeight / (2.0f * (std::max)(distance, FLT_MIN) * tanHalfFoV);
+	float texelsPerUnit = uvDensity * textureSize;
+
+	return std::log2(texelsPerUnit / pixelsPerUnit);
+}
+
+MipBudgetSolver::MipBudgetSolver(uint32_t numTextures, uint64_t budget, float hysteresis) :
+	m_Textures(numTextures),
+	m_RequiredMips(numTextures, FLT_MAX),
+	m_FirstMips(numTextures, 0),
+	m_Budget(budget),
+	m_Hysteresis(hysteresis)
+{}
+
+namespace {
+	// finest mip in range which is not finer than required one
+	uint32_t ClampRequiredMip(float requiredMip, uint32_t maxFirstMip) {
+		if (!(requiredMip > 0.0f)) {
+			return 0;
+		}
+
+		if (requiredMip >= static_cast<float>(maxFirstMip)) {
+			return maxFirstMip;
+		}
+
+		return static_cast<uint32_t>(requiredMip);
+	}
+}
+
+void MipBudgetSolver::SetTextureMips(uint32_t id, const std::vector<uint64_t>& mipsSizes, uint32_t maxFirstMip) {
+	assert(!mipsSizes.empty() && "Texture should have at least one mip");
+
+	TextureMips& texture = m_Textures[id];
+
+	texture.SizesFrom.assign(mipsSizes.size() + 1, 0);
+
+	for (size_t i = mipsSizes.size(); i > 0; --i) {
+		texture.SizesFrom[i - 1] = texture.SizesFrom[i] + mipsSizes[i - 1];
+	}
+
+	texture.MaxFirstMip = (std::min)(maxFirstMip, static_cast<uint32_t>(mipsSizes.size() - 1));
+
+	// new texture has nothing resident, so it starts from required mip without hysteresis
+	m_FirstMips[id] = ClampRequiredMip(m_RequiredMips[id], texture.MaxFirstMip);
+}
+
+void MipBudgetSolver::SetBudget(uint64_t budget) {
+	m_Budget = budget;
+}
+
+const std::vector<uint32_t>& MipBudgetSolver::Solve(const std::vector<float>& requiredMips) {
+	assert(requiredMips.size() == m_Textures.size() && "Required mip should be given for each texture");
+
+	m_RequiredMips = requiredMips;
+
+	// resident mips are dropped for budget less eagerly than not resident mips are declined
+	std::vector<uint32_t> residentMips = m_FirstMips;
+
+	uint64_t totalSize = 0;
+
+	for (uint32_t i = 0; i < m_Textures.size(); ++i) {
+		if (!HasMips(i)) {
+			continue;
+		}
+
+		m_FirstMips[i] = GetHysteresisMip(i, m_RequiredMips[i]);
+		totalSize += m_Textures[i].SizesFrom[m_FirstMips[i]];
+	}
+
+	if (totalSize <= m_Budget) {
+		return m_FirstMips;
+	}
+
+	// mip is dropped from texture which becomes least under resolved after that
+	// unused textures have infinitely coarse required mip, so they are dropped first
+	// resident mips cost hysteresis more, so textures with similar costs don`t swap mips each frame
+	struct Candidate {
+		float Cost;
+		uint64_t Saving;
+		uint32_t Id;
+
+		bool operator<(const Candidate& other) const {
+			if (Cost != other.Cost) {
+				return Cost > other.Cost;
+			}
+
+			if (Saving != other.Saving) {
+				return Saving < other.Saving;
+			}
+
+			return Id > other.Id;
+		}
+	};
+
+	auto makeCandidate = [&](uint32_t id) {
+		const TextureMips& texture = m_Textures[id];
+		uint32_t firstMip = m_FirstMips[id];
+
+		float requiredMip = (std::min)(m_RequiredMips[id], static_cast<float>(texture.SizesFrom.size()));
+		float residentCost = firstMip >= residentMips[id] ? m_Hysteresis : 0.0f;
+
+		return Candidate{
+			static_cast<float>(firstMip + 1) - requiredMip + residentCost,
+			texture.SizesFrom[firstMip] - texture.SizesFrom[firstMip + 1],
+			id
+		};
+	};
+
+	std::priority_queue<Candidate> candidates;
+
+	for (uint32_t i = 0; i < m_Textures.size(); ++i) {
+		if (HasMips(i) && m_FirstMips[i] < m_Textures[i].MaxFirstMip) {
+			candidates.push(makeCandidate(i));
+		}
+	}
+
+	while (totalSize > m_Budget && !candidates.empty()) {
+		Candidate candidate = candidates.top();
+		candidates.pop();
+
+		uint32_t id = candidate.Id;
+
+		totalSize -= candidate.Saving;
+		++m_FirstMips[id];
+
+		if (m_FirstMips[id] < m_Textures[id].MaxFirstMip) {
+			candidates.push(makeCandidate(id));
+		}
+	}
+
+	return m_FirstMips;
+}
+
+uint32_t MipBudgetSolver::GetFirstMip(uint32_t id) const {
+	return m_FirstMips[id];
+}
+
+bool MipBudgetSolver::HasMips(uint32_t id) const {
+	return !m_Textures[id].SizesFrom.empty();
+}
+
+uint64_t MipBudgetSolver::GetResidentSize() const {
+	uint64_t size = 0;
+
+	for (uint32_t i = 0; i < m_Textures.size(); ++i) {
+		if (HasMips(i)) {
+			size += m_Textures[i].SizesFrom[m_FirstMips[i]];
+		}
+	}
+
+	return size;
+}
+
+uint32_t MipBudgetSolver::GetHysteresisMip(uint32_t id, float requiredMip) const {
+	const TextureMips& texture = m_Textures[id];
+	uint32_t firstMip = m_FirstMips[id];
+	uint32_t requiredFirstMip = ClampRequiredMip(requiredMip, texture.MaxFirstMip);
+
+	// finer mips are streamed in at once
+	if (requiredFirstMip <= firstMip) {
+		return requiredFirstMip;
+	}
+
+	// resident mip is dropped only when it is not needed by margin
+	if (requiredMip < static_cast<float>(firstMip + 1) + m_Hysteresis) {
+		return firstMip;
+	}
+
+	return (std::max)(firstMip + 1, ClampRequiredMip(requiredMip - m_Hysteresis, texture.MaxFirstMip));
+}
\ No newline at end of file
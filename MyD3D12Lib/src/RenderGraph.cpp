@@ -0,0 +1,542 @@
+#include <MyD3D12Lib/RenderGraph.h>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+namespace {
+	uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+void RenderGraph::Reset() {
+	m_Resources.clear();
+	m_Passes.clear();
+	m_DeclaredAccesses.clear();
+
+	m_Accesses.clear();
+	m_Order.clear();
+	m_CompiledPasses.clear();
+	m_Barriers.clear();
+	m_FirstFinalBarrier = 0;
+	m_Slots.clear();
+	m_HeapSize = 0;
+	m_HeapAlignment = 1;
+	m_TransientsSize = 0;
+}
+
+uint32_t RenderGraph::CreateTransient(uint64_t size, uint64_t alignment) {
+	assert(size > 0 && "Transient should not be empty");
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "Alignment should be power of two");
+
+	m_Resources.push_back({ true, size, alignment, 0, InvalidIndex, InvalidIndex, 0, InvalidIndex, InvalidIndex });
+	return static_cast<uint32_t>(m_Resources.size() - 1);
+}
+
+uint32_t RenderGraph::Import(uint32_t state) {
+	m_Resources.push_back({ false, 0, 1, state, InvalidIndex, InvalidIndex, 0, InvalidIndex, InvalidIndex });
+	return static_cast<uint32_t>(m_Resources.size() - 1);
+}
+
+uint32_t RenderGraph::AddPass(const std::string& name, ExecuteFunction execute, bool hasSideEffects) {
+	m_Passes.push_back({ name, std::move(execute), hasSideEffects, false, InvalidIndex, 0, 0 });
+	return static_cast<uint32_t>(m_Passes.size() - 1);
+}
+
+void RenderGraph::Read(uint32_t pass, uint32_t resource, uint32_t state) {
+	AddAccess(pass, resource, state, true, false);
+}
+
+void RenderGraph::Write(uint32_t pass, uint32_t resource, uint32_t state) {
+	AddAccess(pass, resource, state, false, true);
+}
+
+void RenderGraph::ReadWrite(uint32_t pass, uint32_t resource, uint32_t state) {
+	AddAccess(pass, resource, state, true, true);
+}
+
+void RenderGraph::Compile() {
+	m_CompiledPasses.clear();
+	m_Barriers.clear();
+	m_Slots.clear();
+
+	GroupAccesses();
+	SortPasses();
+	CullPasses();
+	ComputeLifetimes();
+	AssignMemory();
+	DeriveBarriers();
+}
+
+const std::vector<RenderGraph::CompiledPass>& RenderGraph::GetCompiledPasses() const {
+	return m_CompiledPasses;
+}
+
+const RenderGraph::Barrier* RenderGraph::GetBarriers(const CompiledPass& pass) const {
+	return m_Barriers.data() + pass.FirstBarrier;
+}
+
+const RenderGraph::Barrier* RenderGraph::GetAfterBarriers(const CompiledPass& pass) const {
+	return m_Barriers.data() + pass.FirstBarrier + pass.NumBarriers;
+}
+
+uint32_t RenderGraph::GetNumFinalBarriers() const {
+	return static_cast<uint32_t>(m_Barriers.size()) - m_FirstFinalBarrier;
+}
+
+const RenderGraph::Barrier* RenderGraph::GetFinalBarriers() const {
+	return m_Barriers.data() + m_FirstFinalBarrier;
+}
+
+void RenderGraph::ExecutePass(uint32_t pass) const {
+	if (m_Passes[pass].Execute) {
+		m_Passes[pass].Execute();
+	}
+}
+
+const std::string& RenderGraph::GetPassName(uint32_t pass) const {
+	return m_Passes[pass].Name;
+}
+
+bool RenderGraph::IsPassCulled(uint32_t pass) const {
+	return m_Passes[pass].IsCulled;
+}
+
+uint32_t RenderGraph::GetNumPasses() const {
+	return static_cast<uint32_t>(m_Passes.size());
+}
+
+uint32_t RenderGraph::GetNumResources() const {
+	return static_cast<uint32_t>(m_Resources.size());
+}
+
+bool RenderGraph::IsTransient(uint32_t resource) const {
+	return m_Resources[resource].IsTransient;
+}
+
+bool RenderGraph::IsUsed(uint32_t resource) const {
+	return m_Resources[resource].FirstUse != InvalidIndex;
+}
+
+uint32_t RenderGraph::GetFirstUse(uint32_t resource) const {
+	return m_Resources[resource].FirstUse;
+}
+
+uint32_t RenderGraph::GetLastUse(uint32_t resource) const {
+	return m_Resources[resource].LastUse;
+}
+
+uint32_t RenderGraph::GetInitialState(uint32_t resource) const {
+	return m_Resources[resource].InitialState;
+}
+
+uint64_t RenderGraph::GetSize(uint32_t resource) const {
+	return m_Resources[resource].Size;
+}
+
+uint64_t RenderGraph::GetOffset(uint32_t resource) const {
+	return m_Resources[resource].Offset;
+}
+
+uint64_t RenderGraph::GetHeapSize() const {
+	return m_HeapSize;
+}
+
+uint64_t RenderGraph::GetHeapAlignment() const {
+	return m_HeapAlignment;
+}
+
+uint64_t RenderGraph::GetTransientsSize() const {
+	return m_TransientsSize;
+}
+
+void RenderGraph::AddAccess(uint32_t pass, uint32_t resource, uint32_t state, bool isRead, bool isWrite) {
+	assert(pass < m_Passes.size() && resource < m_Resources.size() && "Invalid pass or resource");
+
+	m_DeclaredAccesses.push_back({ pass, resource, state, isRead, isWrite, false, InvalidIndex, InvalidIndex });
+}
+
+void RenderGraph::GroupAccesses() {
+	// accesses are sorted by passes keeping order of declaration inside pass
+	for (Pass& pass : m_Passes) {
+		pass.NumAccesses = 0;
+	}
+
+	for (const Access& access : m_DeclaredAccesses) {
+		++m_Passes[access.Pass].NumAccesses;
+	}
+
+	uint32_t firstAccess = 0;
+
+	for (Pass& pass : m_Passes) {
+		pass.FirstAccess = firstAccess;
+		firstAccess += pass.NumAccesses;
+		pass.NumAccesses = 0;
+	}
+
+	m_Accesses.resize(m_DeclaredAccesses.size());
+
+	for (const Access& access : m_DeclaredAccesses) {
+		Pass& pass = m_Passes[access.Pass];
+		m_Accesses[pass.FirstAccess + pass.NumAccesses++] = access;
+	}
+
+	// accesses of resource are linked in order of passes declaration
+	m_LastAccesses.assign(m_Resources.size(), InvalidIndex);
+
+	for (uint32_t i = 0; i < m_Accesses.size(); ++i) {
+		Access& access = m_Accesses[i];
+		uint32_t& lastAccess = m_LastAccesses[access.Resource];
+
+		assert((lastAccess == InvalidIndex || m_Accesses[lastAccess].Pass != access.Pass) && "Pass uses resource only once");
+
+		access.Previous = lastAccess;
+		lastAccess = i;
+	}
+}
+
+void RenderGraph::SortPasses() {
+	uint32_t numPasses = static_cast<uint32_t>(m_Passes.size());
+
+	// reads depend on last write, writes depend on last write and on reads after it
+	m_Dependencies.clear();
+	m_States.assign(m_Resources.size(), InvalidIndex);
+
+	for (const Access& access : m_Accesses) {
+		uint32_t& lastWriter = m_States[access.Resource];
+
+		if (access.IsWrite) {
+			for (uint32_t previous = access.Previous; previous != InvalidIndex; previous = m_Accesses[previous].Previous) {
+				const Access& previousAccess = m_Accesses[previous];
+
+				m_Dependencies.push_back(previousAccess.Pass);
+				m_Dependencies.push_back(access.Pass);
+
+				if (previousAccess.IsWrite) {
+					break;
+				}
+			}
+
+			lastWriter = access.Pass;
+		}
+		else if (lastWriter != InvalidIndex) {
+			m_Dependencies.push_back(lastWriter);
+			m_Dependencies.push_back(access.Pass);
+		}
+	}
+
+	// successors are grouped by passes
+	m_SuccessorsStarts.assign(numPasses + 1, 0);
+	m_NumPredecessors.assign(numPasses, 0);
+
+	for (uint32_t i = 0; i < m_Dependencies.size(); i += 2) {
+		++m_SuccessorsStarts[m_Dependencies[i] + 1];
+		++m_NumPredecessors[m_Dependencies[i + 1]];
+	}
+
+	for (uint32_t i = 0; i < numPasses; ++i) {
+		m_SuccessorsStarts[i + 1] += m_SuccessorsStarts[i];
+	}
+
+	m_Successors.resize(m_Dependencies.size() / 2);
+	m_Ready.assign(m_SuccessorsStarts.begin(), m_SuccessorsStarts.end() - 1);
+
+	for (uint32_t i = 0; i < m_Dependencies.size(); i += 2) {
+		m_Successors[m_Ready[m_Dependencies[i]]++] = m_Dependencies[i + 1];
+	}
+
+	// Kahn`s algorithm, of ready passes the first declared one is taken, so order of declaration is kept where it is possible
+	std::greater<uint32_t> compare;
+
+	m_Ready.clear();
+	m_Order.clear();
+
+	for (uint32_t i = 0; i < numPasses; ++i) {
+		if (m_NumPredecessors[i] == 0) {
+			m_Ready.push_back(i);
+		}
+	}
+
+	std::make_heap(m_Ready.begin(), m_Ready.end(), compare);
+
+	while (!m_Ready.empty()) {
+		std::pop_heap(m_Ready.begin(), m_Ready.end(), compare);
+		uint32_t pass = m_Ready.back();
+		m_Ready.pop_back();
+
+		m_Order.push_back(pass);
+
+		for (uint32_t i = m_SuccessorsStarts[pass]; i < m_SuccessorsStarts[pass + 1]; ++i) {
+			if (--m_NumPredecessors[m_Successors[i]] == 0) {
+				m_Ready.push_back(m_Successors[i]);
+				std::push_heap(m_Ready.begin(), m_Ready.end(), compare);
+			}
+		}
+	}
+
+	assert(m_Order.size() == numPasses && "Render graph has cycle");
+}
+
+void RenderGraph::CullPasses() {
+	// content of imported resources at the end of frame is output, pass is needed if later needed pass reads what it writes
+	m_IsNeeded.assign(m_Resources.size(), false);
+
+	for (uint32_t i = 0; i < m_Resources.size(); ++i) {
+		m_IsNeeded[i] = !m_Resources[i].IsTransient;
+	}
+
+	for (auto it = m_Order.rbegin(); it != m_Order.rend(); ++it) {
+		Pass& pass = m_Passes[*it];
+		const Access* accesses = m_Accesses.data() + pass.FirstAccess;
+
+		bool isNeeded = pass.HasSideEffects;
+
+		for (uint32_t i = 0; i < pass.NumAccesses && !isNeeded; ++i) {
+			isNeeded = accesses[i].IsWrite && m_IsNeeded[accesses[i].Resource];
+		}
+
+		pass.IsCulled = !isNeeded;
+
+		if (pass.IsCulled) {
+			continue;
+		}
+
+		// content before pass is needed only if pass reads it
+		for (uint32_t i = 0; i < pass.NumAccesses; ++i) {
+			if (!accesses[i].IsRead) {
+				m_IsNeeded[accesses[i].Resource] = false;
+			}
+		}
+
+		for (uint32_t i = 0; i < pass.NumAccesses; ++i) {
+			if (accesses[i].IsRead) {
+				m_IsNeeded[accesses[i].Resource] = true;
+			}
+		}
+	}
+}
+
+void RenderGraph::ComputeLifetimes() {
+	for (Resource& resource : m_Resources) {
+		resource.FirstUse = InvalidIndex;
+		resource.LastUse = InvalidIndex;
+		resource.Offset = 0;
+		resource.Slot = InvalidIndex;
+		resource.AliasedResource = InvalidIndex;
+	}
+
+	// accesses of executed passes are linked to next ones in order of execution
+	m_LastAccesses.assign(m_Resources.size(), InvalidIndex);
+
+	for (uint32_t passIndex : m_Order) {
+		Pass& pass = m_Passes[passIndex];
+
+		if (pass.IsCulled) {
+			pass.CompiledIndex = InvalidIndex;
+			continue;
+		}
+
+		pass.CompiledIndex = static_cast<uint32_t>(m_CompiledPasses.size());
+		m_CompiledPasses.push_back({ passIndex, 0, 0, 0 });
+
+		for (uint32_t i = pass.FirstAccess; i < pass.FirstAccess + pass.NumAccesses; ++i) {
+			Access& access = m_Accesses[i];
+			Resource& resource = m_Resources[access.Resource];
+
+			access.IsSplit = false;
+			access.Next = InvalidIndex;
+
+			if (resource.FirstUse == InvalidIndex) {
+				resource.FirstUse = pass.CompiledIndex;
+
+				if (resource.IsTransient) {
+					resource.InitialState = access.State;
+				}
+			}
+
+			resource.LastUse = pass.CompiledIndex;
+
+			uint32_t& lastAccess = m_LastAccesses[access.Resource];
+
+			if (lastAccess != InvalidIndex) {
+				m_Accesses[lastAccess].Next = i;
+			}
+
+			lastAccess = i;
+		}
+	}
+}
+
+void RenderGraph::AssignMemory() {
+	m_Transients.clear();
+	m_TransientsSize = 0;
+
+	for (uint32_t i = 0; i < m_Resources.size(); ++i) {
+		const Resource& resource = m_Resources[i];
+
+		if (resource.IsTransient && resource.FirstUse != InvalidIndex) {
+			m_Transients.push_back(i);
+			m_TransientsSize = AlignUp(m_TransientsSize, resource.Alignment) + resource.Size;
+		}
+	}
+
+	// intervals are colored in order of their starts, bigger transients first
+	std::sort(m_Transients.begin(), m_Transients.end(), [this](uint32_t a, uint32_t b) {
+		const Resource& first = m_Resources[a];
+		const Resource& second = m_Resources[b];
+
+		if (first.FirstUse != second.FirstUse) {
+			return first.FirstUse < second.FirstUse;
+		}
+
+		return first.Size != second.Size ? first.Size > second.Size : a < b;
+	});
+
+	for (uint32_t index : m_Transients) {
+		Resource& resource = m_Resources[index];
+
+		// slot is free if its last transient died before this one is born
+		// the smallest free slot which fits is taken, otherwise the biggest one grows least
+		uint32_t best = InvalidIndex;
+
+		for (uint32_t i = 0; i < m_Slots.size(); ++i) {
+			const Slot& slot = m_Slots[i];
+
+			if (m_Resources[slot.LastResource].LastUse >= resource.FirstUse) {
+				continue;
+			}
+
+			if (best == InvalidIndex) {
+				best = i;
+				continue;
+			}
+
+			bool fits = slot.Size >= resource.Size;
+			bool bestFits = m_Slots[best].Size >= resource.Size;
+
+			if (fits ? !bestFits || slot.Size < m_Slots[best].Size : !bestFits && slot.Size > m_Slots[best].Size) {
+				best = i;
+			}
+		}
+
+		if (best == InvalidIndex) {
+			resource.Slot = static_cast<uint32_t>(m_Slots.size());
+			m_Slots.push_back({ resource.Size, resource.Alignment, 0, index, index });
+			continue;
+		}
+
+		Slot& slot = m_Slots[best];
+		slot.Size = (std::max)(slot.Size, resource.Size);
+		slot.Alignment = (std::max)(slot.Alignment, resource.Alignment);
+
+		resource.Slot = best;
+		resource.AliasedResource = slot.LastResource;
+		slot.LastResource = index;
+	}
+
+	m_HeapSize = 0;
+	m_HeapAlignment = 1;
+
+	for (Slot& slot : m_Slots) {
+		slot.Offset = AlignUp(m_HeapSize, slot.Alignment);
+		m_HeapSize = slot.Offset + slot.Size;
+		m_HeapAlignment = (std::max)(m_HeapAlignment, slot.Alignment);
+
+		// memory goes round, the first transient of slot takes it over from the last one of previous frame
+		if (slot.FirstResource != slot.LastResource) {
+			m_Resources[slot.FirstResource].AliasedResource = slot.LastResource;
+		}
+	}
+
+	for (uint32_t index : m_Transients) {
+		m_Resources[index].Offset = m_Slots[m_Resources[index].Slot].Offset;
+	}
+}
+
+void RenderGraph::DeriveBarriers() {
+	m_States.resize(m_Resources.size());
+
+	for (uint32_t i = 0; i < m_Resources.size(); ++i) {
+		m_States[i] = m_Resources[i].InitialState;
+	}
+
+	m_EndingTransients = m_Transients;
+
+	std::stable_sort(m_EndingTransients.begin(), m_EndingTransients.end(), [this](uint32_t a, uint32_t b) {
+		return m_Resources[a].LastUse < m_Resources[b].LastUse;
+	});
+
+	uint32_t numEnded = 0;
+	uint32_t numActivated = 0;
+
+	for (uint32_t i = 0; i < m_CompiledPasses.size(); ++i) {
+		CompiledPass& compiledPass = m_CompiledPasses[i];
+		const Pass& pass = m_Passes[compiledPass.Pass];
+
+		compiledPass.FirstBarrier = static_cast<uint32_t>(m_Barriers.size());
+
+		// dead transients return to state of their first use before their memory is taken by others
+		for (; numEnded < m_EndingTransients.size() && m_Resources[m_EndingTransients[numEnded]].LastUse < i; ++numEnded) {
+			uint32_t resource = m_EndingTransients[numEnded];
+
+			if (m_States[resource] != m_Resources[resource].InitialState) {
+				AddBarrier(BarrierType::Transition, resource, m_States[resource], m_Resources[resource].InitialState);
+				m_States[resource] = m_Resources[resource].InitialState;
+			}
+		}
+
+		for (; numActivated < m_Transients.size() && m_Resources[m_Transients[numActivated]].FirstUse == i; ++numActivated) {
+			uint32_t resource = m_Transients[numActivated];
+			const Resource& transient = m_Resources[resource];
+
+			if (transient.AliasedResource != InvalidIndex) {
+				AddBarrier(BarrierType::Aliasing, resource, transient.InitialState, transient.InitialState, transient.AliasedResource);
+			}
+		}
+
+		for (uint32_t j = pass.FirstAccess; j < pass.FirstAccess + pass.NumAccesses; ++j) {
+			const Access& access = m_Accesses[j];
+
+			if (m_States[access.Resource] != access.State) {
+				AddBarrier(access.IsSplit ? BarrierType::EndTransition : BarrierType::Transition, access.Resource, m_States[access.Resource], access.State);
+				m_States[access.Resource] = access.State;
+			}
+		}
+
+		compiledPass.NumBarriers = static_cast<uint32_t>(m_Barriers.size()) - compiledPass.FirstBarrier;
+
+		// transition to state of next use is begun at once if passes not using resource are between
+		for (uint32_t j = pass.FirstAccess; j < pass.FirstAccess + pass.NumAccesses; ++j) {
+			const Access& access = m_Accesses[j];
+
+			if (access.Next == InvalidIndex) {
+				continue;
+			}
+
+			Access& next = m_Accesses[access.Next];
+
+			if (next.State != access.State && m_Passes[next.Pass].CompiledIndex > i + 1) {
+				AddBarrier(BarrierType::BeginTransition, access.Resource, access.State, next.State);
+				next.IsSplit = true;
+			}
+		}
+
+		compiledPass.NumAfterBarriers = static_cast<uint32_t>(m_Barriers.size()) - compiledPass.FirstBarrier - compiledPass.NumBarriers;
+	}
+
+	m_FirstFinalBarrier = static_cast<uint32_t>(m_Barriers.size());
+
+	for (; numEnded < m_EndingTransients.size(); ++numEnded) {
+		uint32_t resource = m_EndingTransients[numEnded];
+
+		if (m_States[resource] != m_Resources[resource].InitialState) {
+			AddBarrier(BarrierType::Transition, resource, m_States[resource], m_Resources[resource].InitialState);
+			m_States[resource] = m_Resources[resource].InitialState;
+		}
+	}
+}
+
+void RenderGraph::AddBarrier(BarrierType type, uint32_t resource, uint32_t before, uint32_t after, uint32_t aliased) {
+	m_Barriers.push_back({ type, resource, before, after, aliased });
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include <MyD3D12Lib/RenderGraphResources.h>
+#include <MyD3D12Lib/Helpers.h>
+
+#include <d3dx12.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+RenderGraphResources::RenderGraphResources(ComPtr<ID3D12Device2> device) :
+	m_Device(device)
+{
+}
+
+uint32_t RenderGraphResources::Import(RenderGraph& graph, ID3D12Resource* resource, D3D12_RESOURCE_STATES state) {
+	uint32_t index = graph.Import(state);
+	GetGraphResource(index).Imported = resource;
+
+	return index;
+}
+
+uint32_t RenderGraphResources::CreateTransient(RenderGraph& graph, const D3D12_RESOURCE_DESC& desc, const D3D12_CLEAR_VALUE* clearValue) {
+	assert((desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) && "Transient should be render target or depth buffer");
+
+	// index of transient is the same as in previous frames if graph is built the same way
+	Resource& resource = GetGraphResource(graph.GetNumResources());
+	resource.Imported = nullptr;
+
+	if (std::memcmp(&resource.Desc, &desc, sizeof(desc)) != 0 || resource.Info.SizeInBytes == 0) {
+		resource.Desc = desc;
+		resource.Info = m_Device->GetResourceAllocationInfo(0, 1, &desc);
+	}
+
+	resource.HasClearValue = clearValue != nullptr;
+	resource.ClearValue = clearValue != nullptr ? *clearValue : D3D12_CLEAR_VALUE{};
+
+	return graph.CreateTransient(resource.Info.SizeInBytes, (std::max)(resource.Info.Alignment, static_cast<uint64_t>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)));
+}
+
+bool RenderGraphResources::IsLayoutChanged(const RenderGraph& graph) const {
+	if (graph.GetHeapSize() != m_HeapSize) {
+		return true;
+	}
+
+	for (uint32_t i = 0; i < m_Resources.size(); ++i) {
+		const Resource& resource = m_Resources[i];
+
+		bool isUsedTransient = i < graph.GetNumResources() && graph.IsTransient(i) && graph.IsUsed(i);
+
+		if (!isUsedTransient) {
+			// memory of transients which are not used anymore is released
+			if (resource.Placed != nullptr) {
+				return true;
+			}
+
+			continue;
+		}
+
+		if (resource.Placed == nullptr ||
+			resource.PlacedOffset != graph.GetOffset(i) ||
+			resource.PlacedState != static_cast<D3D12_RESOURCE_STATES>(graph.GetInitialState(i)) ||
+			std::memcmp(&resource.PlacedDesc, &resource.Desc, sizeof(resource.Desc)) != 0 ||
+			std::memcmp(&resource.PlacedClearValue, &resource.ClearValue, sizeof(resource.ClearValue)) != 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void RenderGraphResources::UpdateLayout(const RenderGraph& graph, ResourceStates& states, DeferredReleaseQueue& releaseQueue, uint64_t fenceValue) {
+	std::vector<ComPtr<ID3D12Resource>> placed;
+
+	for (Resource& resource : m_Resources) {
+		if (resource.Placed != nullptr) {
+			states.Remove(resource.Placed.Get());
+			placed.push_back(std::move(resource.Placed));
+		}
+	}
+
+	// new heap is created while frames in flight still use old one
+	if (m_Heap != nullptr) {
+		releaseQueue.Push(fenceValue, [placed = std::move(placed), heap = std::move(m_Heap)]() mutable {
+			placed.clear();
+			heap.Reset();
+		});
+	}
+
+	m_Resources.resize(graph.GetNumResources());
+
+	m_HeapSize = graph.GetHeapSize();
+
+	if (m_HeapSize == 0) {
+		return;
+	}
+
+	CD3DX12_HEAP_DESC heapDesc(
+		m_HeapSize,
+		D3D12_HEAP_TYPE_DEFAULT,
+		(std::max)(graph.GetHeapAlignment(), static_cast<uint64_t>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)),
+		D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES
+	);
+
+	ThrowIfFailed(m_Device->CreateHeap(&heapDesc, IID_PPV_ARGS(&m_Heap)));
+
+	// transients are created in state of their first use, graph returns them to it at the end of each frame
+	for (uint32_t i = 0; i < m_Resources.size(); ++i) {
+		if (!graph.IsTransient(i) || !graph.IsUsed(i)) {
+			continue;
+		}
+
+		Resource& resource = m_Resources[i];
+
+		resource.PlacedDesc = resource.Desc;
+		resource.PlacedClearValue = resource.ClearValue;
+		resource.PlacedOffset = graph.GetOffset(i);
+		resource.PlacedState = static_cast<D3D12_RESOURCE_STATES>(graph.GetInitialState(i));
+		resource.NeedsInitialization = true;
+
+		ThrowIfFailed(m_Device->CreatePlacedResource(
+			m_Heap.Get(),
+			resource.PlacedOffset,
+			&resource.PlacedDesc,
+			resource.PlacedState,
+			resource.HasClearValue ? &resource.PlacedClearValue : nullptr,
+			IID_PPV_ARGS(&resource.Placed)
+		));
+
+		states.SetState(resource.Placed.Get(), resource.PlacedState);
+	}
+}
+
+ID3D12Resource* RenderGraphResources::GetResource(uint32_t resource) const {
+	const Resource& graphResource = m_Resources[resource];
+	return graphResource.Imported != nullptr ? graphResource.Imported : graphResource.Placed.Get();
+}
+
+uint64_t RenderGraphResources::GetHeapSize() const {
+	return m_HeapSize;
+}
+
+void RenderGraphResources::Execute(const RenderGraph& graph, ResourceStateTracker& tracker, ID3D12GraphicsCommandList* commandList) {
+	// graph issues no barrier where resource is already in state of its first use, but tracker should know its state before later transitions
+	// states of transients are known, imported ones are resolved at submission if they are not in states they are imported with
+	for (uint32_t i = 0; i < graph.GetNumResources(); ++i) {
+		if (graph.IsUsed(i)) {
+			tracker.Transition(GetResource(i), static_cast<D3D12_RESOURCE_STATES>(graph.GetInitialState(i)));
+		}
+	}
+
+	const std::vector<RenderGraph::CompiledPass>& passes = graph.GetCompiledPasses();
+
+	for (uint32_t passIndex = 0; passIndex < passes.size(); ++passIndex) {
+		const RenderGraph::CompiledPass& pass = passes[passIndex];
+		const RenderGraph::Barrier* barriers = graph.GetBarriers(pass);
+
+		IssueBarriers(barriers, pass.NumBarriers, tracker);
+		tracker.FlushBarriers(commandList);
+
+		// memory taken over from other transient is undefined too
+		for (uint32_t i = 0; i < pass.NumBarriers; ++i) {
+			if (barriers[i].Type == RenderGraph::BarrierType::Aliasing) {
+				m_Resources[barriers[i].Resource].NeedsInitialization = true;
+			}
+		}
+
+		// transient is in state of its first use, discard needs render target or depth write
+		for (uint32_t i = 0; i < graph.GetNumResources(); ++i) {
+			if (!graph.IsTransient(i) || !graph.IsUsed(i) || graph.GetFirstUse(i) != passIndex || !m_Resources[i].NeedsInitialization) {
+				continue;
+			}
+
+			D3D12_RESOURCE_STATES state = static_cast<D3D12_RESOURCE_STATES>(graph.GetInitialState(i));
+
+			if (state == D3D12_RESOURCE_STATE_RENDER_TARGET || state == D3D12_RESOURCE_STATE_DEPTH_WRITE) {
+				commandList->DiscardResource(GetResource(i), nullptr);
+			}
+
+			m_Resources[i].NeedsInitialization = false;
+		}
+
+		graph.ExecutePass(pass.Pass);
+
+		// begun split barriers are flushed together with barriers of next pass
+		IssueBarriers(graph.GetAfterBarriers(pass), pass.NumAfterBarriers, tracker);
+	}
+
+	IssueBarriers(graph.GetFinalBarriers(), graph.GetNumFinalBarriers(), tracker);
+	tracker.FlushBarriers(commandList);
+}
+
+RenderGraphResources::Resource& RenderGraphResources::GetGraphResource(uint32_t resource) {
+	if (resource >= m_Resources.size()) {
+		m_Resources.resize(resource + 1);
+	}
+
+	return m_Resources[resource];
+}
+
+void RenderGraphResources::IssueBarriers(const RenderGraph::Barrier* barriers, uint32_t numBarriers, ResourceStateTracker& tracker) const {
+	for (uint32_t i = 0; i < numBarriers; ++i) {
+		const RenderGraph::Barrier& barrier = barriers[i];
+		ID3D12Resource* resource = GetResource(barrier.Resource);
+
+		switch (barrier.Type) {
+			case RenderGraph::BarrierType::Transition:
+			case RenderGraph::BarrierType::EndTransition:
+				tracker.Transition(resource, static_cast<D3D12_RESOURCE_STATES>(barrier.StateAfter));
+				break;
+			case RenderGraph::BarrierType::BeginTransition:
+				tracker.BeginTransition(resource, static_cast<D3D12_RESOURCE_STATES>(barrier.StateAfter));
+				break;
+			case RenderGraph::BarrierType::Aliasing:
+				tracker.AliasResources(GetResource(barrier.AliasedResource), resource);
+				break;
+		}
+	}
+}
\ No newline at end of file
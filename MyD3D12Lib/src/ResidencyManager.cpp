@@ -0,0 +1,199 @@
+#include <MyD3D12Lib/ResidencyManager.h>
+
+#include <cassert>
+
+ResidencyManager::ResidencyManager(uint64_t budget) : m_Budget(budget) {}
+
+uint32_t ResidencyManager::Register(
+	ResidencyCategory category,
+	uint64_t size,
+	bool isEvictable,
+	uint64_t frame,
+	ResidencyCallback evict,
+	ResidencyCallback restore)
+{
+	assert((!isEvictable || (evict && restore)) && "Evictable resource needs evict and restore callbacks");
+
+	uint32_t id;
+
+	if (!m_FreeIds.empty()) {
+		id = m_FreeIds.back();
+		m_FreeIds.pop_back();
+	}
+	else {
+		id = static_cast<uint32_t>(m_Entries.size());
+		m_Entries.emplace_back();
+	}
+
+	Entry& entry = m_Entries[id];
+
+	entry.Category = category;
+	entry.Size = size;
+	entry.LastUsedFrame = frame;
+	entry.IsEvictable = isEvictable;
+	entry.IsResident = true;
+	entry.IsRegistered = true;
+	entry.Evict = std::move(evict);
+	entry.Restore = std::move(restore);
+
+	m_ResidentSize += size;
+	m_Sizes[static_cast<uint32_t>(category)] += size;
+
+	if (isEvictable) {
+		LinkLast(id);
+	}
+
+	return id;
+}
+
+void ResidencyManager::Unregister(uint32_t id) {
+	Entry& entry = m_Entries[id];
+
+	assert(entry.IsRegistered && "Resource is not registered");
+
+	if (entry.IsResident) {
+		m_ResidentSize -= entry.Size;
+
+		if (entry.IsEvictable) {
+			Unlink(id);
+		}
+	}
+
+	m_Sizes[static_cast<uint32_t>(entry.Category)] -= entry.Size;
+
+	entry = Entry();
+	m_FreeIds.push_back(id);
+}
+
+void ResidencyManager::Resize(uint32_t id, uint64_t size) {
+	Entry& entry = m_Entries[id];
+
+	assert(entry.IsRegistered && "Resource is not registered");
+
+	if (entry.IsResident) {
+		m_ResidentSize = m_ResidentSize - entry.Size + size;
+	}
+
+	uint64_t& categorySize = m_Sizes[static_cast<uint32_t>(entry.Category)];
+	categorySize = categorySize - entry.Size + size;
+
+	entry.Size = size;
+}
+
+void ResidencyManager::MarkUsed(uint32_t id, uint64_t frame) {
+	Entry& entry = m_Entries[id];
+
+	assert(entry.IsRegistered && "Resource is not registered");
+
+	entry.LastUsedFrame = frame;
+
+	if (!entry.IsEvictable) {
+		return;
+	}
+
+	if (!entry.IsResident) {
+		entry.Restore();
+		entry.IsResident = true;
+		m_ResidentSize += entry.Size;
+		++m_NumRestores;
+
+		LinkLast(id);
+		return;
+	}
+
+	// most recently used resource is moved to the end
+	if (m_Last != id) {
+		Unlink(id);
+		LinkLast(id);
+	}
+}
+
+uint32_t ResidencyManager::EnforceBudget(uint64_t firstUnfinishedFrame) {
+	uint32_t numEvicted = 0;
+
+	// resources are ordered by last use, so the first one used by unfinished frame stops eviction
+	while (m_ResidentSize > m_Budget && m_First != InvalidId) {
+		uint32_t id = m_First;
+		Entry& entry = m_Entries[id];
+
+		if (entry.LastUsedFrame >= firstUnfinishedFrame) {
+			break;
+		}
+
+		Unlink(id);
+
+		entry.Evict();
+		entry.IsResident = false;
+		m_ResidentSize -= entry.Size;
+
+		++m_NumEvictions;
+		++numEvicted;
+	}
+
+	return numEvicted;
+}
+
+void ResidencyManager::SetBudget(uint64_t budget) {
+	m_Budget = budget;
+}
+
+uint64_t ResidencyManager::GetBudget() const {
+	return m_Budget;
+}
+
+uint64_t ResidencyManager::GetSize(ResidencyCategory category) const {
+	return m_Sizes[static_cast<uint32_t>(category)];
+}
+
+uint64_t ResidencyManager::GetResidentSize() const {
+	return m_ResidentSize;
+}
+
+bool ResidencyManager::IsResident(uint32_t id) const {
+	return m_Entries[id].IsResident;
+}
+
+uint64_t ResidencyManager::GetNumEvictions() const {
+	return m_NumEvictions;
+}
+
+uint64_t ResidencyManager::GetNumRestores() const {
+	return m_NumRestores;
+}
+
+void ResidencyManager::LinkLast(uint32_t id) {
+	Entry& entry = m_Entries[id];
+
+	entry.Prev = m_Last;
+	entry.Next = InvalidId;
+
+	if (m_Last != InvalidId) {
+		m_Entries[m_Last].Next = id;
+	}
+	else {
+		m_First = id;
+	}
+
+	m_Last = id;
+}
+
+void ResidencyManager::Unlink(uint32_t id) {
+	Entry& entry = m_Entries[id];
+
+	if (entry.Prev != InvalidId) {
+		m_Entries[entry.Prev].Next = entry.Next;
+	}
+	else {
+		m_First = entry.Next;
+	}
+
+	if (entry.Next != InvalidId) {
+		m_Entries[entry.Next].Prev = entry.Prev;
+	}
+	else {
+		m_Last = entry.Prev;
+	}
+
+	entry.Prev = InvalidId;
+	entry.Next = InvalidId;
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include <MyD3D12Lib/ResourceHeapAllocator.h>
+#include <MyD3D12Lib/Helpers.h>
+
+#include <d3dx12.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+	const uint64_t PlacementAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+}
+
+ResourceHeapAllocator::ResourceHeapAllocator(ComPtr<ID3D12Device2> device, uint64_t heapSize) :
+	m_Device(device),
+	m_HeapSize((heapSize + D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT - 1) / D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT * D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT)
+{
+	D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+
+	if (SUCCEEDED(m_Device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)))) {
+		m_HeapTier = options.ResourceHeapTier;
+	}
+}
+
+ComPtr<ID3D12Resource> ResourceHeapAllocator::CreateResource(
+	const D3D12_RESOURCE_DESC& desc,
+	D3D12_HEAP_TYPE heapType,
+	D3D12_RESOURCE_STATES initialState,
+	const D3D12_CLEAR_VALUE* clearValue,
+	PlacedAllocation& allocation)
+{
+	allocation = PlacedAllocation();
+
+	ComPtr<ID3D12Resource> resource;
+	D3D12_RESOURCE_ALLOCATION_INFO info = m_Device->GetResourceAllocationInfo(0, 1, &desc);
+
+	uint64_t size = (info.SizeInBytes + PlacementAlignment - 1) / PlacementAlignment;
+	uint64_t alignment = (std::max)(info.Alignment, PlacementAlignment) / PlacementAlignment;
+
+	// resource which may not fit into empty heap because of alignment is committed
+	if ((size + alignment - 1) * PlacementAlignment > m_HeapSize) {
+		ThrowIfFailed(m_Device->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(heapType),
+			D3D12_HEAP_FLAG_NONE,
+			&desc,
+			initialState,
+			clearValue,
+			IID_PPV_ARGS(&resource)
+		));
+
+		return resource;
+	}
+
+	ResourceClass resourceClass = GetResourceClass(desc);
+
+	// heaps of the same kind are tried in order of creation, new heap is created if none has space
+	for (uint32_t i = 0; i < m_Heaps.size() && !allocation.IsPlaced(); ++i) {
+		Heap* heap = m_Heaps[i].get();
+
+		if (heap == nullptr || heap->Type != heapType || heap->Class != resourceClass) {
+			continue;
+		}
+
+		allocation.Allocation = heap->Allocator.Allocate(size, alignment);
+		allocation.Heap = allocation.Allocation.IsValid() ? i : UINT32_MAX;
+	}
+
+	if (!allocation.IsPlaced()) {
+		allocation.Heap = CreateHeap(heapType, resourceClass);
+		allocation.Allocation = m_Heaps[allocation.Heap]->Allocator.Allocate(size, alignment);
+	}
+
+	const Heap& heap = *m_Heaps[allocation.Heap];
+
+	ThrowIfFailed(m_Device->CreatePlacedResource(
+		heap.Resource.Get(),
+		allocation.Allocation.Offset * PlacementAlignment,
+		&desc,
+		initialState,
+		clearValue,
+		IID_PPV_ARGS(&resource)
+	));
+
+	return resource;
+}
+
+void ResourceHeapAllocator::Free(PlacedAllocation& allocation) {
+	if (!allocation.IsPlaced()) {
+		return;
+	}
+
+	Heap& heap = *m_Heaps[allocation.Heap];
+	heap.Allocator.Free(allocation.Allocation);
+
+	// empty heap is kept for next resources if there is no other heap of its kind
+	if (heap.Allocator.GetNumAllocations() == 0 && !IsLastHeapOfKind(allocation.Heap)) {
+		m_Heaps[allocation.Heap] = nullptr;
+	}
+
+	allocation = PlacedAllocation();
+}
+
+ResourceHeapsStats ResourceHeapAllocator::GetStats() const {
+	ResourceHeapsStats stats;
+
+	uint64_t freeSize = 0;
+	uint64_t largestFreeBlocksSize = 0;
+
+	for (const auto& heap : m_Heaps) {
+		if (heap == nullptr) {
+			continue;
+		}
+
+		const TLSFAllocator& allocator = heap->Allocator;
+		uint64_t largestFreeBlock = allocator.GetLargestFreeBlock() * PlacementAlignment;
+
+		++stats.NumHeaps;
+		stats.NumPlacedResources += allocator.GetNumAllocations();
+		stats.NumFreeBlocks += allocator.GetNumFreeBlocks();
+		stats.HeapsSize += allocator.GetSize() * PlacementAlignment;
+		stats.UsedSize += allocator.GetUsedSize() * PlacementAlignment;
+		stats.LargestFreeBlock = (std::max)(stats.LargestFreeBlock, largestFreeBlock);
+
+		freeSize += allocator.GetFreeSize() * PlacementAlignment;
+		largestFreeBlocksSize += largestFreeBlock;
+	}
+
+	if (freeSize > 0) {
+		stats.Fragmentation = 1.0f - static_cast<float>(static_cast<double>(largestFreeBlocksSize) / freeSize);
+	}
+
+	return stats;
+}
+
+ResourceHeapAllocator::ResourceClass ResourceHeapAllocator::GetResourceClass(const D3D12_RESOURCE_DESC& desc) const {
+	if (m_HeapTier != D3D12_RESOURCE_HEAP_TIER_1) {
+		return ResourceClass::All;
+	}
+
+	if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+		return ResourceClass::Buffers;
+	}
+
+	if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) {
+		return ResourceClass::RenderTargets;
+	}
+
+	return ResourceClass::Textures;
+}
+
+uint32_t ResourceHeapAllocator::CreateHeap(D3D12_HEAP_TYPE type, ResourceClass resourceClass) {
+	D3D12_HEAP_FLAGS flags[] = {
+		D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
+		D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+		D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+		D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES
+	};
+
+	// heap alignment allows multisampled textures too
+	CD3DX12_HEAP_DESC heapDesc(
+		m_HeapSize,
+		type,
+		D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT,
+		flags[static_cast<uint32_t>(resourceClass)]
+	);
+
+	auto heap = std::make_unique<Heap>(Heap{ nullptr, type, resourceClass, TLSFAllocator(m_HeapSize / PlacementAlignment) });
+	ThrowIfFailed(m_Device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap->Resource)));
+
+	// holes of released heaps are reused
+	auto hole = std::find(m_Heaps.begin(), m_Heaps.end(), nullptr);
+
+	if (hole != m_Heaps.end()) {
+		*hole = std::move(heap);
+		return static_cast<uint32_t>(hole - m_Heaps.begin());
+	}
+
+	m_Heaps.push_back(std::move(heap));
+	return static_cast<uint32_t>(m_Heaps.size() - 1);
+}
+
+bool ResourceHeapAllocator::IsLastHeapOfKind(uint32_t heap) const {
+	for (uint32_t i = 0; i < m_Heaps.size(); ++i) {
+		if (i != heap && m_Heaps[i] != nullptr && m_Heaps[i]->Type == m_Heaps[heap]->Type && m_Heaps[i]->Class == m_Heaps[heap]->Class) {
+			return false;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <MyD3D12Lib/ResourceStateTracker.h>
+
+#include <cassert>
+
+namespace {
+	D3D12_RESOURCE_BARRIER CreateTransition(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, D3D12_RESOURCE_BARRIER_FLAGS flags) {
+		D3D12_RESOURCE_BARRIER barrier = {};
+		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		barrier.Flags = flags;
+		barrier.Transition.pResource = resource;
+		barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+		barrier.Transition.StateBefore = before;
+		barrier.Transition.StateAfter = after;
+
+		return barrier;
+	}
+}
+
+void ResourceStates::SetState(ID3D12Resource* resource, D3D12_RESOURCE_STATES state) {
+	m_States[resource] = state;
+}
+
+void ResourceStates::Remove(ID3D12Resource* resource) {
+	m_States.erase(resource);
+}
+
+bool ResourceStates::GetState(ID3D12Resource* resource, D3D12_RESOURCE_STATES& state) const {
+	auto it = m_States.find(resource);
+
+	if (it == m_States.end()) {
+		return false;
+	}
+
+	state = it->second;
+	return true;
+}
+
+void ResourceStateTracker::Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state) {
+	auto it = m_States.find(resource);
+
+	// first use, barrier is resolved at submission
+	if (it == m_States.end()) {
+		m_PendingBarriers.push_back({ resource, state });
+		m_States[resource].State = state;
+		return;
+	}
+
+	ResourceState& resourceState = it->second;
+
+	// begin which is not flushed yet becomes whole transition, otherwise split barrier is ended
+	if (resourceState.IsSplit) {
+		if (resourceState.BarrierIndex != UINT32_MAX) {
+			m_Barriers[resourceState.BarrierIndex].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		}
+		else {
+			AddBarrier(resource, resourceState.SplitBefore, resourceState.State, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+		}
+
+		resourceState.IsSplit = false;
+	}
+
+	if (resourceState.State == state) {
+		return;
+	}
+
+	// transition which is not flushed yet is changed to end in new state, it is dropped if resource returns to its state
+	if (resourceState.BarrierIndex != UINT32_MAX) {
+		D3D12_RESOURCE_BARRIER& barrier = m_Barriers[resourceState.BarrierIndex];
+
+		if (barrier.Transition.StateBefore == state) {
+			m_RemovedBarriers[resourceState.BarrierIndex] = true;
+			resourceState.BarrierIndex = UINT32_MAX;
+		}
+		else {
+			barrier.Transition.StateAfter = state;
+		}
+
+		resourceState.State = state;
+		return;
+	}
+
+	resourceState.BarrierIndex = static_cast<uint32_t>(m_Barriers.size());
+	AddBarrier(resource, resourceState.State, state, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+	resourceState.State = state;
+}
+
+void ResourceStateTracker::BeginTransition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state) {
+	auto it = m_States.find(resource);
+
+	// state before list is not known, so whole transition is made before list
+	if (it == m_States.end()) {
+		Transition(resource, state);
+		return;
+	}
+
+	ResourceState& resourceState = it->second;
+
+	assert(!resourceState.IsSplit && "Transition is already begun");
+
+	if (resourceState.State == state) {
+		return;
+	}
+
+	// transition which is not flushed yet is made whole, there is nothing to overlap with
+	if (resourceState.BarrierIndex != UINT32_MAX) {
+		Transition(resource, state);
+		return;
+	}
+
+	resourceState.BarrierIndex = static_cast<uint32_t>(m_Barriers.size());
+	AddBarrier(resource, resourceState.State, state, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+
+	resourceState.SplitBefore = resourceState.State;
+	resourceState.State = state;
+	resourceState.IsSplit = true;
+}
+
+void ResourceStateTracker::AliasResources(ID3D12Resource* before, ID3D12Resource* after) {
+	D3D12_RESOURCE_BARRIER barrier = {};
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+	barrier.Aliasing.pResourceBefore = before;
+	barrier.Aliasing.pResourceAfter = after;
+
+	m_Barriers.push_back(barrier);
+	m_RemovedBarriers.push_back(false);
+}
+
+void ResourceStateTracker::FlushBarriers(ID3D12GraphicsCommandList* commandList) {
+	uint32_t numBarriers = 0;
+
+	for (uint32_t i = 0; i < m_Barriers.size(); ++i) {
+		if (m_Barriers[i].Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION) {
+			m_States[m_Barriers[i].Transition.pResource].BarrierIndex = UINT32_MAX;
+		}
+
+		if (!m_RemovedBarriers[i]) {
+			m_Barriers[numBarriers++] = m_Barriers[i];
+		}
+	}
+
+	if (numBarriers > 0) {
+		commandList->ResourceBarrier(numBarriers, m_Barriers.data());
+
+		m_NumBarriers += numBarriers;
+		++m_NumBarrierCalls;
+	}
+
+	m_Barriers.clear();
+	m_RemovedBarriers.clear();
+}
+
+uint32_t ResourceStateTracker::ResolvePendingBarriers(const ResourceStates& states, std::vector<D3D12_RESOURCE_BARRIER>& barriers) const {
+	uint32_t numBarriers = 0;
+
+	for (const PendingBarrier& pending : m_PendingBarriers) {
+		D3D12_RESOURCE_STATES state;
+
+		if (!states.GetState(pending.Resource, state)) {
+			assert(false && "Resource state is not known");
+			continue;
+		}
+
+		if (state == pending.State) {
+			continue;
+		}
+
+		barriers.push_back(CreateTransition(pending.Resource, state, pending.State, D3D12_RESOURCE_BARRIER_FLAG_NONE));
+		++numBarriers;
+	}
+
+	return numBarriers;
+}
+
+void ResourceStateTracker::CommitFinalStates(ResourceStates& states) const {
+	assert(m_Barriers.empty() && "Barriers should be flushed before submission");
+
+	for (const auto& it : m_States) {
+		assert(!it.second.IsSplit && "Split barrier should be ended in the same list");
+		states.SetState(it.first, it.second.State);
+	}
+}
+
+void ResourceStateTracker::Reset() {
+	assert(m_Barriers.empty() && "Barriers should be flushed before reset");
+
+	m_States.clear();
+	m_PendingBarriers.clear();
+
+	m_NumBarriers = 0;
+	m_NumBarrierCalls = 0;
+}
+
+uint32_t ResourceStateTracker::GetNumBarriers() const {
+	return m_NumBarriers;
+}
+
+uint32_t ResourceStateTracker::GetNumBarrierCalls() const {
+	return m_NumBarrierCalls;
+}
+
+void ResourceStateTracker::AddBarrier(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, D3D12_RESOURCE_BARRIER_FLAGS flags) {
+	m_Barriers.push_back(CreateTransition(resource, before, after, flags));
+	m_RemovedBarriers.push_back(false);
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <MyD3D12Lib/SkylinePacker.h>
+
+#include <algorithm>
+
+SkylinePacker::SkylinePacker(uint32_t width, uint32_t height) :
+	m_Width(width),
+	m_Height(height)
+{
+	Reset();
+}
+
+bool SkylinePacker::Insert(uint32_t width, uint32_t height, PackedRect& rect) {
+	if (width == 0 || height == 0 || width > m_Width || height > m_Height) {
+		return false;
+	}
+
+	size_t bestIndex = m_Skyline.size();
+	uint32_t bestTop = UINT32_MAX;
+	uint64_t bestWastedArea = UINT64_MAX;
+	uint32_t bestY = 0;
+
+	for (size_t i = 0; i < m_Skyline.size(); ++i) {
+		uint32_t y;
+		uint64_t wastedArea;
+
+		if (!Fit(i, width, height, y, wastedArea)) {
+			continue;
+		}
+
+		uint32_t top = y + height;
+
+		if (top < bestTop || (top == bestTop && wastedArea < bestWastedArea)) {
+			bestIndex = i;
+			bestTop = top;
+			bestWastedArea = wastedArea;
+			bestY = y;
+		}
+	}
+
+	if (bestIndex == m_Skyline.size()) {
+		return false;
+	}
+
+	rect.X = m_Skyline[bestIndex].X;
+	rect.Y = bestY;
+	rect.Width = width;
+	rect.Height = height;
+
+	AddNode(bestIndex, rect.X, bestTop, width);
+
+	m_UsedHeight = (std::max)(m_UsedHeight, bestTop);
+	m_UsedArea += static_cast<uint64_t>(width) * height;
+
+	return true;
+}
+
+void SkylinePacker::Reset() {
+	m_Skyline.clear();
+	m_Skyline.push_back({ 0, 0, m_Width });
+
+	m_UsedHeight = 0;
+	m_UsedArea = 0;
+}
+
+uint32_t SkylinePacker::GetWidth() const {
+	return m_Width;
+}
+
+uint32_t SkylinePacker::GetHeight() const {
+	return m_Height;
+}
+
+uint32_t SkylinePacker::GetUsedHeight() const {
+	return m_UsedHeight;
+}
+
+uint64_t SkylinePacker::GetUsedArea() const {
+	return m_UsedArea;
+}
+
+float SkylinePacker::GetOccupancy() const {
+	return static_cast<float>(static_cast<double>(m_UsedArea) / (static_cast<double>(m_Width) * m_Height));
+}
+
+bool SkylinePacker::Fit(size_t nodeIndex, uint32_t width, uint32_t height, uint32_t& y, uint64_t& wastedArea) const {
+	uint32_t x = m_Skyline[nodeIndex].X;
+
+	if (x + width > m_Width) {
+		return false;
+	}
+
+	// rectangle lies on the highest node under it
+	y = 0;
+
+	uint32_t widthLeft = width;
+
+	for (size_t i = nodeIndex; widthLeft > 0; ++i) {
+		y = (std::max)(y, m_Skyline[i].Y);
+
+		if (y + height > m_Height) {
+			return false;
+		}
+
+		widthLeft -= (std::min)(widthLeft, m_Skyline[i].Width);
+	}
+
+	wastedArea = 0;
+	widthLeft = width;
+
+	for (size_t i = nodeIndex; widthLeft > 0; ++i) {
+		uint32_t coveredWidth = (std::min)(widthLeft, m_Skyline[i].Width);
+
+		wastedArea += static_cast<uint64_t>(y - m_Skyline[i].Y) * coveredWidth;
+		widthLeft -= coveredWidth;
+	}
+
+	return true;
+}
+
+void SkylinePacker::AddNode(size_t nodeIndex, uint32_t x, uint32_t y, uint32_t width) {
+	m_Skyline.insert(m_Skyline.begin() + nodeIndex, { x, y, width });
+
+	// nodes under new one are shrunk or removed
+	uint32_t right = x + width;
+
+	for (size_t i = nodeIndex + 1; i < m_Skyline.size();) {
+		SkylineNode& node = m_Skyline[i];
+
+		if (node.X >= right) {
+			break;
+		}
+
+		uint32_t nodeRight = node.X + node.Width;
+
+		if (nodeRight <= right) {
+			m_Skyline.erase(m_Skyline.begin() + i);
+			continue;
+		}
+
+		node.Width = nodeRight - right;
+		node.X = right;
+		break;
+	}
+
+	// neighbours with same height are merged
+	for (size_t i = 0; i + 1 < m_Skyline.size();) {
+		if (m_Skyline[i].Y == m_Skyline[i + 1].Y) {
+			m_Skyline[i].Width += m_Skyline[i + 1].Width;
+			m_Skyline.erase(m_Skyline.begin() + i + 1);
+		}
+		else {
+			++i;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,334 @@
+#include <MyD3D12Lib/TLSFAllocator.h>
+
+#include <cassert>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+	// index of the highest set bit, value is not zero
+	uint32_t FindLastSet(uint64_t value) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return index;
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+
+	// index of the lowest set bit, value is not zero
+	uint32_t FindFirstSet(uint64_t value) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return index;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+}
+
+TLSFAllocator::TLSFAllocator(uint64_t size) :
+	m_Size(size)
+{
+	for (auto& lists : m_FreeLists) {
+		for (uint32_t& list : lists) {
+			list = InvalidBlock;
+		}
+	}
+
+	if (m_Size > 0) {
+		uint32_t block = CreateBlock();
+		m_Blocks[block].Size = m_Size;
+		m_Blocks[block].IsFree = true;
+
+		InsertFreeBlock(block);
+	}
+}
+
+TLSFAllocation TLSFAllocator::Allocate(uint64_t size, uint64_t alignment) {
+	assert(size > 0 && "Allocation should not be empty");
+	assert((alignment & (alignment - 1)) == 0 && "Alignment should be power of two");
+
+	alignment = alignment > 0 ? alignment : 1;
+
+	// any block of padded size fits aligned allocation
+	uint64_t paddedSize = size + alignment - 1;
+
+	if (paddedSize < size) {
+		return TLSFAllocation();
+	}
+
+	uint32_t block = FindFreeBlock(paddedSize);
+
+	if (block == InvalidBlock) {
+		return TLSFAllocation();
+	}
+
+	RemoveFreeBlock(block);
+
+	// space before aligned offset stays free
+	uint64_t offset = m_Blocks[block].Offset;
+	uint64_t padding = (offset + alignment - 1) / alignment * alignment - offset;
+
+	if (padding > 0) {
+		uint32_t alignedBlock = CreateBlock();
+		SplitBlock(block, alignedBlock, m_Blocks[block].Size - padding);
+		InsertFreeBlock(block);
+
+		block = alignedBlock;
+	}
+
+	if (m_Blocks[block].Size > size) {
+		uint32_t rest = CreateBlock();
+		SplitBlock(block, rest, m_Blocks[block].Size - size);
+		InsertFreeBlock(rest);
+	}
+
+	m_Blocks[block].IsFree = false;
+
+	m_UsedSize += size;
+	++m_NumAllocations;
+
+	TLSFAllocation allocation;
+	allocation.Offset = m_Blocks[block].Offset;
+	allocation.Size = size;
+	allocation.Block = block;
+
+	return allocation;
+}
+
+void TLSFAllocator::Free(const TLSFAllocation& allocation) {
+	assert(allocation.IsValid() && allocation.Block < m_Blocks.size() && "Invalid allocation");
+
+	uint32_t block = allocation.Block;
+
+	assert(!m_Blocks[block].IsFree && m_Blocks[block].Offset == allocation.Offset && "Allocation is already freed");
+
+	m_UsedSize -= m_Blocks[block].Size;
+	--m_NumAllocations;
+
+	m_Blocks[block].IsFree = true;
+
+	// free neighbours are merged, so two free blocks are never adjacent
+	uint32_t prev = m_Blocks[block].PrevPhysical;
+
+	if (prev != InvalidBlock && m_Blocks[prev].IsFree) {
+		RemoveFreeBlock(prev);
+		MergeBlocks(prev, block);
+		block = prev;
+	}
+
+	uint32_t next = m_Blocks[block].NextPhysical;
+
+	if (next != InvalidBlock && m_Blocks[next].IsFree) {
+		RemoveFreeBlock(next);
+		MergeBlocks(block, next);
+	}
+
+	InsertFreeBlock(block);
+}
+
+uint64_t TLSFAllocator::GetSize() const {
+	return m_Size;
+}
+
+uint64_t TLSFAllocator::GetUsedSize() const {
+	return m_UsedSize;
+}
+
+uint64_t TLSFAllocator::GetFreeSize() const {
+	return m_Size - m_UsedSize;
+}
+
+uint32_t TLSFAllocator::GetNumAllocations() const {
+	return m_NumAllocations;
+}
+
+uint32_t TLSFAllocator::GetNumFreeBlocks() const {
+	return m_NumFreeBlocks;
+}
+
+uint64_t TLSFAllocator::GetLargestFreeBlock() const {
+	if (m_FirstLevelBitmap == 0) {
+		return 0;
+	}
+
+	uint32_t firstLevel = FindLastSet(m_FirstLevelBitmap);
+	uint32_t secondLevel = FindLastSet(m_SecondLevelBitmaps[firstLevel]);
+
+	uint64_t largest = 0;
+
+	for (uint32_t block = m_FreeLists[firstLevel][secondLevel]; block != InvalidBlock; block = m_Blocks[block].NextFree) {
+		largest = m_Blocks[block].Size > largest ? m_Blocks[block].Size : largest;
+	}
+
+	return largest;
+}
+
+float TLSFAllocator::GetFragmentation() const {
+	uint64_t freeSize = GetFreeSize();
+
+	if (freeSize == 0) {
+		return 0.0f;
+	}
+
+	return 1.0f - static_cast<float>(static_cast<double>(GetLargestFreeBlock()) / freeSize);
+}
+
+void TLSFAllocator::GetClass(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel) {
+	// small sizes have classes of their own
+	if (size < SecondLevelCount) {
+		firstLevel = 0;
+		secondLevel = static_cast<uint32_t>(size);
+		return;
+	}
+
+	uint32_t lastSet = FindLastSet(size);
+
+	firstLevel = lastSet - SecondLevelBits + 1;
+	secondLevel = static_cast<uint32_t>(size >> (lastSet - SecondLevelBits)) ^ SecondLevelCount;
+}
+
+uint32_t TLSFAllocator::FindFreeBlock(uint64_t size) const {
+	// size is rounded up to next class, so any block of found class fits
+	uint64_t roundedSize = size;
+
+	if (size >= SecondLevelCount) {
+		roundedSize = size + (1ull << (FindLastSet(size) - SecondLevelBits)) - 1;
+	}
+
+	uint32_t firstLevel;
+	uint32_t secondLevel;
+
+	if (roundedSize >= size) {
+		GetClass(roundedSize, firstLevel, secondLevel);
+
+		uint32_t secondLevelMap = m_SecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+		uint64_t firstLevelMap = firstLevel + 1 < 64 ? m_FirstLevelBitmap & (~0ull << (firstLevel + 1)) : 0;
+
+		if (secondLevelMap != 0) {
+			return m_FreeLists[firstLevel][FindFirstSet(secondLevelMap)];
+		}
+
+		if (firstLevelMap != 0) {
+			firstLevel = FindFirstSet(firstLevelMap);
+			return m_FreeLists[firstLevel][FindFirstSet(m_SecondLevelBitmaps[firstLevel])];
+		}
+	}
+
+	// blocks of size class can still fit, e.g. when whole free space is requested
+	GetClass(size, firstLevel, secondLevel);
+
+	for (uint32_t block = m_FreeLists[firstLevel][secondLevel]; block != InvalidBlock; block = m_Blocks[block].NextFree) {
+		if (m_Blocks[block].Size >= size) {
+			return block;
+		}
+	}
+
+	return InvalidBlock;
+}
+
+void TLSFAllocator::InsertFreeBlock(uint32_t block) {
+	uint32_t firstLevel;
+	uint32_t secondLevel;
+	GetClass(m_Blocks[block].Size, firstLevel, secondLevel);
+
+	uint32_t& head = m_FreeLists[firstLevel][secondLevel];
+
+	m_Blocks[block].PrevFree = InvalidBlock;
+	m_Blocks[block].NextFree = head;
+
+	if (head != InvalidBlock) {
+		m_Blocks[head].PrevFree = block;
+	}
+
+	head = block;
+
+	m_FirstLevelBitmap |= 1ull << firstLevel;
+	m_SecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+
+	++m_NumFreeBlocks;
+}
+
+void TLSFAllocator::RemoveFreeBlock(uint32_t block) {
+	uint32_t firstLevel;
+	uint32_t secondLevel;
+	GetClass(m_Blocks[block].Size, firstLevel, secondLevel);
+
+	Block& removed = m_Blocks[block];
+
+	if (removed.PrevFree != InvalidBlock) {
+		m_Blocks[removed.PrevFree].NextFree = removed.NextFree;
+	}
+	else {
+		m_FreeLists[firstLevel][secondLevel] = removed.NextFree;
+	}
+
+	if (removed.NextFree != InvalidBlock) {
+		m_Blocks[removed.NextFree].PrevFree = removed.PrevFree;
+	}
+
+	removed.PrevFree = InvalidBlock;
+	removed.NextFree = InvalidBlock;
+
+	if (m_FreeLists[firstLevel][secondLevel] == InvalidBlock) {
+		m_SecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+
+		if (m_SecondLevelBitmaps[firstLevel] == 0) {
+			m_FirstLevelBitmap &= ~(1ull << firstLevel);
+		}
+	}
+
+	--m_NumFreeBlocks;
+}
+
+void TLSFAllocator::SplitBlock(uint32_t block, uint32_t tail, uint64_t size) {
+	Block& tailBlock = m_Blocks[tail];
+	Block& splitBlock = m_Blocks[block];
+
+	tailBlock.Size = size;
+	tailBlock.Offset = splitBlock.Offset + splitBlock.Size - size;
+	tailBlock.IsFree = true;
+	tailBlock.PrevPhysical = block;
+	tailBlock.NextPhysical = splitBlock.NextPhysical;
+
+	if (splitBlock.NextPhysical != InvalidBlock) {
+		m_Blocks[splitBlock.NextPhysical].PrevPhysical = tail;
+	}
+
+	splitBlock.Size -= size;
+	splitBlock.NextPhysical = tail;
+}
+
+void TLSFAllocator::MergeBlocks(uint32_t block, uint32_t next) {
+	Block& mergedBlock = m_Blocks[block];
+	const Block& nextBlock = m_Blocks[next];
+
+	mergedBlock.Size += nextBlock.Size;
+	mergedBlock.NextPhysical = nextBlock.NextPhysical;
+
+	if (nextBlock.NextPhysical != InvalidBlock) {
+		m_Blocks[nextBlock.NextPhysical].PrevPhysical = block;
+	}
+
+	DestroyBlock(next);
+}
+
+uint32_t TLSFAllocator::CreateBlock() {
+	if (!m_UnusedBlocks.empty()) {
+		uint32_t block = m_UnusedBlocks.back();
+		m_UnusedBlocks.pop_back();
+		return block;
+	}
+
+	m_Blocks.emplace_back();
+	return static_cast<uint32_t>(m_Blocks.size() - 1);
+}
+
+void TLSFAllocator::DestroyBlock(uint32_t block) {
+	m_Blocks[block] = Block();
+	m_UnusedBlocks.push_back(block);
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include <MyD3D12Lib/TexturePacker.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+namespace {
+	uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	uint32_t GetNumMips(uint32_t size) {
+		uint32_t numMips = 1;
+
+		while (size > 1) {
+			size >>= 1;
+			++numMips;
+		}
+
+		return numMips;
+	}
+
+	void SetUVTransform(const TextureGroup& group, TexturePlacement& placement) {
+		placement.UVScale[0] = static_cast<float>(placement.Rect.Width) / group.Width;
+		placement.UVScale[1] = static_cast<float>(placement.Rect.Height) / group.Height;
+		placement.UVOffset[0] = static_cast<float>(placement.Rect.X) / group.Width;
+		placement.UVOffset[1] = static_cast<float>(placement.Rect.Y) / group.Height;
+	}
+
+	// packs items of one format into pages of atlas, returns false if some item doesn`t fit into empty page
+	bool PackAtlas(
+		const std::vector<TexturePackingItem>& items,
+		const std::vector<uint32_t>& itemsIds,
+		const TexturePackingDesc& desc,
+		TexturePackingPlan& plan)
+	{
+		const TexturePackingItem& first = items[itemsIds[0]];
+
+		TextureGroup group;
+		group.Type = TextureGroupType::Atlas;
+		group.Format = first.Format;
+		group.BlockSize = first.BlockSize;
+		group.MipLevels = (std::min)(desc.AtlasMipLevels, GetNumMips(desc.AtlasSize));
+		group.Gutter = first.BlockSize << (group.MipLevels - 1);
+
+		// the highest items are packed first
+		std::vector<uint32_t> order = itemsIds;
+
+		std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			return std::make_tuple(items[b].Height, items[b].Width, a) < std::make_tuple(items[a].Height, items[a].Width, b);
+		});
+
+		std::vector<SkylinePacker> pages;
+		std::vector<TexturePlacement> placements(order.size());
+		uint32_t usedWidth = 0;
+		uint32_t usedHeight = 0;
+
+		for (uint32_t i = 0; i < order.size(); ++i) {
+			const TexturePackingItem& item = items[order[i]];
+			uint32_t paddedWidth = item.Width + 2 * group.Gutter;
+			uint32_t paddedHeight = item.Height + 2 * group.Gutter;
+
+			PackedRect rect;
+			uint32_t page = 0;
+
+			while (page < pages.size() && !pages[page].Insert(paddedWidth, paddedHeight, rect)) {
+				++page;
+			}
+
+			if (page == pages.size()) {
+				pages.emplace_back(desc.AtlasSize, desc.AtlasSize);
+
+				if (!pages.back().Insert(paddedWidth, paddedHeight, rect)) {
+					return false;
+				}
+			}
+
+			usedWidth = (std::max)(usedWidth, rect.X + rect.Width);
+			usedHeight = (std::max)(usedHeight, rect.Y + rect.Height);
+
+			TexturePlacement& placement = placements[i];
+			placement.ArrayIndex = page;
+			placement.Rect = { rect.X + group.Gutter, rect.Y + group.Gutter, item.Width, item.Height };
+		}
+
+		// pages are cropped to what is used, sizes stay multiple of gutter so item mips start at whole blocks
+		group.Width = AlignUp(usedWidth, group.Gutter);
+		group.Height = AlignUp(usedHeight, group.Gutter);
+		group.ArraySize = static_cast<uint32_t>(pages.size());
+
+		uint32_t groupIndex = static_cast<uint32_t>(plan.Groups.size());
+
+		for (uint32_t i = 0; i < order.size(); ++i) {
+			placements[i].Group = groupIndex;
+			SetUVTransform(group, placements[i]);
+			plan.Placements[order[i]] = placements[i];
+		}
+
+		plan.Groups.push_back(group);
+
+		return true;
+	}
+}
+
+TexturePackingPlan PlanTexturePacking(const std::vector<TexturePackingItem>& items, const TexturePackingDesc& desc) {
+	TexturePackingPlan plan;
+	plan.Placements.resize(items.size());
+
+	// atlas candidates are grouped by format, array items by format, size and mips
+	std::map<std::pair<uint32_t, uint32_t>, std::vector<uint32_t>> atlasesItems;
+	std::map<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>, std::vector<uint32_t>> arraysItems;
+
+	for (uint32_t i = 0; i < items.size(); ++i) {
+		const TexturePackingItem& item = items[i];
+
+		assert(item.Width > 0 && item.Height > 0 && item.BlockSize > 0 && "Texture should not be empty");
+
+		plan.ItemsArea += static_cast<uint64_t>(item.Width) * item.Height;
+
+		uint32_t atlasMipLevels = (std::min)(desc.AtlasMipLevels, GetNumMips(desc.AtlasSize));
+		uint32_t alignment = item.BlockSize << (atlasMipLevels - 1);
+
+		bool isAtlasItem =
+			item.Width <= desc.MaxAtlasItemSize && item.Height <= desc.MaxAtlasItemSize &&
+			item.Width % alignment == 0 && item.Height % alignment == 0 &&
+			item.MipLevels >= atlasMipLevels;
+
+		if (isAtlasItem) {
+			atlasesItems[{ item.Format, item.BlockSize }].push_back(i);
+		}
+		else {
+			arraysItems[{ item.Format, item.Width, item.Height, item.MipLevels, item.BlockSize }].push_back(i);
+		}
+	}
+
+	for (auto& [key, itemsIds] : atlasesItems) {
+		// atlas with one item only loses mips
+		if (itemsIds.size() < 2 || !PackAtlas(items, itemsIds, desc, plan)) {
+			for (uint32_t id : itemsIds) {
+				const TexturePackingItem& item = items[id];
+				arraysItems[{ item.Format, item.Width, item.Height, item.MipLevels, item.BlockSize }].push_back(id);
+			}
+		}
+	}
+
+	for (auto& [key, itemsIds] : arraysItems) {
+		// items keep their order in array
+		std::sort(itemsIds.begin(), itemsIds.end());
+
+		for (uint32_t start = 0; start < itemsIds.size(); start += desc.MaxArraySize) {
+			const TexturePackingItem& first = items[itemsIds[start]];
+
+			TextureGroup group;
+			group.Type = TextureGroupType::Array;
+			group.Width = first.Width;
+			group.Height = first.Height;
+			group.Format = first.Format;
+			group.MipLevels = first.MipLevels;
+			group.BlockSize = first.BlockSize;
+			group.ArraySize = (std::min)(desc.MaxArraySize, static_cast<uint32_t>(itemsIds.size()) - start);
+
+			uint32_t groupIndex = static_cast<uint32_t>(plan.Groups.size());
+
+			for (uint32_t i = 0; i < group.ArraySize; ++i) {
+				TexturePlacement& placement = plan.Placements[itemsIds[start + i]];
+				placement.Group = groupIndex;
+				placement.ArrayIndex = i;
+				placement.Rect = { 0, 0, first.Width, first.Height };
+				SetUVTransform(group, placement);
+			}
+
+			plan.Groups.push_back(group);
+		}
+	}
+
+	for (const TextureGroup& group : plan.Groups) {
+		plan.GroupsArea += static_cast<uint64_t>(group.Width) * group.Height * group.ArraySize;
+	}
+
+	return plan;
+}
+
+void CopyTextureToAtlasMip(
+	const TextureGroup& group,
+	const TexturePlacement& placement,
+	uint32_t mip,
+	const uint8_t* srcData,
+	size_t srcRowPitch,
+	uint8_t* dstData,
+	size_t dstRowPitch,
+	uint32_t elementSize)
+{
+	assert(mip < group.MipLevels && "Atlas doesn`t have such mip");
+
+	// positions and gutter are multiples of block at each atlas mip
+	uint32_t x = (placement.Rect.X >> mip) / group.BlockSize;
+	uint32_t y = (placement.Rect.Y >> mip) / group.BlockSize;
+	uint32_t width = (placement.Rect.Width >> mip) / group.BlockSize;
+	uint32_t height = (placement.Rect.Height >> mip) / group.BlockSize;
+	uint32_t gutter = (group.Gutter >> mip) / group.BlockSize;
+
+	for (uint32_t row = 0; row < height + 2 * gutter; ++row) {
+		uint32_t srcRow = (std::min)((std::max)(row, gutter) - gutter, height - 1);
+
+		const uint8_t* src = srcData + srcRow * srcRowPitch;
+		uint8_t* dst = dstData + (y - gutter + row) * dstRowPitch + static_cast<size_t>(x - gutter) * elementSize;
+
+		for (uint32_t i = 0; i < gutter; ++i) {
+			std::memcpy(dst + static_cast<size_t>(i) * elementSize, src, elementSize);
+		}
+
+		std::memcpy(dst + static_cast<size_t>(gutter) * elementSize, src, static_cast<size_t>(width) * elementSize);
+
+		for (uint32_t i = 0; i < gutter; ++i) {
+			std::memcpy(
+				dst + static_cast<size_t>(gutter + width + i) * elementSize,
+				src + static_cast<size_t>(width - 1) * elementSize,
+				elementSize
+			);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include <MyD3D12Lib/TextureRegistry.h>
+
+std::string TextureRegistry::Register(const std::string& name, const TextureContentKey& key, uint64_t byteSize) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	// same name registered again, e.g. by scene loaded before
+	auto nameIt = m_Names.find(name);
+
+	if (nameIt != m_Names.end()) {
+		return nameIt->second;
+	}
+
+	auto [contentIt, isNew] = m_Contents.emplace(key, name);
+	m_Names.emplace(name, contentIt->second);
+
+	if (!isNew) {
+		++m_NumAliases;
+		m_SavedBytes += byteSize;
+	}
+
+	return contentIt->second;
+}
+
+std::string TextureRegistry::Resolve(const std::string& name) const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	auto it = m_Names.find(name);
+
+	return it != m_Names.end() ? it->second : name;
+}
+
+uint32_t TextureRegistry::GetNumContents() const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return static_cast<uint32_t>(m_Contents.size());
+}
+
+uint32_t TextureRegistry::GetNumAliases() const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_NumAliases;
+}
+
+uint64_t TextureRegistry::GetSavedBytes() const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_SavedBytes;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <MyD3D12Lib/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+ThreadPool::ThreadPool(uint32_t numThreads, std::function<void()> onThreadStart, std::function<void()> onThreadExit) :
+	m_OnThreadStart(std::move(onThreadStart)),
+	m_OnThreadExit(std::move(onThreadExit))
+{
+	// leave one core for main thread by default, number of hardware threads is 0 if it isn`t known
+	if (numThreads == 0) {
+		uint32_t numHardwareThreads = std::thread::hardware_concurrency();
+		numThreads = numHardwareThreads > 1 ? numHardwareThreads - 1 : 1;
+	}
+
+	m_Threads.reserve(numThreads);
+
+	for (uint32_t i = 0; i < numThreads; ++i) {
+		m_Threads.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsStopping = true;
+	}
+
+	m_HasTasks.notify_all();
+
+	for (auto& thread : m_Threads) {
+		thread.join();
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Tasks.push(std::move(task));
+	}
+
+	m_HasTasks.notify_one();
+}
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& body) {
+	if (count == 0) {
+		return;
+	}
+
+	// state is shared with helpers, they can start after calling thread has returned
+	struct State {
+		std::atomic<uint32_t> NextIndex{ 0 };
+		uint32_t NumDone = 0;
+		std::exception_ptr Error;
+		std::mutex Mutex;
+		std::condition_variable IsDone;
+	};
+
+	auto state = std::make_shared<State>();
+	const auto* bodyPtr = &body;
+
+	// body is accessed only after index is taken, so calling thread is still waiting
+	auto run = [state, count, bodyPtr]() {
+		while (true) {
+			uint32_t index = state->NextIndex.fetch_add(1);
+
+			if (index >= count) {
+				break;
+			}
+
+			std::exception_ptr error;
+
+			try {
+				(*bodyPtr)(index);
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(state->Mutex);
+
+			if (error && !state->Error) {
+				state->Error = error;
+			}
+
+			if (++state->NumDone == count) {
+				state->IsDone.notify_all();
+			}
+		}
+	};
+
+	uint32_t numHelpers = std::min(count - 1, GetNumThreads());
+
+	for (uint32_t i = 0; i < numHelpers; ++i) {
+		Submit(run);
+	}
+
+	run();
+
+	std::unique_lock<std::mutex> lock(state->Mutex);
+	state->IsDone.wait(lock, [&]() { return state->NumDone == count; });
+
+	if (state->Error) {
+		std::rethrow_exception(state->Error);
+	}
+}
+
+uint32_t ThreadPool::GetNumThreads() const {
+	return static_cast<uint32_t>(m_Threads.size());
+}
+
+void ThreadPool::WorkerLoop() {
+	if (m_OnThreadStart) {
+		m_OnThreadStart();
+	}
+
+	while (true) {
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_HasTasks.wait(lock, [this]() { return m_IsStopping || !m_Tasks.empty(); });
+
+			// remaining tasks are finished before stopping
+			if (m_Tasks.empty()) {
+				break;
+			}
+
+			task = std::move(m_Tasks.front());
+			m_Tasks.pop();
+		}
+
+		task();
+	}
+
+	if (m_OnThreadExit) {
+		m_OnThreadExit();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include <MyD3D12Lib/UploadAllocator.h>
+#include <MyD3D12Lib/Helpers.h>
+
+#include <d3dx12.h>
+
+UploadAllocator::UploadAllocator(ComPtr<ID3D12Device2> device, uint64_t pageSize) :
+	m_Device(device),
+	m_Allocator(pageSize)
+{}
+
+UploadAllocator::~UploadAllocator() {
+	for (Page& page : m_Pages) {
+		page.Resource->Unmap(0, NULL);
+	}
+}
+
+UploadAllocation UploadAllocator::Allocate(uint64_t size, uint64_t alignment) {
+	LinearAllocation allocation = m_Allocator.Allocate(size, alignment);
+
+	if (allocation.Page == m_Pages.size()) {
+		Page page;
+
+		ThrowIfFailed(m_Device->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(m_Allocator.GetPageSize()),
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			NULL,
+			IID_PPV_ARGS(&page.Resource)
+		));
+
+		// upload heap may stay mapped, CPU only writes it
+		CD3DX12_RANGE readRange(0, 0);
+		ThrowIfFailed(page.Resource->Map(0, &readRange, reinterpret_cast<void**>(&page.MappedData)));
+		page.GPUAddress = page.Resource->GetGPUVirtualAddress();
+
+		m_Pages.push_back(std::move(page));
+	}
+
+	const Page& page = m_Pages[allocation.Page];
+
+	UploadAllocation uploadAllocation;
+	uploadAllocation.CPUAddress = page.MappedData + allocation.Offset;
+	uploadAllocation.GPUAddress = page.GPUAddress + allocation.Offset;
+
+	return uploadAllocation;
+}
+
+void UploadAllocator::Retire(uint64_t fenceValue) {
+	m_Allocator.Retire(fenceValue);
+}
+
+void UploadAllocator::ReleaseCompleted(uint64_t completedFenceValue) {
+	m_Allocator.ReleaseCompleted(completedFenceValue);
+}
+
+const LinearAllocator& UploadAllocator::GetLinearAllocator() const {
+	return m_Allocator;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include <MyD3D12Lib/UploadBatcher.h>
+
+#include <cassert>
+
+UploadBatcher::UploadBatcher(uint64_t maxBatchSize, uint32_t maxBatchUploads) :
+	m_MaxBatchSize(maxBatchSize),
+	m_MaxBatchUploads(maxBatchUploads)
+{
+	assert(maxBatchUploads > 0 && "Batch should fit at least one upload");
+}
+
+bool UploadBatcher::IsFull(uint64_t size) const {
+	if (m_OpenBatchUploads == 0) {
+		return false;
+	}
+
+	return m_OpenBatchUploads >= m_MaxBatchUploads || m_OpenBatchSize + size > m_MaxBatchSize;
+}
+
+uint64_t UploadBatcher::Add(uint64_t size) {
+	m_OpenBatchSize += size;
+	++m_OpenBatchUploads;
+	++m_NumUploads;
+
+	return m_OpenBatch;
+}
+
+bool UploadBatcher::HasOpenUploads() const {
+	return m_OpenBatchUploads > 0;
+}
+
+uint64_t UploadBatcher::GetOpenBatch() const {
+	return m_OpenBatch;
+}
+
+void UploadBatcher::Submit(uint64_t fenceValue) {
+	assert(m_OpenBatchUploads > 0 && "Empty batch should not be submitted");
+	assert((m_FenceValues.empty() || m_FenceValues.back() < fenceValue) && "Fence values should increase");
+
+	if (m_FenceValues.empty()) {
+		m_FirstBatch = m_OpenBatch;
+	}
+
+	m_FenceValues.push_back(fenceValue);
+
+	++m_OpenBatch;
+	m_OpenBatchSize = 0;
+	m_OpenBatchUploads = 0;
+}
+
+uint64_t UploadBatcher::GetFenceValue(uint64_t batch) const {
+	assert(batch < m_OpenBatch && "Batch is not submitted");
+
+	if (m_FenceValues.empty() || batch < m_FirstBatch) {
+		return 0;
+	}
+
+	return m_FenceValues[batch - m_FirstBatch];
+}
+
+uint64_t UploadBatcher::RequireBatch(uint64_t batch, uint64_t completedFenceValue) {
+	uint64_t fenceValue = GetFenceValue(batch);
+
+	// consumer waiting for later batch waits for this one too
+	if (fenceValue <= completedFenceValue || fenceValue <= m_ConsumerFenceValue) {
+		return 0;
+	}
+
+	m_ConsumerFenceValue = fenceValue;
+	++m_NumConsumerWaits;
+
+	return fenceValue;
+}
+
+void UploadBatcher::ReleaseCompleted(uint64_t completedFenceValue) {
+	while (!m_FenceValues.empty() && m_FenceValues.front() <= completedFenceValue) {
+		m_FenceValues.pop_front();
+		++m_FirstBatch;
+	}
+}
+
+uint64_t UploadBatcher::GetNumSubmittedBatches() const {
+	return m_OpenBatch;
+}
+
+uint64_t UploadBatcher::GetNumUploads() const {
+	return m_NumUploads;
+}
+
+uint64_t UploadBatcher::GetNumConsumerWaits() const {
+	return m_NumConsumerWaits;
+}
\ No newline at end of file
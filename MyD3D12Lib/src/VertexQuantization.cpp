@@ -0,0 +1,452 @@
+#include <MyD3D12Lib/VertexQuantization.h>
+#include <MyD3D12Lib/CpuFeatures.h>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+	const float UNorm16Max = 65535.0f;
+	const float SNorm16Max = 32767.0f;
+
+	const float* GetAttribute(const VertexStreamDesc& stream, uint32_t vertexIndex, uint32_t offset) {
+		const uint8_t* data = static_cast<const uint8_t*>(stream.Data);
+		return reinterpret_cast<const float*>(data + static_cast<size_t>(vertexIndex) * stream.ByteStride + offset);
+	}
+
+	float SignNotZero(float value) {
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	void ComputeInvScale(const PositionDequantization& dequantization, float invScale[3]) {
+		// flat bounding box along some axis gives zero scale, all positions are quantized to zero then
+		for (uint32_t i = 0; i < 3; ++i) {
+			invScale[i] = dequantization.Scale[i] > 0.0f ? 1.0f / dequantization.Scale[i] : 0.0f;
+		}
+	}
+
+	void EncodeCompactVertex(
+		const VertexStreamDesc& stream,
+		uint32_t vertexIndex,
+		const PositionDequantization& dequantization,
+		const float invScale[3],
+		CompactVertex& compactVertex)
+	{
+		const float* position = GetAttribute(stream, vertexIndex, stream.PositionOffset);
+		const float* norm = GetAttribute(stream, vertexIndex, stream.NormOffset);
+		const float* texC = GetAttribute(stream, vertexIndex, stream.TexCOffset);
+
+		for (uint32_t i = 0; i < 3; ++i) {
+			float unorm = (std::min)((std::max)((position[i] - dequantization.Offset[i]) * invScale[i], 0.0f), 1.0f);
+			compactVertex.Position[i] = static_cast<uint16_t>(unorm * UNorm16Max + 0.5f);
+		}
+
+		compactVertex.Position[3] = 0;
+
+		EncodeOctahedralNorm(norm, compactVertex.Norm);
+
+		compactVertex.TexC[0] = FloatToHalf(texC[0]);
+		compactVertex.TexC[1] = FloatToHalf(texC[1]);
+	}
+
+	void DecodeCompactVertex(
+		const CompactVertex& compactVertex,
+		const PositionDequantization& dequantization,
+		float* position,
+		float* norm,
+		float* texC)
+	{
+		for (uint32_t i = 0; i < 3; ++i) {
+			position[i] = dequantization.Offset[i] + dequantization.Scale[i] * (compactVertex.Position[i] / UNorm16Max);
+		}
+
+		DecodeOctahedralNorm(compactVertex.Norm, norm);
+
+		texC[0] = HalfToFloat(compactVertex.TexC[0]);
+		texC[1] = HalfToFloat(compactVertex.TexC[1]);
+	}
+
+	// 8 vertexes per iteration, vertex attributes are gathered from interleaved stream
+	SIMD_TARGET_AVX2
+	uint32_t EncodeCompactVertexesAVX2(
+		const VertexStreamDesc& stream,
+		uint32_t numVertexes,
+		const PositionDequantization& dequantization,
+		const float invScale[3],
+		CompactVertex* compactVertexes)
+	{
+		const uint8_t* data = static_cast<const uint8_t*>(stream.Data);
+		const __m256i byteOffsets = _mm256_mullo_epi32(
+			_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+			_mm256_set1_epi32(static_cast<int>(stream.ByteStride))
+		);
+
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+		const __m256 unormMax = _mm256_set1_ps(UNorm16Max);
+		const __m256 snormMax = _mm256_set1_ps(SNorm16Max);
+
+		alignas(32) int32_t position[3][8];
+		alignas(32) int32_t norm[2][8];
+		alignas(16) uint16_t texC[2][8];
+
+		uint32_t i = 0;
+
+		for (; i + 8 <= numVertexes; i += 8) {
+			const uint8_t* block = data + static_cast<size_t>(i) * stream.ByteStride;
+
+			// positions
+			for (uint32_t c = 0; c < 3; ++c) {
+				const float* base = reinterpret_cast<const float*>(block + stream.PositionOffset) + c;
+				__m256 p = _mm256_i32gather_ps(base, byteOffsets, 1);
+
+				p = _mm256_mul_ps(_mm256_sub_ps(p, _mm256_set1_ps(dequantization.Offset[c])), _mm256_set1_ps(invScale[c]));
+				p = _mm256_min_ps(_mm256_max_ps(p, zero), one);
+				p = _mm256_fmadd_ps(p, unormMax, _mm256_set1_ps(0.5f));
+
+				_mm256_store_si256(reinterpret_cast<__m256i*>(position[c]), _mm256_cvttps_epi32(p));
+			}
+
+			// octahedral norms
+			{
+				const float* base = reinterpret_cast<const float*>(block + stream.NormOffset);
+				__m256 x = _mm256_i32gather_ps(base, byteOffsets, 1);
+				__m256 y = _mm256_i32gather_ps(base + 1, byteOffsets, 1);
+				__m256 z = _mm256_i32gather_ps(base + 2, byteOffsets, 1);
+
+				__m256 l1 = _mm256_add_ps(
+					_mm256_add_ps(_mm256_and_ps(x, absMask), _mm256_and_ps(y, absMask)),
+					_mm256_and_ps(z, absMask)
+				);
+
+				__m256 invL1 = _mm256_and_ps(_mm256_div_ps(one, l1), _mm256_cmp_ps(l1, zero, _CMP_GT_OQ));
+				x = _mm256_mul_ps(x, invL1);
+				y = _mm256_mul_ps(y, invL1);
+
+				// lower hemisphere is folded over diagonals
+				__m256 signX = _mm256_blendv_ps(one, _mm256_set1_ps(-1.0f), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+				__m256 signY = _mm256_blendv_ps(one, _mm256_set1_ps(-1.0f), _mm256_cmp_ps(y, zero, _CMP_LT_OQ));
+				__m256 foldedX = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_and_ps(y, absMask)), signX);
+				__m256 foldedY = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_and_ps(x, absMask)), signY);
+
+				__m256 isLower = _mm256_cmp_ps(z, zero, _CMP_LT_OQ);
+				x = _mm256_blendv_ps(x, foldedX, isLower);
+				y = _mm256_blendv_ps(y, foldedY, isLower);
+
+				x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-1.0f)), one);
+				y = _mm256_min_ps(_mm256_max_ps(y, _mm256_set1_ps(-1.0f)), one);
+
+				_mm256_store_si256(reinterpret_cast<__m256i*>(norm[0]), _mm256_cvtps_epi32(_mm256_mul_ps(x, snormMax)));
+				_mm256_store_si256(reinterpret_cast<__m256i*>(norm[1]), _mm256_cvtps_epi32(_mm256_mul_ps(y, snormMax)));
+			}
+
+			// half float texture coordinates
+			for (uint32_t c = 0; c < 2; ++c) {
+				const float* base = reinterpret_cast<const float*>(block + stream.TexCOffset) + c;
+				__m256 t = _mm256_i32gather_ps(base, byteOffsets, 1);
+
+				_mm_store_si128(reinterpret_cast<__m128i*>(texC[c]), _mm256_cvtps_ph(t, _MM_FROUND_TO_NEAREST_INT));
+			}
+
+			for (uint32_t j = 0; j < 8; ++j) {
+				CompactVertex& compactVertex = compactVertexes[i + j];
+
+				compactVertex.Position[0] = static_cast<uint16_t>(position[0][j]);
+				compactVertex.Position[1] = static_cast<uint16_t>(position[1][j]);
+				compactVertex.Position[2] = static_cast<uint16_t>(position[2][j]);
+				compactVertex.Position[3] = 0;
+				compactVertex.Norm[0] = static_cast<int16_t>(norm[0][j]);
+				compactVertex.Norm[1] = static_cast<int16_t>(norm[1][j]);
+				compactVertex.TexC[0] = texC[0][j];
+				compactVertex.TexC[1] = texC[1][j];
+			}
+		}
+
+		return i;
+	}
+
+	SIMD_TARGET_AVX2
+	uint32_t DecodeCompactVertexesAVX2(
+		const CompactVertex* compactVertexes,
+		uint32_t numVertexes,
+		const PositionDequantization& dequantization,
+		float* positions,
+		float* norms,
+		float* texCs)
+	{
+		static_assert(sizeof(CompactVertex) == 16, "Compact vertex should be 16 bytes");
+
+		const __m256i dwordOffsets = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+		const __m256i lowMask = _mm256_set1_epi32(0xFFFF);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+		const __m256 invSNormMax = _mm256_set1_ps(1.0f / SNorm16Max);
+
+		alignas(32) float position[3][8];
+		alignas(32) float norm[3][8];
+
+		uint32_t i = 0;
+
+		for (; i + 8 <= numVertexes; i += 8) {
+			const int* block = reinterpret_cast<const int*>(compactVertexes + i);
+
+			__m256i posXY = _mm256_i32gather_epi32(block, dwordOffsets, 4);
+			__m256i posZW = _mm256_i32gather_epi32(block + 1, dwordOffsets, 4);
+			__m256i normXY = _mm256_i32gather_epi32(block + 2, dwordOffsets, 4);
+
+			// positions
+			__m256i quantized[3] = {
+				_mm256_and_si256(posXY, lowMask),
+				_mm256_srli_epi32(posXY, 16),
+				_mm256_and_si256(posZW, lowMask)
+			};
+
+			for (uint32_t c = 0; c < 3; ++c) {
+				__m256 p = _mm256_fmadd_ps(
+					_mm256_cvtepi32_ps(quantized[c]),
+					_mm256_set1_ps(dequantization.Scale[c] / UNorm16Max),
+					_mm256_set1_ps(dequantization.Offset[c])
+				);
+
+				_mm256_store_ps(position[c], p);
+			}
+
+			// octahedral norms, sign extend SNORM16 pair
+			__m256 ex = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(normXY, 16), 16)), invSNormMax);
+			__m256 ey = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(normXY, 16)), invSNormMax);
+			ex = _mm256_max_ps(ex, _mm256_set1_ps(-1.0f));
+			ey = _mm256_max_ps(ey, _mm256_set1_ps(-1.0f));
+
+			__m256 nz = _mm256_sub_ps(_mm256_sub_ps(one, _mm256_and_ps(ex, absMask)), _mm256_and_ps(ey, absMask));
+			__m256 t = _mm256_max_ps(_mm256_sub_ps(zero, nz), zero);
+
+			__m256 nx = _mm256_add_ps(ex, _mm256_blendv_ps(_mm256_sub_ps(zero, t), t, _mm256_cmp_ps(ex, zero, _CMP_LT_OQ)));
+			__m256 ny = _mm256_add_ps(ey, _mm256_blendv_ps(_mm256_sub_ps(zero, t), t, _mm256_cmp_ps(ey, zero, _CMP_LT_OQ)));
+
+			__m256 lengthSq = _mm256_fmadd_ps(nx, nx, _mm256_fmadd_ps(ny, ny, _mm256_mul_ps(nz, nz)));
+			__m256 invLength = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSq));
+
+			_mm256_store_ps(norm[0], _mm256_mul_ps(nx, invLength));
+			_mm256_store_ps(norm[1], _mm256_mul_ps(ny, invLength));
+			_mm256_store_ps(norm[2], _mm256_mul_ps(nz, invLength));
+
+			// texture coordinates are already interleaved as u, v pairs
+			__m256i texC = _mm256_i32gather_epi32(block + 3, dwordOffsets, 4);
+			_mm256_storeu_ps(texCs + 2 * i, _mm256_cvtph_ps(_mm256_castsi256_si128(texC)));
+			_mm256_storeu_ps(texCs + 2 * i + 8, _mm256_cvtph_ps(_mm256_extracti128_si256(texC, 1)));
+
+			for (uint32_t j = 0; j < 8; ++j) {
+				for (uint32_t c = 0; c < 3; ++c) {
+					positions[3 * (i + j) + c] = position[c][j];
+					norms[3 * (i + j) + c] = norm[c][j];
+				}
+			}
+		}
+
+		return i;
+	}
+}
+
+PositionDequantization ComputePositionDequantization(const VertexStreamDesc& stream, uint32_t numVertexes) {
+	PositionDequantization dequantization;
+
+	if (numVertexes == 0) {
+		return dequantization;
+	}
+
+	float minPos[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float maxPos[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	for (uint32_t i = 0; i < numVertexes; ++i) {
+		const float* position = GetAttribute(stream, i, stream.PositionOffset);
+
+		for (uint32_t c = 0; c < 3; ++c) {
+			minPos[c] = std::min(minPos[c], position[c]);
+			maxPos[c] = std::max(maxPos[c], position[c]);
+		}
+	}
+
+	for (uint32_t c = 0; c < 3; ++c) {
+		dequantization.Offset[c] = minPos[c];
+		dequantization.Scale[c] = maxPos[c] - minPos[c];
+	}
+
+	return dequantization;
+}
+
+void EncodeCompactVertexes(
+	const VertexStreamDesc& stream,
+	uint32_t numVertexes,
+	const PositionDequantization& dequantization,
+	CompactVertex* compactVertexes)
+{
+	float invScale[3];
+	ComputeInvScale(dequantization, invScale);
+
+	uint32_t i = 0;
+
+	if (IsAVX2Supported()) {
+		i = EncodeCompactVertexesAVX2(stream, numVertexes, dequantization, invScale, compactVertexes);
+	}
+
+	for (; i < numVertexes; ++i) {
+		EncodeCompactVertex(stream, i, dequantization, invScale, compactVertexes[i]);
+	}
+}
+
+void DecodeCompactVertexes(
+	const CompactVertex* compactVertexes,
+	uint32_t numVertexes,
+	const PositionDequantization& dequantization,
+	float* positions,
+	float* norms,
+	float* texCs)
+{
+	uint32_t i = 0;
+
+	if (IsAVX2Supported()) {
+		i = DecodeCompactVertexesAVX2(compactVertexes, numVertexes, dequantization, positions, norms, texCs);
+	}
+
+	for (; i < numVertexes; ++i) {
+		DecodeCompactVertex(compactVertexes[i], dequantization, positions + 3 * i, norms + 3 * i, texCs + 2 * i);
+	}
+}
+
+void EncodeCompactVertexesScalar(
+	const VertexStreamDesc& stream,
+	uint32_t numVertexes,
+	const PositionDequantization& dequantization,
+	CompactVertex* compactVertexes)
+{
+	float invScale[3];
+	ComputeInvScale(dequantization, invScale);
+
+	for (uint32_t i = 0; i < numVertexes; ++i) {
+		EncodeCompactVertex(stream, i, dequantization, invScale, compactVertexes[i]);
+	}
+}
+
+void DecodeCompactVertexesScalar(
+	const CompactVertex* compactVertexes,
+	uint32_t numVertexes,
+	const PositionDequantization& dequantization,
+	float* positions,
+	float* norms,
+	float* texCs)
+{
+	for (uint32_t i = 0; i < numVertexes; ++i) {
+		DecodeCompactVertex(compactVertexes[i], dequantization, positions + 3 * i, norms + 3 * i, texCs + 2 * i);
+	}
+}
+
+// round to nearest even, same as F16C
+// Source: https://gist.github.com/rygorous/2156668
+uint16_t FloatToHalf(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	uint16_t half;
+
+	if (bits >= 0x47800000u) {
+		// Inf or NaN
+		half = bits > 0x7F800000u ? 0x7E00 : 0x7C00;
+	}
+	else if (bits < 0x38800000u) {
+		// subnormal or zero, magic addition aligns mantissa and rounds
+		const uint32_t denormMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+		float denormMagic;
+		std::memcpy(&denormMagic, &denormMagicBits, sizeof(denormMagic));
+
+		float f;
+		std::memcpy(&f, &bits, sizeof(f));
+		f += denormMagic;
+		std::memcpy(&bits, &f, sizeof(bits));
+
+		half = static_cast<uint16_t>(bits - denormMagicBits);
+	}
+	else {
+		uint32_t mantissaOdd = (bits >> 13) & 1;
+		bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFF;
+		bits += mantissaOdd;
+		half = static_cast<uint16_t>(bits >> 13);
+	}
+
+	return static_cast<uint16_t>((sign >> 16) | half);
+}
+
+float HalfToFloat(uint16_t value) {
+	const uint32_t shiftedExponent = 0x7C00 << 13;
+	const uint32_t magicBits = 113 << 23;
+
+	uint32_t bits = (value & 0x7FFFu) << 13;
+	uint32_t exponent = shiftedExponent & bits;
+	bits += (127 - 15) << 23;
+
+	if (exponent == shiftedExponent) {
+		// Inf or NaN
+		bits += (128 - 16) << 23;
+	}
+	else if (exponent == 0) {
+		// zero or subnormal
+		float magic;
+		std::memcpy(&magic, &magicBits, sizeof(magic));
+
+		bits += 1 << 23;
+
+		float f;
+		std::memcpy(&f, &bits, sizeof(f));
+		f -= magic;
+		std::memcpy(&bits, &f, sizeof(bits));
+	}
+
+	bits |= static_cast<uint32_t>(value & 0x8000u) << 16;
+
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+
+	return result;
+}
+
+void EncodeOctahedralNorm(const float norm[3], int16_t encoded[2]) {
+	float l1 = std::fabs(norm[0]) + std::fabs(norm[1]) + std::fabs(norm[2]);
+	float invL1 = l1 > 0.0f ? 1.0f / l1 : 0.0f;
+
+	float x = norm[0] * invL1;
+	float y = norm[1] * invL1;
+
+	// lower hemisphere is folded over diagonals
+	if (norm[2] < 0.0f) {
+		float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	encoded[0] = static_cast<int16_t>(std::lrint((std::min)((std::max)(x, -1.0f), 1.0f) * SNorm16Max));
+	encoded[1] = static_cast<int16_t>(std::lrint((std::min)((std::max)(y, -1.0f), 1.0f) * SNorm16Max));
+}
+
+void DecodeOctahedralNorm(const int16_t encoded[2], float norm[3]) {
+	float x = std::max(encoded[0] / SNorm16Max, -1.0f);
+	float y = std::max(encoded[1] / SNorm16Max, -1.0f);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+	float t = std::max(-z, 0.0f);
+	x += x >= 0.0f ? -t : t;
+	y += y >= 0.0f ? -t : t;
+
+	float invLength = 1.0f / std::sqrt(x * x + y * y + z * z);
+
+	norm[0] = x * invLength;
+	norm[1] = y * invLength;
+	norm[2] = z * invLength;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include <MyD3D12Lib/VertexStreams.h>
+
+#include <cassert>
+#include <cstring>
+
+void SplitVertexStreams(
+	const void* vertexes,
+	uint32_t numVertexes,
+	uint32_t byteStride,
+	uint32_t positionOffset,
+	uint32_t positionByteSize,
+	void* positions,
+	void* attributes)
+{
+	assert(positionOffset + positionByteSize <= byteStride && "Position is out of vertex");
+
+	const uint8_t* src = static_cast<const uint8_t*>(vertexes);
+	uint8_t* dstPositions = static_cast<uint8_t*>(positions);
+	uint8_t* dstAttributes = static_cast<uint8_t*>(attributes);
+
+	uint32_t attributesByteStride = byteStride - positionByteSize;
+	uint32_t tailOffset = positionOffset + positionByteSize;
+	uint32_t tailByteSize = byteStride - tailOffset;
+
+	for (uint32_t i = 0; i < numVertexes; ++i) {
+		std::memcpy(dstPositions, src + positionOffset, positionByteSize);
+
+		if (attributesByteStride > 0) {
+			std::memcpy(dstAttributes, src, positionOffset);
+			std::memcpy(dstAttributes + positionOffset, src + tailOffset, tailByteSize);
+			dstAttributes += attributesByteStride;
+		}
+
+		src += byteStride;
+		dstPositions += positionByteSize;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <MyD3D12Lib/VertexWelder.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace {
+	const uint32_t KeySize = 8;
+	const uint32_t EmptySlot = UINT32_MAX;
+
+	struct VertexKey {
+		int32_t Values[KeySize];
+	};
+
+	int32_t QuantizeComponent(float value, float epsilon) {
+		if (epsilon <= 0.0f) {
+			int32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+
+		return static_cast<int32_t>(std::floor(value / epsilon + 0.5f));
+	}
+
+	VertexKey MakeKey(const VertexStreamDesc& stream, uint32_t vertexIndex, const WeldEpsilons& epsilons) {
+		const uint8_t* vertex = static_cast<const uint8_t*>(stream.Data) + static_cast<size_t>(vertexIndex) * stream.ByteStride;
+		const float* position = reinterpret_cast<const float*>(vertex + stream.PositionOffset);
+		const float* norm = reinterpret_cast<const float*>(vertex + stream.NormOffset);
+		const float* texC = reinterpret_cast<const float*>(vertex + stream.TexCOffset);
+
+		VertexKey key;
+
+		for (uint32_t i = 0; i < 3; ++i) {
+			key.Values[i] = QuantizeComponent(position[i], epsilons.Position);
+			key.Values[3 + i] = QuantizeComponent(norm[i], epsilons.Norm);
+		}
+
+		key.Values[6] = QuantizeComponent(texC[0], epsilons.TexC);
+		key.Values[7] = QuantizeComponent(texC[1], epsilons.TexC);
+
+		return key;
+	}
+
+	// FNV-1a over key words followed by avalanche, table size is power of two so low bits should be mixed well
+	uint32_t HashKey(const VertexKey& key) {
+		uint32_t hash = 2166136261u;
+
+		for (uint32_t i = 0; i < KeySize; ++i) {
+			hash = (hash ^ static_cast<uint32_t>(key.Values[i])) * 16777619u;
+		}
+
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6Bu;
+		hash ^= hash >> 13;
+
+		return hash;
+	}
+
+	bool IsKeysEqual(const VertexKey& a, const VertexKey& b) {
+		return std::memcmp(a.Values, b.Values, sizeof(a.Values)) == 0;
+	}
+}
+
+WeldResult WeldVertexes(const VertexStreamDesc& stream, uint32_t numVertexes, const WeldEpsilons& epsilons) {
+	WeldResult result;
+	result.Remap.resize(numVertexes);
+
+	// keep load factor not greater than one half
+	uint32_t tableSize = 16;
+
+	while (tableSize < numVertexes * 2) {
+		tableSize *= 2;
+	}
+
+	uint32_t mask = tableSize - 1;
+
+	std::vector<uint32_t> table(tableSize, EmptySlot);
+	std::vector<VertexKey> keys;
+	keys.reserve(numVertexes);
+
+	for (uint32_t i = 0; i < numVertexes; ++i) {
+		VertexKey key = MakeKey(stream, i, epsilons);
+
+		// linear probing
+		uint32_t slot = HashKey(key) & mask;
+
+		while (table[slot] != EmptySlot && !IsKeysEqual(keys[table[slot]], key)) {
+			slot = (slot + 1) & mask;
+		}
+
+		if (table[slot] == EmptySlot) {
+			table[slot] = static_cast<uint32_t>(result.Vertexes.size());
+			keys.push_back(key);
+			result.Vertexes.push_back(i);
+		}
+
+		result.Remap[i] = table[slot];
+	}
+
+	return result;
+}
+
+void RemapIndexes(uint32_t* indexes, uint32_t numIndexes, const std::vector<uint32_t>& remap) {
+	for (uint32_t i = 0; i < numIndexes; ++i) {
+		assert(indexes[i] < remap.size() && "Index out of range!");
+
+		indexes[i] = remap[indexes[i]];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// checks stay in release builds, failed check stops test with non zero exit code
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			std::exit(1); \
+		} \
+	} while (false)
+
+// benchmarks take scale from first argument, ctest runs them with small one
+inline uint32_t GetScaleArgument(int argc, char** argv, uint32_t defaultScale) {
+	return argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : defaultScale;
+}
+
+class Stopwatch {
+public:
+	Stopwatch() :
+		m_Start(std::chrono::steady_clock::now())
+	{}
+
+	double GetSeconds() const {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count();
+	}
+
+	void Restart() {
+		m_Start = std::chrono::steady_clock::now();
+	}
+
+private:
+	std::chrono::steady_clock::time_point m_Start;
+};
+
+// keeps result of benchmarked code, so it isn`t optimized out
+inline void KeepResult(uint64_t value) {
+	static volatile uint64_t sink;
+	sink = sink + value;
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include <MyD3D12Lib/AssetPackage.h>
+#include <MyD3D12Lib/LZCompression.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+std::vector<uint8_t> ReadFileBytes(const std::filesystem::path& fileName) {
+	std::ifstream file(fileName, std::ios::binary);
+	CHECK(file);
+
+	std::vector<uint8_t> data(std::filesystem::file_size(fileName));
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+
+	return data;
+}
+
+// assets are emulated by files of three kinds: text like glTF, vertex buffers and noise like compressed images
+std::vector<uint8_t> GenerateAsset(uint32_t index, std::mt19937& rng) {
+	std::vector<uint8_t> data;
+
+	switch (index % 3) {
+	case 0: {
+		const std::string words[] = { "\"bufferView\": ", "\"byteOffset\": ", "\"componentType\": 5126, ", "\"count\": ", "\"type\": \"VEC3\" },\n" };
+
+		while (data.size() < 64 * 1024) {
+			std::string word = words[rng() % 5] + std::to_string(rng() % 10000);
+			data.insert(data.end(), word.begin(), word.end());
+		}
+		break;
+	}
+	case 1: {
+		// smooth positions, normals and texture coordinates
+		uint32_t numVertexes = 4096 + rng() % 16384;
+		std::vector<float> vertexes(8 * numVertexes);
+
+		for (uint32_t v = 0; v < numVertexes; ++v) {
+			for (uint32_t i = 0; i < 8; ++i) {
+				vertexes[8 * v + i] = static_cast<float>((v / 16 + i) % 256) * 0.125f;
+			}
+		}
+
+		data.resize(vertexes.size() * sizeof(float));
+		std::memcpy(data.data(), vertexes.data(), data.size());
+		break;
+	}
+	default:
+		data.resize((64 + rng() % 448) * 1024);
+
+		for (uint8_t& byte : data) {
+			byte = static_cast<uint8_t>(rng());
+		}
+		break;
+	}
+
+	return data;
+}
+
+std::filesystem::path CreateSyntheticAssets(uint32_t numFiles) {
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / "AssetPackageBenchmark";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder / "meshes");
+
+	std::mt19937 rng(40);
+
+	for (uint32_t i = 0; i < numFiles; ++i) {
+		std::vector<uint8_t> data = GenerateAsset(i, rng);
+
+		std::ofstream file(folder / "meshes" / ("asset" + std::to_string(i) + ".bin"), std::ios::binary);
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	}
+
+	return folder;
+}
+
+void MeasureLZ(const std::vector<std::vector<uint8_t>>& datas) {
+	std::vector<uint8_t> compressed;
+	std::vector<uint8_t> decompressed;
+	uint64_t srcSize = 0;
+	uint64_t compressedSize = 0;
+	double compressSeconds = 0.0;
+	double decompressSeconds = 0.0;
+
+	for (const std::vector<uint8_t>& data : datas) {
+		compressed.resize(GetLZMaxCompressedSize(data.size()));
+		decompressed.resize(data.size());
+
+		Stopwatch stopwatch;
+		size_t size = CompressLZ(data.data(), data.size(), compressed.data());
+		compressSeconds += stopwatch.GetSeconds();
+
+		stopwatch.Restart();
+		DecompressLZ(compressed.data(), size, decompressed.data(), decompressed.size());
+		decompressSeconds += stopwatch.GetSeconds();
+
+		CHECK(decompressed == data);
+
+		srcSize += data.size();
+		compressedSize += size;
+	}
+
+	std::printf(
+		"LZ: ratio %.2f, compress %.0f MB/s, decompress %.0f MB/s\n",
+		static_cast<double>(srcSize) / compressedSize, srcSize / compressSeconds / 1048576.0, srcSize / decompressSeconds / 1048576.0
+	);
+}
+
+// argument is directory with assets, synthetic files are generated if it is not given
+int main(int argc, char** argv) {
+	bool isSynthetic = argc < 2;
+	std::filesystem::path folder = isSynthetic ? CreateSyntheticAssets(60) : std::filesystem::path(argv[1]);
+
+	std::vector<std::filesystem::path> files;
+	std::vector<std::string> names;
+
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(folder)) {
+		if (entry.is_regular_file()) {
+			files.push_back(entry.path());
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+	CHECK(!files.empty());
+
+	ThreadPool pool;
+	AssetPackageWriter writer;
+	std::vector<std::vector<uint8_t>> datas;
+	uint64_t totalSize = 0;
+
+	for (const std::filesystem::path& fileName : files) {
+		names.push_back(fileName.lexically_relative(folder).generic_string());
+		datas.push_back(ReadFileBytes(fileName));
+		totalSize += datas.back().size();
+
+		writer.AddFile(names.back(), datas.back());
+	}
+
+	MeasureLZ(datas);
+
+	std::filesystem::path packageName = std::filesystem::temp_directory_path() / "AssetPackageBenchmark.pak";
+
+	Stopwatch stopwatch;
+	writer.Write(packageName, &pool);
+	double writeSeconds = stopwatch.GetSeconds();
+
+	std::printf(
+		"%zu files, %.1f MB, compressed %.1f MB, package written in %.1f ms, %u threads\n",
+		files.size(), totalSize / 1048576.0, writer.GetCompressedSize() / 1048576.0, writeSeconds * 1e3, pool.GetNumThreads()
+	);
+
+	// files are in OS cache after they are written, so both ways are measured warm and best of runs is taken
+	double looseSeconds = 1e30;
+	double packageSeconds = 1e30;
+	double poolSeconds = 1e30;
+
+	for (uint32_t run = 0; run < 3; ++run) {
+		uint64_t looseChecksum = 0;
+		stopwatch.Restart();
+
+		for (const std::filesystem::path& fileName : files) {
+			std::vector<uint8_t> data = ReadFileBytes(fileName);
+			looseChecksum += data.size() + data.back();
+		}
+
+		looseSeconds = std::min(looseSeconds, stopwatch.GetSeconds());
+
+		// package is opened inside measured time like game would do at load
+		uint64_t packageChecksum = 0;
+		stopwatch.Restart();
+
+		{
+			AssetPackage package(packageName);
+
+			for (const std::string& name : names) {
+				std::vector<uint8_t> data = package.ReadFile(package.Find(name));
+				packageChecksum += data.size() + data.back();
+			}
+		}
+
+		packageSeconds = std::min(packageSeconds, stopwatch.GetSeconds());
+
+		uint64_t poolChecksum = 0;
+		stopwatch.Restart();
+
+		{
+			AssetPackage package(packageName);
+
+			for (const std::string& name : names) {
+				std::vector<uint8_t> data = package.ReadFile(package.Find(name), &pool);
+				poolChecksum += data.size() + data.back();
+			}
+		}
+
+		poolSeconds = std::min(poolSeconds, stopwatch.GetSeconds());
+
+		CHECK(packageChecksum == looseChecksum && poolChecksum == looseChecksum);
+	}
+
+	std::printf("loose files: %.1f ms\n", looseSeconds * 1e3);
+	std::printf("package: %.1f ms, x%.2f\n", packageSeconds * 1e3, looseSeconds / packageSeconds);
+	std::printf("package on pool: %.1f ms, x%.2f\n", poolSeconds * 1e3, looseSeconds / poolSeconds);
+
+	// lookup by name against opening loose file, which is what it replaces
+	AssetPackage package(packageName);
+	const uint32_t numLookups = 100000;
+	uint64_t numFound = 0;
+
+	stopwatch.Restart();
+
+	for (uint32_t i = 0; i < numLookups; ++i) {
+		numFound += package.Find(names[i % names.size()]) != AssetPackage::InvalidIndex;
+	}
+
+	double findSeconds = stopwatch.GetSeconds();
+	CHECK(numFound == numLookups);
+
+	stopwatch.Restart();
+
+	for (const std::filesystem::path& fileName : files) {
+		std::ifstream file(fileName, std::ios::binary);
+		numFound += file.is_open();
+	}
+
+	double openSeconds = stopwatch.GetSeconds();
+	KeepResult(numFound);
+
+	std::printf("find: %.0f ns, open of loose file: %.0f ns\n", findSeconds / numLookups * 1e9, openSeconds / files.size() * 1e9);
+
+	std::filesystem::remove(packageName);
+
+	if (isSynthetic) {
+		std::filesystem::remove_all(folder);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include <MyD3D12Lib/BindlessRemap.h>
+#include <MyD3D12Lib/DescriptorIndexAllocator.h>
+
+#include <TestUtils.h>
+
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+void TestRemap() {
+	std::mt19937 rng(44);
+
+	const uint32_t numIds = 1000;
+	BindlessRemap remap(numIds);
+
+	for (uint32_t frame = 0; frame < 2000; ++frame) {
+		remap.Clear();
+		CHECK(remap.GetNumSlots() == 0);
+
+		std::map<uint32_t, uint32_t> slots;
+		uint32_t numAdds = rng() % 300;
+
+		// slots are given in order of first use, repeated id keeps its slot
+		for (uint32_t i = 0; i < numAdds; ++i) {
+			uint32_t id = rng() % numIds;
+			uint32_t slot = remap.Add(id);
+
+			auto it = slots.find(id);
+
+			if (it == slots.end()) {
+				CHECK(slot == slots.size());
+				slots[id] = slot;
+			}
+			else {
+				CHECK(slot == it->second);
+			}
+		}
+
+		CHECK(remap.GetNumSlots() == slots.size());
+		CHECK(remap.GetIds().size() == slots.size());
+
+		// ids not added in this frame are not mapped, even if they were in previous one
+		for (uint32_t id = 0; id < numIds; ++id) {
+			auto it = slots.find(id);
+			CHECK(remap.GetSlot(id) == (it == slots.end() ? BindlessRemap::InvalidSlot : it->second));
+		}
+
+		for (uint32_t slot = 0; slot < remap.GetNumSlots(); ++slot) {
+			CHECK(slots[remap.GetIds()[slot]] == slot);
+		}
+	}
+
+	CHECK(remap.GetSlot(numIds + 5) == BindlessRemap::InvalidSlot);
+
+	BindlessRemap empty;
+	CHECK(empty.GetNumSlots() == 0 && empty.GetSlot(0) == BindlessRemap::InvalidSlot);
+
+	// app creates remap when number of staging views is known
+	BindlessRemap assigned;
+	assigned = BindlessRemap(4);
+	CHECK(assigned.Add(3) == 0 && assigned.Add(1) == 1 && assigned.Add(3) == 0);
+}
+
+struct TestTexture {
+	uint32_t SRVStagingIndex = DescriptorIndexAllocator::InvalidIndex;
+	uint32_t SRVHeapIndex = DescriptorIndexAllocator::InvalidIndex;
+};
+
+// textures table of frame is built as app does: each used staging view is copied once into ring of frame
+// heaps are emulated by arrays of view ids, copy of descriptor is copy of id
+uint32_t BuildTexturesTable(
+	std::vector<TestTexture>& textures,
+	const std::vector<uint32_t>& stagingHeap,
+	BindlessRemap& remap,
+	DescriptorRing& ring,
+	std::vector<uint32_t>& shaderVisibleHeap)
+{
+	remap.Clear();
+
+	for (const TestTexture& texture : textures) {
+		remap.Add(texture.SRVStagingIndex);
+	}
+
+	uint32_t tableIndex = ring.Allocate(remap.GetNumSlots());
+	CHECK(tableIndex != DescriptorIndexAllocator::InvalidIndex);
+
+	const std::vector<uint32_t>& stagingIndexes = remap.GetIds();
+
+	for (uint32_t slot = 0; slot < stagingIndexes.size(); ++slot) {
+		shaderVisibleHeap[tableIndex + slot] = stagingHeap[stagingIndexes[slot]];
+	}
+
+	for (TestTexture& texture : textures) {
+		texture.SRVHeapIndex = tableIndex + remap.GetSlot(texture.SRVStagingIndex);
+	}
+
+	return tableIndex;
+}
+
+void TestTexturesTable() {
+	std::mt19937 rng(45);
+
+	const uint32_t numStagingViews = 512;
+	const uint32_t numFrames = 3;
+	const uint32_t numTextures = 300;
+
+	// first views of shader visible heap are persistent ones, ring of frames follows them
+	const uint32_t numPersistentViews = 16;
+
+	DescriptorIndexAllocator stagingAllocator(0, numStagingViews);
+	DescriptorRing ring(numPersistentViews, numStagingViews, numFrames);
+	BindlessRemap remap(numStagingViews);
+
+	std::vector<uint32_t> stagingHeap(numStagingViews, 0);
+	std::vector<uint32_t> shaderVisibleHeap(numPersistentViews + numFrames * numStagingViews, 0);
+	uint32_t nextViewId = 1;
+
+	// all textures start with default view, some of them are packed into groups sharing view
+	uint32_t defaultView = stagingAllocator.Allocate(1).Index;
+	stagingHeap[defaultView] = nextViewId++;
+
+	std::vector<uint32_t> groupsViews;
+
+	for (uint32_t i = 0; i < 4; ++i) {
+		groupsViews.push_back(stagingAllocator.Allocate(1).Index);
+		stagingHeap[groupsViews.back()] = nextViewId++;
+	}
+
+	std::vector<TestTexture> textures(numTextures);
+
+	for (TestTexture& texture : textures) {
+		texture.SRVStagingIndex = rng() % 3 == 0 ? groupsViews[rng() % groupsViews.size()] : defaultView;
+	}
+
+	// tables of frames in flight with view each texture should see
+	std::vector<std::vector<uint32_t>> framesViews(numFrames);
+	std::vector<std::vector<uint32_t>> framesHeapIndexes(numFrames);
+
+	for (uint32_t frame = 0; frame < 500; ++frame) {
+		uint32_t frameSlot = frame % numFrames;
+
+		// streamed textures become resident with own view or get new mips, which rewrites view in place
+		for (uint32_t i = 0; i < 5; ++i) {
+			TestTexture& texture = textures[rng() % numTextures];
+
+			if (texture.SRVStagingIndex == defaultView) {
+				DescriptorRange range = stagingAllocator.Allocate(1);
+
+				if (range.IsValid()) {
+					texture.SRVStagingIndex = range.Index;
+				}
+			}
+
+			if (texture.SRVStagingIndex != defaultView) {
+				stagingHeap[texture.SRVStagingIndex] = nextViewId++;
+			}
+		}
+
+		ring.BeginFrame(frameSlot);
+		uint32_t tableIndex = BuildTexturesTable(textures, stagingHeap, remap, ring, shaderVisibleHeap);
+
+		std::set<uint32_t> usedViews;
+
+		for (const TestTexture& texture : textures) {
+			usedViews.insert(texture.SRVStagingIndex);
+		}
+
+		// one slot per used view, table is inside partition of frame
+		CHECK(remap.GetNumSlots() == usedViews.size());
+		CHECK(tableIndex == numPersistentViews + frameSlot * numStagingViews);
+
+		framesViews[frameSlot].clear();
+		framesHeapIndexes[frameSlot].clear();
+
+		for (const TestTexture& texture : textures) {
+			CHECK(texture.SRVHeapIndex >= tableIndex && texture.SRVHeapIndex < tableIndex + remap.GetNumSlots());
+			CHECK(shaderVisibleHeap[texture.SRVHeapIndex] == stagingHeap[texture.SRVStagingIndex]);
+
+			framesViews[frameSlot].push_back(stagingHeap[texture.SRVStagingIndex]);
+			framesHeapIndexes[frameSlot].push_back(texture.SRVHeapIndex);
+		}
+
+		// tables of other frames in flight, which GPU may still read, are not overwritten
+		for (uint32_t slot = 0; slot < numFrames; ++slot) {
+			for (uint32_t i = 0; i < framesViews[slot].size(); ++i) {
+				CHECK(shaderVisibleHeap[framesHeapIndexes[slot][i]] == framesViews[slot][i]);
+			}
+		}
+
+		// persistent views are never touched by ring
+		for (uint32_t i = 0; i < numPersistentViews; ++i) {
+			CHECK(shaderVisibleHeap[i] == 0);
+		}
+	}
+}
+
+int main() {
+	TestRemap();
+	TestTexturesTable();
+
+	std::printf("BindlessRemap tests passed\n");
+	return 0;
+}
\ No newline at end of file
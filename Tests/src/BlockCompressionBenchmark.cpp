@@ -0,0 +1,111 @@
+#include <MyD3D12Lib/BlockCompression.h>
+#include <MyD3D12Lib/MipGenerator.h>
+#include <MyD3D12Lib/ThreadPool.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// smooth color gradients with noise, hard pattern in blue, alpha gradient on right half
+std::vector<uint8_t> GenerateImage(uint32_t width, uint32_t height) {
+	std::mt19937 rng(33);
+	std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			uint8_t* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+
+			pixel[0] = static_cast<uint8_t>(128 + 100 * std::sin(x * 0.02) * std::cos(y * 0.015) + rng() % 9);
+			pixel[1] = static_cast<uint8_t>(128 + 90 * std::sin((x + y) * 0.01) + rng() % 7);
+			pixel[2] = static_cast<uint8_t>((x ^ y) & 0xff);
+			pixel[3] = static_cast<uint8_t>(x < width / 2 ? 255 : y * 255 / height);
+		}
+	}
+
+	return pixels;
+}
+
+// decoded block of constant color matches it within endpoint precision
+void CheckConstantBlocks() {
+	using EncodeFunction = void(*)(const uint8_t*, uint8_t*);
+	using DecodeFunction = void(*)(const uint8_t*, uint8_t*);
+
+	EncodeFunction encoders[] = { &EncodeBC1Block, &EncodeBC3Block, &EncodeBC5Block, &EncodeBC7Block };
+	DecodeFunction decoders[] = { &DecodeBC1Block, &DecodeBC3Block, &DecodeBC5Block, &DecodeBC7Block };
+	// BC1 and BC3 colors are 565, BC5 is exact, BC7 mode 6 shares p-bit by all channels of endpoint
+	int tolerances[] = { 4, 4, 0, 1 };
+	// channels stored in format
+	uint32_t numChannels[] = { 3, 4, 2, 4 };
+
+	uint8_t pixels[64];
+
+	for (uint32_t i = 0; i < 64; ++i) {
+		pixels[i] = i % 4 == 3 ? 200 : static_cast<uint8_t>(77 + 30 * (i % 4));
+	}
+
+	for (uint32_t format = 0; format < 4; ++format) {
+		uint8_t block[16];
+		uint8_t decoded[64];
+
+		encoders[format](pixels, block);
+		decoders[format](block, decoded);
+
+		for (uint32_t i = 0; i < 64; ++i) {
+			if (i % 4 < numChannels[format]) {
+				CHECK(std::abs(decoded[i] - pixels[i]) <= tolerances[format]);
+			}
+		}
+	}
+}
+
+// argument is side of texture, its full mip chain is compressed
+int main(int argc, char** argv) {
+	uint32_t side = GetScaleArgument(argc, argv, 1024);
+
+	CheckConstantBlocks();
+
+	std::vector<uint8_t> pixels = GenerateImage(side, side);
+	MipChain chain = GenerateMipChain(pixels.data(), side, side, side * 4, MipGenerationDesc());
+	double megapixels = chain.Data.size() / 4 * 1e-6;
+
+	ThreadPool pool;
+
+	const char* formatNames[] = { "BC1", "BC3", "BC5", "BC7" };
+	// minimal acceptable quality of smooth test image
+	float minPSNRs[] = { 30.0f, 30.0f, 35.0f, 35.0f };
+
+	std::printf("%ux%u mip chain, %.2f megapixels, %u threads\n", side, side, megapixels, pool.GetNumThreads());
+
+	for (uint32_t format = 0; format < 4; ++format) {
+		Stopwatch stopwatch;
+		CompressedMipChain serial = CompressMipChain(chain, static_cast<BlockFormat>(format));
+		double serialSeconds = stopwatch.GetSeconds();
+
+		stopwatch.Restart();
+		CompressedMipChain parallel = CompressMipChain(chain, static_cast<BlockFormat>(format), &pool);
+		double parallelSeconds = stopwatch.GetSeconds();
+
+		// blocks are independent, so parallel encoding gives the same bytes
+		CHECK(serial.Data == parallel.Data);
+		CHECK(serial.Levels.size() == chain.Levels.size());
+
+		float psnr = ComputeCompressionPSNR(chain, parallel);
+		CHECK(psnr >= minPSNRs[format]);
+
+		std::printf(
+			"%s: serial %.1f MP/s, parallel %.1f MP/s, PSNR %.2f dB, %.1f MB from %.1f MB\n",
+			formatNames[format],
+			megapixels / serialSeconds,
+			megapixels / parallelSeconds,
+			psnr,
+			parallel.Data.size() / 1048576.0,
+			chain.Data.size() / 1048576.0
+		);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include <MyD3D12Lib/CommandListPool.h>
+
+#include <TestUtils.h>
+
+#include <exception>
+#include <memory>
+#include <vector>
+
+// null backend, lists and allocators are reference counted handles as ComPtr of CommandQueue
+struct NullAllocator {
+	// fence value of submission which used allocator, UINT64_MAX while list is recorded
+	uint64_t FenceValue = 0;
+};
+
+using NullList = std::shared_ptr<uint32_t>;
+using NullAllocatorHandle = std::shared_ptr<NullAllocator>;
+
+// queue with simulated fence, GPU completes submissions with fixed lag
+class NullQueue {
+public:
+	NullList GetCommandList() {
+		NullAllocatorHandle allocator;
+		NullList list;
+
+		if (m_Pool.TakeAllocator(m_CompletedFenceValue, allocator)) {
+			// allocator is reset only after GPU finished its list
+			CHECK(allocator->FenceValue <= m_CompletedFenceValue);
+		}
+		else {
+			allocator = std::make_shared<NullAllocator>();
+			++m_NumCreatedAllocators;
+		}
+
+		if (!m_Pool.TakeList(list)) {
+			list = std::make_shared<uint32_t>(m_NumCreatedLists++);
+		}
+
+		allocator->FenceValue = UINT64_MAX;
+		m_Pool.Open(list, allocator);
+		m_RecordedAllocators.push_back(allocator);
+
+		return list;
+	}
+
+	// lists are checked before fence is signaled, as CommandQueue does before lists are executed
+	uint64_t ExecuteCommandLists(const NullList* lists, uint32_t numLists) {
+		m_Pool.Validate(lists, numLists);
+
+		uint64_t fenceValue = ++m_FenceValue;
+
+		for (const NullAllocatorHandle& allocator : m_RecordedAllocators) {
+			allocator->FenceValue = fenceValue;
+		}
+
+		m_RecordedAllocators.clear();
+		m_Pool.Submit(lists, numLists, fenceValue);
+
+		return fenceValue;
+	}
+
+	void CompleteUntil(uint64_t lag) {
+		m_CompletedFenceValue = m_FenceValue > lag ? m_FenceValue - lag : 0;
+	}
+
+	CommandListPool<NullList, NullAllocatorHandle>& GetPool() {
+		return m_Pool;
+	}
+
+	uint64_t GetFenceValue() const {
+		return m_FenceValue;
+	}
+
+	uint32_t GetNumCreatedAllocators() const {
+		return m_NumCreatedAllocators;
+	}
+
+	uint32_t GetNumCreatedLists() const {
+		return m_NumCreatedLists;
+	}
+
+private:
+	CommandListPool<NullList, NullAllocatorHandle> m_Pool;
+	std::vector<NullAllocatorHandle> m_RecordedAllocators;
+
+	uint64_t m_FenceValue = 0;
+	uint64_t m_CompletedFenceValue = 0;
+
+	uint32_t m_NumCreatedAllocators = 0;
+	uint32_t m_NumCreatedLists = 0;
+};
+
+// lists of frame are submitted one by one or all together, GPU is some frames behind
+void MeasureFrames(uint32_t numFrames, uint32_t numListsPerFrame, bool isBatched) {
+	const uint64_t FramesLag = 3;
+
+	NullQueue queue;
+	std::vector<NullList> lists;
+
+	Stopwatch stopwatch;
+
+	for (uint32_t frame = 0; frame < numFrames; ++frame) {
+		lists.clear();
+
+		for (uint32_t i = 0; i < numListsPerFrame; ++i) {
+			lists.push_back(queue.GetCommandList());
+		}
+
+		if (isBatched) {
+			queue.ExecuteCommandLists(lists.data(), numListsPerFrame);
+			queue.CompleteUntil(FramesLag);
+		}
+		else {
+			for (const NullList& list : lists) {
+				queue.ExecuteCommandLists(&list, 1);
+			}
+
+			queue.CompleteUntil(FramesLag * numListsPerFrame);
+		}
+
+		CHECK(queue.GetPool().GetNumOpenLists() == 0);
+	}
+
+	double time = stopwatch.GetSeconds();
+	const CommandListPool<NullList, NullAllocatorHandle>& pool = queue.GetPool();
+
+	CHECK(pool.GetNumSubmittedLists() == static_cast<uint64_t>(numFrames) * numListsPerFrame);
+	CHECK(pool.GetNumSubmissions() == (isBatched ? numFrames : static_cast<uint64_t>(numFrames) * numListsPerFrame));
+
+	// allocators of frames in flight are enough, lists are reused at once
+	CHECK(queue.GetNumCreatedAllocators() <= (FramesLag + 2) * numListsPerFrame);
+	CHECK(queue.GetNumCreatedLists() == numListsPerFrame);
+
+	std::printf(
+		"%s: %.1f ns per list, %llu signals, %u allocators and %u lists created, %u allocators waiting for GPU\n",
+		isBatched ? "batched" : "single ", time / (static_cast<double>(numFrames) * numListsPerFrame) * 1e9,
+		static_cast<unsigned long long>(queue.GetFenceValue()), queue.GetNumCreatedAllocators(), queue.GetNumCreatedLists(),
+		pool.GetNumSubmittedAllocators()
+	);
+}
+
+// submission with list which isn`t open is rejected and leaves queue as it was
+bool IsSubmissionRejected(NullQueue& queue, const NullList* lists, uint32_t numLists) {
+	uint64_t fenceValue = queue.GetFenceValue();
+	uint32_t numOpenLists = queue.GetPool().GetNumOpenLists();
+	uint32_t numFreeLists = queue.GetPool().GetNumFreeLists();
+	uint32_t numSubmittedAllocators = queue.GetPool().GetNumSubmittedAllocators();
+	uint64_t numSubmissions = queue.GetPool().GetNumSubmissions();
+
+	bool isThrown = false;
+
+	try {
+		queue.ExecuteCommandLists(lists, numLists);
+	}
+	catch (const std::exception&) {
+		isThrown = true;
+	}
+
+	CHECK(queue.GetFenceValue() == fenceValue);
+	CHECK(queue.GetPool().GetNumOpenLists() == numOpenLists);
+	CHECK(queue.GetPool().GetNumFreeLists() == numFreeLists);
+	CHECK(queue.GetPool().GetNumSubmittedAllocators() == numSubmittedAllocators);
+	CHECK(queue.GetPool().GetNumSubmissions() == numSubmissions);
+
+	return isThrown;
+}
+
+void CheckRejectedSubmissions() {
+	NullQueue queue;
+	NullList submitted = queue.GetCommandList();
+	NullList open = queue.GetCommandList();
+	queue.ExecuteCommandLists(&submitted, 1);
+
+	// submitted list is closed, it isn`t taken again yet
+	CHECK(queue.GetPool().GetNumFreeLists() == 1);
+
+	NullList foreign = std::make_shared<uint32_t>(100);
+
+	NullList withForeign[] = { open, foreign };
+	NullList withSubmitted[] = { open, submitted };
+	NullList twice[] = { open, open };
+
+	CHECK(queue.GetPool().GetNumOpenLists() == 1);
+	CHECK(IsSubmissionRejected(queue, withForeign, 2));
+	CHECK(IsSubmissionRejected(queue, withSubmitted, 2));
+	CHECK(IsSubmissionRejected(queue, twice, 2));
+
+	// open list is still submitted after rejected submissions
+	CHECK(queue.ExecuteCommandLists(&open, 1) == 2);
+	CHECK(queue.GetPool().GetNumOpenLists() == 0);
+	CHECK(queue.GetPool().GetNumSubmittedAllocators() == 2);
+}
+
+// argument is number of frames
+int main(int argc, char** argv) {
+	uint32_t numFrames = GetScaleArgument(argc, argv, 200000);
+	const uint32_t NumListsPerFrame = 8;
+
+	CheckRejectedSubmissions();
+
+	std::printf("%u frames, %u lists per frame\n", numFrames, NumListsPerFrame);
+	MeasureFrames(numFrames, NumListsPerFrame, false);
+	MeasureFrames(numFrames, NumListsPerFrame, true);
+
+	return 0;
+}
\ No newline at end of file
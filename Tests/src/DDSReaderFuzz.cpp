@@ -0,0 +1,184 @@
+#include <MyD3D12Lib/BlockCompression.h>
+#include <MyD3D12Lib/DDSFormat.h>
+#include <MyD3D12Lib/DDSReader.h>
+#include <MyD3D12Lib/DDSWriter.h>
+#include <MyD3D12Lib/MipGenerator.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+std::vector<uint8_t> BuildLegacyFile(const DDSPixelFormat& pixelFormat, uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t caps2, size_t dataSize) {
+	DDSHeader header = {};
+	header.Size = sizeof(DDSHeader);
+	header.Flags = DDSFlagCaps | DDSFlagHeight | DDSFlagWidth | DDSFlagPixelFormat | DDSFlagMipMapCount;
+	header.Width = width;
+	header.Height = height;
+	header.MipMapCount = mipLevels;
+	header.PixelFormat = pixelFormat;
+	header.PixelFormat.Size = sizeof(DDSPixelFormat);
+	header.Caps = DDSCapsTexture;
+	header.Caps2 = caps2;
+
+	std::vector<uint8_t> file(sizeof(DDSMagic) + sizeof(header) + dataSize, 0x5a);
+	std::memcpy(file.data(), &DDSMagic, sizeof(DDSMagic));
+	std::memcpy(file.data() + sizeof(DDSMagic), &header, sizeof(header));
+
+	return file;
+}
+
+DDSPixelFormat MakeFourCCFormat(uint32_t fourCC) {
+	DDSPixelFormat pixelFormat = {};
+	pixelFormat.Flags = DDSPixelFormatFourCC;
+	pixelFormat.FourCC = fourCC;
+
+	return pixelFormat;
+}
+
+DDSPixelFormat MakeMaskFormat(uint32_t flags, uint32_t bitCount, uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+	DDSPixelFormat pixelFormat = {};
+	pixelFormat.Flags = flags;
+	pixelFormat.RGBBitCount = bitCount;
+	pixelFormat.RBitMask = r;
+	pixelFormat.GBitMask = g;
+	pixelFormat.BBitMask = b;
+	pixelFormat.ABitMask = a;
+
+	return pixelFormat;
+}
+
+// files written by baking are parsed back with the same layout
+std::vector<std::vector<uint8_t>> BuildSeeds() {
+	std::vector<std::vector<uint8_t>> seeds;
+
+	std::vector<uint8_t> pixels(20 * 12 * 4, 7);
+	MipChain chain = GenerateMipChain(pixels.data(), 20, 12, 20 * 4, MipGenerationDesc());
+
+	for (BlockFormat format : { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC5, BlockFormat::BC7 }) {
+		CompressedMipChain compressed = CompressMipChain(chain, format);
+		std::vector<uint8_t> file = BuildDDSFile(compressed);
+
+		DDSTextureInfo info;
+		CHECK(ParseDDS(file.data(), file.size(), info));
+		CHECK(info.Format == static_cast<uint32_t>(GetBlockFormatDXGI(format)));
+		CHECK(info.Width == 20 && info.Height == 12 && info.ArraySize == 1 && !info.IsCubeMap);
+		CHECK(info.MipLevels == compressed.Levels.size() && info.Subresources.size() == compressed.Levels.size());
+
+		size_t dataOffset = sizeof(DDSMagic) + sizeof(DDSHeader) + sizeof(DDSHeaderDX10);
+
+		for (uint32_t i = 0; i < compressed.Levels.size(); ++i) {
+			CHECK(info.Subresources[i].Offset == dataOffset + compressed.Levels[i].Offset);
+			CHECK(info.Subresources[i].RowPitch == compressed.Levels[i].RowPitch);
+			CHECK(info.Subresources[i].NumRows == compressed.Levels[i].NumRows);
+		}
+
+		seeds.push_back(std::move(file));
+	}
+
+	seeds.push_back(BuildLegacyFile(MakeFourCCFormat(MakeDDSFourCC('D', 'X', 'T', '5')), 64, 32, 7, 0, 16 * 16 * 8 * 2));
+	seeds.push_back(BuildLegacyFile(MakeMaskFormat(DDSPixelFormatRGB | DDSPixelFormatAlphaPixels, 32, 0xff, 0xff00, 0xff0000, 0xff000000), 16, 16, 5, 0, 2000));
+	seeds.push_back(BuildLegacyFile(MakeFourCCFormat(MakeDDSFourCC('D', 'X', 'T', '1')), 8, 8, 1, DDSCaps2CubeMap | DDSCaps2CubeMapAllFaces, 6 * 32));
+	seeds.push_back(BuildLegacyFile(MakeMaskFormat(DDSPixelFormatLuminance, 8, 0xff, 0, 0, 0), 9, 7, 4, 0, 200));
+
+	// legacy seeds are valid too
+	for (size_t i = 4; i < seeds.size(); ++i) {
+		DDSTextureInfo info;
+		CHECK(ParseDDS(seeds[i].data(), seeds[i].size(), info));
+	}
+
+	DDSTextureInfo cubeInfo;
+	CHECK(ParseDDS(seeds[6].data(), seeds[6].size(), cubeInfo));
+	CHECK(cubeInfo.IsCubeMap && cubeInfo.ArraySize == 6 && cubeInfo.Subresources.size() == 6);
+
+	return seeds;
+}
+
+// accepted file has layout inside of data, so loader can point subresources into mapping
+void CheckParse(const std::vector<uint8_t>& file) {
+	// exact size copy, so reads past end are caught by sanitizers
+	std::unique_ptr<uint8_t[]> data(new uint8_t[std::max<size_t>(1, file.size())]);
+	std::memcpy(data.get(), file.data(), file.size());
+
+	DDSTextureInfo info;
+
+	if (!ParseDDS(data.get(), file.size(), info)) {
+		CHECK(info.Subresources.empty());
+		return;
+	}
+
+	CHECK(info.Width > 0 && info.Height > 0 && info.MipLevels > 0 && info.ArraySize > 0);
+	CHECK(info.Subresources.size() == static_cast<size_t>(info.MipLevels) * info.ArraySize);
+
+	for (const DDSSubresourceLayout& subresource : info.Subresources) {
+		CHECK(subresource.SlicePitch == static_cast<uint64_t>(subresource.RowPitch) * subresource.NumRows);
+		CHECK(subresource.Offset <= file.size() && subresource.SlicePitch <= file.size() - subresource.Offset);
+		CHECK(subresource.Width > 0 && subresource.Height > 0);
+
+		if (subresource.SlicePitch > 0) {
+			KeepResult(data[subresource.Offset] + data[subresource.Offset + subresource.SlicePitch - 1]);
+		}
+	}
+}
+
+// argument is number of mutated files
+int main(int argc, char** argv) {
+	uint32_t numIterations = GetScaleArgument(argc, argv, 1000000);
+
+	std::vector<std::vector<uint8_t>> seeds = BuildSeeds();
+
+	// values near limits of dimensions, array sizes and mips, and overflowing ones
+	const uint32_t interestingValues[] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 15, 16, 0xff, 0x100, 2048, 2049, 16384, 16385, 0x7fff, 0xffff, 0x7fffffff, 0x80000000, 0xffffffff
+	};
+
+	const size_t headersSize = sizeof(DDSMagic) + sizeof(DDSHeader) + sizeof(DDSHeaderDX10);
+
+	std::mt19937 rng(35);
+	uint32_t numAccepted = 0;
+
+	for (uint32_t i = 0; i < numIterations; ++i) {
+		std::vector<uint8_t> file = seeds[rng() % seeds.size()];
+		uint32_t numMutations = 1 + rng() % 4;
+
+		for (uint32_t m = 0; m < numMutations; ++m) {
+			switch (rng() % 4) {
+			case 0:
+				if (!file.empty()) {
+					file[rng() % file.size()] ^= 1 << (rng() % 8);
+				}
+				break;
+			case 1:
+				if (file.size() >= 4) {
+					size_t offset = (rng() % std::min(file.size() - 3, headersSize)) & ~size_t(3);
+					uint32_t value = interestingValues[rng() % std::size(interestingValues)];
+					std::memcpy(&file[offset], &value, sizeof(value));
+				}
+				break;
+			case 2:
+				file.resize(rng() % (file.size() + 1));
+				break;
+			default:
+				if (!file.empty()) {
+					file[rng() % std::min(file.size(), headersSize)] = static_cast<uint8_t>(rng());
+				}
+				break;
+			}
+		}
+
+		CheckParse(file);
+
+		DDSTextureInfo info;
+		numAccepted += ParseDDS(file.data(), file.size(), info);
+	}
+
+	DDSTextureInfo info;
+	CHECK(!ParseDDS(nullptr, 0, info));
+
+	std::printf("DDS fuzzing: %u files, %u accepted\n", numIterations, numAccepted);
+	return 0;
+}
\ No newline at end of file
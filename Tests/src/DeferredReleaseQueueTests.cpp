@@ -0,0 +1,159 @@
+#include <MyD3D12Lib/DeferredReleaseQueue.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// object used by GPU until its fence value is completed, counts objects which are alive and released too early
+class TrackedObject {
+public:
+	TrackedObject(uint64_t fenceValue, const std::atomic<uint64_t>& completedFenceValue, std::atomic<int32_t>& numAlive, std::atomic<uint32_t>& numEarlyReleases) :
+		m_FenceValue(fenceValue),
+		m_CompletedFenceValue(completedFenceValue),
+		m_NumAlive(numAlive),
+		m_NumEarlyReleases(numEarlyReleases)
+	{
+		m_NumAlive.fetch_add(1);
+	}
+
+	~TrackedObject() {
+		if (m_CompletedFenceValue.load() < m_FenceValue) {
+			m_NumEarlyReleases.fetch_add(1);
+		}
+
+		m_NumAlive.fetch_sub(1);
+	}
+
+private:
+	uint64_t m_FenceValue;
+	const std::atomic<uint64_t>& m_CompletedFenceValue;
+	std::atomic<int32_t>& m_NumAlive;
+	std::atomic<uint32_t>& m_NumEarlyReleases;
+};
+
+void TestReleaseOrder() {
+	DeferredReleaseQueue queue;
+	std::vector<uint32_t> released;
+
+	// fence values can come in any order, objects of one fence value are released in order of pushing
+	queue.Push(2, [&]() { released.push_back(0); });
+	queue.Push(1, [&]() { released.push_back(1); });
+	queue.Push(2, [&]() { released.push_back(2); });
+	queue.Push(3, [&]() { released.push_back(3); });
+
+	CHECK(queue.GetNumPending() == 0);
+	CHECK(queue.ReleaseCompleted(0) == 0);
+	CHECK(queue.GetNumPending() == 4);
+
+	CHECK(queue.ReleaseCompleted(1) == 1);
+	CHECK((released == std::vector<uint32_t>{ 1 }));
+
+	queue.Push(1, [&]() { released.push_back(4); });
+	CHECK(queue.ReleaseCompleted(2) == 3);
+	CHECK((released == std::vector<uint32_t>{ 1, 0, 2, 4 }));
+	CHECK(queue.GetNumPending() == 1);
+
+	CHECK(queue.ReleaseAll() == 1);
+	CHECK(queue.GetNumPending() == 0);
+	CHECK(queue.GetNumReleased() == 5);
+}
+
+void TestReleaseOnDestruction() {
+	std::atomic<uint64_t> completedFenceValue{ 0 };
+	std::atomic<int32_t> numAlive{ 0 };
+	std::atomic<uint32_t> numEarlyReleases{ 0 };
+
+	{
+		DeferredReleaseQueue queue;
+
+		for (uint64_t i = 0; i < 10; ++i) {
+			auto object = std::make_shared<TrackedObject>(0, completedFenceValue, numAlive, numEarlyReleases);
+			queue.Push(i, [object]() mutable { object.reset(); });
+		}
+
+		// the last reference is owned by release function
+		CHECK(numAlive.load() == 10);
+		queue.ReleaseCompleted(4);
+		CHECK(numAlive.load() == 5);
+	}
+
+	CHECK(numAlive.load() == 0);
+	CHECK(numEarlyReleases.load() == 0);
+}
+
+// producers push objects with fence value of last submitted frame while releasing thread advances simulated fence
+// no object is released before GPU finishes frames which can use it, all of them are released at the end
+void TestConcurrentProducers(uint32_t seed) {
+	const uint32_t NumProducers = 4;
+	const uint32_t NumPushes = 2000;
+	const uint32_t NumFrames = 3000;
+
+	std::atomic<uint64_t> submittedFenceValue{ 0 };
+	std::atomic<uint64_t> completedFenceValue{ 0 };
+	std::atomic<int32_t> numAlive{ 0 };
+	std::atomic<uint32_t> numEarlyReleases{ 0 };
+
+	DeferredReleaseQueue queue;
+	std::vector<std::thread> producers;
+
+	for (uint32_t i = 0; i < NumProducers; ++i) {
+		producers.emplace_back([&, i]() {
+			std::mt19937 rng(seed * NumProducers + i);
+
+			for (uint32_t j = 0; j < NumPushes; ++j) {
+				uint64_t fenceValue = submittedFenceValue.load();
+				auto object = std::make_shared<TrackedObject>(fenceValue, completedFenceValue, numAlive, numEarlyReleases);
+				queue.Push(fenceValue, [object]() mutable { object.reset(); });
+
+				if (rng() % 8 == 0) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	// GPU is at most three frames behind
+	std::mt19937 rng(seed);
+	uint64_t numReleased = 0;
+
+	for (uint32_t frame = 0; frame < NumFrames; ++frame) {
+		uint64_t submitted = submittedFenceValue.fetch_add(1) + 1;
+		uint64_t completed = completedFenceValue.load();
+
+		if (completed + 3 < submitted || rng() % 2 == 0) {
+			completedFenceValue.store(std::min(submitted, completed + 1 + rng() % 2));
+		}
+
+		numReleased += queue.ReleaseCompleted(completedFenceValue.load());
+	}
+
+	for (std::thread& producer : producers) {
+		producer.join();
+	}
+
+	completedFenceValue.store(submittedFenceValue.load());
+	numReleased += queue.ReleaseCompleted(completedFenceValue.load());
+
+	CHECK(numReleased == NumProducers * NumPushes);
+	CHECK(queue.GetNumReleased() == numReleased);
+	CHECK(queue.GetNumPending() == 0);
+	CHECK(numAlive.load() == 0);
+	CHECK(numEarlyReleases.load() == 0);
+}
+
+int main() {
+	TestReleaseOrder();
+	TestReleaseOnDestruction();
+
+	for (uint32_t seed = 0; seed < 20; ++seed) {
+		TestConcurrentProducers(seed);
+	}
+
+	std::printf("DeferredReleaseQueue tests passed\n");
+	return 0;
+}
\ No newline at end of file
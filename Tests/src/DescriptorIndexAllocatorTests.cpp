@@ -0,0 +1,230 @@
+#include <MyD3D12Lib/DescriptorIndexAllocator.h>
+
+#include <TestUtils.h>
+
+#include <random>
+#include <vector>
+
+void TestBasic() {
+	DescriptorIndexAllocator allocator(16, 64);
+
+	DescriptorRange a = allocator.Allocate(10);
+	DescriptorRange b = allocator.Allocate(54);
+
+	CHECK(a.IsValid() && a.Index == 16 && a.Count == 10);
+	CHECK(b.IsValid() && b.Index == 26);
+	CHECK(!allocator.Allocate(1).IsValid());
+
+	// deferred range stays used until its fence is completed
+	allocator.Free(a, 5);
+	CHECK(!a.IsValid() && a.Index == DescriptorIndexAllocator::InvalidIndex);
+	CHECK(allocator.GetNumUsed() == 64 && allocator.GetNumPending() == 10 && allocator.GetNumAllocations() == 1);
+	CHECK(!allocator.Allocate(1).IsValid());
+
+	CHECK(allocator.ReleaseCompleted(4) == 0);
+	CHECK(allocator.ReleaseCompleted(5) == 10);
+	CHECK(allocator.GetNumUsed() == 54 && allocator.GetNumPending() == 0);
+
+	allocator.Free(b);
+	CHECK(allocator.GetNumUsed() == 0 && allocator.GetNumAllocations() == 0);
+}
+
+struct PendingRange {
+	uint64_t FenceValue;
+	uint32_t Index;
+	uint32_t Count;
+};
+
+// random allocations, immediate and deferred frees are compared with owner of each descriptor
+void TestChurn(uint32_t seed) {
+	std::mt19937 rng(seed);
+
+	for (uint32_t round = 0; round < 20; ++round) {
+		const uint32_t firstIndex = 100 + round;
+		const uint32_t numDescriptors = 1 + rng() % 5000;
+
+		DescriptorIndexAllocator allocator(firstIndex, numDescriptors);
+
+		const uint32_t noOwner = UINT32_MAX;
+		std::vector<uint32_t> owners(numDescriptors, noOwner);
+		std::vector<DescriptorRange> ranges;
+		std::vector<PendingRange> pendingRanges;
+
+		uint64_t fenceValue = 0;
+		uint32_t numRanges = 0;
+		uint32_t numUsed = 0;
+		uint32_t numPending = 0;
+
+		for (uint32_t step = 0; step < 50000; ++step) {
+			uint32_t operation = rng() % 10;
+
+			if (operation < 5) {
+				uint32_t count = 1 + (rng() % 4 == 0 ? rng() % 64 : rng() % 4);
+				DescriptorRange range = allocator.Allocate(count);
+
+				if (!range.IsValid()) {
+					CHECK(range.Index == DescriptorIndexAllocator::InvalidIndex);
+					continue;
+				}
+
+				CHECK(range.Count == count);
+				CHECK(range.Index >= firstIndex && range.Index + count <= firstIndex + numDescriptors);
+
+				// descriptors aren`t given out while they are used or wait for fence
+				for (uint32_t i = 0; i < count; ++i) {
+					CHECK(owners[range.Index - firstIndex + i] == noOwner);
+					owners[range.Index - firstIndex + i] = numRanges;
+				}
+
+				ranges.push_back(range);
+				++numRanges;
+				numUsed += count;
+			}
+			else if (operation < 8 && !ranges.empty()) {
+				size_t r = rng() % ranges.size();
+				DescriptorRange range = ranges[r];
+				ranges[r] = ranges.back();
+				ranges.pop_back();
+
+				uint32_t index = range.Index;
+				uint32_t count = range.Count;
+				uint64_t freeFenceValue = rng() % 2 == 0 ? 0 : fenceValue + 1 + rng() % 3;
+
+				allocator.Free(range, freeFenceValue);
+				CHECK(!range.IsValid());
+
+				if (freeFenceValue == 0) {
+					for (uint32_t i = 0; i < count; ++i) {
+						owners[index - firstIndex + i] = noOwner;
+					}
+
+					numUsed -= count;
+				}
+				else {
+					pendingRanges.push_back({ freeFenceValue, index, count });
+					numPending += count;
+				}
+			}
+			else {
+				// GPU can lag behind by one fence
+				++fenceValue;
+				uint64_t completedFenceValue = fenceValue - rng() % 2;
+
+				uint32_t numReleased = 0;
+
+				for (size_t i = 0; i < pendingRanges.size();) {
+					const PendingRange& pending = pendingRanges[i];
+
+					if (pending.FenceValue > completedFenceValue) {
+						++i;
+						continue;
+					}
+
+					for (uint32_t j = 0; j < pending.Count; ++j) {
+						owners[pending.Index - firstIndex + j] = noOwner;
+					}
+
+					numReleased += pending.Count;
+					pendingRanges[i] = pendingRanges.back();
+					pendingRanges.pop_back();
+				}
+
+				CHECK(allocator.ReleaseCompleted(completedFenceValue) == numReleased);
+
+				numUsed -= numReleased;
+				numPending -= numReleased;
+			}
+
+			CHECK(allocator.GetNumUsed() == numUsed);
+			CHECK(allocator.GetNumPending() == numPending);
+			CHECK(allocator.GetNumAllocations() == ranges.size());
+		}
+
+		for (DescriptorRange& range : ranges) {
+			allocator.Free(range);
+		}
+
+		allocator.ReleaseCompleted(UINT64_MAX);
+
+		// free ranges are merged back, so whole heap can be allocated again
+		CHECK(allocator.GetNumUsed() == 0 && allocator.GetNumPending() == 0 && allocator.GetNumAllocations() == 0);
+		CHECK(allocator.GetFragmentation() == 0.0f);
+
+		DescriptorRange all = allocator.Allocate(numDescriptors);
+		CHECK(all.IsValid() && all.Index == firstIndex);
+	}
+}
+
+void TestRing() {
+	DescriptorRing ring(10, 8, 3);
+
+	for (uint32_t frame = 0; frame < 9; ++frame) {
+		ring.BeginFrame(frame % 3);
+
+		uint32_t firstIndex = 10 + (frame % 3) * 8;
+
+		CHECK(ring.Allocate(3) == firstIndex);
+		CHECK(ring.Allocate(5) == firstIndex + 3);
+		CHECK(ring.Allocate(1) == DescriptorIndexAllocator::InvalidIndex);
+		CHECK(ring.GetNumUsed() == 8);
+	}
+
+	// failed allocation doesn`t use descriptors
+	ring.BeginFrame(1);
+	CHECK(ring.Allocate(9) == DescriptorIndexAllocator::InvalidIndex);
+	CHECK(ring.Allocate(8) == 18);
+}
+
+// each frame fills its partition by random counts, descriptors of other frames in flight are never touched
+void TestRingChurn() {
+	std::mt19937 rng(42);
+
+	const uint32_t firstIndex = 7;
+	const uint32_t numDescriptorsPerFrame = 300;
+	const uint32_t numFrames = 3;
+
+	DescriptorRing ring(firstIndex, numDescriptorsPerFrame, numFrames);
+	std::vector<uint32_t> writtenFrames(numDescriptorsPerFrame * numFrames, UINT32_MAX);
+
+	for (uint32_t frame = 0; frame < 3000; ++frame) {
+		uint32_t partition = frame % numFrames;
+		ring.BeginFrame(partition);
+
+		uint32_t numUsed = 0;
+
+		for (uint32_t i = 0; i < 100; ++i) {
+			uint32_t count = 1 + rng() % 16;
+			uint32_t index = ring.Allocate(count);
+
+			if (numUsed + count > numDescriptorsPerFrame) {
+				CHECK(index == DescriptorIndexAllocator::InvalidIndex);
+				continue;
+			}
+
+			CHECK(index == firstIndex + partition * numDescriptorsPerFrame + numUsed);
+
+			// previous writer is this partition in earlier frame, which is finished on GPU
+			for (uint32_t j = 0; j < count; ++j) {
+				uint32_t& writtenFrame = writtenFrames[index - firstIndex + j];
+
+				CHECK(writtenFrame == UINT32_MAX || writtenFrame + numFrames <= frame);
+				CHECK(writtenFrame == UINT32_MAX || writtenFrame % numFrames == partition);
+				writtenFrame = frame;
+			}
+
+			numUsed += count;
+			CHECK(ring.GetNumUsed() == numUsed);
+		}
+	}
+}
+
+int main() {
+	TestBasic();
+	TestChurn(42);
+	TestChurn(43);
+	TestRing();
+	TestRingChurn();
+
+	std::printf("DescriptorIndexAllocator tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include <MyD3D12Lib/FramePacer.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// fence value of frame is its index plus one
+void TestWaitFenceValues() {
+	// throughput mode waits for previous frame of the slot
+	FramePacer throughput(3);
+
+	for (uint64_t frame = 0; frame < 10; ++frame) {
+		CHECK(throughput.GetFrameSlot() == frame % 3);
+		CHECK(throughput.GetWaitFenceValue() == (frame >= 3 ? frame - 2 : 0));
+		throughput.EndFrame(frame + 1);
+	}
+
+	// latency mode keeps one frame less in flight
+	FramePacer latency(3, FramePacingMode::Latency);
+
+	for (uint64_t frame = 0; frame < 10; ++frame) {
+		CHECK(latency.GetFrameSlot() == frame % 3);
+		CHECK(latency.GetWaitFenceValue() == (frame >= 2 ? frame - 1 : 0));
+		CHECK(latency.GetFirstUnfinishedFrame() == (frame >= 2 ? frame - 1 : 0));
+		latency.EndFrame(frame + 1);
+	}
+
+	// with two frames in flight CPU waits for previous frame, with one frame it always does
+	FramePacer two(2, FramePacingMode::Latency);
+	FramePacer one(1, FramePacingMode::Latency);
+
+	for (uint64_t frame = 0; frame < 10; ++frame) {
+		CHECK(two.GetWaitFenceValue() == frame);
+		CHECK(one.GetWaitFenceValue() == frame);
+		CHECK(one.GetFrameSlot() == 0);
+		two.EndFrame(frame + 1);
+		one.EndFrame(frame + 1);
+	}
+}
+
+void TestModeSwitch() {
+	FramePacer pacer(4);
+
+	for (uint64_t frame = 0; frame < 6; ++frame) {
+		pacer.EndFrame(frame + 1);
+	}
+
+	CHECK(pacer.GetWaitFenceValue() == 3);
+	CHECK(pacer.GetFirstUnfinishedFrame() == 3);
+
+	// the next frame waits by new mode, slots are kept
+	pacer.SetMode(FramePacingMode::Latency);
+	CHECK(pacer.GetMode() == FramePacingMode::Latency);
+	CHECK(pacer.GetWaitFenceValue() == 4);
+	CHECK(pacer.GetFirstUnfinishedFrame() == 4);
+	CHECK(pacer.GetFrameSlot() == 2);
+
+	pacer.SetMode(FramePacingMode::Throughput);
+	CHECK(pacer.GetWaitFenceValue() == 3);
+	CHECK(pacer.GetNumFrames() == 6);
+}
+
+struct TimelineResult {
+	double FrameTime;
+	double Latency;
+	uint64_t NumStalls;
+	double StallTime;
+};
+
+// GPU executes frames in order of submission, CPU records frame after waiting for fence value from pacer
+// frame resources of slot shouldn`t be written while GPU still executes frame which used them
+TimelineResult SimulateTimeline(uint32_t numFramesInFlight, FramePacingMode mode, double cpuTime, double gpuTime, uint32_t seed) {
+	const uint32_t NumFrames = 2000;
+
+	FramePacer pacer(numFramesInFlight, mode);
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> jitter(0.0, 1.0);
+
+	std::vector<double> gpuFinishTimes;
+	std::vector<uint32_t> slots;
+	double cpuTimeline = 0.0;
+	double gpuTimeline = 0.0;
+	double latency = 0.0;
+
+	for (uint32_t frame = 0; frame < NumFrames; ++frame) {
+		uint64_t waitFenceValue = pacer.GetWaitFenceValue();
+		double readyTime = waitFenceValue > 0 ? gpuFinishTimes[waitFenceValue - 1] : 0.0;
+
+		if (readyTime > cpuTimeline) {
+			pacer.AddStall(readyTime - cpuTimeline);
+			cpuTimeline = readyTime;
+		}
+
+		uint32_t slot = pacer.GetFrameSlot();
+
+		for (uint32_t previous = 0; previous < frame; ++previous) {
+			CHECK(slots[previous] != slot || gpuFinishTimes[previous] <= cpuTimeline);
+		}
+
+		// frames before first unfinished one are done, so their resources can be evicted
+		uint64_t firstUnfinishedFrame = pacer.GetFirstUnfinishedFrame();
+
+		for (uint64_t previous = 0; previous < std::min<uint64_t>(firstUnfinishedFrame, frame); ++previous) {
+			CHECK(gpuFinishTimes[previous] <= cpuTimeline);
+		}
+
+		// queued frames including recorded one don`t exceed limit of mode
+		uint32_t numQueuedFrames = 1;
+
+		for (uint32_t previous = 0; previous < frame; ++previous) {
+			numQueuedFrames += gpuFinishTimes[previous] > cpuTimeline ? 1 : 0;
+		}
+
+		uint32_t maxQueuedFrames = mode == FramePacingMode::Latency ? std::max(numFramesInFlight - 1, 1u) : numFramesInFlight;
+		CHECK(numQueuedFrames <= maxQueuedFrames);
+
+		double recordStart = cpuTimeline;
+		cpuTimeline += cpuTime + jitter(rng);
+
+		gpuTimeline = std::max(gpuTimeline, cpuTimeline) + gpuTime + jitter(rng);
+		gpuFinishTimes.push_back(gpuTimeline);
+		slots.push_back(slot);
+
+		// from start of recording, when input is read, to end of frame on GPU
+		latency += gpuTimeline - recordStart;
+
+		pacer.EndFrame(frame + 1);
+	}
+
+	return { gpuTimeline / NumFrames, latency / NumFrames, pacer.GetNumStalls(), pacer.GetStallTime() / NumFrames };
+}
+
+void TestSimulatedTimeline() {
+	const double CpuTimes[] = { 4.0, 10.0, 7.0 };
+	const double GpuTimes[] = { 10.0, 4.0, 7.0 };
+
+	for (uint32_t numFramesInFlight = 1; numFramesInFlight <= 4; ++numFramesInFlight) {
+		for (uint32_t i = 0; i < 3; ++i) {
+			TimelineResult throughput = SimulateTimeline(numFramesInFlight, FramePacingMode::Throughput, CpuTimes[i], GpuTimes[i], i);
+			TimelineResult latency = SimulateTimeline(numFramesInFlight, FramePacingMode::Latency, CpuTimes[i], GpuTimes[i], i);
+
+			std::printf(
+				"%u frames in flight, CPU %2.0f ms, GPU %2.0f ms: throughput frame %.2f ms, latency %.2f ms, stall %.2f ms in %llu stalls | latency mode frame %.2f ms, latency %.2f ms, stall %.2f ms in %llu stalls\n",
+				numFramesInFlight, CpuTimes[i], GpuTimes[i],
+				throughput.FrameTime, throughput.Latency, throughput.StallTime, static_cast<unsigned long long>(throughput.NumStalls),
+				latency.FrameTime, latency.Latency, latency.StallTime, static_cast<unsigned long long>(latency.NumStalls)
+			);
+
+			// latency mode never queues more frames, so input is never older
+			CHECK(latency.Latency <= throughput.Latency + 1e-6);
+
+			if (numFramesInFlight == 1) {
+				CHECK(latency.FrameTime == throughput.FrameTime);
+			}
+
+			// GPU bound frames are queued in throughput mode, latency mode drops one of them
+			if (numFramesInFlight >= 2 && GpuTimes[i] > CpuTimes[i] + 1.0) {
+				CHECK(latency.Latency < throughput.Latency - 0.5 * GpuTimes[i]);
+			}
+
+			// with two frames in flight latency mode doesn`t overlap CPU and GPU, so CPU waits for whole frame
+			if (numFramesInFlight == 2) {
+				CHECK(latency.StallTime > throughput.StallTime + 0.5 * std::min(CpuTimes[i], GpuTimes[i]));
+				CHECK(latency.FrameTime > throughput.FrameTime);
+			}
+
+			// with three frames in flight latency mode still overlaps CPU and GPU
+			if (numFramesInFlight >= 3) {
+				CHECK(latency.FrameTime < throughput.FrameTime * 1.05);
+			}
+
+			// CPU bound frames don`t stall in throughput mode if there are two slots
+			if (numFramesInFlight >= 2 && CpuTimes[i] > GpuTimes[i] + 1.0) {
+				CHECK(throughput.NumStalls == 0);
+			}
+		}
+	}
+}
+
+int main() {
+	TestWaitFenceValues();
+	TestModeSwitch();
+	TestSimulatedTimeline();
+
+	std::printf("FramePacer tests passed\n");
+	return 0;
+}
\ No newline at end of file
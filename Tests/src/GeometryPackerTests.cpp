@@ -0,0 +1,158 @@
+#include <MyD3D12Lib/GeometryPacker.h>
+
+#include <TestUtils.h>
+
+#include <random>
+
+void TestPoolChoice() {
+	CHECK(GeometryPacker::ChoosePool(1) == IndexPool::Index16);
+	CHECK(GeometryPacker::ChoosePool(GeometryPacker::MaxIndex16Vertexes) == IndexPool::Index16);
+	CHECK(GeometryPacker::ChoosePool(GeometryPacker::MaxIndex16Vertexes + 1) == IndexPool::Index32);
+
+	CHECK(GeometryPacker::GetIndexByteStride(IndexPool::Index16) == 2);
+	CHECK(GeometryPacker::GetIndexByteStride(IndexPool::Index32) == 4);
+}
+
+void TestAlignment() {
+	GeometryPacker packer(4, 8, 16);
+
+	PackedMesh a = packer.AddMesh(3, 5);
+	PackedMesh b = packer.AddMesh(6, 9);
+	PackedMesh c = packer.AddMesh(1, 1);
+
+	CHECK(a.BaseVertexLocation == 0 && a.StartIndexLocation == 0);
+	CHECK(b.BaseVertexLocation == 4 && b.StartIndexLocation == 8);
+	CHECK(c.BaseVertexLocation == 12 && c.StartIndexLocation == 24);
+
+	CHECK(packer.GetNumVertexes() == 13);
+	CHECK(packer.GetNumIndexes(IndexPool::Index16) == 25);
+	CHECK(packer.GetMeshes().size() == 3);
+}
+
+void TestPoolsAreIndependent() {
+	GeometryPacker packer;
+
+	PackedMesh small = packer.AddMesh(100, 300);
+	PackedMesh big = packer.AddMesh(GeometryPacker::MaxIndex16Vertexes + 1, 600);
+	PackedMesh forced = packer.AddMesh(10, 30, IndexPool::Index32);
+
+	CHECK(small.Pool == IndexPool::Index16 && small.StartIndexLocation == 0);
+	CHECK(big.Pool == IndexPool::Index32 && big.StartIndexLocation == 0);
+	CHECK(forced.Pool == IndexPool::Index32 && forced.StartIndexLocation == 600);
+
+	// vertexes are shared by both pools
+	CHECK(big.BaseVertexLocation == 100);
+	CHECK(forced.BaseVertexLocation == 100 + GeometryPacker::MaxIndex16Vertexes + 1);
+
+	CHECK(packer.GetNumIndexes(IndexPool::Index16) == 300);
+	CHECK(packer.GetNumIndexes(IndexPool::Index32) == 630);
+}
+
+void TestGrowth() {
+	GeometryPacker packer(1, 1, 64);
+
+	packer.AddMesh(10, 10);
+	CHECK(packer.CheckAndResetGrown());
+	CHECK(packer.GetVertexCapacity() == 64);
+	CHECK(packer.GetIndexCapacity(IndexPool::Index16) == 64);
+	CHECK(packer.GetIndexCapacity(IndexPool::Index32) == 0);
+
+	packer.AddMesh(50, 50);
+	CHECK(!packer.CheckAndResetGrown());
+
+	// capacity grows by half or to required size if it is bigger
+	packer.AddMesh(10, 10);
+	CHECK(packer.CheckAndResetGrown());
+	CHECK(packer.GetVertexCapacity() == 96);
+
+	packer.AddMesh(1000, 10);
+	CHECK(packer.CheckAndResetGrown());
+	CHECK(packer.GetVertexCapacity() == 1070);
+	CHECK(packer.GetIndexCapacity(IndexPool::Index16) == 96);
+}
+
+void TestReserveAndReset() {
+	GeometryPacker packer(1, 1, 64);
+
+	packer.Reserve(1000, 2000, 3000);
+	CHECK(packer.CheckAndResetGrown());
+
+	packer.AddMesh(600, 1500);
+	packer.AddMesh(400, 500);
+	packer.AddMesh(GeometryPacker::MaxIndex16Vertexes + 1, 3000);
+	CHECK(packer.GetIndexCapacity(IndexPool::Index16) == 2000);
+	CHECK(packer.GetIndexCapacity(IndexPool::Index32) == 3000);
+
+	// reserved vertexes are exceeded only by the big mesh
+	CHECK(packer.CheckAndResetGrown());
+
+	// capacity is kept, so same meshes are packed again without growth
+	uint32_t vertexCapacity = packer.GetVertexCapacity();
+	packer.Reset();
+
+	CHECK(packer.GetNumVertexes() == 0 && packer.GetMeshes().empty());
+
+	packer.AddMesh(600, 1500);
+	CHECK(!packer.CheckAndResetGrown());
+	CHECK(packer.GetVertexCapacity() == vertexCapacity);
+
+	// smaller reserve doesn`t shrink capacity
+	packer.Reserve(10, 10, 10);
+	CHECK(!packer.CheckAndResetGrown());
+}
+
+void TestRandomMeshesDontOverlap() {
+	std::mt19937 rng(26);
+
+	for (uint32_t run = 0; run < 100; ++run) {
+		uint32_t vertexAlignment = 1 + rng() % 8;
+		uint32_t indexAlignment = 1 + rng() % 8;
+		GeometryPacker packer(vertexAlignment, indexAlignment, rng() % 256);
+
+		uint32_t numMeshes = 1 + rng() % 50;
+
+		for (uint32_t i = 0; i < numMeshes; ++i) {
+			uint32_t numVertexes = 1 + (rng() % 4 == 0 ? rng() % 200000 : rng() % 1000);
+			packer.AddMesh(numVertexes, 3 * (1 + rng() % 3000));
+		}
+
+		const std::vector<PackedMesh>& meshes = packer.GetMeshes();
+		uint32_t vertexEnd = 0;
+		uint32_t indexEnd[static_cast<uint32_t>(IndexPool::Count)] = {};
+
+		for (const PackedMesh& mesh : meshes) {
+			uint32_t pool = static_cast<uint32_t>(mesh.Pool);
+
+			CHECK(mesh.Pool == GeometryPacker::ChoosePool(mesh.VertexCount));
+			CHECK(mesh.BaseVertexLocation % vertexAlignment == 0);
+			CHECK(mesh.StartIndexLocation % indexAlignment == 0);
+
+			// meshes are placed in order, so each one starts after previous one of its pool
+			CHECK(mesh.BaseVertexLocation >= vertexEnd);
+			CHECK(mesh.StartIndexLocation >= indexEnd[pool]);
+
+			vertexEnd = mesh.BaseVertexLocation + mesh.VertexCount;
+			indexEnd[pool] = mesh.StartIndexLocation + mesh.IndexCount;
+		}
+
+		CHECK(vertexEnd == packer.GetNumVertexes());
+		CHECK(vertexEnd <= packer.GetVertexCapacity());
+
+		for (uint32_t pool = 0; pool < static_cast<uint32_t>(IndexPool::Count); ++pool) {
+			CHECK(indexEnd[pool] == packer.GetNumIndexes(static_cast<IndexPool>(pool)));
+			CHECK(indexEnd[pool] <= packer.GetIndexCapacity(static_cast<IndexPool>(pool)));
+		}
+	}
+}
+
+int main() {
+	TestPoolChoice();
+	TestAlignment();
+	TestPoolsAreIndependent();
+	TestGrowth();
+	TestReserveAndReset();
+	TestRandomMeshesDontOverlap();
+
+	std::printf("GeometryPacker tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include <MyD3D12Lib/LinearAllocator.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+// constant buffer views need 256 byte alignment
+const uint64_t ConstantsAlignment = 256;
+
+void TestConstantsAlignment() {
+	LinearAllocator allocator(64 * 1024);
+
+	uint64_t end = 0;
+
+	for (uint64_t size : { 64ull, 200ull, 256ull, 300ull, 16ull, 512ull, 1ull }) {
+		LinearAllocation allocation = allocator.Allocate(size, ConstantsAlignment);
+
+		CHECK(allocation.IsValid() && allocation.Page == 0);
+		CHECK(allocation.Offset % ConstantsAlignment == 0 && allocation.Offset >= end);
+
+		end = allocation.Offset + size;
+	}
+
+	// used size includes padding between allocations
+	CHECK(allocator.GetUsedSize() == end);
+	CHECK(end == 6 * 256 + 512 + 1);
+}
+
+void TestOverflowPaging() {
+	LinearAllocator allocator(1024);
+
+	LinearAllocation a = allocator.Allocate(100, ConstantsAlignment);
+	LinearAllocation b = allocator.Allocate(10, ConstantsAlignment);
+	CHECK(a.Page == 0 && a.Offset == 0);
+	CHECK(b.Page == 0 && b.Offset == 256);
+
+	// 512 + 700 doesn`t fit, rest of page is wasted and allocation starts next one
+	LinearAllocation c = allocator.Allocate(700, ConstantsAlignment);
+	CHECK(c.Page == 1 && c.Offset == 0);
+	CHECK(allocator.GetNumPages() == 2);
+	CHECK(allocator.GetUsedSize() == 1024 + 700);
+
+	// whole page allocation
+	LinearAllocation d = allocator.Allocate(1024, ConstantsAlignment);
+	CHECK(d.Page == 2 && d.Offset == 0);
+
+	// small allocation fits after padding
+	LinearAllocation e = allocator.Allocate(16, 16);
+	CHECK(e.Page == 3 && e.Offset == 0);
+	LinearAllocation f = allocator.Allocate(16, 16);
+	CHECK(f.Page == 3 && f.Offset == 16);
+}
+
+void TestFenceGatedReset() {
+	LinearAllocator allocator(1024);
+
+	allocator.Allocate(600, ConstantsAlignment);
+	allocator.Allocate(600, ConstantsAlignment);
+	allocator.Allocate(1024, ConstantsAlignment);
+	allocator.Retire(5);
+
+	CHECK(allocator.GetUsedSize() == 0 && allocator.GetNumFreePages() == 0);
+
+	// pages of unfinished frame are not reused
+	allocator.ReleaseCompleted(4);
+	CHECK(allocator.GetNumFreePages() == 0);
+
+	LinearAllocation a = allocator.Allocate(16, ConstantsAlignment);
+	CHECK(a.Page == 3 && a.Offset == 0);
+
+	allocator.ReleaseCompleted(5);
+	CHECK(allocator.GetNumFreePages() == 3);
+
+	// frame without allocations retires only its current page
+	allocator.Retire(6);
+	allocator.Retire(7);
+	allocator.ReleaseCompleted(7);
+	CHECK(allocator.GetNumFreePages() == 4 && allocator.GetNumPages() == 4);
+
+	// reused page starts from beginning
+	LinearAllocation b = allocator.Allocate(16, ConstantsAlignment);
+	CHECK(b.Offset == 0 && b.Page < 4);
+	CHECK(allocator.GetNumPages() == 4);
+}
+
+// frames in flight: pages of frames which are not finished on GPU are never given out
+void TestFramesInFlight(uint32_t seed) {
+	std::mt19937 rng(seed);
+
+	for (uint32_t round = 0; round < 50; ++round) {
+		const uint64_t pageSize = 4096ull << (rng() % 5);
+		const uint64_t numFramesInFlight = 1 + rng() % 3;
+
+		LinearAllocator allocator(pageSize);
+
+		// fence value of the last frame which used page
+		std::map<uint32_t, uint64_t> pagesFenceValues;
+		uint64_t fenceValue = 0;
+		uint64_t completedFenceValue = 0;
+
+		for (uint32_t frame = 0; frame < 2000; ++frame) {
+			// app waits for frame which used the same frame resources, GPU may be one more frame ahead
+			if (fenceValue >= numFramesInFlight) {
+				completedFenceValue = std::max(completedFenceValue, fenceValue - numFramesInFlight + 1 - rng() % 2);
+			}
+
+			allocator.ReleaseCompleted(completedFenceValue);
+
+			std::map<uint32_t, std::vector<std::pair<uint64_t, uint64_t>>> pagesRanges;
+			uint32_t numAllocations = rng() % 300;
+
+			for (uint32_t i = 0; i < numAllocations; ++i) {
+				uint64_t size = 1 + rng() % (rng() % 8 == 0 ? pageSize : 512);
+				uint64_t alignment = rng() % 4 == 0 ? 16 : ConstantsAlignment;
+
+				LinearAllocation allocation = allocator.Allocate(size, alignment);
+
+				CHECK(allocation.IsValid());
+				CHECK(allocation.Offset % alignment == 0 && allocation.Offset + size <= pageSize);
+
+				auto fence = pagesFenceValues.find(allocation.Page);
+				CHECK(fence == pagesFenceValues.end() || fence->second <= completedFenceValue);
+
+				std::vector<std::pair<uint64_t, uint64_t>>& ranges = pagesRanges[allocation.Page];
+
+				for (const std::pair<uint64_t, uint64_t>& range : ranges) {
+					CHECK(allocation.Offset >= range.second || allocation.Offset + size <= range.first);
+				}
+
+				ranges.emplace_back(allocation.Offset, allocation.Offset + size);
+			}
+
+			++fenceValue;
+
+			for (const auto& pageRanges : pagesRanges) {
+				pagesFenceValues[pageRanges.first] = fenceValue;
+			}
+
+			allocator.Retire(fenceValue);
+		}
+
+		// pages are recycled, so their number is bounded by pages of frames in flight
+		CHECK(allocator.GetNumPages() <= (numFramesInFlight + 1) * (300 * 512 / pageSize + 40));
+	}
+}
+
+int main() {
+	TestConstantsAlignment();
+	TestOverflowPaging();
+	TestFenceGatedReset();
+	TestFramesInFlight(43);
+
+	std::printf("LinearAllocator tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include <MyD3D12Lib/MeshSplitter.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// size of Vertex of apps, used for memory footprint report
+const uint32_t VertexByteSize = 32;
+
+// chunks reproduce source triangles in original order and each chunk is addressable by 16 bit indexes
+void CheckChunks(const std::vector<MeshChunk>& chunks, const std::vector<uint32_t>& indexes, uint32_t numVertexes, uint32_t maxChunkVertexes) {
+	std::vector<uint32_t> lastChunk(numVertexes, UINT32_MAX);
+	uint32_t position = 0;
+
+	for (uint32_t c = 0; c < chunks.size(); ++c) {
+		const MeshChunk& chunk = chunks[c];
+
+		CHECK(!chunk.Indexes.empty() && chunk.Indexes.size() % 3 == 0);
+		CHECK(chunk.Vertexes.size() <= maxChunkVertexes);
+
+		// each vertex is stored once per chunk
+		for (uint32_t vertex : chunk.Vertexes) {
+			CHECK(vertex < numVertexes);
+			CHECK(lastChunk[vertex] != c);
+			lastChunk[vertex] = c;
+		}
+
+		// vertexes are in order of first use, so index is at most one bigger than previous maximum
+		uint32_t maxIndex = 0;
+
+		for (uint16_t index : chunk.Indexes) {
+			CHECK(index < chunk.Vertexes.size());
+			CHECK(index <= maxIndex + 1 || (maxIndex == 0 && index == 0));
+			maxIndex = std::max<uint32_t>(maxIndex, index);
+
+			CHECK(chunk.Vertexes[index] == indexes[position]);
+			++position;
+		}
+
+		// chunk is started only when next triangle doesn`t fit in previous one
+		if (c + 1 < chunks.size()) {
+			const uint16_t* next = chunks[c + 1].Indexes.data();
+			uint32_t numNewVertexes = 0;
+
+			for (uint32_t k = 0; k < 3; ++k) {
+				uint32_t vertex = chunks[c + 1].Vertexes[next[k]];
+				bool isRepeated = (k > 0 && next[k] == next[0]) || (k > 1 && next[k] == next[1]);
+				numNewVertexes += lastChunk[vertex] != c && !isRepeated;
+			}
+
+			CHECK(chunk.Vertexes.size() + numNewVertexes > maxChunkVertexes);
+		}
+	}
+
+	CHECK(position == indexes.size());
+}
+
+// grid of width x height vertexes, two triangles per quad in row order
+std::vector<uint32_t> GenerateGrid(uint32_t width, uint32_t height) {
+	std::vector<uint32_t> indexes;
+	indexes.reserve(6 * static_cast<size_t>(width - 1) * (height - 1));
+
+	for (uint32_t y = 0; y + 1 < height; ++y) {
+		for (uint32_t x = 0; x + 1 < width; ++x) {
+			uint32_t a = y * width + x;
+			uint32_t b = a + 1;
+			uint32_t c = a + width;
+			uint32_t d = c + 1;
+
+			indexes.insert(indexes.end(), { a, c, b, b, c, d });
+		}
+	}
+
+	return indexes;
+}
+
+void TestSmallMesh() {
+	// strip of four triangles over six vertexes
+	std::vector<uint32_t> indexes = { 0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5 };
+	std::vector<MeshChunk> chunks = SplitMesh(indexes.data(), 12, 6, 4);
+
+	CHECK(chunks.size() == 2);
+	CHECK((chunks[0].Vertexes == std::vector<uint32_t>{ 0, 1, 2, 3 }));
+	CHECK((chunks[0].Indexes == std::vector<uint16_t>{ 0, 1, 2, 2, 1, 3 }));
+
+	// shared edge is duplicated in second chunk
+	CHECK((chunks[1].Vertexes == std::vector<uint32_t>{ 2, 3, 4, 5 }));
+	CHECK((chunks[1].Indexes == std::vector<uint16_t>{ 0, 1, 2, 2, 1, 3 }));
+
+	CheckChunks(chunks, indexes, 6, 4);
+}
+
+void TestDegenerateTriangles() {
+	// repeated vertexes of triangle are counted once, so triangle fits in full chunk
+	std::vector<uint32_t> indexes = { 0, 1, 2, 3, 3, 3, 0, 4, 4 };
+	std::vector<MeshChunk> chunks = SplitMesh(indexes.data(), 9, 5, 4);
+
+	CHECK(chunks.size() == 2);
+	CHECK(chunks[0].Vertexes.size() == 4);
+	CHECK((chunks[1].Vertexes == std::vector<uint32_t>{ 0, 4 }));
+
+	CheckChunks(chunks, indexes, 5, 4);
+}
+
+void TestEmptyAndSmallMeshes() {
+	CHECK(SplitMesh(nullptr, 0, 0).empty());
+
+	// mesh which fits in 16 bit indexes stays one chunk without duplicates
+	std::vector<uint32_t> indexes = GenerateGrid(100, 100);
+	std::vector<MeshChunk> chunks = SplitMesh(indexes.data(), static_cast<uint32_t>(indexes.size()), 10000);
+
+	CHECK(chunks.size() == 1);
+	CHECK(chunks[0].Vertexes.size() == 10000);
+
+	CheckChunks(chunks, indexes, 10000, 1u << 16);
+}
+
+void TestRandomMeshes() {
+	std::mt19937 rng(29);
+
+	for (uint32_t run = 0; run < 50; ++run) {
+		uint32_t numVertexes = 3 + rng() % 5000;
+		uint32_t maxChunkVertexes = 3 + rng() % 300;
+		std::vector<uint32_t> indexes(3 * (1 + rng() % 5000));
+
+		// mix of local and random triangles
+		for (uint32_t i = 0; i < indexes.size(); ++i) {
+			indexes[i] = rng() % 4 == 0 ? rng() % numVertexes : (i / 3 + rng() % 8) % numVertexes;
+		}
+
+		std::vector<MeshChunk> chunks = SplitMesh(indexes.data(), static_cast<uint32_t>(indexes.size()), numVertexes, maxChunkVertexes);
+		CheckChunks(chunks, indexes, numVertexes, maxChunkVertexes);
+	}
+}
+
+void ReportLargeMesh(const char* name, const std::vector<uint32_t>& indexes, uint32_t numVertexes) {
+	Stopwatch stopwatch;
+	std::vector<MeshChunk> chunks = SplitMesh(indexes.data(), static_cast<uint32_t>(indexes.size()), numVertexes);
+	double seconds = stopwatch.GetSeconds();
+
+	CheckChunks(chunks, indexes, numVertexes, 1u << 16);
+
+	size_t numChunkVertexes = 0;
+
+	for (const MeshChunk& chunk : chunks) {
+		numChunkVertexes += chunk.Vertexes.size();
+	}
+
+	size_t sourceBytes = static_cast<size_t>(numVertexes) * VertexByteSize + indexes.size() * sizeof(uint32_t);
+	size_t splitBytes = numChunkVertexes * VertexByteSize + indexes.size() * sizeof(uint16_t);
+
+	std::printf(
+		"%s: %u vertexes, %zu triangles split in %zu chunks in %.1f ms, %.2f%% vertexes duplicated, %.1f MB with 32 bit indexes, %.1f MB split\n",
+		name,
+		numVertexes,
+		indexes.size() / 3,
+		chunks.size(),
+		seconds * 1e3,
+		100.0 * (numChunkVertexes - numVertexes) / numVertexes,
+		sourceBytes / 1048576.0,
+		splitBytes / 1048576.0
+	);
+}
+
+// argument is number of vertexes of synthetic meshes
+void TestLargeMeshes(uint32_t numVertexes) {
+	uint32_t width = 2000;
+	uint32_t height = std::max(2u, numVertexes / width);
+
+	// grid in row order has good locality, few vertexes are duplicated
+	std::vector<uint32_t> grid = GenerateGrid(width, height);
+	ReportLargeMesh("grid", grid, width * height);
+
+	// triangles in random order are worst case, split still has to be correct
+	std::vector<uint32_t> shuffled(grid.size());
+	std::vector<uint32_t> order(grid.size() / 3);
+
+	for (uint32_t i = 0; i < order.size(); ++i) {
+		order[i] = i;
+	}
+
+	std::shuffle(order.begin(), order.end(), std::mt19937(290));
+
+	for (uint32_t i = 0; i < order.size(); ++i) {
+		std::copy(grid.begin() + 3 * order[i], grid.begin() + 3 * order[i] + 3, shuffled.begin() + 3 * i);
+	}
+
+	ReportLargeMesh("shuffled grid", shuffled, width * height);
+}
+
+int main(int argc, char** argv) {
+	TestSmallMesh();
+	TestDegenerateTriangles();
+	TestEmptyAndSmallMeshes();
+	TestRandomMeshes();
+	TestLargeMeshes(GetScaleArgument(argc, argv, 3000000));
+
+	std::printf("MeshSplitter tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include <MyD3D12Lib/CpuFeatures.h>
+#include <MyD3D12Lib/MipGenerator.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using GenerateFunction = MipChain(*)(const uint8_t*, uint32_t, uint32_t, uint32_t, const MipGenerationDesc&, uint32_t);
+
+// best of several runs, throughput in source megapixels per second
+double MeasureGeneration(GenerateFunction generate, const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, const MipGenerationDesc& desc, MipChain& mips) {
+	double bestTime = 1e30;
+
+	for (uint32_t run = 0; run < 3; ++run) {
+		Stopwatch stopwatch;
+		mips = generate(pixels.data(), width, height, width * 4, desc, 0);
+		bestTime = std::min(bestTime, stopwatch.GetSeconds());
+
+		KeepResult(mips.Data.back());
+	}
+
+	return static_cast<double>(width) * height / bestTime * 1e-6;
+}
+
+// smooth gradients with noise, like photo textures, alpha is mostly opaque with cut out holes
+std::vector<uint8_t> GenerateImage(uint32_t width, uint32_t height) {
+	std::mt19937 rng(32);
+	std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			uint8_t* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+
+			pixel[0] = static_cast<uint8_t>(x * 255 / width + rng() % 16);
+			pixel[1] = static_cast<uint8_t>(y * 255 / height + rng() % 16);
+			pixel[2] = static_cast<uint8_t>(rng());
+			pixel[3] = rng() % 8 == 0 ? 0 : 255;
+		}
+	}
+
+	return pixels;
+}
+
+void RunCase(const char* name, uint32_t width, uint32_t height, const MipGenerationDesc& desc) {
+	std::vector<uint8_t> pixels = GenerateImage(width, height);
+
+	MipChain simdMips;
+	MipChain scalarMips;
+
+	double scalar = MeasureGeneration(&GenerateMipChainScalar, pixels, width, height, desc, scalarMips);
+	double simd = MeasureGeneration(&GenerateMipChain, pixels, width, height, desc, simdMips);
+
+	// SIMD path differs from scalar reference only by rounding
+	CHECK(simdMips.Levels.size() == scalarMips.Levels.size());
+	CHECK(simdMips.Data.size() == scalarMips.Data.size());
+
+	int maxDifference = 0;
+
+	for (size_t i = 0; i < simdMips.Data.size(); ++i) {
+		maxDifference = std::max(maxDifference, std::abs(simdMips.Data[i] - scalarMips.Data[i]));
+	}
+
+	CHECK(maxDifference <= 1);
+
+	std::printf(
+		"%-28s %5ux%-5u scalar %7.1f MP/s, SIMD %7.1f MP/s, x%.2f, max difference %d\n",
+		name, width, height, scalar, simd, simd / scalar, maxDifference
+	);
+}
+
+// argument is side of power of two image, non power of two image is a bit smaller
+int main(int argc, char** argv) {
+	uint32_t side = GetScaleArgument(argc, argv, 2048);
+	uint32_t oddWidth = side - side / 4 + 1;
+	uint32_t oddHeight = side / 2 + 3;
+
+	std::printf("AVX2 %s\n", IsAVX2Supported() ? "supported" : "not supported");
+
+	MipGenerationDesc desc;
+
+	desc.Filter = MipFilter::Box;
+	RunCase("box sRGB", side, side, desc);
+	RunCase("box sRGB", oddWidth, oddHeight, desc);
+
+	desc.Filter = MipFilter::Kaiser;
+	RunCase("kaiser sRGB", side, side, desc);
+	RunCase("kaiser sRGB", oddWidth, oddHeight, desc);
+
+	desc.IsSRGB = false;
+	RunCase("kaiser linear", side, side, desc);
+
+	desc.IsSRGB = true;
+	desc.AlphaCoverageReference = 0.5f;
+	RunCase("kaiser sRGB alpha coverage", side, side, desc);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <MyD3D12Lib/MipStreaming.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// sizes of BC1 mips from finest one down to 1x1
+std::vector<uint64_t> GetBC1MipsSizes(uint32_t size) {
+	std::vector<uint64_t> sizes;
+
+	for (uint32_t side = size; ; side /= 2) {
+		uint64_t numBlocks = std::max(1u, (side + 3) / 4);
+		sizes.push_back(numBlocks * numBlocks * 8);
+
+		if (side == 1) {
+			break;
+		}
+	}
+
+	return sizes;
+}
+
+// scene like Sponza atrium: render items along long hall share textures of different sizes
+struct Scene {
+	std::vector<uint32_t> TextureSizes;
+	std::vector<uint32_t> ItemTextures;
+	std::vector<float> ItemsX;
+	std::vector<float> ItemsZ;
+	std::vector<float> ItemsRadiuses;
+	std::vector<float> ItemsUVDensities;
+};
+
+Scene GenerateScene(uint32_t numTextures, uint32_t numItems) {
+	std::mt19937 rng(370);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	Scene scene;
+	scene.TextureSizes.resize(numTextures);
+
+	for (uint32_t& size : scene.TextureSizes) {
+		size = 256u << (rng() % 4);
+	}
+
+	for (uint32_t i = 0; i < numItems; ++i) {
+		scene.ItemTextures.push_back(rng() % numTextures);
+		scene.ItemsX.push_back(unit(rng) * 60.0f - 30.0f);
+		scene.ItemsZ.push_back(unit(rng) * 20.0f - 10.0f);
+		scene.ItemsRadiuses.push_back(0.5f + unit(rng) * 3.0f);
+		scene.ItemsUVDensities.push_back(0.1f + unit(rng) * 0.5f);
+	}
+
+	return scene;
+}
+
+struct PathResult {
+	uint64_t PeakResidentSize = 0;
+	uint64_t NumMipChanges = 0;
+	uint64_t StreamedInSize = 0;
+	double SolveSeconds = 0.0;
+	double EstimateSeconds = 0.0;
+};
+
+// camera walks along hall with small shaking, required mips are estimated each frame
+PathResult RunCameraPath(const Scene& scene, uint32_t numFrames, uint64_t budget, float hysteresis) {
+	uint32_t numTextures = static_cast<uint32_t>(scene.TextureSizes.size());
+	MipBudgetSolver solver(numTextures, budget, hysteresis);
+
+	for (uint32_t id = 0; id < numTextures; ++id) {
+		// BC textures can`t start from mip smaller than block
+		uint32_t maxFirstMip = static_cast<uint32_t>(std::log2(scene.TextureSizes[id])) - 2;
+		solver.SetTextureMips(id, GetBC1MipsSizes(scene.TextureSizes[id]), maxFirstMip);
+	}
+
+	const float tanHalfFoV = std::tan(0.3927f);
+
+	PathResult result;
+	std::vector<uint32_t> previousFirstMips(numTextures, 0);
+	std::vector<float> requiredMips(numTextures);
+
+	for (uint32_t frame = 0; frame < numFrames; ++frame) {
+		float t = static_cast<float>(frame) / numFrames;
+		float cameraX = -28.0f + 56.0f * t + 0.3f * std::sin(frame * 0.7f);
+		float cameraZ = 2.0f * std::sin(t * 20.0f);
+
+		Stopwatch stopwatch;
+
+		// finest mip over all render items which use texture
+		std::fill(requiredMips.begin(), requiredMips.end(), FLT_MAX);
+
+		for (uint32_t i = 0; i < scene.ItemTextures.size(); ++i) {
+			float dx = scene.ItemsX[i] - cameraX;
+			float dz = scene.ItemsZ[i] - cameraZ;
+			float distance = std::max(std::sqrt(dx * dx + dz * dz) - scene.ItemsRadiuses[i], 0.1f);
+
+			uint32_t id = scene.ItemTextures[i];
+			float requiredMip = ComputeRequiredMip(scene.ItemsUVDensities[i], static_cast<float>(scene.TextureSizes[id]), distance, 1080.0f, tanHalfFoV);
+			requiredMips[id] = std::min(requiredMips[id], requiredMip);
+		}
+
+		result.EstimateSeconds += stopwatch.GetSeconds();
+		stopwatch.Restart();
+
+		const std::vector<uint32_t>& firstMips = solver.Solve(requiredMips);
+
+		result.SolveSeconds += stopwatch.GetSeconds();
+
+		CHECK(solver.GetResidentSize() <= budget);
+		result.PeakResidentSize = std::max(result.PeakResidentSize, solver.GetResidentSize());
+
+		for (uint32_t id = 0; id < numTextures; ++id) {
+			if (firstMips[id] == previousFirstMips[id]) {
+				continue;
+			}
+
+			++result.NumMipChanges;
+
+			if (firstMips[id] < previousFirstMips[id]) {
+				std::vector<uint64_t> sizes = GetBC1MipsSizes(scene.TextureSizes[id]);
+
+				for (uint32_t mip = firstMips[id]; mip < previousFirstMips[id]; ++mip) {
+					result.StreamedInSize += sizes[mip];
+				}
+			}
+
+			previousFirstMips[id] = firstMips[id];
+		}
+	}
+
+	return result;
+}
+
+// argument is number of frames of camera path
+int main(int argc, char** argv) {
+	uint32_t numFrames = GetScaleArgument(argc, argv, 2000);
+
+	Scene scene = GenerateScene(70, 400);
+
+	uint64_t allMipsSize = 0;
+
+	for (uint32_t size : scene.TextureSizes) {
+		std::vector<uint64_t> sizes = GetBC1MipsSizes(size);
+
+		for (uint64_t mipSize : sizes) {
+			allMipsSize += mipSize;
+		}
+	}
+
+	std::printf("%zu textures, %zu render items, all mips %.1f MB, %u frames\n",
+		scene.TextureSizes.size(), scene.ItemTextures.size(), allMipsSize / 1048576.0, numFrames);
+
+	for (uint64_t budgetDivisor : { 1ull, 4ull }) {
+		for (float hysteresis : { 0.0f, 0.5f }) {
+			uint64_t budget = allMipsSize / budgetDivisor;
+			PathResult result = RunCameraPath(scene, numFrames, budget, hysteresis);
+
+			std::printf(
+				"budget %.1f MB, hysteresis %.1f: peak %.1f MB, %llu mip changes, %.1f MB streamed in, estimate %.2f us, solve %.2f us per frame\n",
+				budget / 1048576.0,
+				hysteresis,
+				result.PeakResidentSize / 1048576.0,
+				static_cast<unsigned long long>(result.NumMipChanges),
+				result.StreamedInSize / 1048576.0,
+				result.EstimateSeconds / numFrames * 1e6,
+				result.SolveSeconds / numFrames * 1e6
+			);
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include <MyD3D12Lib/MipStreaming.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// sizes of BC1 mips from finest one down to 1x1
+std::vector<uint64_t> GetBC1MipsSizes(uint32_t size) {
+	std::vector<uint64_t> sizes;
+
+	for (uint32_t side = size; ; side /= 2) {
+		uint64_t numBlocks = std::max(1u, (side + 3) / 4);
+		sizes.push_back(numBlocks * numBlocks * 8);
+
+		if (side == 1) {
+			break;
+		}
+	}
+
+	return sizes;
+}
+
+void TestUVDensity() {
+	// 2x2 quad mapped to whole texture, and degenerate triangle which is skipped
+	float positions[] = { 0, 0, 0, 2, 0, 0, 2, 2, 0, 0, 2, 0, 5, 5, 5 };
+	float texCoords[] = { 0, 0, 1, 0, 1, 1, 0, 1, 0, 0 };
+	uint32_t indexes[] = { 0, 1, 2, 0, 2, 3, 0, 4, 4 };
+
+	CHECK(std::fabs(ComputeMeshUVDensity(positions, 3, texCoords, 2, indexes, 9) - 0.5f) < 1e-6f);
+	CHECK(ComputeMeshUVDensity(positions, 3, texCoords, 2, indexes + 6, 3) == 0.0f);
+	CHECK(ComputeMeshUVDensity(positions, 3, texCoords, 2, indexes, 0) == 0.0f);
+
+	// density doesn`t depend on tessellation, interleaved strides are supported
+	const uint32_t gridSize = 17;
+	std::vector<float> vertexes;
+	std::vector<uint32_t> gridIndexes;
+
+	for (uint32_t y = 0; y < gridSize; ++y) {
+		for (uint32_t x = 0; x < gridSize; ++x) {
+			float u = static_cast<float>(x) / (gridSize - 1);
+			float v = static_cast<float>(y) / (gridSize - 1);
+
+			// position, norm, texture coordinates, 10 units side mapped to 0.25 of texture
+			vertexes.insert(vertexes.end(), { 10.0f * u, 0.0f, 10.0f * v, 0.0f, 1.0f, 0.0f, 0.25f * u, 0.25f * v });
+		}
+	}
+
+	for (uint32_t y = 0; y + 1 < gridSize; ++y) {
+		for (uint32_t x = 0; x + 1 < gridSize; ++x) {
+			uint32_t a = y * gridSize + x;
+			gridIndexes.insert(gridIndexes.end(), { a, a + gridSize, a + 1, a + 1, a + gridSize, a + gridSize + 1 });
+		}
+	}
+
+	float density = ComputeMeshUVDensity(vertexes.data(), 8, vertexes.data() + 6, 8, gridIndexes.data(), static_cast<uint32_t>(gridIndexes.size()));
+	CHECK(std::fabs(density - 0.025f) < 1e-6f);
+}
+
+void TestRequiredMip() {
+	// 1024 texels over 2 units, 90 degrees FoV on 1080 pixels covers 540 pixels per unit at distance 1
+	float mip = ComputeRequiredMip(0.5f, 1024.0f, 1.0f, 1080.0f, 1.0f);
+	CHECK(std::fabs(mip - std::log2(512.0f / 540.0f)) < 1e-5f);
+
+	// each doubling of distance or texture size, or halving of screen takes one mip coarser
+	CHECK(std::fabs(ComputeRequiredMip(0.5f, 1024.0f, 8.0f, 1080.0f, 1.0f) - mip - 3.0f) < 1e-4f);
+	CHECK(std::fabs(ComputeRequiredMip(0.5f, 1024.0f, 1.0f, 540.0f, 1.0f) - mip - 1.0f) < 1e-4f);
+	CHECK(std::fabs(ComputeRequiredMip(0.5f, 2048.0f, 1.0f, 1080.0f, 1.0f) - mip - 1.0f) < 1e-4f);
+
+	CHECK(ComputeRequiredMip(0.0f, 1024.0f, 1.0f, 1080.0f, 1.0f) == FLT_MAX);
+
+	// camera inside of item needs finest mip
+	CHECK(ComputeRequiredMip(0.5f, 1024.0f, 0.0f, 1080.0f, 1.0f) < 0.0f);
+}
+
+void TestHysteresis() {
+	MipBudgetSolver solver(3, UINT64_MAX, 0.5f);
+	std::vector<float> requiredMips = { 1.2f, FLT_MAX, -INFINITY };
+
+	solver.Solve(requiredMips);
+	CHECK(!solver.HasMips(0));
+	CHECK(solver.GetResidentSize() == 0);
+
+	// new textures start from required mip clamped to their range
+	solver.SetTextureMips(0, GetBC1MipsSizes(1024), 8);
+	solver.SetTextureMips(1, GetBC1MipsSizes(1024), 8);
+	solver.SetTextureMips(2, GetBC1MipsSizes(256), 6);
+
+	CHECK(solver.GetFirstMip(0) == 1);
+	CHECK(solver.GetFirstMip(1) == 8);
+	CHECK(solver.GetFirstMip(2) == 0);
+
+	// mip is dropped only when required mip is coarser by hysteresis, finer mips are streamed in at once
+	requiredMips[0] = 2.3f;
+	CHECK(solver.Solve(requiredMips)[0] == 1);
+
+	requiredMips[0] = 2.6f;
+	CHECK(solver.Solve(requiredMips)[0] == 2);
+
+	requiredMips[0] = 2.4f;
+	CHECK(solver.Solve(requiredMips)[0] == 2);
+
+	requiredMips[0] = 1.9f;
+	CHECK(solver.Solve(requiredMips)[0] == 1);
+
+	requiredMips[0] = 6.0f;
+	CHECK(solver.Solve(requiredMips)[0] == 5);
+
+	requiredMips[0] = 100.0f;
+	CHECK(solver.Solve(requiredMips)[0] == 8);
+}
+
+void TestBudget() {
+	MipBudgetSolver solver(3, UINT64_MAX, 0.5f);
+
+	solver.SetTextureMips(0, GetBC1MipsSizes(1024), 8);
+	solver.SetTextureMips(1, GetBC1MipsSizes(1024), 8);
+	solver.SetTextureMips(2, GetBC1MipsSizes(256), 6);
+
+	std::vector<float> requiredMips = { 0.0f, 0.0f, 0.0f };
+	solver.Solve(requiredMips);
+
+	uint64_t fullSize = solver.GetResidentSize();
+	uint64_t expectedFullSize = 0;
+
+	for (uint32_t size : { 1024u, 1024u, 256u }) {
+		std::vector<uint64_t> sizes = GetBC1MipsSizes(size);
+
+		for (uint64_t mipSize : sizes) {
+			expectedFullSize += mipSize;
+		}
+	}
+
+	CHECK(fullSize == expectedFullSize);
+
+	// least under resolved mips are dropped first, small texture keeps all of them
+	solver.SetBudget(fullSize / 2);
+	requiredMips = { 0.0f, 0.9f, 0.0f };
+	solver.Solve(requiredMips);
+
+	CHECK(solver.GetResidentSize() <= fullSize / 2);
+	CHECK(solver.GetFirstMip(0) == 1 && solver.GetFirstMip(1) == 1 && solver.GetFirstMip(2) == 0);
+
+	// unused textures are dropped before used ones
+	requiredMips = { 0.0f, FLT_MAX, 0.0f };
+	solver.SetBudget(fullSize * 3 / 4);
+	solver.Solve(requiredMips);
+
+	CHECK(solver.GetFirstMip(1) == 8);
+	CHECK(solver.GetFirstMip(0) == 0 && solver.GetFirstMip(2) == 0);
+
+	// budget can`t go below coarsest allowed mips
+	solver.SetBudget(0);
+	solver.Solve(requiredMips);
+	CHECK(solver.GetFirstMip(0) == 8 && solver.GetFirstMip(1) == 8 && solver.GetFirstMip(2) == 6);
+}
+
+// any required mips give first mips in range which fit in budget, if it is reachable
+void TestRandomBudgets() {
+	std::mt19937 rng(37);
+	std::uniform_real_distribution<float> mip(-2.0f, 12.0f);
+
+	for (uint32_t run = 0; run < 200; ++run) {
+		uint32_t numTextures = 1 + rng() % 40;
+		MipBudgetSolver solver(numTextures, UINT64_MAX, 0.5f * (rng() % 3));
+
+		uint64_t minSize = 0;
+		uint64_t maxSize = 0;
+		std::vector<uint32_t> maxFirstMips(numTextures);
+
+		for (uint32_t id = 0; id < numTextures; ++id) {
+			std::vector<uint64_t> sizes = GetBC1MipsSizes(16u << (rng() % 8));
+			maxFirstMips[id] = static_cast<uint32_t>(sizes.size()) - 3;
+			solver.SetTextureMips(id, sizes, maxFirstMips[id]);
+
+			for (uint32_t m = 0; m < sizes.size(); ++m) {
+				maxSize += sizes[m];
+				minSize += m >= maxFirstMips[id] ? sizes[m] : 0;
+			}
+		}
+
+		for (uint32_t frame = 0; frame < 20; ++frame) {
+			uint64_t budget = minSize + rng() % (maxSize - minSize + 1);
+			solver.SetBudget(budget);
+
+			std::vector<float> requiredMips(numTextures);
+
+			for (float& requiredMip : requiredMips) {
+				requiredMip = rng() % 10 == 0 ? FLT_MAX : mip(rng);
+			}
+
+			const std::vector<uint32_t>& firstMips = solver.Solve(requiredMips);
+
+			CHECK(solver.GetResidentSize() <= budget);
+
+			for (uint32_t id = 0; id < numTextures; ++id) {
+				CHECK(firstMips[id] <= maxFirstMips[id]);
+			}
+		}
+	}
+}
+
+int main() {
+	TestUVDensity();
+	TestRequiredMip();
+	TestHysteresis();
+	TestBudget();
+	TestRandomBudgets();
+
+	std::printf("MipStreaming tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <MyD3D12Lib/MipGenerator.h>
+#include <MyD3D12Lib/OrderedPipeline.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+struct DecodedImage {
+	MipChain Mips;
+	size_t FileSize = 0;
+};
+
+std::vector<uint8_t> ReadFileBytes(const std::filesystem::path& fileName) {
+	std::ifstream file(fileName, std::ios::binary);
+	CHECK(file);
+
+	std::vector<uint8_t> data(std::filesystem::file_size(fileName));
+	file.read(reinterpret_cast<char*>(data.data()), data.size());
+
+	return data;
+}
+
+// WIC decoders are Windows only, so decode stage is emulated by portable work of similar shape:
+// file bytes are expanded to RGBA8 image four times bigger and its mip chain is generated
+DecodedImage DecodeImage(const std::vector<uint8_t>& fileData) {
+	const uint32_t width = 1024;
+	uint32_t height = std::max<uint32_t>(1, static_cast<uint32_t>(fileData.size() / width));
+
+	std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+
+	for (size_t i = 0; i < pixels.size(); ++i) {
+		pixels[i] = fileData.empty() ? 0 : fileData[(i / 4) % fileData.size()];
+	}
+
+	DecodedImage image;
+	image.Mips = GenerateMipChain(pixels.data(), width, height, width * 4, MipGenerationDesc());
+	image.FileSize = fileData.size();
+
+	return image;
+}
+
+// directory isn`t given, so images are emulated by files of random bytes
+std::filesystem::path CreateSyntheticImages(uint32_t numFiles) {
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / "OrderedPipelineBenchmark";
+	std::filesystem::create_directories(folder);
+
+	std::mt19937 rng(31);
+
+	for (uint32_t i = 0; i < numFiles; ++i) {
+		std::vector<char> data((256 + rng() % 768) * 1024);
+
+		for (char& byte : data) {
+			byte = static_cast<char>(rng());
+		}
+
+		std::ofstream file(folder / ("image" + std::to_string(i) + ".bin"), std::ios::binary);
+		file.write(data.data(), data.size());
+	}
+
+	return folder;
+}
+
+struct RunResult {
+	double Seconds = 0.0;
+	size_t PeakDecodedBytes = 0;
+	uint64_t Checksum = 0;
+};
+
+// read and decode on pool, consume in file order on calling thread like copy recording does
+RunResult RunPipeline(ThreadPool& pool, const std::vector<std::filesystem::path>& files, uint32_t maxInFlight) {
+	std::atomic<size_t> decodedBytes(0);
+	std::atomic<size_t> peakDecodedBytes(0);
+	RunResult result;
+
+	Stopwatch stopwatch;
+
+	RunOrderedPipeline<DecodedImage>(
+		pool,
+		static_cast<uint32_t>(files.size()),
+		maxInFlight,
+		[&](uint32_t i) {
+			DecodedImage image = DecodeImage(ReadFileBytes(files[i]));
+
+			size_t current = decodedBytes += image.Mips.Data.size();
+			size_t observed = peakDecodedBytes.load();
+
+			while (current > observed && !peakDecodedBytes.compare_exchange_weak(observed, current)) {}
+
+			return image;
+		},
+		[&](uint32_t, DecodedImage& image) {
+			result.Checksum += image.Mips.Data.back() + image.Mips.Data.size();
+			decodedBytes -= image.Mips.Data.size();
+		}
+	);
+
+	result.Seconds = stopwatch.GetSeconds();
+	result.PeakDecodedBytes = peakDecodedBytes.load();
+
+	return result;
+}
+
+RunResult RunSerial(const std::vector<std::filesystem::path>& files) {
+	RunResult result;
+	Stopwatch stopwatch;
+
+	for (const std::filesystem::path& fileName : files) {
+		DecodedImage image = DecodeImage(ReadFileBytes(fileName));
+
+		result.Checksum += image.Mips.Data.back() + image.Mips.Data.size();
+		result.PeakDecodedBytes = std::max(result.PeakDecodedBytes, image.Mips.Data.size());
+	}
+
+	result.Seconds = stopwatch.GetSeconds();
+
+	return result;
+}
+
+// argument is directory with images, synthetic files are generated if it is not given
+int main(int argc, char** argv) {
+	bool isSynthetic = argc < 2;
+	std::filesystem::path folder = isSynthetic ? CreateSyntheticImages(32) : std::filesystem::path(argv[1]);
+
+	std::vector<std::filesystem::path> files;
+	size_t totalFileSize = 0;
+
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(folder)) {
+		if (entry.is_regular_file()) {
+			files.push_back(entry.path());
+			totalFileSize += entry.file_size();
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+	CHECK(!files.empty());
+
+	ThreadPool pool;
+	uint32_t numThreads = pool.GetNumThreads();
+
+	std::printf("%zu files, %.1f MB, %u threads\n", files.size(), totalFileSize / 1048576.0, numThreads);
+
+	RunResult serial = RunSerial(files);
+	std::printf("serial: %.1f ms, peak decoded %.1f MB\n", serial.Seconds * 1e3, serial.PeakDecodedBytes / 1048576.0);
+
+	for (uint32_t maxInFlight : { numThreads, 2 * numThreads, 4 * numThreads }) {
+		RunResult pipeline = RunPipeline(pool, files, maxInFlight);
+		CHECK(pipeline.Checksum == serial.Checksum);
+
+		std::printf(
+			"pipeline with window %u: %.1f ms, x%.2f, peak decoded %.1f MB\n",
+			maxInFlight,
+			pipeline.Seconds * 1e3,
+			serial.Seconds / pipeline.Seconds,
+			pipeline.PeakDecodedBytes / 1048576.0
+		);
+	}
+
+	if (isSynthetic) {
+		std::filesystem::remove_all(folder);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include <MyD3D12Lib/OrderedPipeline.h>
+
+#include <TestUtils.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+void TestOrderAndWindow(ThreadPool& pool, uint32_t numItems, uint32_t maxInFlight) {
+	std::atomic<uint32_t> numInFlight(0);
+	std::atomic<uint32_t> maxNumInFlight(0);
+	std::vector<uint32_t> consumed;
+
+	RunOrderedPipeline<std::vector<uint32_t>>(
+		pool,
+		numItems,
+		maxInFlight,
+		[&](uint32_t i) {
+			uint32_t current = ++numInFlight;
+			uint32_t observed = maxNumInFlight.load();
+
+			while (current > observed && !maxNumInFlight.compare_exchange_weak(observed, current)) {}
+
+			// later items are often produced before earlier ones
+			std::this_thread::sleep_for(std::chrono::microseconds((i * 7919) % 500));
+
+			return std::vector<uint32_t>(100, i);
+		},
+		[&](uint32_t i, std::vector<uint32_t>& value) {
+			CHECK(value.size() == 100 && value[0] == i);
+			consumed.push_back(i);
+			--numInFlight;
+		}
+	);
+
+	CHECK(consumed.size() == numItems);
+
+	for (uint32_t i = 0; i < numItems; ++i) {
+		CHECK(consumed[i] == i);
+	}
+
+	// produced but not consumed items never exceed window
+	CHECK(maxNumInFlight.load() <= maxInFlight);
+	CHECK(numInFlight.load() == 0);
+}
+
+void TestEmpty(ThreadPool& pool) {
+	bool isCalled = false;
+
+	RunOrderedPipeline<int>(
+		pool, 0, 4,
+		[&](uint32_t) { isCalled = true; return 0; },
+		[&](uint32_t, int&) { isCalled = true; }
+	);
+
+	CHECK(!isCalled);
+}
+
+void TestMoveOnlyItems(ThreadPool& pool) {
+	uint32_t sum = 0;
+
+	RunOrderedPipeline<std::unique_ptr<uint32_t>>(
+		pool, 1000, 8,
+		[](uint32_t i) { return std::make_unique<uint32_t>(i); },
+		[&](uint32_t i, std::unique_ptr<uint32_t>& value) { CHECK(*value == i); sum += *value; }
+	);
+
+	CHECK(sum == 999 * 1000 / 2);
+}
+
+void TestProduceError(ThreadPool& pool) {
+	std::atomic<uint32_t> numProduced(0);
+	uint32_t numConsumed = 0;
+	bool isThrown = false;
+
+	try {
+		RunOrderedPipeline<uint32_t>(
+			pool, 100, 4,
+			[&](uint32_t i) {
+				++numProduced;
+
+				if (i == 10) {
+					throw std::runtime_error("produce");
+				}
+
+				return i;
+			},
+			[&](uint32_t, uint32_t&) { ++numConsumed; }
+		);
+	}
+	catch (const std::runtime_error&) {
+		isThrown = true;
+	}
+
+	// items before failed one are consumed, nothing is submitted after it is seen
+	CHECK(isThrown);
+	CHECK(numConsumed == 10);
+	CHECK(numProduced.load() <= 10 + 4);
+}
+
+void TestConsumeError(ThreadPool& pool) {
+	bool isThrown = false;
+
+	try {
+		RunOrderedPipeline<uint32_t>(
+			pool, 100, 4,
+			[](uint32_t i) { return i; },
+			[](uint32_t i, uint32_t&) {
+				if (i == 50) {
+					throw std::logic_error("consume");
+				}
+			}
+		);
+	}
+	catch (const std::logic_error&) {
+		isThrown = true;
+	}
+
+	CHECK(isThrown);
+}
+
+// pipeline returns right after last task notifies, so task must not touch its state after that
+// short pipelines repeated many times make use after scope likely to crash
+void TestManyShortPipelines(ThreadPool& pool) {
+	std::mt19937 rng(31);
+
+	for (uint32_t run = 0; run < 20000; ++run) {
+		uint32_t numItems = 1 + rng() % 4;
+		uint32_t sum = 0;
+
+		RunOrderedPipeline<uint32_t>(
+			pool, numItems, 1 + rng() % 3,
+			[](uint32_t i) { return i + 1; },
+			[&](uint32_t, uint32_t& value) { sum += value; }
+		);
+
+		CHECK(sum == numItems * (numItems + 1) / 2);
+	}
+}
+
+int main() {
+	ThreadPool pool(4);
+
+	TestOrderAndWindow(pool, 200, 1);
+	TestOrderAndWindow(pool, 200, 3);
+	TestOrderAndWindow(pool, 500, 8);
+	TestOrderAndWindow(pool, 5, 16);
+	TestEmpty(pool);
+	TestMoveOnlyItems(pool);
+	TestProduceError(pool);
+	TestConsumeError(pool);
+	TestManyShortPipelines(pool);
+
+	std::printf("OrderedPipeline tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include <MyD3D12Lib/RenderGraph.h>
+
+#include <TestUtils.h>
+
+#include <vector>
+
+// values of D3D12_RESOURCE_STATES, graph only compares them
+enum State : uint32_t {
+	Present = 0x0,
+	RenderTarget = 0x4,
+	DepthWrite = 0x10,
+	PixelShaderResource = 0x80
+};
+
+const uint64_t Alignment = 65536;
+
+// passes of ModelsApp with SSAO and Sobel
+void BuildAppGraph(RenderGraph& graph) {
+	graph.Reset();
+
+	uint32_t backBuffer = graph.Import(Present);
+	uint32_t depthBuffer = graph.Import(DepthWrite);
+	uint32_t shadowMap = graph.Import(PixelShaderResource);
+	uint32_t normalMap = graph.CreateTransient(1920 * 1080 * 8, Alignment);
+	uint32_t occlusionMap0 = graph.CreateTransient(960 * 540 * 2, Alignment);
+	uint32_t occlusionMap1 = graph.CreateTransient(960 * 540 * 2, Alignment);
+	uint32_t sobelMap = graph.CreateTransient(1920 * 1080 * 4, Alignment);
+
+	uint32_t pass = graph.AddPass("SSAONormals", nullptr);
+	graph.Write(pass, normalMap, RenderTarget);
+	graph.Write(pass, depthBuffer, DepthWrite);
+	graph.Read(pass, shadowMap, PixelShaderResource);
+
+	pass = graph.AddPass("SSAO", nullptr);
+	graph.Read(pass, normalMap, PixelShaderResource);
+	graph.Read(pass, depthBuffer, PixelShaderResource);
+	graph.Write(pass, occlusionMap0, RenderTarget);
+
+	for (uint32_t i = 0; i < 2; ++i) {
+		pass = graph.AddPass("BlurH", nullptr);
+		graph.Read(pass, occlusionMap0, PixelShaderResource);
+		graph.Write(pass, occlusionMap1, RenderTarget);
+
+		pass = graph.AddPass("BlurV", nullptr);
+		graph.Read(pass, occlusionMap1, PixelShaderResource);
+		graph.Write(pass, occlusionMap0, RenderTarget);
+	}
+
+	pass = graph.AddPass("Geometry", nullptr);
+	graph.ReadWrite(pass, depthBuffer, DepthWrite);
+	graph.Read(pass, occlusionMap0, PixelShaderResource);
+	graph.Read(pass, shadowMap, PixelShaderResource);
+	graph.Write(pass, sobelMap, RenderTarget);
+
+	pass = graph.AddPass("Sobel", nullptr);
+	graph.Read(pass, sobelMap, PixelShaderResource);
+	graph.Write(pass, backBuffer, RenderTarget);
+
+	pass = graph.AddPass("Present", nullptr, true);
+	graph.Read(pass, backBuffer, Present);
+
+	graph.Compile();
+}
+
+// chains of effects over many transients, some of them are culled
+void BuildBigGraph(RenderGraph& graph, uint32_t numPasses, uint32_t numTransients) {
+	graph.Reset();
+
+	uint32_t backBuffer = graph.Import(RenderTarget);
+	std::vector<uint32_t> transients(numTransients);
+
+	for (uint32_t i = 0; i < numTransients; ++i) {
+		transients[i] = graph.CreateTransient(static_cast<uint64_t>(1 + i % 7) << 20, Alignment);
+	}
+
+	for (uint32_t i = 0; i < numPasses; ++i) {
+		uint32_t pass = graph.AddPass("Effect", nullptr, i % 50 == 0);
+		graph.Read(pass, transients[(i * 7) % numTransients], PixelShaderResource);
+		graph.Write(pass, transients[(i * 7 + 1) % numTransients], RenderTarget);
+
+		if (i % 10 == 0) {
+			graph.Read(pass, transients[(i * 3 + 2) % numTransients], PixelShaderResource);
+		}
+	}
+
+	uint32_t pass = graph.AddPass("Output", nullptr);
+	graph.Read(pass, transients[((numPasses - 1) * 7 + 1) % numTransients], PixelShaderResource);
+	graph.Write(pass, backBuffer, RenderTarget);
+
+	graph.Compile();
+}
+
+// argument is number of compiles of app graph, big graph is compiled 100 times less
+int main(int argc, char** argv) {
+	uint32_t numCompiles = GetScaleArgument(argc, argv, 100000);
+	uint32_t numBigCompiles = numCompiles / 100 > 0 ? numCompiles / 100 : 1;
+
+	RenderGraph graph;
+
+	// the first compile allocates memory of containers, it is reused by the next ones
+	BuildAppGraph(graph);
+
+	Stopwatch stopwatch;
+
+	for (uint32_t i = 0; i < numCompiles; ++i) {
+		BuildAppGraph(graph);
+		KeepResult(graph.GetHeapSize());
+	}
+
+	double appTime = stopwatch.GetSeconds();
+	CHECK(graph.GetCompiledPasses().size() == 9);
+
+	const uint32_t NumPasses = 1000;
+	const uint32_t NumTransients = 300;
+
+	BuildBigGraph(graph, NumPasses, NumTransients);
+	stopwatch.Restart();
+
+	for (uint32_t i = 0; i < numBigCompiles; ++i) {
+		BuildBigGraph(graph, NumPasses, NumTransients);
+		KeepResult(graph.GetHeapSize());
+	}
+
+	double bigTime = stopwatch.GetSeconds();
+
+	std::printf("app graph, 9 passes: %.2f us per build and compile\n", appTime / numCompiles * 1e6);
+	std::printf(
+		"%u passes and %u transients: %.1f us per build and compile, %zu passes executed, heap %.0f MB of %.0f MB without aliasing\n",
+		NumPasses, NumTransients, bigTime / numBigCompiles * 1e6, graph.GetCompiledPasses().size(),
+		graph.GetHeapSize() / 1048576.0, graph.GetTransientsSize() / 1048576.0
+	);
+
+	return 0;
+}
\ No newline at end of file
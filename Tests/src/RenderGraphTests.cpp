@@ -0,0 +1,573 @@
+#include <MyD3D12Lib/RenderGraph.h>
+
+#include <TestUtils.h>
+
+#include <random>
+#include <set>
+#include <vector>
+
+// values of D3D12_RESOURCE_STATES, graph only compares them
+enum State : uint32_t {
+	Present = 0x0,
+	RenderTarget = 0x4,
+	DepthWrite = 0x10,
+	PixelShaderResource = 0x80
+};
+
+const uint64_t Width = 1920;
+const uint64_t Height = 1080;
+const uint64_t Alignment = 65536;
+
+uint64_t AlignSize(uint64_t size) {
+	return (size + Alignment - 1) / Alignment * Alignment;
+}
+
+struct AppGraph {
+	uint32_t BackBuffer;
+	uint32_t DepthBuffer;
+	uint32_t ShadowMap;
+	uint32_t NormalMap;
+	uint32_t OcclusionMap0;
+	uint32_t OcclusionMap1;
+	uint32_t SobelMap;
+	std::vector<uint32_t> Passes;
+};
+
+// the same passes and accesses as graph of ModelsApp, sizes are of its formats
+AppGraph BuildAppGraph(RenderGraph& graph, bool ssao, bool sobel, uint32_t* numExecuted) {
+	AppGraph app;
+	RenderGraph::ExecuteFunction execute = [numExecuted]() {
+		if (numExecuted != nullptr) {
+			++*numExecuted;
+		}
+	};
+
+	graph.Reset();
+
+	app.BackBuffer = graph.Import(Present);
+	app.DepthBuffer = graph.Import(DepthWrite);
+	app.ShadowMap = graph.Import(PixelShaderResource);
+	app.NormalMap = graph.CreateTransient(AlignSize(Width * Height * 8), Alignment);
+	app.OcclusionMap0 = graph.CreateTransient(AlignSize(Width / 2 * Height / 2 * 2), Alignment);
+	app.OcclusionMap1 = graph.CreateTransient(AlignSize(Width / 2 * Height / 2 * 2), Alignment);
+	app.SobelMap = sobel ? graph.CreateTransient(AlignSize(Width * Height * 4), Alignment) : RenderGraph::InvalidIndex;
+
+	uint32_t pass = graph.AddPass("SSAONormals", execute);
+	graph.Write(pass, app.NormalMap, RenderTarget);
+	graph.Write(pass, app.DepthBuffer, DepthWrite);
+	graph.Read(pass, app.ShadowMap, PixelShaderResource);
+	app.Passes.push_back(pass);
+
+	pass = graph.AddPass("SSAO", execute);
+	graph.Read(pass, app.NormalMap, PixelShaderResource);
+	graph.Read(pass, app.DepthBuffer, PixelShaderResource);
+	graph.Write(pass, app.OcclusionMap0, RenderTarget);
+	app.Passes.push_back(pass);
+
+	for (uint32_t i = 0; i < 2; ++i) {
+		pass = graph.AddPass("BlurH", execute);
+		graph.Read(pass, app.OcclusionMap0, PixelShaderResource);
+		graph.Write(pass, app.OcclusionMap1, RenderTarget);
+		app.Passes.push_back(pass);
+
+		pass = graph.AddPass("BlurV", execute);
+		graph.Read(pass, app.OcclusionMap1, PixelShaderResource);
+		graph.Write(pass, app.OcclusionMap0, RenderTarget);
+		app.Passes.push_back(pass);
+	}
+
+	pass = graph.AddPass("Geometry", execute);
+
+	if (ssao) {
+		graph.ReadWrite(pass, app.DepthBuffer, DepthWrite);
+		graph.Read(pass, app.OcclusionMap0, PixelShaderResource);
+	}
+	else {
+		graph.Write(pass, app.DepthBuffer, DepthWrite);
+	}
+
+	graph.Read(pass, app.ShadowMap, PixelShaderResource);
+	graph.Write(pass, sobel ? app.SobelMap : app.BackBuffer, RenderTarget);
+	app.Passes.push_back(pass);
+
+	if (sobel) {
+		pass = graph.AddPass("Sobel", execute);
+		graph.Read(pass, app.SobelMap, PixelShaderResource);
+		graph.Write(pass, app.BackBuffer, RenderTarget);
+		app.Passes.push_back(pass);
+	}
+
+	pass = graph.AddPass("Present", execute, true);
+	graph.Read(pass, app.BackBuffer, Present);
+	app.Passes.push_back(pass);
+
+	graph.Compile();
+
+	return app;
+}
+
+struct DeclaredAccess {
+	uint32_t Pass;
+	uint32_t Resource;
+	uint32_t State;
+	bool IsRead;
+	bool IsWrite;
+};
+
+// barriers are replayed on states of resources, each executed pass should find its resources in declared states
+// transients which are alive at the same time shouldn`t share memory
+void ValidateCompiledGraph(const RenderGraph& graph, const std::vector<DeclaredAccess>& accesses) {
+	const uint32_t Pending = UINT32_MAX - 1;
+
+	uint32_t numResources = graph.GetNumResources();
+	std::vector<uint32_t> states(numResources);
+	std::vector<uint32_t> pendingStates(numResources, RenderGraph::InvalidIndex);
+
+	for (uint32_t i = 0; i < numResources; ++i) {
+		states[i] = graph.GetInitialState(i);
+
+		if (graph.IsTransient(i) && graph.IsUsed(i)) {
+			CHECK(graph.GetFirstUse(i) <= graph.GetLastUse(i));
+			CHECK(graph.GetOffset(i) + graph.GetSize(i) <= graph.GetHeapSize());
+		}
+	}
+
+	for (uint32_t a = 0; a < numResources; ++a) {
+		for (uint32_t b = a + 1; b < numResources; ++b) {
+			if (!graph.IsTransient(a) || !graph.IsTransient(b) || !graph.IsUsed(a) || !graph.IsUsed(b)) {
+				continue;
+			}
+
+			bool livesOverlap = graph.GetFirstUse(a) <= graph.GetLastUse(b) && graph.GetFirstUse(b) <= graph.GetLastUse(a);
+			bool memoryOverlaps = graph.GetOffset(a) < graph.GetOffset(b) + graph.GetSize(b) && graph.GetOffset(b) < graph.GetOffset(a) + graph.GetSize(a);
+			CHECK(!livesOverlap || !memoryOverlaps);
+		}
+	}
+
+	auto applyBarrier = [&](const RenderGraph::Barrier& barrier, uint32_t passIndex) {
+		uint32_t resource = barrier.Resource;
+
+		switch (barrier.Type) {
+		case RenderGraph::BarrierType::Transition:
+			CHECK(pendingStates[resource] == RenderGraph::InvalidIndex);
+			CHECK(states[resource] == barrier.StateBefore);
+			states[resource] = barrier.StateAfter;
+			break;
+		case RenderGraph::BarrierType::BeginTransition:
+			CHECK(pendingStates[resource] == RenderGraph::InvalidIndex);
+			CHECK(states[resource] == barrier.StateBefore);
+			pendingStates[resource] = barrier.StateAfter;
+			states[resource] = Pending;
+			break;
+		case RenderGraph::BarrierType::EndTransition:
+			CHECK(pendingStates[resource] == barrier.StateAfter);
+			pendingStates[resource] = RenderGraph::InvalidIndex;
+			states[resource] = barrier.StateAfter;
+			break;
+		case RenderGraph::BarrierType::Aliasing:
+			// deactivated transient is dead and returned to its initial state, activated one starts its lifetime
+			CHECK(graph.IsTransient(resource) && graph.IsTransient(barrier.AliasedResource));
+			CHECK(graph.GetOffset(resource) == graph.GetOffset(barrier.AliasedResource));
+			CHECK(graph.GetFirstUse(resource) == passIndex);
+			CHECK(states[resource] == graph.GetInitialState(resource));
+			CHECK(states[barrier.AliasedResource] == graph.GetInitialState(barrier.AliasedResource));
+			CHECK(graph.GetLastUse(barrier.AliasedResource) < passIndex || graph.GetFirstUse(barrier.AliasedResource) > passIndex);
+			break;
+		}
+	};
+
+	const std::vector<RenderGraph::CompiledPass>& passes = graph.GetCompiledPasses();
+
+	for (uint32_t i = 0; i < passes.size(); ++i) {
+		const RenderGraph::CompiledPass& pass = passes[i];
+
+		for (uint32_t j = 0; j < pass.NumBarriers; ++j) {
+			applyBarrier(graph.GetBarriers(pass)[j], i);
+		}
+
+		for (const DeclaredAccess& access : accesses) {
+			if (access.Pass == pass.Pass) {
+				CHECK(states[access.Resource] == access.State);
+
+				if (graph.IsTransient(access.Resource)) {
+					CHECK(graph.GetFirstUse(access.Resource) <= i && i <= graph.GetLastUse(access.Resource));
+				}
+			}
+		}
+
+		for (uint32_t j = 0; j < pass.NumAfterBarriers; ++j) {
+			applyBarrier(graph.GetAfterBarriers(pass)[j], i);
+		}
+	}
+
+	for (uint32_t j = 0; j < graph.GetNumFinalBarriers(); ++j) {
+		applyBarrier(graph.GetFinalBarriers()[j], static_cast<uint32_t>(passes.size()));
+	}
+
+	// transients are back in states of their first use for the next frame
+	for (uint32_t i = 0; i < numResources; ++i) {
+		CHECK(pendingStates[i] == RenderGraph::InvalidIndex);
+
+		if (graph.IsTransient(i)) {
+			CHECK(states[i] == graph.GetInitialState(i));
+		}
+	}
+}
+
+// reference culling by versions of resources, each write makes new version
+// pass is needed if it has side effects or writes version which is read by needed pass or is the last one of imported resource
+std::vector<bool> FindNeededPasses(uint32_t numPasses, const std::vector<bool>& isTransient, const std::vector<bool>& hasSideEffects, const std::vector<DeclaredAccess>& accesses) {
+	std::vector<uint32_t> versionWriters;
+	std::vector<uint32_t> lastVersions(isTransient.size(), RenderGraph::InvalidIndex);
+	std::vector<std::vector<uint32_t>> readVersions(numPasses);
+	std::vector<std::vector<uint32_t>> writtenVersions(numPasses);
+
+	for (const DeclaredAccess& access : accesses) {
+		if (access.IsRead && lastVersions[access.Resource] != RenderGraph::InvalidIndex) {
+			readVersions[access.Pass].push_back(lastVersions[access.Resource]);
+		}
+
+		if (access.IsWrite) {
+			lastVersions[access.Resource] = static_cast<uint32_t>(versionWriters.size());
+			writtenVersions[access.Pass].push_back(lastVersions[access.Resource]);
+			versionWriters.push_back(access.Pass);
+		}
+	}
+
+	std::vector<bool> isPassNeeded(numPasses, false);
+	std::vector<bool> isVersionNeeded(versionWriters.size(), false);
+
+	for (uint32_t i = 0; i < isTransient.size(); ++i) {
+		if (!isTransient[i] && lastVersions[i] != RenderGraph::InvalidIndex) {
+			isVersionNeeded[lastVersions[i]] = true;
+		}
+	}
+
+	bool isChanged = true;
+
+	while (isChanged) {
+		isChanged = false;
+
+		for (uint32_t pass = 0; pass < numPasses; ++pass) {
+			bool isNeeded = hasSideEffects[pass];
+
+			for (uint32_t version : writtenVersions[pass]) {
+				isNeeded = isNeeded || isVersionNeeded[version];
+			}
+
+			if (isNeeded && !isPassNeeded[pass]) {
+				isPassNeeded[pass] = true;
+				isChanged = true;
+
+				for (uint32_t version : readVersions[pass]) {
+					isVersionNeeded[version] = true;
+				}
+			}
+		}
+	}
+
+	return isPassNeeded;
+}
+
+void TestAppGraph() {
+	RenderGraph graph;
+	uint32_t numExecuted = 0;
+	AppGraph app = BuildAppGraph(graph, true, true, &numExecuted);
+
+	const std::vector<RenderGraph::CompiledPass>& passes = graph.GetCompiledPasses();
+	CHECK(passes.size() == 9);
+
+	const uint32_t expectedNumBarriers[] = { 1, 2, 3, 2, 2, 2, 4, 3, 2 };
+
+	for (uint32_t i = 0; i < passes.size(); ++i) {
+		CHECK(passes[i].Pass == app.Passes[i]);
+		CHECK(passes[i].NumBarriers == expectedNumBarriers[i]);
+	}
+
+	// depth is needed as depth write again only by geometry, its transition is split around SSAO
+	CHECK(passes[1].NumAfterBarriers == 1);
+	CHECK(graph.GetAfterBarriers(passes[1])[0].Type == RenderGraph::BarrierType::BeginTransition);
+	CHECK(graph.GetAfterBarriers(passes[1])[0].Resource == app.DepthBuffer);
+	CHECK(graph.GetNumFinalBarriers() == 0);
+
+	// normals, the second occlusion map and Sobel input are never alive at the same time
+	CHECK(graph.GetOffset(app.NormalMap) == graph.GetOffset(app.OcclusionMap1));
+	CHECK(graph.GetOffset(app.NormalMap) == graph.GetOffset(app.SobelMap));
+	CHECK(graph.GetOffset(app.OcclusionMap0) != graph.GetOffset(app.NormalMap));
+	CHECK(graph.GetHeapSize() == AlignSize(Width * Height * 8) + AlignSize(Width / 2 * Height / 2 * 2));
+	CHECK(graph.GetHeapSize() < graph.GetTransientsSize());
+
+	for (const RenderGraph::CompiledPass& pass : passes) {
+		graph.ExecutePass(pass.Pass);
+	}
+
+	CHECK(numExecuted == 9);
+}
+
+void TestCulling() {
+	RenderGraph graph;
+
+	// without SSAO normals, SSAO and blur passes have no readers
+	AppGraph app = BuildAppGraph(graph, false, true, nullptr);
+	CHECK(graph.GetCompiledPasses().size() == 3);
+
+	for (uint32_t i = 0; i < 6; ++i) {
+		CHECK(graph.IsPassCulled(app.Passes[i]));
+	}
+
+	CHECK(!graph.IsUsed(app.NormalMap) && !graph.IsUsed(app.OcclusionMap0) && !graph.IsUsed(app.OcclusionMap1));
+	CHECK(graph.IsUsed(app.SobelMap));
+	CHECK(graph.GetHeapSize() == AlignSize(Width * Height * 4));
+
+	BuildAppGraph(graph, false, false, nullptr);
+	CHECK(graph.GetCompiledPasses().size() == 2);
+	CHECK(graph.GetHeapSize() == 0);
+
+	BuildAppGraph(graph, true, false, nullptr);
+	CHECK(graph.GetCompiledPasses().size() == 8);
+	CHECK(graph.GetHeapSize() == AlignSize(Width * Height * 8) + AlignSize(Width / 2 * Height / 2 * 2));
+
+	// write which is overwritten before any read is culled, imported resource keeps its last write
+	graph.Reset();
+	uint32_t output = graph.Import(RenderTarget);
+	uint32_t first = graph.AddPass("First", nullptr);
+	uint32_t second = graph.AddPass("Second", nullptr);
+	graph.Write(first, output, RenderTarget);
+	graph.Write(second, output, RenderTarget);
+	graph.Compile();
+
+	CHECK(graph.IsPassCulled(first) && !graph.IsPassCulled(second));
+	CHECK(graph.GetCompiledPasses().size() == 1);
+}
+
+void TestTopologicalOrder() {
+	RenderGraph graph;
+	uint32_t output = graph.Import(RenderTarget);
+	uint32_t temporary = graph.CreateTransient(256, 256);
+
+	// accesses are ordered by passes, so read of consumer which is declared first still sees write of producer
+	uint32_t producer = graph.AddPass("Producer", nullptr);
+	uint32_t consumer = graph.AddPass("Consumer", nullptr);
+	graph.Write(consumer, output, RenderTarget);
+	graph.Read(consumer, temporary, PixelShaderResource);
+	graph.Write(producer, temporary, RenderTarget);
+	graph.Compile();
+
+	const std::vector<RenderGraph::CompiledPass>& passes = graph.GetCompiledPasses();
+	CHECK(passes.size() == 2);
+	CHECK(passes[0].Pass == producer && passes[1].Pass == consumer);
+	CHECK(graph.GetFirstUse(temporary) == 0 && graph.GetLastUse(temporary) == 1);
+	CHECK(graph.GetInitialState(temporary) == RenderTarget);
+
+	// write waits for reads of previous content, read waits for last write
+	graph.Reset();
+	uint32_t texture = graph.Import(PixelShaderResource);
+	output = graph.Import(RenderTarget);
+	uint32_t a = graph.AddPass("A", nullptr, true);
+	uint32_t b = graph.AddPass("B", nullptr);
+	uint32_t c = graph.AddPass("C", nullptr, true);
+	uint32_t d = graph.AddPass("D", nullptr);
+	graph.Read(d, texture, PixelShaderResource);
+	graph.Write(d, output, RenderTarget);
+	graph.Read(c, texture, PixelShaderResource);
+	graph.Write(b, texture, RenderTarget);
+	graph.Read(a, texture, PixelShaderResource);
+	graph.Read(b, output, PixelShaderResource);
+	graph.Compile();
+
+	std::vector<uint32_t> order;
+
+	for (const RenderGraph::CompiledPass& pass : graph.GetCompiledPasses()) {
+		order.push_back(pass.Pass);
+	}
+
+	CHECK((order == std::vector<uint32_t>{ a, b, c, d }));
+
+	ValidateCompiledGraph(graph, {
+		{ a, texture, PixelShaderResource, true, false },
+		{ b, texture, RenderTarget, false, true },
+		{ b, output, PixelShaderResource, true, false },
+		{ c, texture, PixelShaderResource, true, false },
+		{ d, texture, PixelShaderResource, true, false },
+		{ d, output, RenderTarget, false, true }
+	});
+
+	// the last write of imported resource is output, so the first one is culled with pass reading it
+	graph.Reset();
+	output = graph.Import(RenderTarget);
+	temporary = graph.CreateTransient(256, 256);
+	a = graph.AddPass("A", nullptr);
+	b = graph.AddPass("B", nullptr);
+	c = graph.AddPass("C", nullptr);
+	graph.Write(c, output, RenderTarget);
+	graph.Read(b, output, PixelShaderResource);
+	graph.Write(b, temporary, RenderTarget);
+	graph.Write(a, output, RenderTarget);
+	graph.Compile();
+
+	CHECK(graph.IsPassCulled(a) && graph.IsPassCulled(b) && !graph.IsPassCulled(c));
+	CHECK(!graph.IsUsed(temporary));
+}
+
+void TestLifetimesAndAliasing() {
+	RenderGraph graph;
+	uint32_t output = graph.Import(RenderTarget);
+
+	// chain of passes, each transient lives from pass writing it to pass reading it
+	const uint32_t NumTransients = 6;
+	const uint64_t Sizes[NumTransients] = { 1024, 4096, 2048, 4096, 512, 1024 };
+	uint32_t transients[NumTransients];
+
+	for (uint32_t i = 0; i < NumTransients; ++i) {
+		transients[i] = graph.CreateTransient(Sizes[i], 512);
+	}
+
+	for (uint32_t i = 0; i <= NumTransients; ++i) {
+		uint32_t pass = graph.AddPass("Pass", nullptr);
+
+		if (i > 0) {
+			graph.Read(pass, transients[i - 1], PixelShaderResource);
+		}
+
+		graph.Write(pass, i < NumTransients ? transients[i] : output, RenderTarget);
+	}
+
+	graph.Compile();
+
+	CHECK(graph.GetCompiledPasses().size() == NumTransients + 1);
+
+	for (uint32_t i = 0; i < NumTransients; ++i) {
+		CHECK(graph.GetFirstUse(transients[i]) == i);
+		CHECK(graph.GetLastUse(transients[i]) == i + 1);
+		CHECK(graph.GetInitialState(transients[i]) == RenderTarget);
+		CHECK(graph.GetOffset(transients[i]) % 512 == 0);
+	}
+
+	// only neighbours are alive at the same time, so two slots as big as the biggest transients are enough
+	CHECK(graph.GetTransientsSize() == 12800);
+	CHECK(graph.GetHeapSize() <= 8192);
+
+	std::vector<DeclaredAccess> accesses;
+
+	for (uint32_t i = 0; i <= NumTransients; ++i) {
+		if (i > 0) {
+			accesses.push_back({ i, transients[i - 1], PixelShaderResource, true, false });
+		}
+
+		accesses.push_back({ i, i < NumTransients ? transients[i] : output, RenderTarget, false, true });
+	}
+
+	ValidateCompiledGraph(graph, accesses);
+
+	// transients which are used by the same pass are never aliased
+	graph.Reset();
+	output = graph.Import(RenderTarget);
+	uint32_t x = graph.CreateTransient(1000, 8);
+	uint32_t y = graph.CreateTransient(1000, 8);
+	uint32_t pass = graph.AddPass("Both", nullptr);
+	graph.Write(pass, x, RenderTarget);
+	graph.Write(pass, y, RenderTarget);
+	uint32_t resolve = graph.AddPass("Resolve", nullptr);
+	graph.Read(resolve, x, PixelShaderResource);
+	graph.Read(resolve, y, PixelShaderResource);
+	graph.Write(resolve, output, RenderTarget);
+	graph.Compile();
+
+	CHECK(graph.GetOffset(x) != graph.GetOffset(y));
+	CHECK(graph.GetHeapSize() == graph.GetTransientsSize());
+}
+
+void TestRandomGraphs() {
+	RenderGraph graph;
+	std::mt19937 rng(46);
+
+	for (uint32_t run = 0; run < 20000; ++run) {
+		uint32_t numPasses = 1 + rng() % 24;
+		uint32_t numResources = 1 + rng() % 12;
+
+		graph.Reset();
+
+		std::vector<bool> isTransient(numResources);
+		std::vector<uint64_t> alignments(numResources);
+
+		for (uint32_t i = 0; i < numResources; ++i) {
+			isTransient[i] = rng() % 3 != 0;
+
+			if (isTransient[i]) {
+				alignments[i] = 1ull << (rng() % 4);
+				graph.CreateTransient(1 + rng() % 100, alignments[i]);
+			}
+			else {
+				graph.Import(rng() % 4);
+			}
+		}
+
+		std::vector<bool> hasSideEffects(numPasses);
+		std::vector<DeclaredAccess> accesses;
+
+		for (uint32_t pass = 0; pass < numPasses; ++pass) {
+			hasSideEffects[pass] = rng() % 8 == 0;
+			graph.AddPass("Pass", nullptr, hasSideEffects[pass]);
+
+			std::set<uint32_t> usedResources;
+			uint32_t numAccesses = rng() % 4;
+
+			for (uint32_t i = 0; i < numAccesses; ++i) {
+				uint32_t resource = rng() % numResources;
+
+				if (!usedResources.insert(resource).second) {
+					continue;
+				}
+
+				uint32_t state = rng() % 4;
+				uint32_t kind = rng() % 3;
+
+				if (kind == 0) {
+					graph.Read(pass, resource, state);
+				}
+				else if (kind == 1) {
+					graph.Write(pass, resource, state);
+				}
+				else {
+					graph.ReadWrite(pass, resource, state);
+				}
+
+				accesses.push_back({ pass, resource, state, kind != 1, kind != 0 });
+			}
+		}
+
+		graph.Compile();
+
+		std::vector<bool> isPassNeeded = FindNeededPasses(numPasses, isTransient, hasSideEffects, accesses);
+
+		for (uint32_t pass = 0; pass < numPasses; ++pass) {
+			CHECK(isPassNeeded[pass] == !graph.IsPassCulled(pass));
+		}
+
+		// accesses are declared in order of passes, so it is kept
+		const std::vector<RenderGraph::CompiledPass>& passes = graph.GetCompiledPasses();
+
+		for (uint32_t i = 1; i < passes.size(); ++i) {
+			CHECK(passes[i - 1].Pass < passes[i].Pass);
+		}
+
+		for (uint32_t i = 0; i < numResources; ++i) {
+			if (isTransient[i] && graph.IsUsed(i)) {
+				CHECK(graph.GetOffset(i) % alignments[i] == 0);
+			}
+		}
+
+		ValidateCompiledGraph(graph, accesses);
+	}
+}
+
+int main() {
+	TestAppGraph();
+	TestCulling();
+	TestTopologicalOrder();
+	TestLifetimesAndAliasing();
+	TestRandomGraphs();
+
+	std::printf("RenderGraph tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <MyD3D12Lib/ResidencyManager.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// LRU order, budget and accounting on small known workload
+void CheckPolicy() {
+	ResidencyManager manager(100);
+
+	std::vector<uint32_t> numEvictions(5, 0);
+	std::vector<uint32_t> numRestores(5, 0);
+	std::vector<uint32_t> ids;
+
+	for (uint32_t i = 0; i < 5; ++i) {
+		ids.push_back(manager.Register(
+			ResidencyCategory::Textures, 30, true, 0,
+			[&numEvictions, i]() { ++numEvictions[i]; },
+			[&numRestores, i]() { ++numRestores[i]; }
+		));
+	}
+
+	uint32_t targetsId = manager.Register(ResidencyCategory::SSAO, 20, false, 0);
+
+	CHECK(targetsId != ResidencyManager::InvalidId);
+	CHECK(manager.GetResidentSize() == 170);
+	CHECK(manager.GetSize(ResidencyCategory::Textures) == 150);
+
+	manager.MarkUsed(ids[0], 1);
+	manager.MarkUsed(ids[2], 1);
+	manager.MarkUsed(ids[4], 2);
+
+	// resources of unfinished frames aren`t evicted
+	CHECK(manager.EnforceBudget(0) == 0);
+
+	// least recently used are evicted first, until budget is met
+	CHECK(manager.EnforceBudget(2) == 3);
+	CHECK(numEvictions[1] == 1 && numEvictions[3] == 1 && numEvictions[0] == 1);
+	CHECK(numEvictions[2] == 0 && numEvictions[4] == 0);
+	CHECK(manager.GetResidentSize() == 80);
+
+	// evicted resource is restored on use
+	manager.MarkUsed(ids[1], 3);
+	CHECK(numRestores[1] == 1 && manager.IsResident(ids[1]));
+	CHECK(manager.GetResidentSize() == 110);
+
+	// not evictable resources stay resident with any budget
+	manager.SetBudget(0);
+	manager.EnforceBudget(10);
+	CHECK(manager.GetResidentSize() == 20 && manager.IsResident(targetsId));
+}
+
+struct WorkloadResult {
+	uint64_t NumEvictions = 0;
+	uint64_t NumRestores = 0;
+	uint64_t RestoredSize = 0;
+	uint32_t NumFramesOverBudget = 0;
+	double Seconds = 0.0;
+};
+
+// scene streams through drifting working set of meshes and textures, render targets are used every frame
+WorkloadResult RunWorkload(uint32_t numFrames, uint32_t numResources, uint32_t usesPerFrame, uint32_t numFramesInFlight, uint64_t& totalSize, uint64_t& budget) {
+	std::mt19937 rng(38);
+
+	std::vector<uint64_t> sizes(numResources);
+	std::vector<ResidencyCategory> categories(numResources);
+	totalSize = 0;
+
+	for (uint32_t i = 0; i < numResources; ++i) {
+		// textures from 64 KB to 2 MB, meshes from 16 KB to 512 KB
+		bool isTexture = rng() % 3 != 0;
+		categories[i] = isTexture ? ResidencyCategory::Textures : ResidencyCategory::Meshes;
+		sizes[i] = (isTexture ? 64ull << 10 : 16ull << 10) << (rng() % 6);
+		totalSize += sizes[i];
+	}
+
+	uint64_t renderTargetsSize = 64ull << 20;
+	budget = totalSize / 3 + renderTargetsSize;
+
+	ResidencyManager manager(budget);
+	WorkloadResult result;
+
+	std::vector<uint32_t> ids(numResources);
+
+	for (uint32_t i = 0; i < numResources; ++i) {
+		uint64_t size = sizes[i];
+		ids[i] = manager.Register(categories[i], size, true, 0, []() {}, [&result, size]() { result.RestoredSize += size; });
+	}
+
+	uint32_t shadowMapsId = manager.Register(ResidencyCategory::ShadowMaps, renderTargetsSize / 2, false, 0);
+	uint32_t ssaoId = manager.Register(ResidencyCategory::SSAO, renderTargetsSize / 2, false, 0);
+
+	CHECK(manager.GetSize(ResidencyCategory::Textures) + manager.GetSize(ResidencyCategory::Meshes) == totalSize);
+
+	std::normal_distribution<float> offset(0.0f, numResources * 0.06f);
+
+	Stopwatch stopwatch;
+
+	for (uint32_t frame = 1; frame <= numFrames; ++frame) {
+		// camera moves, so center of working set drifts over resources
+		float center = frame * 0.4f;
+
+		for (uint32_t k = 0; k < usesPerFrame; ++k) {
+			int64_t index = static_cast<int64_t>(center + offset(rng)) % numResources;
+			manager.MarkUsed(ids[(index + numResources) % numResources], frame);
+		}
+
+		manager.MarkUsed(shadowMapsId, frame);
+		manager.MarkUsed(ssaoId, frame);
+
+		uint64_t firstUnfinishedFrame = frame + 1 > numFramesInFlight ? frame + 1 - numFramesInFlight : 0;
+		manager.EnforceBudget(firstUnfinishedFrame);
+
+		// resources of frames in flight can temporarily exceed budget
+		result.NumFramesOverBudget += manager.GetResidentSize() > manager.GetBudget();
+	}
+
+	result.Seconds = stopwatch.GetSeconds();
+	result.NumEvictions = manager.GetNumEvictions();
+	result.NumRestores = manager.GetNumRestores();
+
+	return result;
+}
+
+// argument is number of frames
+int main(int argc, char** argv) {
+	uint32_t numFrames = GetScaleArgument(argc, argv, 5000);
+
+	CheckPolicy();
+
+	const uint32_t numResources = 2000;
+
+	for (uint32_t usesPerFrame : { 100u, 300u, 1000u }) {
+		uint64_t totalSize = 0;
+		uint64_t budget = 0;
+		WorkloadResult result = RunWorkload(numFrames, numResources, usesPerFrame, 3, totalSize, budget);
+
+		std::printf(
+			"%u resources, %.0f MB, budget %.0f MB, %u uses per frame: %llu evictions, %llu restores, %.1f MB restored per frame, %u frames over budget, %.2f us per frame\n",
+			numResources,
+			totalSize / 1048576.0,
+			budget / 1048576.0,
+			usesPerFrame,
+			static_cast<unsigned long long>(result.NumEvictions),
+			static_cast<unsigned long long>(result.NumRestores),
+			result.RestoredSize / 1048576.0 / numFrames,
+			result.NumFramesOverBudget,
+			result.Seconds / numFrames * 1e6
+		);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,575 @@
+#include <MyD3D12Lib/RenderGraph.h>
+#include <MyD3D12Lib/ResourceStateTracker.h>
+
+#include <TestUtils.h>
+
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+const D3D12_RESOURCE_STATES RenderTarget = D3D12_RESOURCE_STATE_RENDER_TARGET;
+const D3D12_RESOURCE_STATES DepthWrite = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+const D3D12_RESOURCE_STATES ShaderResource = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+const D3D12_RESOURCE_STATES Present = D3D12_RESOURCE_STATE_PRESENT;
+
+// checks recorded barriers against real states of resources, as debug layer does
+class BarrierValidator {
+public:
+	void SetState(ID3D12Resource* resource, D3D12_RESOURCE_STATES state) {
+		m_States[resource] = state;
+	}
+
+	D3D12_RESOURCE_STATES GetState(ID3D12Resource* resource) const {
+		auto it = m_States.find(resource);
+		CHECK(it != m_States.end());
+
+		return it->second;
+	}
+
+	void Apply(const std::vector<D3D12_RESOURCE_BARRIER>& barriers) {
+		for (const D3D12_RESOURCE_BARRIER& barrier : barriers) {
+			if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_ALIASING) {
+				++m_NumAliasingBarriers;
+				continue;
+			}
+
+			ID3D12Resource* resource = barrier.Transition.pResource;
+			D3D12_RESOURCE_STATES before = barrier.Transition.StateBefore;
+			D3D12_RESOURCE_STATES after = barrier.Transition.StateAfter;
+
+			// transition to the same state is error of debug layer
+			CHECK(before != after);
+			++m_NumTransitions;
+
+			if (barrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) {
+				CHECK(GetState(resource) == before && m_SplitBarriers.count(resource) == 0);
+				m_SplitBarriers[resource] = { before, after };
+				++m_NumSplitBarriers;
+				continue;
+			}
+
+			if (barrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY) {
+				auto it = m_SplitBarriers.find(resource);
+				CHECK(it != m_SplitBarriers.end() && it->second.first == before && it->second.second == after);
+				m_SplitBarriers.erase(it);
+			}
+			else {
+				CHECK(m_SplitBarriers.count(resource) == 0 && GetState(resource) == before);
+			}
+
+			m_States[resource] = after;
+		}
+	}
+
+	// resource can be used only in state it is transitioned to and not while its split barrier is begun
+	void CheckUse(ID3D12Resource* resource, D3D12_RESOURCE_STATES state) const {
+		CHECK(m_SplitBarriers.count(resource) == 0);
+		CHECK(GetState(resource) == state);
+	}
+
+	bool HasSplitBarriers() const {
+		return !m_SplitBarriers.empty();
+	}
+
+	// transitions with begun and ended split barriers counted once
+	uint32_t GetNumTransitions() const {
+		return m_NumTransitions - m_NumSplitBarriers;
+	}
+
+	uint32_t GetNumAliasingBarriers() const {
+		return m_NumAliasingBarriers;
+	}
+
+	void ResetCounters() {
+		m_NumTransitions = 0;
+		m_NumSplitBarriers = 0;
+		m_NumAliasingBarriers = 0;
+	}
+
+private:
+	std::map<ID3D12Resource*, D3D12_RESOURCE_STATES> m_States;
+	std::map<ID3D12Resource*, std::pair<D3D12_RESOURCE_STATES, D3D12_RESOURCE_STATES>> m_SplitBarriers;
+	uint32_t m_NumTransitions = 0;
+	uint32_t m_NumSplitBarriers = 0;
+	uint32_t m_NumAliasingBarriers = 0;
+};
+
+struct PassUse {
+	uint32_t Resource;
+	D3D12_RESOURCE_STATES State;
+};
+
+// resources of ModelsApp frame, transients are separate resources placed in shared memory
+struct FrameResources {
+	ID3D12Resource BackBuffers[2] = { { 0 }, { 1 } };
+	ID3D12Resource DepthBuffer = { 2 };
+	ID3D12Resource ShadowMaps[4] = { { 3 }, { 4 }, { 5 }, { 6 } };
+	ID3D12Resource NormalMap = { 7 };
+	ID3D12Resource OcclusionMaps[2] = { { 8 }, { 9 } };
+	ID3D12Resource SobelTexture = { 10 };
+};
+
+// frame graph is built the same way as ModelsApp::BuildFrameGraph does, passes record what they use
+class TestFrame {
+public:
+	TestFrame(FrameResources& resources, uint32_t backBufferIndex, bool isSSAO, bool isSobelFilter) {
+		uint32_t backBuffer = Import(&resources.BackBuffers[backBufferIndex], Present);
+		uint32_t depthBuffer = Import(&resources.DepthBuffer, DepthWrite);
+
+		std::vector<uint32_t> shadowMaps;
+
+		for (ID3D12Resource& shadowMap : resources.ShadowMaps) {
+			shadowMaps.push_back(Import(&shadowMap, ShaderResource));
+		}
+
+		uint32_t normalMap = CreateTransient(&resources.NormalMap, 8);
+		uint32_t occlusionMap0 = CreateTransient(&resources.OcclusionMaps[0], 2);
+		uint32_t occlusionMap1 = CreateTransient(&resources.OcclusionMaps[1], 2);
+		uint32_t sobelTexture = isSobelFilter ? CreateTransient(&resources.SobelTexture, 4) : RenderGraph::InvalidIndex;
+
+		uint32_t pass = AddPass("SSAONormals");
+		Use(pass, normalMap, RenderTarget, false, true);
+		Use(pass, depthBuffer, DepthWrite, false, true);
+
+		for (uint32_t shadowMap : shadowMaps) {
+			Use(pass, shadowMap, ShaderResource, true, false);
+		}
+
+		pass = AddPass("SSAO");
+		Use(pass, normalMap, ShaderResource, true, false);
+		Use(pass, depthBuffer, ShaderResource, true, false);
+		Use(pass, occlusionMap0, RenderTarget, false, true);
+
+		for (uint32_t i = 0; i < 2; ++i) {
+			pass = AddPass("BlurVertical");
+			Use(pass, occlusionMap0, ShaderResource, true, false);
+			Use(pass, occlusionMap1, RenderTarget, false, true);
+
+			pass = AddPass("BlurHorizontal");
+			Use(pass, occlusionMap1, ShaderResource, true, false);
+			Use(pass, occlusionMap0, RenderTarget, false, true);
+		}
+
+		pass = AddPass("Geometry");
+
+		if (isSSAO) {
+			Use(pass, depthBuffer, DepthWrite, true, true);
+			Use(pass, occlusionMap0, ShaderResource, true, false);
+		}
+		else {
+			Use(pass, depthBuffer, DepthWrite, false, true);
+		}
+
+		for (uint32_t shadowMap : shadowMaps) {
+			Use(pass, shadowMap, ShaderResource, true, false);
+		}
+
+		Use(pass, isSobelFilter ? sobelTexture : backBuffer, RenderTarget, false, true);
+
+		if (isSobelFilter) {
+			pass = AddPass("Sobel");
+			Use(pass, sobelTexture, ShaderResource, true, false);
+			Use(pass, backBuffer, RenderTarget, false, true);
+		}
+
+		pass = AddPass("Present", true);
+		Use(pass, backBuffer, Present, true, false);
+
+		m_Graph.Compile();
+	}
+
+	// mirrors RenderGraphResources::Execute
+	void Execute(ResourceStateTracker& tracker) {
+		for (uint32_t i = 0; i < m_Graph.GetNumResources(); ++i) {
+			if (m_Graph.IsUsed(i)) {
+				tracker.Transition(m_Resources[i], static_cast<D3D12_RESOURCE_STATES>(m_Graph.GetInitialState(i)));
+			}
+		}
+
+		for (const RenderGraph::CompiledPass& pass : m_Graph.GetCompiledPasses()) {
+			IssueBarriers(m_Graph.GetBarriers(pass), pass.NumBarriers, tracker);
+			tracker.FlushBarriers(&m_CommandList);
+
+			m_Graph.ExecutePass(pass.Pass);
+
+			IssueBarriers(m_Graph.GetAfterBarriers(pass), pass.NumAfterBarriers, tracker);
+		}
+
+		IssueBarriers(m_Graph.GetFinalBarriers(), m_Graph.GetNumFinalBarriers(), tracker);
+		tracker.FlushBarriers(&m_CommandList);
+	}
+
+	// barriers before list are applied first, uses of each pass are checked after calls recorded before it
+	void Validate(BarrierValidator& validator, const std::vector<D3D12_RESOURCE_BARRIER>& resolvedBarriers) const {
+		validator.Apply(resolvedBarriers);
+
+		size_t numAppliedCalls = 0;
+
+		for (const std::pair<uint32_t, size_t>& executedPass : m_ExecutedPasses) {
+			for (; numAppliedCalls < executedPass.second; ++numAppliedCalls) {
+				validator.Apply(m_CommandList.BarrierCalls[numAppliedCalls]);
+			}
+
+			for (const PassUse& use : m_PassesUses[executedPass.first]) {
+				validator.CheckUse(m_Resources[use.Resource], use.State);
+			}
+		}
+
+		for (; numAppliedCalls < m_CommandList.BarrierCalls.size(); ++numAppliedCalls) {
+			validator.Apply(m_CommandList.BarrierCalls[numAppliedCalls]);
+		}
+
+		CHECK(!validator.HasSplitBarriers());
+	}
+
+	// least number of transitions: each change of state between executed uses, transients return to state of first use
+	uint32_t GetNumRequiredTransitions(const ResourceStates& states) const {
+		std::vector<D3D12_RESOURCE_STATES> currentStates(m_Resources.size());
+
+		for (uint32_t i = 0; i < m_Resources.size(); ++i) {
+			currentStates[i] = static_cast<D3D12_RESOURCE_STATES>(m_Graph.GetInitialState(i));
+			CHECK(!m_Graph.IsUsed(i) || states.GetState(m_Resources[i], currentStates[i]));
+		}
+
+		uint32_t numTransitions = 0;
+
+		for (const RenderGraph::CompiledPass& pass : m_Graph.GetCompiledPasses()) {
+			for (const PassUse& use : m_PassesUses[pass.Pass]) {
+				if (currentStates[use.Resource] != use.State) {
+					currentStates[use.Resource] = use.State;
+					++numTransitions;
+				}
+			}
+		}
+
+		for (uint32_t i = 0; i < m_Resources.size(); ++i) {
+			if (m_Graph.IsTransient(i) && m_Graph.IsUsed(i) && currentStates[i] != m_Graph.GetInitialState(i)) {
+				++numTransitions;
+			}
+		}
+
+		return numTransitions;
+	}
+
+	const RenderGraph& GetGraph() const {
+		return m_Graph;
+	}
+
+	ID3D12Resource* GetResource(uint32_t resource) const {
+		return m_Resources[resource];
+	}
+
+	uint32_t GetNumBarrierCalls() const {
+		return static_cast<uint32_t>(m_CommandList.BarrierCalls.size());
+	}
+
+private:
+	uint32_t Import(ID3D12Resource* resource, D3D12_RESOURCE_STATES state) {
+		m_Resources.push_back(resource);
+		return m_Graph.Import(state);
+	}
+
+	uint32_t CreateTransient(ID3D12Resource* resource, uint64_t size) {
+		m_Resources.push_back(resource);
+		return m_Graph.CreateTransient(size << 20, 65536);
+	}
+
+	uint32_t AddPass(const char* name, bool hasSideEffects = false) {
+		uint32_t pass = static_cast<uint32_t>(m_PassesUses.size());
+		m_PassesUses.emplace_back();
+
+		m_Graph.AddPass(name, [this, pass]() {
+			m_ExecutedPasses.emplace_back(pass, m_CommandList.BarrierCalls.size());
+		}, hasSideEffects);
+
+		return pass;
+	}
+
+	void Use(uint32_t pass, uint32_t resource, D3D12_RESOURCE_STATES state, bool isRead, bool isWrite) {
+		if (isRead && isWrite) {
+			m_Graph.ReadWrite(pass, resource, state);
+		}
+		else if (isRead) {
+			m_Graph.Read(pass, resource, state);
+		}
+		else {
+			m_Graph.Write(pass, resource, state);
+		}
+
+		m_PassesUses[pass].push_back({ resource, state });
+	}
+
+	void IssueBarriers(const RenderGraph::Barrier* barriers, uint32_t numBarriers, ResourceStateTracker& tracker) const {
+		for (uint32_t i = 0; i < numBarriers; ++i) {
+			const RenderGraph::Barrier& barrier = barriers[i];
+			ID3D12Resource* resource = m_Resources[barrier.Resource];
+
+			switch (barrier.Type) {
+				case RenderGraph::BarrierType::Transition:
+				case RenderGraph::BarrierType::EndTransition:
+					tracker.Transition(resource, static_cast<D3D12_RESOURCE_STATES>(barrier.StateAfter));
+					break;
+				case RenderGraph::BarrierType::BeginTransition:
+					tracker.BeginTransition(resource, static_cast<D3D12_RESOURCE_STATES>(barrier.StateAfter));
+					break;
+				case RenderGraph::BarrierType::Aliasing:
+					tracker.AliasResources(m_Resources[barrier.AliasedResource], resource);
+					break;
+			}
+		}
+	}
+
+	RenderGraph m_Graph;
+	std::vector<ID3D12Resource*> m_Resources;
+	std::vector<std::vector<PassUse>> m_PassesUses;
+
+	// pass and number of barrier calls recorded before it
+	std::vector<std::pair<uint32_t, size_t>> m_ExecutedPasses;
+	ID3D12GraphicsCommandList m_CommandList;
+};
+
+void SetInitialStates(FrameResources& resources, ResourceStates& states, BarrierValidator& validator) {
+	auto setState = [&](ID3D12Resource* resource, D3D12_RESOURCE_STATES state) {
+		states.SetState(resource, state);
+		validator.SetState(resource, state);
+	};
+
+	// as app tracks them after creation and as transients are placed in states of their first use
+	setState(&resources.BackBuffers[0], Present);
+	setState(&resources.BackBuffers[1], Present);
+	setState(&resources.DepthBuffer, DepthWrite);
+
+	for (ID3D12Resource& shadowMap : resources.ShadowMaps) {
+		setState(&shadowMap, ShaderResource);
+	}
+
+	setState(&resources.NormalMap, RenderTarget);
+	setState(&resources.OcclusionMaps[0], RenderTarget);
+	setState(&resources.OcclusionMaps[1], RenderTarget);
+	setState(&resources.SobelTexture, RenderTarget);
+}
+
+struct FrameCase {
+	bool IsSSAO;
+	bool IsSobelFilter;
+	// expected per frame
+	uint32_t NumBarrierCalls;
+	uint32_t NumBarriers;
+	uint32_t NumResolvedBarriers;
+};
+
+void TestFrameGraphBarriers() {
+	FrameResources resources;
+	ResourceStates states;
+	BarrierValidator validator;
+	SetInitialStates(resources, states, validator);
+
+	// SSAO passes are culled when geometry doesn`t read occlusion map
+	// states of all resources are known before list, so no barrier is resolved at submission
+	const FrameCase cases[] = {
+		{ false, false, 2, 2, 0 },
+		{ false, true, 2, 4, 0 },
+		{ true, false, 8, 19, 0 },
+		{ true, true, 9, 22, 0 },
+	};
+
+	ResourceStateTracker tracker;
+
+	// switching effects between frames keeps known states consistent
+	for (uint32_t frame = 0; frame < 12; ++frame) {
+		const FrameCase& frameCase = cases[frame % 4];
+
+		TestFrame testFrame(resources, frame % 2, frameCase.IsSSAO, frameCase.IsSobelFilter);
+		uint32_t numRequiredTransitions = testFrame.GetNumRequiredTransitions(states);
+
+		testFrame.Execute(tracker);
+
+		std::vector<D3D12_RESOURCE_BARRIER> resolvedBarriers;
+		uint32_t numResolvedBarriers = tracker.ResolvePendingBarriers(states, resolvedBarriers);
+		tracker.CommitFinalStates(states);
+
+		validator.ResetCounters();
+		testFrame.Validate(validator, resolvedBarriers);
+
+		std::printf(
+			"SSAO %d, Sobel %d: %u barrier calls, %u barriers, %u resolved, %u required transitions\n",
+			frameCase.IsSSAO, frameCase.IsSobelFilter,
+			tracker.GetNumBarrierCalls(), tracker.GetNumBarriers(), numResolvedBarriers, numRequiredTransitions
+		);
+
+		// no transition is issued twice or undone, aliasing barriers are the only others
+		CHECK(validator.GetNumTransitions() == numRequiredTransitions);
+
+		// one call per group of barriers before pass, split barriers begun after pass go with next group
+		CHECK(tracker.GetNumBarrierCalls() == testFrame.GetNumBarrierCalls());
+		CHECK(tracker.GetNumBarrierCalls() == frameCase.NumBarrierCalls);
+		CHECK(tracker.GetNumBarriers() == frameCase.NumBarriers);
+		CHECK(numResolvedBarriers == frameCase.NumResolvedBarriers);
+
+		// states after list are what validator sees
+		for (uint32_t i = 0; i < testFrame.GetGraph().GetNumResources(); ++i) {
+			D3D12_RESOURCE_STATES state;
+			ID3D12Resource* resource = testFrame.GetResource(i);
+
+			CHECK(states.GetState(resource, state) && state == validator.GetState(resource));
+		}
+
+		tracker.Reset();
+	}
+}
+
+void TestShadowMapsPass() {
+	FrameResources resources;
+	ResourceStates states;
+	BarrierValidator validator;
+	SetInitialStates(resources, states, validator);
+
+	ResourceStateTracker tracker;
+	ID3D12GraphicsCommandList commandList;
+
+	// as ModelsApp::RenderShadowMaps records it, transition of map to shader resource overlaps with rendering of next maps
+	for (ID3D12Resource& shadowMap : resources.ShadowMaps) {
+		tracker.Transition(&shadowMap, DepthWrite);
+		tracker.FlushBarriers(&commandList);
+		tracker.BeginTransition(&shadowMap, ShaderResource);
+	}
+
+	for (ID3D12Resource& shadowMap : resources.ShadowMaps) {
+		tracker.Transition(&shadowMap, ShaderResource);
+	}
+
+	tracker.FlushBarriers(&commandList);
+
+	std::vector<D3D12_RESOURCE_BARRIER> resolvedBarriers;
+	uint32_t numResolvedBarriers = tracker.ResolvePendingBarriers(states, resolvedBarriers);
+	tracker.CommitFinalStates(states);
+
+	validator.Apply(resolvedBarriers);
+
+	for (const std::vector<D3D12_RESOURCE_BARRIER>& call : commandList.BarrierCalls) {
+		validator.Apply(call);
+	}
+
+	CHECK(!validator.HasSplitBarriers());
+
+	// first transitions to depth are resolved before list, the last begun barrier is not split
+	CHECK(numResolvedBarriers == 4);
+	CHECK(tracker.GetNumBarrierCalls() == 4 && tracker.GetNumBarriers() == 7);
+	CHECK(validator.GetNumTransitions() == 8);
+}
+
+void TestMergedTransitions() {
+	ID3D12Resource resource = { 0 };
+	ResourceStates states;
+	states.SetState(&resource, Present);
+
+	ResourceStateTracker tracker;
+	ID3D12GraphicsCommandList commandList;
+
+	// first use is resolved, transitions between flushes are merged and dropped if resource returns to its state
+	tracker.Transition(&resource, RenderTarget);
+	tracker.FlushBarriers(&commandList);
+
+	tracker.Transition(&resource, ShaderResource);
+	tracker.Transition(&resource, DepthWrite);
+	tracker.FlushBarriers(&commandList);
+
+	tracker.Transition(&resource, ShaderResource);
+	tracker.Transition(&resource, DepthWrite);
+	tracker.FlushBarriers(&commandList);
+
+	CHECK(commandList.BarrierCalls.size() == 1 && commandList.BarrierCalls[0].size() == 1);
+	CHECK(commandList.BarrierCalls[0][0].Transition.StateBefore == RenderTarget);
+	CHECK(commandList.BarrierCalls[0][0].Transition.StateAfter == DepthWrite);
+
+	std::vector<D3D12_RESOURCE_BARRIER> resolvedBarriers;
+	CHECK(tracker.ResolvePendingBarriers(states, resolvedBarriers) == 1);
+	CHECK(resolvedBarriers[0].Transition.StateBefore == Present && resolvedBarriers[0].Transition.StateAfter == RenderTarget);
+}
+
+// random streams of transitions, split barriers and flushes are validated barrier by barrier
+void TestRandomStreams() {
+	std::mt19937 rng(45);
+
+	const D3D12_RESOURCE_STATES allStates[] = { RenderTarget, ShaderResource, DepthWrite, Present };
+	ID3D12Resource resources[6] = { { 0 }, { 1 }, { 2 }, { 3 }, { 4 }, { 5 } };
+
+	for (uint32_t iteration = 0; iteration < 20000; ++iteration) {
+		ResourceStates states;
+		BarrierValidator validator;
+
+		for (ID3D12Resource& resource : resources) {
+			D3D12_RESOURCE_STATES state = allStates[rng() % 4];
+			states.SetState(&resource, state);
+			validator.SetState(&resource, state);
+		}
+
+		ResourceStateTracker tracker;
+		ID3D12GraphicsCommandList commandList;
+		std::map<ID3D12Resource*, bool> isSplit;
+
+		uint32_t numOperations = rng() % 30;
+
+		for (uint32_t i = 0; i < numOperations; ++i) {
+			ID3D12Resource* resource = &resources[rng() % 6];
+			D3D12_RESOURCE_STATES state = allStates[rng() % 4];
+
+			switch (rng() % 4) {
+				case 0:
+					if (!isSplit[resource]) {
+						tracker.BeginTransition(resource, state);
+						isSplit[resource] = true;
+						break;
+					}
+					// begun transition is ended by next one
+					[[fallthrough]];
+				case 1:
+				case 2:
+					tracker.Transition(resource, state);
+					isSplit[resource] = false;
+					break;
+				default:
+					tracker.FlushBarriers(&commandList);
+					break;
+			}
+		}
+
+		// all split barriers are ended in the same list
+		for (ID3D12Resource& resource : resources) {
+			tracker.Transition(&resource, ShaderResource);
+		}
+
+		tracker.FlushBarriers(&commandList);
+
+		std::vector<D3D12_RESOURCE_BARRIER> resolvedBarriers;
+		tracker.ResolvePendingBarriers(states, resolvedBarriers);
+		tracker.CommitFinalStates(states);
+
+		validator.Apply(resolvedBarriers);
+
+		for (const std::vector<D3D12_RESOURCE_BARRIER>& call : commandList.BarrierCalls) {
+			CHECK(!call.empty());
+			validator.Apply(call);
+		}
+
+		CHECK(!validator.HasSplitBarriers());
+
+		for (ID3D12Resource& resource : resources) {
+			D3D12_RESOURCE_STATES state;
+
+			CHECK(validator.GetState(&resource) == ShaderResource);
+			CHECK(states.GetState(&resource, state) && state == ShaderResource);
+		}
+	}
+}
+
+int main() {
+	TestFrameGraphBarriers();
+	TestShadowMapsPass();
+	TestMergedTransitions();
+	TestRandomStreams();
+
+	std::printf("ResourceStateTracker tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include <MyD3D12Lib/TLSFAllocator.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+// reference is first fit over free ranges ordered by offset, as simple heap suballocators do
+class FirstFitAllocator {
+public:
+	explicit FirstFitAllocator(uint64_t size) {
+		m_FreeRanges[0] = size;
+	}
+
+	uint64_t Allocate(uint64_t size, uint64_t alignment) {
+		for (auto it = m_FreeRanges.begin(); it != m_FreeRanges.end(); ++it) {
+			uint64_t offset = (it->first + alignment - 1) / alignment * alignment;
+			uint64_t end = it->first + it->second;
+
+			if (offset + size > end) {
+				continue;
+			}
+
+			uint64_t begin = it->first;
+			m_FreeRanges.erase(it);
+
+			if (offset > begin) {
+				m_FreeRanges[begin] = offset - begin;
+			}
+
+			if (offset + size < end) {
+				m_FreeRanges[offset + size] = end - offset - size;
+			}
+
+			return offset;
+		}
+
+		return UINT64_MAX;
+	}
+
+	void Free(uint64_t offset, uint64_t size) {
+		auto it = m_FreeRanges.emplace(offset, size).first;
+		auto next = std::next(it);
+
+		if (next != m_FreeRanges.end() && offset + size == next->first) {
+			it->second += next->second;
+			m_FreeRanges.erase(next);
+		}
+
+		if (it != m_FreeRanges.begin()) {
+			auto prev = std::prev(it);
+
+			if (prev->first + prev->second == it->first) {
+				prev->second += it->second;
+				m_FreeRanges.erase(it);
+			}
+		}
+	}
+
+	uint64_t GetLargestFreeRange() const {
+		uint64_t largest = 0;
+
+		for (const auto& range : m_FreeRanges) {
+			largest = std::max(largest, range.second);
+		}
+
+		return largest;
+	}
+
+	size_t GetNumFreeRanges() const {
+		return m_FreeRanges.size();
+	}
+
+private:
+	std::map<uint64_t, uint64_t> m_FreeRanges;
+};
+
+struct Allocation {
+	uint64_t Offset = 0;
+	uint64_t Size = 0;
+	TLSFAllocation TLSF;
+};
+
+struct RunResult {
+	double Seconds = 0.0;
+	uint64_t NumFailures = 0;
+	uint64_t UsedSize = 0;
+	uint64_t LargestFreeBlock = 0;
+	size_t NumFreeBlocks = 0;
+};
+
+// heap like workload: 1 GiB of placed resources from 64 KiB to 16 MiB with 64 KiB alignment
+template<typename AllocateFunction, typename FreeFunction>
+RunResult RunWorkload(uint32_t numOperations, AllocateFunction allocate, FreeFunction free) {
+	const uint64_t alignment = 64 * 1024;
+
+	std::mt19937_64 rng(41);
+	std::vector<Allocation> allocations;
+	RunResult result;
+
+	Stopwatch stopwatch;
+
+	for (uint32_t i = 0; i < numOperations; ++i) {
+		if (allocations.size() < 2000 && (allocations.empty() || rng() % 100 < 52)) {
+			Allocation allocation;
+			allocation.Size = alignment * (1 + (rng() % 4 == 0 ? rng() % 256 : rng() % 16));
+
+			if (allocate(allocation, alignment)) {
+				allocations.push_back(allocation);
+			}
+			else {
+				++result.NumFailures;
+			}
+		}
+		else {
+			size_t index = rng() % allocations.size();
+
+			free(allocations[index]);
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+
+	result.Seconds = stopwatch.GetSeconds();
+
+	for (const Allocation& allocation : allocations) {
+		result.UsedSize += allocation.Size;
+	}
+
+	return result;
+}
+
+void PrintResult(const char* name, const RunResult& result, uint32_t numOperations, uint64_t size) {
+	std::printf(
+		"%-9s %.0f ns per operation, %llu failures, used %.0f MB, largest free block %.0f MB, fragmentation %.3f, %zu free blocks\n",
+		name,
+		result.Seconds / numOperations * 1e9,
+		static_cast<unsigned long long>(result.NumFailures),
+		result.UsedSize / 1048576.0,
+		result.LargestFreeBlock / 1048576.0,
+		1.0 - static_cast<double>(result.LargestFreeBlock) / (size - result.UsedSize),
+		result.NumFreeBlocks
+	);
+}
+
+// argument is number of allocations and frees
+int main(int argc, char** argv) {
+	uint32_t numOperations = GetScaleArgument(argc, argv, 200000);
+	const uint64_t size = 1ull << 30;
+
+	TLSFAllocator tlsf(size);
+
+	RunResult tlsfResult = RunWorkload(
+		numOperations,
+		[&](Allocation& allocation, uint64_t alignment) {
+			allocation.TLSF = tlsf.Allocate(allocation.Size, alignment);
+			allocation.Offset = allocation.TLSF.Offset;
+			return allocation.TLSF.IsValid();
+		},
+		[&](const Allocation& allocation) {
+			tlsf.Free(allocation.TLSF);
+		}
+	);
+
+	tlsfResult.LargestFreeBlock = tlsf.GetLargestFreeBlock();
+	tlsfResult.NumFreeBlocks = tlsf.GetNumFreeBlocks();
+	CHECK(tlsf.GetUsedSize() == tlsfResult.UsedSize);
+
+	FirstFitAllocator firstFit(size);
+
+	RunResult firstFitResult = RunWorkload(
+		numOperations,
+		[&](Allocation& allocation, uint64_t alignment) {
+			allocation.Offset = firstFit.Allocate(allocation.Size, alignment);
+			return allocation.Offset != UINT64_MAX;
+		},
+		[&](const Allocation& allocation) {
+			firstFit.Free(allocation.Offset, allocation.Size);
+		}
+	);
+
+	firstFitResult.LargestFreeBlock = firstFit.GetLargestFreeRange();
+	firstFitResult.NumFreeBlocks = firstFit.GetNumFreeRanges();
+
+	std::printf("%u operations on 1 GiB heap\n", numOperations);
+	PrintResult("TLSF", tlsfResult, numOperations, size);
+	PrintResult("first fit", firstFitResult, numOperations, size);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include <MyD3D12Lib/TLSFAllocator.h>
+
+#include <TestUtils.h>
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+void TestBasic() {
+	TLSFAllocator allocator(1000);
+
+	CHECK(allocator.GetFreeSize() == 1000 && allocator.GetNumFreeBlocks() == 1);
+	CHECK(allocator.GetLargestFreeBlock() == 1000 && allocator.GetFragmentation() == 0.0f);
+
+	TLSFAllocation a = allocator.Allocate(100);
+	TLSFAllocation b = allocator.Allocate(200, 256);
+	TLSFAllocation c = allocator.Allocate(300);
+
+	CHECK(a.IsValid() && b.IsValid() && c.IsValid());
+	CHECK(b.Offset % 256 == 0);
+	CHECK(allocator.GetUsedSize() == 600 && allocator.GetNumAllocations() == 3);
+
+	// too big request fails and doesn`t change allocator
+	CHECK(!allocator.Allocate(1000).IsValid());
+	CHECK(allocator.GetUsedSize() == 600 && allocator.GetNumAllocations() == 3);
+
+	// freed hole in the middle is reused, neighbours are merged when all is freed
+	allocator.Free(b);
+	TLSFAllocation d = allocator.Allocate(200);
+	CHECK(d.IsValid());
+
+	allocator.Free(a);
+	allocator.Free(c);
+	allocator.Free(d);
+
+	CHECK(allocator.GetUsedSize() == 0 && allocator.GetNumAllocations() == 0);
+	CHECK(allocator.GetNumFreeBlocks() == 1 && allocator.GetLargestFreeBlock() == 1000);
+}
+
+void TestWholeSpace() {
+	// request of whole free space is found by search in its size class
+	for (uint64_t size : { 1ull, 31ull, 32ull, 33ull, 1000ull, 65537ull, 1ull << 40 }) {
+		TLSFAllocator allocator(size);
+
+		TLSFAllocation allocation = allocator.Allocate(size);
+		CHECK(allocation.IsValid() && allocation.Offset == 0 && allocation.Size == size);
+		CHECK(allocator.GetFreeSize() == 0 && allocator.GetNumFreeBlocks() == 0);
+		CHECK(!allocator.Allocate(1).IsValid());
+
+		allocator.Free(allocation);
+		CHECK(allocator.GetLargestFreeBlock() == size);
+	}
+
+	// overflow of padded size fails instead of wrapping
+	TLSFAllocator allocator(1ull << 40);
+	CHECK(!allocator.Allocate(UINT64_MAX, 1ull << 20).IsValid());
+}
+
+// size which surely succeeds if free block of it exists, padded size rounded up to next class
+uint64_t GetGuaranteedSize(uint64_t size, uint64_t alignment) {
+	uint64_t paddedSize = size + alignment - 1;
+
+	if (paddedSize < 32) {
+		return paddedSize;
+	}
+
+	uint32_t lastSet = 63;
+
+	while ((paddedSize >> lastSet) == 0) {
+		--lastSet;
+	}
+
+	return paddedSize + (1ull << (lastSet - 5)) - 1;
+}
+
+// random allocations and frees are compared with model of live ranges
+void TestStress(uint32_t seed) {
+	std::mt19937_64 rng(seed);
+
+	for (uint32_t round = 0; round < 20; ++round) {
+		uint64_t size = 1 + rng() % (1ull << (10 + round));
+		TLSFAllocator allocator(size);
+
+		std::map<uint64_t, TLSFAllocation> allocations;
+		uint64_t usedSize = 0;
+
+		for (uint32_t i = 0; i < 20000; ++i) {
+			if (allocations.empty() || rng() % 100 < 55) {
+				uint64_t allocationSize = 1 + rng() % (1 + size / (1 + rng() % 64));
+				uint64_t alignment = 1ull << (rng() % 8);
+				uint64_t largestFreeBlock = allocator.GetLargestFreeBlock();
+
+				TLSFAllocation allocation = allocator.Allocate(allocationSize, alignment);
+
+				if (!allocation.IsValid()) {
+					CHECK(largestFreeBlock < GetGuaranteedSize(allocationSize, alignment));
+					continue;
+				}
+
+				CHECK(allocation.Offset % alignment == 0);
+				CHECK(allocation.Size == allocationSize && allocation.Offset + allocationSize <= size);
+
+				// doesn`t overlap neighbours
+				auto next = allocations.lower_bound(allocation.Offset);
+
+				if (next != allocations.end()) {
+					CHECK(allocation.Offset + allocationSize <= next->first);
+				}
+
+				if (next != allocations.begin()) {
+					auto prev = std::prev(next);
+					CHECK(prev->first + prev->second.Size <= allocation.Offset);
+				}
+
+				allocations[allocation.Offset] = allocation;
+				usedSize += allocationSize;
+			}
+			else {
+				auto it = allocations.begin();
+				std::advance(it, rng() % allocations.size());
+
+				allocator.Free(it->second);
+				usedSize -= it->second.Size;
+				allocations.erase(it);
+			}
+
+			CHECK(allocator.GetUsedSize() == usedSize && allocator.GetFreeSize() == size - usedSize);
+			CHECK(allocator.GetNumAllocations() == allocations.size());
+			CHECK(allocator.GetLargestFreeBlock() <= size - usedSize);
+		}
+
+		for (const auto& allocation : allocations) {
+			allocator.Free(allocation.second);
+		}
+
+		// all free blocks are merged back
+		CHECK(allocator.GetNumFreeBlocks() == 1 && allocator.GetLargestFreeBlock() == size);
+		CHECK(allocator.GetFragmentation() == 0.0f);
+	}
+}
+
+void TestMove() {
+	TLSFAllocator allocator(4096);
+	TLSFAllocation a = allocator.Allocate(1024);
+
+	TLSFAllocator moved(std::move(allocator));
+	CHECK(moved.GetUsedSize() == 1024);
+
+	moved.Free(a);
+	CHECK(moved.GetNumFreeBlocks() == 1 && moved.GetLargestFreeBlock() == 4096);
+}
+
+int main() {
+	TestBasic();
+	TestWholeSpace();
+	TestStress(41);
+	TestStress(42);
+	TestMove();
+
+	std::printf("TLSFAllocator tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include <MyD3D12Lib/SkylinePacker.h>
+#include <MyD3D12Lib/TexturePacker.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+enum class SizeDistribution {
+	Uniform = 0,
+	PowerOfTwo,
+	Tall,
+	Count
+};
+
+const char* GetDistributionName(SizeDistribution distribution) {
+	switch (distribution) {
+	case SizeDistribution::Uniform:
+		return "uniform";
+	case SizeDistribution::PowerOfTwo:
+		return "power of two";
+	default:
+		return "tall";
+	}
+}
+
+std::pair<uint32_t, uint32_t> GenerateSize(SizeDistribution distribution, std::mt19937& rng) {
+	switch (distribution) {
+	case SizeDistribution::Uniform:
+		return { 8 + rng() % 120, 8 + rng() % 120 };
+	case SizeDistribution::PowerOfTwo:
+		return { 16u << (rng() % 4), 16u << (rng() % 4) };
+	default:
+		return { 4 + rng() % 60, 4 + rng() % 200 };
+	}
+}
+
+// argument is number of bins for each distribution
+int main(int argc, char** argv) {
+	uint32_t numBins = GetScaleArgument(argc, argv, 200);
+
+	std::mt19937 rng(39);
+
+	std::printf("skyline packing of 2000 rectangles into 1024x1024 bin, %u bins\n", numBins);
+
+	for (uint32_t d = 0; d < static_cast<uint32_t>(SizeDistribution::Count); ++d) {
+		SizeDistribution distribution = static_cast<SizeDistribution>(d);
+		double occupancy = 0.0;
+		double seconds = 0.0;
+
+		for (uint32_t bin = 0; bin < numBins; ++bin) {
+			std::vector<std::pair<uint32_t, uint32_t>> sizes(2000);
+
+			for (auto& size : sizes) {
+				size = GenerateSize(distribution, rng);
+			}
+
+			// the highest first, as texture packer does
+			std::sort(sizes.begin(), sizes.end(), [](const auto& a, const auto& b) {
+				return std::make_pair(a.second, a.first) > std::make_pair(b.second, b.first);
+			});
+
+			SkylinePacker packer(1024, 1024);
+			Stopwatch stopwatch;
+
+			for (const auto& size : sizes) {
+				PackedRect rect;
+				packer.Insert(size.first, size.second, rect);
+			}
+
+			seconds += stopwatch.GetSeconds();
+			occupancy += packer.GetOccupancy();
+
+			CHECK(packer.GetUsedArea() <= 1024 * 1024);
+		}
+
+		std::printf("%-12s occupancy %.3f, %.1f us per bin\n", GetDistributionName(distribution), occupancy / numBins, seconds / numBins * 1e6);
+	}
+
+	// plan for scene with many small block compressed textures, efficiency is area of items relative to area of groups
+	std::vector<TexturePackingItem> items;
+
+	for (uint32_t i = 0; i < 10 * numBins; ++i) {
+		uint32_t width = 32u << (rng() % 4);
+		uint32_t height = 32u << (rng() % 4);
+		uint32_t mipLevels = 1;
+
+		while ((std::max(width, height) >> mipLevels) > 0) {
+			++mipLevels;
+		}
+
+		items.push_back({ width, height, rng() % 2 == 0 ? 71u : 77u, mipLevels, 4 });
+	}
+
+	Stopwatch stopwatch;
+	TexturePackingPlan plan = PlanTexturePacking(items, TexturePackingDesc());
+	double seconds = stopwatch.GetSeconds();
+
+	CHECK(plan.Placements.size() == items.size());
+	KeepResult(plan.GroupsArea);
+
+	uint32_t numPages = 0;
+
+	for (const TextureGroup& group : plan.Groups) {
+		numPages += group.ArraySize;
+	}
+
+	std::printf(
+		"plan of %zu textures: %zu groups, %u pages, efficiency %.3f, %.2f ms\n",
+		items.size(), plan.Groups.size(), numPages, static_cast<double>(plan.ItemsArea) / plan.GroupsArea, seconds * 1e3
+	);
+
+	return 0;
+}
\ No newline at end of file
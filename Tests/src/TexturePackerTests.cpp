@@ -0,0 +1,261 @@
+#include <MyD3D12Lib/SkylinePacker.h>
+#include <MyD3D12Lib/TexturePacker.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+bool Overlap(const PackedRect& a, const PackedRect& b) {
+	return a.X < b.X + b.Width && b.X < a.X + a.Width && a.Y < b.Y + b.Height && b.Y < a.Y + a.Height;
+}
+
+void TestSkylineBasic() {
+	SkylinePacker packer(100, 100);
+	PackedRect rect;
+
+	CHECK(packer.Insert(50, 50, rect) && rect.X == 0 && rect.Y == 0);
+	CHECK(packer.Insert(50, 50, rect) && rect.X == 50 && rect.Y == 0);
+	CHECK(packer.Insert(100, 50, rect) && rect.X == 0 && rect.Y == 50);
+
+	CHECK(!packer.Insert(1, 1, rect));
+	CHECK(packer.GetOccupancy() == 1.0f);
+	CHECK(packer.GetUsedHeight() == 100);
+
+	// empty and too wide rectangles don`t fit
+	CHECK(!packer.Insert(0, 1, rect));
+	packer.Reset();
+	CHECK(packer.GetUsedArea() == 0 && packer.GetUsedHeight() == 0);
+	CHECK(!packer.Insert(101, 1, rect));
+}
+
+void TestSkylineFailedInsert() {
+	SkylinePacker packer(64, 64);
+	PackedRect rect;
+
+	CHECK(packer.Insert(64, 40, rect));
+	uint64_t usedArea = packer.GetUsedArea();
+
+	// failed insert doesn`t change bin
+	CHECK(!packer.Insert(32, 32, rect));
+	CHECK(packer.GetUsedArea() == usedArea && packer.GetUsedHeight() == 40);
+
+	CHECK(packer.Insert(32, 24, rect) && rect.Y == 40);
+}
+
+void TestSkylineRandom() {
+	std::mt19937 rng(39);
+
+	for (uint32_t run = 0; run < 30; ++run) {
+		uint32_t width = 64 + rng() % 1024;
+		uint32_t height = 64 + rng() % 1024;
+		SkylinePacker packer(width, height);
+
+		std::vector<PackedRect> rects;
+		uint64_t area = 0;
+
+		for (uint32_t i = 0; i < 500; ++i) {
+			PackedRect rect;
+
+			if (packer.Insert(1 + rng() % 100, 1 + rng() % 100, rect)) {
+				CHECK(rect.X + rect.Width <= width && rect.Y + rect.Height <= height);
+				CHECK(rect.Y + rect.Height <= packer.GetUsedHeight());
+
+				rects.push_back(rect);
+				area += static_cast<uint64_t>(rect.Width) * rect.Height;
+			}
+		}
+
+		for (size_t i = 0; i < rects.size(); ++i) {
+			for (size_t j = i + 1; j < rects.size(); ++j) {
+				CHECK(!Overlap(rects[i], rects[j]));
+			}
+		}
+
+		CHECK(packer.GetUsedArea() == area);
+	}
+}
+
+void TestPlanGroups() {
+	std::vector<TexturePackingItem> items;
+
+	// arrays by size and mips
+	for (uint32_t i = 0; i < 10; ++i) {
+		items.push_back({ 1024, 1024, 71, 11, 4 });
+	}
+
+	for (uint32_t i = 0; i < 3; ++i) {
+		items.push_back({ 2048, 2048, 71, 12, 4 });
+	}
+
+	items.push_back({ 512, 512, 98, 10, 4 });
+
+	// small block compressed items share atlas
+	for (uint32_t i = 0; i < 20; ++i) {
+		items.push_back({ 64u << (i % 3), 64, 71, 7 + i % 3, 4 });
+	}
+
+	// single item of format and item with side not multiple of gutter go to arrays
+	items.push_back({ 96, 64, 29, 7, 1 });
+	items.push_back({ 100, 64, 29, 7, 1 });
+
+	TexturePackingDesc desc;
+	desc.AtlasMipLevels = 4;
+
+	TexturePackingPlan plan = PlanTexturePacking(items, desc);
+
+	CHECK(plan.Placements.size() == items.size());
+	CHECK(plan.Groups.size() == 6);
+
+	uint32_t numAtlases = 0;
+
+	for (const TextureGroup& group : plan.Groups) {
+		if (group.Type == TextureGroupType::Atlas) {
+			++numAtlases;
+
+			// one block at last of 4 mips
+			CHECK(group.Gutter == 32);
+			CHECK(group.Width % group.Gutter == 0 && group.Height % group.Gutter == 0);
+			CHECK(group.Width <= desc.AtlasSize && group.Height <= desc.AtlasSize);
+		}
+
+		CHECK(group.ArraySize <= desc.MaxArraySize);
+	}
+
+	CHECK(numAtlases == 1);
+
+	uint64_t itemsArea = 0;
+
+	for (size_t i = 0; i < items.size(); ++i) {
+		const TexturePlacement& placement = plan.Placements[i];
+		const TextureGroup& group = plan.Groups[placement.Group];
+
+		CHECK(group.Format == items[i].Format);
+		CHECK(placement.ArrayIndex < group.ArraySize);
+		CHECK(placement.Rect.Width == items[i].Width && placement.Rect.Height == items[i].Height);
+
+		itemsArea += static_cast<uint64_t>(items[i].Width) * items[i].Height;
+
+		if (group.Type == TextureGroupType::Array) {
+			CHECK(group.Width == items[i].Width && group.Height == items[i].Height && group.MipLevels == items[i].MipLevels);
+			CHECK(placement.UVScale[0] == 1.0f && placement.UVScale[1] == 1.0f);
+			CHECK(placement.UVOffset[0] == 0.0f && placement.UVOffset[1] == 0.0f);
+			continue;
+		}
+
+		// items with their gutters are inside page and don`t overlap each other
+		const PackedRect& rect = placement.Rect;
+		CHECK(rect.X >= group.Gutter && rect.X + rect.Width + group.Gutter <= group.Width);
+		CHECK(rect.Y >= group.Gutter && rect.Y + rect.Height + group.Gutter <= group.Height);
+
+		PackedRect padded = { rect.X - group.Gutter, rect.Y - group.Gutter, rect.Width + 2 * group.Gutter, rect.Height + 2 * group.Gutter };
+
+		for (size_t j = 0; j < items.size(); ++j) {
+			const TexturePlacement& other = plan.Placements[j];
+
+			if (j == i || other.Group != placement.Group || other.ArrayIndex != placement.ArrayIndex) {
+				continue;
+			}
+
+			PackedRect otherPadded = { other.Rect.X - group.Gutter, other.Rect.Y - group.Gutter, other.Rect.Width + 2 * group.Gutter, other.Rect.Height + 2 * group.Gutter };
+			CHECK(!Overlap(padded, otherPadded));
+		}
+
+		// corners of item map to corners of its rectangle in page
+		CHECK(placement.UVOffset[0] * group.Width == rect.X && placement.UVOffset[1] * group.Height == rect.Y);
+		CHECK((placement.UVScale[0] + placement.UVOffset[0]) * group.Width == rect.X + rect.Width);
+		CHECK((placement.UVScale[1] + placement.UVOffset[1]) * group.Height == rect.Y + rect.Height);
+	}
+
+	CHECK(plan.ItemsArea == itemsArea);
+	CHECK(plan.GroupsArea >= plan.ItemsArea);
+}
+
+void TestCopyFillsGutter() {
+	std::vector<TexturePackingItem> items = { { 32, 32, 1, 6, 1 }, { 64, 32, 1, 7, 1 }, { 32, 64, 1, 7, 1 } };
+
+	TexturePackingDesc desc;
+	desc.AtlasMipLevels = 3;
+	desc.AtlasSize = 256;
+
+	TexturePackingPlan plan = PlanTexturePacking(items, desc);
+	CHECK(plan.Groups.size() == 1);
+
+	const TextureGroup& group = plan.Groups[0];
+	CHECK(group.Type == TextureGroupType::Atlas && group.Gutter == 4);
+
+	// texel keeps item, row and column, so each gutter texel is checked to be copy of nearest edge one
+	auto texel = [](size_t item, int x, int y) {
+		return static_cast<uint32_t>((item + 1) << 24 | y << 12 | x);
+	};
+
+	for (uint32_t mip = 0; mip < group.MipLevels; ++mip) {
+		uint32_t width = group.Width >> mip;
+		uint32_t height = group.Height >> mip;
+		std::vector<uint32_t> page(width * height, 0);
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			uint32_t itemWidth = items[i].Width >> mip;
+			uint32_t itemHeight = items[i].Height >> mip;
+			std::vector<uint32_t> src(itemWidth * itemHeight);
+
+			for (uint32_t y = 0; y < itemHeight; ++y) {
+				for (uint32_t x = 0; x < itemWidth; ++x) {
+					src[y * itemWidth + x] = texel(i, x, y);
+				}
+			}
+
+			CopyTextureToAtlasMip(
+				group, plan.Placements[i], mip,
+				reinterpret_cast<const uint8_t*>(src.data()), itemWidth * 4,
+				reinterpret_cast<uint8_t*>(page.data()), width * 4, 4
+			);
+		}
+
+		for (size_t i = 0; i < items.size(); ++i) {
+			const PackedRect& rect = plan.Placements[i].Rect;
+			int x0 = rect.X >> mip;
+			int y0 = rect.Y >> mip;
+			int itemWidth = rect.Width >> mip;
+			int itemHeight = rect.Height >> mip;
+			int gutter = group.Gutter >> mip;
+
+			for (int y = -gutter; y < itemHeight + gutter; ++y) {
+				for (int x = -gutter; x < itemWidth + gutter; ++x) {
+					int edgeX = std::min(std::max(x, 0), itemWidth - 1);
+					int edgeY = std::min(std::max(y, 0), itemHeight - 1);
+
+					CHECK(page[(y0 + y) * width + x0 + x] == texel(i, edgeX, edgeY));
+				}
+			}
+		}
+	}
+}
+
+void TestManyPages() {
+	std::vector<TexturePackingItem> items(300, { 128, 128, 5, 8, 4 });
+	TexturePackingDesc desc;
+
+	TexturePackingPlan plan = PlanTexturePacking(items, desc);
+
+	CHECK(plan.Groups.size() == 1);
+	CHECK(plan.Groups[0].Type == TextureGroupType::Atlas && plan.Groups[0].ArraySize > 1);
+
+	for (const TexturePlacement& placement : plan.Placements) {
+		CHECK(placement.ArrayIndex < plan.Groups[0].ArraySize);
+	}
+}
+
+int main() {
+	TestSkylineBasic();
+	TestSkylineFailedInsert();
+	TestSkylineRandom();
+	TestPlanGroups();
+	TestCopyFillsGutter();
+	TestManyPages();
+
+	std::printf("TexturePacker tests passed\n");
+	return 0;
+}
\ No newline at end of file
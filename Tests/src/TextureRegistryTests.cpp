@@ -0,0 +1,151 @@
+#include <MyD3D12Lib/ContentHash.h>
+#include <MyD3D12Lib/TextureRegistry.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+void TestContentHash() {
+	std::mt19937 rng(34);
+	std::vector<uint8_t> data(1000);
+
+	for (uint8_t& byte : data) {
+		byte = static_cast<uint8_t>(rng());
+	}
+
+	// SIMD paths match scalar reference for all tails and unaligned starts
+	for (size_t offset = 0; offset < 8; ++offset) {
+		for (size_t size = 0; size + offset <= 300; ++size) {
+			CHECK(ComputeContentHash(data.data() + offset, size) == ComputeContentHashScalar(data.data() + offset, size));
+		}
+	}
+
+	CHECK(ComputeContentHash(data.data(), data.size(), 7) == ComputeContentHashScalar(data.data(), data.size(), 7));
+	CHECK(ComputeContentHash(data.data(), data.size(), 7) != ComputeContentHash(data.data(), data.size()));
+
+	// each flipped bit changes hash
+	Hash128 original = ComputeContentHash(data.data(), data.size());
+
+	for (size_t bit = 0; bit < 8 * data.size(); bit += 13) {
+		data[bit / 8] ^= 1 << (bit % 8);
+		CHECK(ComputeContentHash(data.data(), data.size()) != original);
+		data[bit / 8] ^= 1 << (bit % 8);
+	}
+
+	CHECK(ComputeContentHash(data.data(), data.size()) == original);
+}
+
+TextureContentKey MakeKey(uint64_t content, uint32_t format = 28, uint32_t width = 256, uint32_t height = 256, uint32_t mipLevels = 9) {
+	TextureContentKey key;
+	key.ContentHash = ComputeContentHash(&content, sizeof(content));
+	key.Format = format;
+	key.Width = width;
+	key.Height = height;
+	key.MipLevels = mipLevels;
+
+	return key;
+}
+
+void TestAliasing() {
+	TextureRegistry registry;
+
+	CHECK(registry.Register("a.png", MakeKey(1), 100) == "a.png");
+	CHECK(registry.Register("b.png", MakeKey(2), 200) == "b.png");
+
+	// same content under other path is alias of first name
+	CHECK(registry.Register("copy/a.png", MakeKey(1), 100) == "a.png");
+	CHECK(registry.Register("other/a.jpg", MakeKey(1), 100) == "a.png");
+
+	// same name registered again, e.g. by next scene, isn`t counted twice
+	CHECK(registry.Register("copy/a.png", MakeKey(1), 100) == "a.png");
+	CHECK(registry.Register("b.png", MakeKey(2), 200) == "b.png");
+
+	// same pixels in other format, size or mips are different textures
+	CHECK(registry.Register("a_bc7.dds", MakeKey(1, 98), 25) == "a_bc7.dds");
+	CHECK(registry.Register("a_wide.png", MakeKey(1, 28, 512, 128), 100) == "a_wide.png");
+	CHECK(registry.Register("a_nomips.png", MakeKey(1, 28, 256, 256, 1), 75) == "a_nomips.png");
+
+	CHECK(registry.Resolve("copy/a.png") == "a.png");
+	CHECK(registry.Resolve("a.png") == "a.png");
+	CHECK(registry.Resolve("unknown.png") == "unknown.png");
+
+	CHECK(registry.GetNumContents() == 5);
+	CHECK(registry.GetNumAliases() == 2);
+	CHECK(registry.GetSavedBytes() == 200);
+}
+
+// loading workers register textures concurrently, several of them load same files
+void TestConcurrentRegistration() {
+	const uint32_t numThreads = 8;
+	const uint32_t numNames = 2000;
+	const uint32_t numContents = 300;
+	const uint64_t byteSize = 4096;
+
+	auto getName = [](uint32_t i) { return "textures/" + std::to_string(i) + ".png"; };
+
+	TextureRegistry registry;
+	std::vector<std::vector<std::string>> canonicals(numThreads, std::vector<std::string>(numNames));
+	std::vector<std::thread> threads;
+
+	for (uint32_t t = 0; t < numThreads; ++t) {
+		threads.emplace_back([&, t]() {
+			std::vector<uint32_t> order(numNames);
+
+			for (uint32_t i = 0; i < numNames; ++i) {
+				order[i] = i;
+			}
+
+			std::shuffle(order.begin(), order.end(), std::mt19937(340 + t));
+
+			for (uint32_t i : order) {
+				canonicals[t][i] = registry.Register(getName(i), MakeKey(i % numContents), byteSize);
+
+				// resolve races with registration of other names
+				CHECK(!registry.Resolve(getName(i)).empty());
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	CHECK(registry.GetNumContents() == numContents);
+	CHECK(registry.GetNumAliases() == numNames - numContents);
+	CHECK(registry.GetSavedBytes() == (numNames - numContents) * byteSize);
+
+	// all threads agree on canonical names, one of each content is canonical
+	std::vector<std::string> contentCanonicals(numContents);
+
+	for (uint32_t i = 0; i < numNames; ++i) {
+		const std::string& canonical = canonicals[0][i];
+
+		for (uint32_t t = 1; t < numThreads; ++t) {
+			CHECK(canonicals[t][i] == canonical);
+		}
+
+		CHECK(registry.Resolve(getName(i)) == canonical);
+		CHECK(registry.Resolve(canonical) == canonical);
+
+		std::string& contentCanonical = contentCanonicals[i % numContents];
+
+		if (contentCanonical.empty()) {
+			contentCanonical = canonical;
+		}
+
+		CHECK(canonical == contentCanonical);
+	}
+}
+
+int main() {
+	TestContentHash();
+	TestAliasing();
+	TestConcurrentRegistration();
+
+	std::printf("TextureRegistry tests passed\n");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include <MyD3D12Lib/TextureStreamer.h>
+
+#include <TestUtils.h>
+
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+// blocks simulated loads until test opens it
+class Gate {
+public:
+	void Open() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsOpen = true;
+		m_Opened.notify_all();
+	}
+
+	void Wait() {
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Opened.wait(lock, [this]() { return m_IsOpen; });
+	}
+
+private:
+	std::mutex m_Mutex;
+	std::condition_variable m_Opened;
+	bool m_IsOpen = false;
+};
+
+template<class T>
+void WaitWhileInState(const TextureStreamer<T>& streamer, uint32_t id, StreamingState state) {
+	while (streamer.GetState(id) == state) {
+		std::this_thread::sleep_for(1ms);
+	}
+}
+
+template<class T>
+void WaitForLoad(const TextureStreamer<T>& streamer, uint32_t id) {
+	WaitWhileInState(streamer, id, StreamingState::Pending);
+	WaitWhileInState(streamer, id, StreamingState::Loading);
+}
+
+void TestPriorityAndFenceGating() {
+	ThreadPool pool(2);
+	Gate gate;
+	std::mutex orderMutex;
+	std::vector<uint32_t> loadOrder;
+
+	// one load at once, first one is blocked until all others are requested
+	TextureStreamer<std::string> streamer(pool, 6, 1, [&](uint32_t id, const std::atomic<bool>&) {
+		if (id == 0) {
+			gate.Wait();
+		}
+
+		std::lock_guard<std::mutex> lock(orderMutex);
+		loadOrder.push_back(id);
+
+		return std::to_string(id);
+	});
+
+	streamer.Request(0, 100.0f);
+	WaitWhileInState(streamer, 0, StreamingState::Pending);
+	CHECK(streamer.GetState(0) == StreamingState::Loading);
+
+	streamer.Request(1, 1.0f);
+	streamer.Request(2, 5.0f);
+	streamer.Request(3, 3.0f);
+	streamer.Request(4, 0.5f);
+	streamer.Request(5, 0.1f);
+
+	// screen size of item grew, so it goes before others
+	streamer.Request(1, 10.0f);
+
+	streamer.Cancel(5);
+	CHECK(streamer.GetState(5) == StreamingState::Canceled);
+
+	// many priority updates leave outdated queue entries, queue is rebuilt
+	for (uint32_t i = 0; i < 100; ++i) {
+		streamer.Request(4, 0.5f + i);
+	}
+
+	gate.Open();
+
+	uint64_t fenceValue = 0;
+	std::vector<uint32_t> taken;
+
+	while (taken.size() < 5) {
+		for (auto& [id, value] : streamer.TakeLoaded(2)) {
+			CHECK(value == std::to_string(id));
+			CHECK(streamer.GetState(id) == StreamingState::Uploading);
+
+			taken.push_back(id);
+			streamer.OnUploadSubmitted(id, ++fenceValue);
+		}
+
+		std::this_thread::sleep_for(1ms);
+	}
+
+	CHECK((loadOrder == std::vector<uint32_t>{ 0, 4, 1, 2, 3 }));
+
+	// item is resident only after fence of its upload is completed
+	CHECK(streamer.TakeResident(0).empty());
+	CHECK(streamer.TakeResident(2).size() == 2);
+	CHECK(streamer.GetState(taken[1]) == StreamingState::Resident);
+	CHECK(streamer.GetState(taken[2]) == StreamingState::Uploading);
+	CHECK(!streamer.IsIdle());
+
+	CHECK(streamer.TakeResident(100).size() == 3);
+	CHECK(streamer.IsIdle());
+
+	// canceled item can be requested again, cancel of loaded one drops its value
+	streamer.Request(5, 1.0f);
+	WaitForLoad(streamer, 5);
+	CHECK(streamer.GetState(5) == StreamingState::Loaded);
+
+	streamer.Cancel(5);
+	CHECK(streamer.GetState(5) == StreamingState::Canceled);
+	CHECK(streamer.TakeLoaded(10).empty());
+
+	// resident items aren`t loaded again
+	streamer.Request(0, 1.0f);
+	CHECK(streamer.GetState(0) == StreamingState::Resident);
+}
+
+void TestCancellationAndErrors() {
+	ThreadPool pool(2);
+	std::atomic<uint32_t> numLoads(0);
+
+	TextureStreamer<uint32_t> streamer(pool, 3, 2, [&](uint32_t id, const std::atomic<bool>& isCanceled) {
+		++numLoads;
+
+		if (id == 2) {
+			throw std::runtime_error("broken file");
+		}
+
+		// long load which stops only when it is canceled
+		if (id == 0) {
+			while (!isCanceled.load()) {
+				std::this_thread::sleep_for(1ms);
+			}
+		}
+
+		return id;
+	});
+
+	streamer.Request(0, 1.0f);
+	WaitWhileInState(streamer, 0, StreamingState::Pending);
+
+	streamer.Cancel(0);
+	WaitWhileInState(streamer, 0, StreamingState::Loading);
+
+	CHECK(streamer.GetState(0) == StreamingState::Canceled);
+	CHECK(streamer.TakeLoaded(10).empty());
+
+	// error is rethrown after already loaded items are taken
+	streamer.Request(2, 1.0f);
+	streamer.Request(1, 0.0f);
+	WaitForLoad(streamer, 2);
+	WaitForLoad(streamer, 1);
+
+	CHECK(streamer.GetState(2) == StreamingState::Failed);
+
+	bool isThrown = false;
+	size_t numTaken = 0;
+
+	for (uint32_t i = 0; i < 3; ++i) {
+		try {
+			numTaken += streamer.TakeLoaded(10).size();
+		}
+		catch (const std::runtime_error&) {
+			isThrown = true;
+		}
+	}
+
+	CHECK(isThrown && numTaken == 1);
+
+	// failed item isn`t loaded again
+	uint32_t numLoadsBefore = numLoads.load();
+	streamer.Request(2, 1.0f);
+	CHECK(streamer.GetState(2) == StreamingState::Failed);
+	CHECK(numLoads.load() == numLoadsBefore);
+}
+
+void TestRequeueOfCanceledLoad() {
+	ThreadPool pool(2);
+	Gate gate;
+	std::atomic<uint32_t> numLoads(0);
+
+	TextureStreamer<uint32_t> streamer(pool, 1, 1, [&](uint32_t id, const std::atomic<bool>&) {
+		if (numLoads++ == 0) {
+			gate.Wait();
+		}
+
+		return id + 10;
+	});
+
+	// item is canceled and requested again while it is loading, result of first load is dropped
+	streamer.Request(0, 1.0f);
+	WaitWhileInState(streamer, 0, StreamingState::Pending);
+
+	streamer.Cancel(0);
+	streamer.Request(0, 2.0f);
+	CHECK(streamer.GetState(0) == StreamingState::Loading);
+
+	gate.Open();
+	WaitWhileInState(streamer, 0, StreamingState::Loading);
+	WaitForLoad(streamer, 0);
+
+	CHECK(numLoads.load() == 2);
+
+	std::vector<std::pair<uint32_t, uint32_t>> loaded = streamer.TakeLoaded(10);
+	CHECK(loaded.size() == 1 && loaded[0].second == 10);
+}
+
+// render loop over simulated GPU, which completes fence of each frame two frames later
+// materials are drawn with default texture until their texture is resident
+void TestSimulatedFrames() {
+	const uint32_t numTextures = 200;
+	const uint32_t defaultTexture = UINT32_MAX;
+	const uint64_t gpuLatency = 2;
+
+	ThreadPool pool(4);
+	std::mt19937 rng(36);
+
+	// screen space size of render items using each texture
+	std::vector<float> screenSizes(numTextures);
+
+	for (float& size : screenSizes) {
+		size = static_cast<float>(rng() % 1000);
+	}
+
+	TextureStreamer<std::vector<uint32_t>> streamer(pool, numTextures, 3, [](uint32_t id, const std::atomic<bool>& isCanceled) {
+		for (uint32_t i = 0; i < 3 && !isCanceled.load(); ++i) {
+			std::this_thread::sleep_for(100us);
+		}
+
+		return std::vector<uint32_t>(64, id);
+	});
+
+	std::vector<uint32_t> boundTextures(numTextures, defaultTexture);
+	std::vector<uint64_t> uploadFenceValues(numTextures, 0);
+	std::vector<uint32_t> residentOrder;
+
+	for (uint32_t id = 0; id < numTextures; ++id) {
+		streamer.Request(id, screenSizes[id]);
+	}
+
+	uint64_t fenceValue = 0;
+
+	for (uint32_t frame = 0; frame < 100000 && !streamer.IsIdle(); ++frame) {
+		uint64_t completedFenceValue = fenceValue > gpuLatency ? fenceValue - gpuLatency : 0;
+
+		// swap is done only for textures which upload is completed
+		for (uint32_t id : streamer.TakeResident(completedFenceValue)) {
+			CHECK(uploadFenceValues[id] != 0 && uploadFenceValues[id] <= completedFenceValue);
+			CHECK(boundTextures[id] == defaultTexture);
+
+			boundTextures[id] = id;
+			residentOrder.push_back(id);
+		}
+
+		++fenceValue;
+
+		for (auto& [id, data] : streamer.TakeLoaded(4)) {
+			CHECK(data.size() == 64 && data[0] == id);
+
+			uploadFenceValues[id] = fenceValue;
+			streamer.OnUploadSubmitted(id, fenceValue);
+		}
+
+		// textures uploaded in this frame are still drawn with default one
+		for (uint32_t id = 0; id < numTextures; ++id) {
+			CHECK(boundTextures[id] == defaultTexture || uploadFenceValues[id] + gpuLatency <= fenceValue);
+		}
+
+		std::this_thread::sleep_for(100us);
+	}
+
+	CHECK(streamer.IsIdle());
+
+	// last uploads are completed after loop
+	for (uint32_t id : streamer.TakeResident(UINT64_MAX)) {
+		boundTextures[id] = id;
+		residentOrder.push_back(id);
+	}
+
+	CHECK(residentOrder.size() == numTextures);
+
+	for (uint32_t id = 0; id < numTextures; ++id) {
+		CHECK(boundTextures[id] == id);
+		CHECK(streamer.GetState(id) == StreamingState::Resident);
+	}
+
+	// bigger textures on screen become resident earlier on average
+	float firstHalfSize = 0.0f;
+	float secondHalfSize = 0.0f;
+
+	for (uint32_t i = 0; i < numTextures; ++i) {
+		(i < numTextures / 2 ? firstHalfSize : secondHalfSize) += screenSizes[residentOrder[i]];
+	}
+
+	CHECK(firstHalfSize > secondHalfSize);
+}
+
+// destructor cancels pending loads and waits for running ones
+void TestDestructionWithRunningLoads() {
+	ThreadPool pool(4);
+	std::atomic<uint32_t> numFinished(0);
+
+	{
+		TextureStreamer<std::vector<uint32_t>> streamer(pool, 64, 3, [&](uint32_t id, const std::atomic<bool>& isCanceled) {
+			for (uint32_t i = 0; i < 20 && !isCanceled.load(); ++i) {
+				std::this_thread::sleep_for(1ms);
+			}
+
+			++numFinished;
+			return std::vector<uint32_t>(id);
+		});
+
+		for (uint32_t id = 0; id < 64; ++id) {
+			streamer.Request(id, static_cast<float>(id % 7));
+		}
+
+		std::this_thread::sleep_for(5ms);
+
+		for (uint32_t id = 0; id < 64; id += 2) {
+			streamer.Cancel(id);
+			streamer.Request(id, 1.0f);
+		}
+
+		uint64_t fenceValue = 0;
+
+		for (uint32_t i = 0; i < 5; ++i) {
+			for (auto& [id, data] : streamer.TakeLoaded(4)) {
+				CHECK(data.size() == id);
+				streamer.OnUploadSubmitted(id, ++fenceValue);
+			}
+
+			streamer.TakeResident(fenceValue);
+			std::this_thread::sleep_for(5ms);
+		}
+	}
+
+	// loads started by streamer are finished before it is destroyed
+	uint32_t numFinishedAfterDestruction = numFinished.load();
+	std::this_thread::sleep_for(30ms);
+	CHECK(numFinished.load() == numFinishedAfterDestruction);
+}
+
+int main() {
+	TestPriorityAndFenceGating();
+	TestCancellationAndErrors();
+	TestRequeueOfCanceledLoad();
+	TestSimulatedFrames();
+	TestDestructionWithRunningLoads();
+
+	std::printf("TextureStreamer tests passed\n");
+	return 0;
+}
\ No newline at end of file
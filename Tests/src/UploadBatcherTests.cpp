@@ -0,0 +1,217 @@
+#include <MyD3D12Lib/UploadBatcher.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+void TestBatchLimits() {
+	UploadBatcher batcher(1000, 3);
+
+	// empty batch fits any upload, even bigger than limit
+	CHECK(!batcher.HasOpenUploads());
+	CHECK(!batcher.IsFull(5000));
+	CHECK(batcher.Add(5000) == 0);
+	CHECK(batcher.IsFull(1));
+
+	batcher.Submit(10);
+	CHECK(batcher.GetOpenBatch() == 1);
+	CHECK(!batcher.IsFull(1000));
+
+	// limit of size and of number of uploads
+	CHECK(batcher.Add(600) == 1);
+	CHECK(!batcher.IsFull(400));
+	CHECK(batcher.IsFull(401));
+	CHECK(batcher.Add(100) == 1);
+	CHECK(batcher.Add(100) == 1);
+	CHECK(batcher.IsFull(0));
+
+	batcher.Submit(11);
+
+	CHECK(batcher.GetNumSubmittedBatches() == 2);
+	CHECK(batcher.GetNumUploads() == 4);
+	CHECK(batcher.GetFenceValue(0) == 10);
+	CHECK(batcher.GetFenceValue(1) == 11);
+}
+
+void TestConsumerWaits() {
+	UploadBatcher batcher(1000, 1);
+
+	for (uint64_t batch = 0; batch < 4; ++batch) {
+		batcher.Add(10);
+		batcher.Submit(10 * (batch + 1));
+	}
+
+	// finished batch needs no wait
+	CHECK(batcher.RequireBatch(0, 10) == 0);
+	CHECK(batcher.RequireBatch(1, 10) == 20);
+
+	// consumer already waits for batch 1, so wait for the same or earlier batch isn`t repeated
+	CHECK(batcher.RequireBatch(1, 10) == 0);
+	CHECK(batcher.RequireBatch(0, 0) == 0);
+	CHECK(batcher.RequireBatch(3, 10) == 40);
+	CHECK(batcher.RequireBatch(2, 10) == 0);
+	CHECK(batcher.GetNumConsumerWaits() == 2);
+
+	// released batches are finished
+	batcher.ReleaseCompleted(25);
+	CHECK(batcher.GetFenceValue(0) == 0 && batcher.GetFenceValue(1) == 0);
+	CHECK(batcher.GetFenceValue(2) == 30);
+
+	batcher.ReleaseCompleted(40);
+	CHECK(batcher.GetFenceValue(3) == 0);
+	CHECK(batcher.RequireBatch(3, 40) == 0);
+
+	// fence values are kept for batches submitted after all were released
+	batcher.Add(10);
+	batcher.Submit(50);
+	CHECK(batcher.GetFenceValue(3) == 0);
+	CHECK(batcher.GetFenceValue(4) == 50);
+	CHECK(batcher.RequireBatch(4, 40) == 50);
+}
+
+// copy queue executes batches in order of submission, direct queue executes frames which use uploads
+// direct queue waits on GPU for fence values returned by batcher, each frame should start after batches it uses are finished
+void TestSimulatedQueuePair() {
+	std::mt19937 rng(48);
+	std::uniform_real_distribution<double> duration(0.0, 1.0);
+
+	uint64_t totalUploads = 0;
+	uint64_t totalBatches = 0;
+	uint64_t totalUses = 0;
+	uint64_t totalWaits = 0;
+
+	for (uint32_t run = 0; run < 500; ++run) {
+		uint64_t maxBatchSize = 1 + rng() % 1000;
+		uint32_t maxBatchUploads = 1 + rng() % 8;
+		UploadBatcher batcher(maxBatchSize, maxBatchUploads);
+
+		// fence values of copy queue are not batch indexes
+		uint64_t copyFenceValue = rng() % 100;
+		std::vector<uint64_t> batchFenceValues;
+		std::vector<double> batchFinishTimes;
+		std::vector<uint64_t> uploadBatches;
+
+		uint64_t openBatchSize = 0;
+		uint32_t openBatchUploads = 0;
+		double copyTimeline = 0.0;
+		double directTimeline = 0.0;
+		double consumerWaitTime = 0.0;
+		uint64_t numWaits = 0;
+
+		auto submit = [&](double time) {
+			copyTimeline = std::max(copyTimeline, time) + 0.1 + 1e-3 * openBatchSize * duration(rng);
+			copyFenceValue += 1 + rng() % 3;
+
+			batcher.Submit(copyFenceValue);
+			batchFenceValues.push_back(copyFenceValue);
+			batchFinishTimes.push_back(copyTimeline);
+
+			openBatchSize = 0;
+			openBatchUploads = 0;
+		};
+
+		for (uint32_t frame = 0; frame < 200; ++frame) {
+			double time = frame;
+
+			// completed fence value seen by CPU lags behind GPU
+			uint64_t completedFenceValue = 0;
+
+			for (uint32_t batch = 0; batch < batchFinishTimes.size(); ++batch) {
+				if (batchFinishTimes[batch] <= time - duration(rng)) {
+					completedFenceValue = batchFenceValues[batch];
+				}
+				else {
+					break;
+				}
+			}
+
+			batcher.ReleaseCompleted(completedFenceValue);
+
+			uint32_t numUploads = rng() % 6;
+
+			for (uint32_t i = 0; i < numUploads; ++i) {
+				uint64_t size = rng() % 600;
+
+				if (batcher.IsFull(size)) {
+					submit(time);
+				}
+
+				uint64_t batch = batcher.Add(size);
+				openBatchSize += size;
+				++openBatchUploads;
+
+				CHECK(batch == batchFenceValues.size());
+				CHECK(openBatchUploads == 1 || (openBatchUploads <= maxBatchUploads && openBatchSize <= maxBatchSize));
+
+				uploadBatches.push_back(batch);
+			}
+
+			// frame uses some uploads, open batch is submitted when it is needed, as ModelsApp does
+			double frameStart = std::max(directTimeline, time + 0.05);
+			std::vector<uint64_t> usedBatches;
+
+			for (uint32_t i = 0; i < 3 && !uploadBatches.empty(); ++i) {
+				uint64_t batch = uploadBatches[uploadBatches.size() - 1 - rng() % std::min<size_t>(uploadBatches.size(), 16)];
+
+				if (batch == batcher.GetOpenBatch()) {
+					submit(time);
+				}
+
+				uint64_t waitFenceValue = batcher.RequireBatch(batch, completedFenceValue);
+
+				if (waitFenceValue > 0) {
+					CHECK(waitFenceValue == batchFenceValues[batch]);
+					++numWaits;
+
+					// queue waits until copy queue signals fence value
+					uint32_t waitedBatch = static_cast<uint32_t>(std::lower_bound(batchFenceValues.begin(), batchFenceValues.end(), waitFenceValue) - batchFenceValues.begin());
+					double finishTime = batchFinishTimes[waitedBatch];
+
+					if (finishTime > frameStart) {
+						consumerWaitTime += finishTime - frameStart;
+						frameStart = finishTime;
+					}
+				}
+
+				usedBatches.push_back(batch);
+			}
+
+			// uploads are finished before frame using them is executed
+			for (uint64_t batch : usedBatches) {
+				CHECK(batchFinishTimes[batch] <= frameStart);
+			}
+
+			totalUses += usedBatches.size();
+
+			directTimeline = frameStart + 0.5 * duration(rng);
+		}
+
+		CHECK(batcher.GetNumConsumerWaits() == numWaits);
+		CHECK(batcher.GetNumUploads() == uploadBatches.size());
+
+		totalUploads += batcher.GetNumUploads();
+		totalBatches += batcher.GetNumSubmittedBatches();
+		totalWaits += numWaits;
+
+		if (run == 0) {
+			std::printf("first run: direct queue waited for copy queue %.1f%% of time\n", consumerWaitTime / 200.0 * 100.0);
+		}
+	}
+
+	std::printf(
+		"%llu uploads in %llu batches, %llu waits on GPU for %llu uses\n",
+		static_cast<unsigned long long>(totalUploads), static_cast<unsigned long long>(totalBatches),
+		static_cast<unsigned long long>(totalWaits), static_cast<unsigned long long>(totalUses)
+	);
+}
+
+int main() {
+	TestBatchLimits();
+	TestConsumerWaits();
+	TestSimulatedQueuePair();
+
+	std::printf("UploadBatcher tests passed\n");
+	return 0;
+}
\ No newline at end of file
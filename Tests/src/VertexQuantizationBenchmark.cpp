@@ -0,0 +1,78 @@
+#include <MyD3D12Lib/CpuFeatures.h>
+#include <MyD3D12Lib/VertexQuantization.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+struct FloatVertex {
+	float Position[3];
+	float Norm[3];
+	float TexC[2];
+};
+
+using EncodeFunction = void(*)(const VertexStreamDesc&, uint32_t, const PositionDequantization&, CompactVertex*);
+
+// best of several runs, throughput in millions of vertexes per second
+double MeasureEncode(EncodeFunction encode, const VertexStreamDesc& stream, uint32_t numVertexes, const PositionDequantization& dequantization, std::vector<CompactVertex>& compactVertexes) {
+	double bestTime = 1e30;
+
+	for (uint32_t run = 0; run < 5; ++run) {
+		Stopwatch stopwatch;
+		encode(stream, numVertexes, dequantization, compactVertexes.data());
+		bestTime = std::min(bestTime, stopwatch.GetSeconds());
+
+		KeepResult(compactVertexes[run % numVertexes].Position[0]);
+	}
+
+	return numVertexes / bestTime * 1e-6;
+}
+
+// argument is number of vertexes
+int main(int argc, char** argv) {
+	uint32_t numVertexes = GetScaleArgument(argc, argv, 1u << 20);
+
+	std::mt19937 rng(27);
+	std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+
+	std::vector<FloatVertex> vertexes(numVertexes);
+
+	for (FloatVertex& vertex : vertexes) {
+		for (uint32_t i = 0; i < 3; ++i) {
+			vertex.Position[i] = value(rng);
+			vertex.Norm[i] = value(rng);
+		}
+
+		float length = std::sqrt(vertex.Norm[0] * vertex.Norm[0] + vertex.Norm[1] * vertex.Norm[1] + vertex.Norm[2] * vertex.Norm[2]);
+
+		for (uint32_t i = 0; i < 3; ++i) {
+			vertex.Norm[i] /= length;
+		}
+
+		vertex.TexC[0] = value(rng);
+		vertex.TexC[1] = value(rng);
+	}
+
+	VertexStreamDesc stream;
+	stream.Data = vertexes.data();
+	stream.ByteStride = sizeof(FloatVertex);
+	stream.PositionOffset = offsetof(FloatVertex, Position);
+	stream.NormOffset = offsetof(FloatVertex, Norm);
+	stream.TexCOffset = offsetof(FloatVertex, TexC);
+
+	PositionDequantization dequantization = ComputePositionDequantization(stream, numVertexes);
+	std::vector<CompactVertex> compactVertexes(numVertexes);
+
+	double scalar = MeasureEncode(&EncodeCompactVertexesScalar, stream, numVertexes, dequantization, compactVertexes);
+	double batch = MeasureEncode(&EncodeCompactVertexes, stream, numVertexes, dequantization, compactVertexes);
+
+	std::printf("encode of %u vertexes, AVX2 %s\n", numVertexes, IsAVX2Supported() ? "supported" : "not supported");
+	std::printf("scalar: %.1f Mvertexes/s\n", scalar);
+	std::printf("batch:  %.1f Mvertexes/s, x%.2f\n", batch, batch / scalar);
+
+	return 0;
+}
\ No newline at end of file
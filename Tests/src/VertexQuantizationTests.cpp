@@ -0,0 +1,211 @@
+#include <MyD3D12Lib/VertexQuantization.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <vector>
+
+struct FloatVertex {
+	float Position[3];
+	float Norm[3];
+	float TexC[2];
+};
+
+VertexStreamDesc GetStreamDesc(const std::vector<FloatVertex>& vertexes) {
+	VertexStreamDesc stream;
+	stream.Data = vertexes.data();
+	stream.ByteStride = sizeof(FloatVertex);
+	stream.PositionOffset = offsetof(FloatVertex, Position);
+	stream.NormOffset = offsetof(FloatVertex, Norm);
+	stream.TexCOffset = offsetof(FloatVertex, TexC);
+
+	return stream;
+}
+
+std::vector<FloatVertex> GenerateVertexes(uint32_t numVertexes, float extent, std::mt19937& rng) {
+	std::uniform_real_distribution<float> position(-extent, extent);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> texC(-4.0f, 4.0f);
+
+	std::vector<FloatVertex> vertexes(numVertexes);
+
+	for (FloatVertex& vertex : vertexes) {
+		float length = 0.0f;
+
+		while (length < 1e-3f) {
+			for (uint32_t i = 0; i < 3; ++i) {
+				vertex.Norm[i] = unit(rng);
+			}
+
+			length = std::sqrt(vertex.Norm[0] * vertex.Norm[0] + vertex.Norm[1] * vertex.Norm[1] + vertex.Norm[2] * vertex.Norm[2]);
+		}
+
+		for (uint32_t i = 0; i < 3; ++i) {
+			vertex.Position[i] = position(rng);
+			vertex.Norm[i] /= length;
+		}
+
+		vertex.TexC[0] = texC(rng);
+		vertex.TexC[1] = texC(rng);
+	}
+
+	// axis aligned normals are edge cases of octahedral mapping
+	if (numVertexes >= 6) {
+		for (uint32_t i = 0; i < 6; ++i) {
+			std::fill(std::begin(vertexes[i].Norm), std::end(vertexes[i].Norm), 0.0f);
+			vertexes[i].Norm[i / 2] = i % 2 == 0 ? 1.0f : -1.0f;
+		}
+	}
+
+	return vertexes;
+}
+
+void TestHalfConversion() {
+	CHECK(HalfToFloat(FloatToHalf(0.0f)) == 0.0f);
+	CHECK(std::signbit(HalfToFloat(FloatToHalf(-0.0f))));
+	CHECK(HalfToFloat(FloatToHalf(1.0f)) == 1.0f);
+	CHECK(HalfToFloat(FloatToHalf(-2.5f)) == -2.5f);
+	CHECK(HalfToFloat(FloatToHalf(65504.0f)) == 65504.0f);
+	CHECK(std::isinf(HalfToFloat(FloatToHalf(70000.0f))));
+
+	// smallest normal and subnormal halfs are exact
+	CHECK(HalfToFloat(FloatToHalf(std::ldexp(1.0f, -14))) == std::ldexp(1.0f, -14));
+	CHECK(HalfToFloat(FloatToHalf(std::ldexp(1.0f, -24))) == std::ldexp(1.0f, -24));
+
+	// all halfs which are not NaN survive round trip
+	for (uint32_t bits = 0; bits < 0x10000; ++bits) {
+		uint16_t half = static_cast<uint16_t>(bits);
+
+		if ((half & 0x7c00) == 0x7c00 && (half & 0x03ff) != 0) {
+			continue;
+		}
+
+		CHECK(FloatToHalf(HalfToFloat(half)) == half);
+	}
+}
+
+void TestErrorBounds(float extent, uint32_t numVertexes, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::vector<FloatVertex> vertexes = GenerateVertexes(numVertexes, extent, rng);
+	VertexStreamDesc stream = GetStreamDesc(vertexes);
+
+	PositionDequantization dequantization = ComputePositionDequantization(stream, numVertexes);
+
+	std::vector<CompactVertex> compactVertexes(numVertexes);
+	std::vector<CompactVertex> scalarVertexes(numVertexes);
+	EncodeCompactVertexes(stream, numVertexes, dequantization, compactVertexes.data());
+	EncodeCompactVertexesScalar(stream, numVertexes, dequantization, scalarVertexes.data());
+
+	// SIMD paths give the same bits as scalar reference
+	CHECK(std::memcmp(compactVertexes.data(), scalarVertexes.data(), numVertexes * sizeof(CompactVertex)) == 0);
+
+	std::vector<float> positions(3 * numVertexes);
+	std::vector<float> norms(3 * numVertexes);
+	std::vector<float> texCs(2 * numVertexes);
+	DecodeCompactVertexes(compactVertexes.data(), numVertexes, dequantization, positions.data(), norms.data(), texCs.data());
+
+	std::vector<float> scalarPositions(3 * numVertexes);
+	std::vector<float> scalarNorms(3 * numVertexes);
+	std::vector<float> scalarTexCs(2 * numVertexes);
+	DecodeCompactVertexesScalar(compactVertexes.data(), numVertexes, dequantization, scalarPositions.data(), scalarNorms.data(), scalarTexCs.data());
+
+	float maxPositionError = 0.0f;
+	double maxNormAngle = 0.0;
+	float maxTexCError = 0.0f;
+
+	for (uint32_t v = 0; v < numVertexes; ++v) {
+		const FloatVertex& vertex = vertexes[v];
+		double normLength = 0.0;
+
+		for (uint32_t i = 0; i < 3; ++i) {
+			float position = positions[3 * v + i];
+			float norm = norms[3 * v + i];
+
+			CHECK(std::fabs(position - scalarPositions[3 * v + i]) <= 1e-5f * extent);
+			CHECK(std::fabs(norm - scalarNorms[3 * v + i]) <= 1e-5f);
+
+			// half of quantization step of bounding box plus float rounding
+			float positionError = std::fabs(position - vertex.Position[i]);
+			CHECK(positionError <= 0.5f * dequantization.Scale[i] / 65535.0f + 4.0f * FLT_EPSILON * extent);
+			maxPositionError = std::max(maxPositionError, positionError);
+
+			normLength += static_cast<double>(norm) * norm;
+		}
+
+		CHECK(std::fabs(std::sqrt(normLength) - 1.0f) <= 1e-4f);
+
+		// angle from cross and dot products, acos near 1 is coarser than 16 bit normals
+		const float* norm = &norms[3 * v];
+		double crossX = static_cast<double>(vertex.Norm[1]) * norm[2] - static_cast<double>(vertex.Norm[2]) * norm[1];
+		double crossY = static_cast<double>(vertex.Norm[2]) * norm[0] - static_cast<double>(vertex.Norm[0]) * norm[2];
+		double crossZ = static_cast<double>(vertex.Norm[0]) * norm[1] - static_cast<double>(vertex.Norm[1]) * norm[0];
+		double dot = static_cast<double>(vertex.Norm[0]) * norm[0] + static_cast<double>(vertex.Norm[1]) * norm[1] + static_cast<double>(vertex.Norm[2]) * norm[2];
+
+		double normAngle = std::atan2(std::sqrt(crossX * crossX + crossY * crossY + crossZ * crossZ), dot);
+		maxNormAngle = std::max(maxNormAngle, normAngle);
+
+		for (uint32_t i = 0; i < 2; ++i) {
+			CHECK(texCs[2 * v + i] == scalarTexCs[2 * v + i]);
+
+			// half keeps 11 significant bits
+			float texCError = std::fabs(texCs[2 * v + i] - vertex.TexC[i]);
+			CHECK(texCError <= std::ldexp(std::fabs(vertex.TexC[i]), -11) + std::ldexp(1.0f, -25));
+			maxTexCError = std::max(maxTexCError, texCError);
+		}
+	}
+
+	// 16 bit octahedral normals are within about 0.005 degree
+	CHECK(maxNormAngle < 1e-4);
+
+	std::printf(
+		"extent %g, %u vertexes: position error %g, normal error %g deg, texture coordinates error %g\n",
+		extent, numVertexes, maxPositionError, maxNormAngle * 180.0 / 3.14159265, maxTexCError
+	);
+}
+
+void TestFlatBoundingBox() {
+	std::vector<FloatVertex> vertexes(17);
+
+	for (uint32_t i = 0; i < vertexes.size(); ++i) {
+		vertexes[i] = FloatVertex{ { static_cast<float>(i), 2.0f, -3.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f } };
+	}
+
+	VertexStreamDesc stream = GetStreamDesc(vertexes);
+	PositionDequantization dequantization = ComputePositionDequantization(stream, static_cast<uint32_t>(vertexes.size()));
+
+	std::vector<CompactVertex> compactVertexes(vertexes.size());
+	EncodeCompactVertexes(stream, static_cast<uint32_t>(vertexes.size()), dequantization, compactVertexes.data());
+
+	std::vector<float> positions(3 * vertexes.size());
+	std::vector<float> norms(3 * vertexes.size());
+	std::vector<float> texCs(2 * vertexes.size());
+	DecodeCompactVertexes(compactVertexes.data(), static_cast<uint32_t>(vertexes.size()), dequantization, positions.data(), norms.data(), texCs.data());
+
+	// flat axes are restored exactly from offset
+	for (uint32_t i = 0; i < vertexes.size(); ++i) {
+		CHECK(std::fabs(positions[3 * i] - vertexes[i].Position[0]) <= 1e-3f);
+		CHECK(positions[3 * i + 1] == 2.0f);
+		CHECK(positions[3 * i + 2] == -3.0f);
+	}
+}
+
+int main() {
+	TestHalfConversion();
+
+	// counts which are not multiples of SIMD width check tails
+	TestErrorBounds(1.0f, 1, 1);
+	TestErrorBounds(1.0f, 7, 2);
+	TestErrorBounds(0.01f, 1003, 3);
+	TestErrorBounds(100.0f, 4099, 4);
+	TestErrorBounds(10000.0f, 65536, 5);
+
+	TestFlatBoundingBox();
+
+	std::printf("VertexQuantization tests passed\n");
+	return 0;
+}
\ No newline at end of file
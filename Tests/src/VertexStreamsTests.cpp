@@ -0,0 +1,181 @@
+#include <MyD3D12Lib/GeometryPacker.h>
+#include <MyD3D12Lib/VertexQuantization.h>
+#include <MyD3D12Lib/VertexStreams.h>
+
+#include <TestUtils.h>
+
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// same layout as Vertex of apps
+struct FullVertex {
+	float Position[3];
+	float Norm[3];
+	float TexC[2];
+};
+
+// interleaved vertex is position stream element followed by attribute stream element with position cut out
+void CheckSplit(const void* vertexes, uint32_t numVertexes, uint32_t byteStride, uint32_t positionOffset, uint32_t positionByteSize) {
+	uint32_t attributesByteStride = byteStride - positionByteSize;
+
+	std::vector<uint8_t> positions(numVertexes * positionByteSize, 0xcd);
+	std::vector<uint8_t> attributes(numVertexes * attributesByteStride + 1, 0xcd);
+
+	SplitVertexStreams(vertexes, numVertexes, byteStride, positionOffset, positionByteSize, positions.data(), attributes.data());
+
+	const uint8_t* src = static_cast<const uint8_t*>(vertexes);
+	std::vector<uint8_t> merged(byteStride);
+
+	for (uint32_t i = 0; i < numVertexes; ++i) {
+		const uint8_t* attribute = attributes.data() + i * attributesByteStride;
+
+		std::memcpy(merged.data(), attribute, positionOffset);
+		std::memcpy(merged.data() + positionOffset, positions.data() + i * positionByteSize, positionByteSize);
+		std::memcpy(merged.data() + positionOffset + positionByteSize, attribute + positionOffset, attributesByteStride - positionOffset);
+
+		CHECK(std::memcmp(merged.data(), src + i * byteStride, byteStride) == 0);
+	}
+
+	// streams are tightly packed, nothing is written after them
+	CHECK(attributes.back() == 0xcd);
+}
+
+std::vector<FullVertex> GenerateVertexes(uint32_t numVertexes, std::mt19937& rng) {
+	std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+	std::vector<FullVertex> vertexes(numVertexes);
+
+	for (FullVertex& vertex : vertexes) {
+		for (uint32_t i = 0; i < 3; ++i) {
+			vertex.Position[i] = value(rng);
+			vertex.Norm[i] = value(rng);
+		}
+
+		vertex.TexC[0] = value(rng);
+		vertex.TexC[1] = value(rng);
+	}
+
+	return vertexes;
+}
+
+void TestLayouts() {
+	std::mt19937 rng(28);
+	std::vector<FullVertex> vertexes = GenerateVertexes(1000, rng);
+
+	// position at start, in the middle and at the end of vertex
+	CheckSplit(vertexes.data(), 1000, sizeof(FullVertex), offsetof(FullVertex, Position), sizeof(FullVertex::Position));
+	CheckSplit(vertexes.data(), 1000, sizeof(FullVertex), offsetof(FullVertex, Norm), sizeof(FullVertex::Norm));
+	CheckSplit(vertexes.data(), 1000, sizeof(FullVertex), offsetof(FullVertex, TexC), sizeof(FullVertex::TexC));
+
+	CheckSplit(vertexes.data(), 0, sizeof(FullVertex), 0, 12);
+	CheckSplit(vertexes.data(), 1, sizeof(FullVertex), 0, 12);
+
+	// odd strides and sizes aren`t assumed to be aligned
+	std::vector<uint8_t> bytes(7 * 333);
+
+	for (uint8_t& byte : bytes) {
+		byte = static_cast<uint8_t>(rng());
+	}
+
+	CheckSplit(bytes.data(), 333, 7, 3, 3);
+	CheckSplit(bytes.data(), 333, 7, 0, 1);
+}
+
+void TestPositionOnlyVertex() {
+	float vertexes[] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+	float positions[6] = {};
+
+	// attribute stream is empty, so it isn`t written at all
+	SplitVertexStreams(vertexes, 2, 12, 0, 12, positions, nullptr);
+
+	CHECK(std::memcmp(vertexes, positions, sizeof(vertexes)) == 0);
+}
+
+void TestCompactVertexes() {
+	std::mt19937 rng(280);
+	std::vector<CompactVertex> vertexes(4099);
+
+	for (CompactVertex& vertex : vertexes) {
+		uint8_t* bytes = reinterpret_cast<uint8_t*>(&vertex);
+
+		for (uint32_t i = 0; i < sizeof(CompactVertex); ++i) {
+			bytes[i] = static_cast<uint8_t>(rng());
+		}
+	}
+
+	// compact position stream is 8 bytes per vertex, half of compact vertex
+	CHECK(sizeof(CompactVertex::Position) * 2 == sizeof(CompactVertex));
+
+	CheckSplit(vertexes.data(), 4099, sizeof(CompactVertex), offsetof(CompactVertex, Position), sizeof(CompactVertex::Position));
+}
+
+// meshes are packed in one vertex buffer, which is split as a whole,
+// so same index buffer and base vertex locations address both streams
+void TestIndexSharing() {
+	std::mt19937 rng(2800);
+	GeometryPacker packer(1, 1);
+
+	std::vector<std::vector<uint32_t>> meshesIndexes;
+	std::vector<FullVertex> vertexes;
+
+	for (uint32_t m = 0; m < 20; ++m) {
+		uint32_t numVertexes = 3 + rng() % 2000;
+		uint32_t numIndexes = 3 * (1 + rng() % 3000);
+
+		std::vector<uint32_t> indexes(numIndexes);
+
+		for (uint32_t& index : indexes) {
+			index = rng() % numVertexes;
+		}
+
+		PackedMesh mesh = packer.AddMesh(numVertexes, numIndexes);
+		CHECK(mesh.BaseVertexLocation == vertexes.size());
+
+		std::vector<FullVertex> meshVertexes = GenerateVertexes(numVertexes, rng);
+		vertexes.insert(vertexes.end(), meshVertexes.begin(), meshVertexes.end());
+		meshesIndexes.push_back(std::move(indexes));
+	}
+
+	uint32_t numVertexes = static_cast<uint32_t>(vertexes.size());
+	uint32_t attributesByteStride = sizeof(FullVertex) - sizeof(FullVertex::Position);
+
+	std::vector<float> positions(3 * numVertexes);
+	std::vector<uint8_t> attributes(attributesByteStride * numVertexes);
+
+	SplitVertexStreams(
+		vertexes.data(),
+		numVertexes,
+		sizeof(FullVertex),
+		offsetof(FullVertex, Position),
+		sizeof(FullVertex::Position),
+		positions.data(),
+		attributes.data()
+	);
+
+	const std::vector<PackedMesh>& meshes = packer.GetMeshes();
+
+	for (uint32_t m = 0; m < meshes.size(); ++m) {
+		for (uint32_t index : meshesIndexes[m]) {
+			uint32_t vertex = meshes[m].BaseVertexLocation + index;
+
+			// fetch of depth only pass
+			CHECK(std::memcmp(&positions[3 * vertex], vertexes[vertex].Position, sizeof(FullVertex::Position)) == 0);
+
+			// fetch of shading pass, which binds both streams
+			const uint8_t* attribute = attributes.data() + vertex * attributesByteStride;
+			CHECK(std::memcmp(attribute, vertexes[vertex].Norm, sizeof(FullVertex::Norm)) == 0);
+			CHECK(std::memcmp(attribute + sizeof(FullVertex::Norm), vertexes[vertex].TexC, sizeof(FullVertex::TexC)) == 0);
+		}
+	}
+}
+
+int main() {
+	TestLayouts();
+	TestPositionOnlyVertex();
+	TestCompactVertexes();
+	TestIndexSharing();
+
+	std::printf("VertexStreams tests passed\n");
+	return 0;
+}
\ No newline at end of file
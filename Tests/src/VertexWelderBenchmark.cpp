@@ -0,0 +1,139 @@
+#include <MyD3D12Lib/VertexWelder.h>
+
+#include <TestUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// same layout as Vertex of apps
+struct FullVertex {
+	float Position[3];
+	float Norm[3];
+	float TexC[2];
+};
+
+struct ExactKey {
+	FullVertex Vertex;
+
+	bool operator==(const ExactKey& other) const {
+		return std::memcmp(&Vertex, &other.Vertex, sizeof(FullVertex)) == 0;
+	}
+};
+
+struct ExactKeyHash {
+	size_t operator()(const ExactKey& key) const {
+		uint32_t words[sizeof(FullVertex) / 4];
+		std::memcpy(words, &key.Vertex, sizeof(words));
+
+		size_t hash = 0;
+
+		for (uint32_t word : words) {
+			hash = hash * 31 + word;
+		}
+
+		return hash;
+	}
+};
+
+// reference welding of bit identical vertexes with node based std::unordered_map
+uint32_t WeldWithUnorderedMap(const std::vector<FullVertex>& vertexes, std::vector<uint32_t>& remap) {
+	std::unordered_map<ExactKey, uint32_t, ExactKeyHash> welded;
+	welded.reserve(vertexes.size());
+
+	for (uint32_t i = 0; i < vertexes.size(); ++i) {
+		auto it = welded.emplace(ExactKey{ vertexes[i] }, static_cast<uint32_t>(welded.size())).first;
+		remap[i] = it->second;
+	}
+
+	return static_cast<uint32_t>(welded.size());
+}
+
+// grid where each quad has own corners, as exporters of unindexed meshes emit them
+// every fourth corner is slightly shifted, so only epsilon welding merges it
+std::vector<FullVertex> GenerateQuads(uint32_t side) {
+	std::vector<FullVertex> vertexes;
+	vertexes.reserve(4 * static_cast<size_t>(side) * side);
+
+	for (uint32_t y = 0; y < side; ++y) {
+		for (uint32_t x = 0; x < side; ++x) {
+			for (uint32_t k = 0; k < 4; ++k) {
+				float px = static_cast<float>(x + (k & 1));
+				float py = static_cast<float>(y + (k >> 1));
+				float pz = k == 3 ? 1e-6f : 0.0f;
+
+				vertexes.push_back(FullVertex{ { px, py, pz }, { 0.0f, 0.0f, 1.0f }, { px / side, py / side } });
+			}
+		}
+	}
+
+	return vertexes;
+}
+
+// argument is number of quads along side of grid, 4 vertexes per quad
+int main(int argc, char** argv) {
+	uint32_t side = GetScaleArgument(argc, argv, 1000);
+
+	std::vector<FullVertex> vertexes = GenerateQuads(side);
+	uint32_t numVertexes = static_cast<uint32_t>(vertexes.size());
+
+	VertexStreamDesc stream;
+	stream.Data = vertexes.data();
+	stream.ByteStride = sizeof(FullVertex);
+	stream.PositionOffset = offsetof(FullVertex, Position);
+	stream.NormOffset = offsetof(FullVertex, Norm);
+	stream.TexCOffset = offsetof(FullVertex, TexC);
+
+	WeldEpsilons epsilons;
+	epsilons.Position = 1e-4f;
+	epsilons.Norm = 1e-3f;
+	epsilons.TexC = 1e-6f;
+
+	Stopwatch stopwatch;
+	WeldResult exact = WeldVertexes(stream, numVertexes);
+	double exactSeconds = stopwatch.GetSeconds();
+
+	stopwatch.Restart();
+	WeldResult nearby = WeldVertexes(stream, numVertexes, epsilons);
+	double nearbySeconds = stopwatch.GetSeconds();
+
+	std::vector<uint32_t> referenceRemap(numVertexes);
+
+	stopwatch.Restart();
+	uint32_t numReferenceVertexes = WeldWithUnorderedMap(vertexes, referenceRemap);
+	double referenceSeconds = stopwatch.GetSeconds();
+
+	// exact welding matches reference, both number welded vertexes in order of first occurrence
+	CHECK(exact.Vertexes.size() == numReferenceVertexes);
+	CHECK(exact.Remap == referenceRemap);
+
+	// shifted corners are welded too, so grid has all corners once
+	CHECK(nearby.Vertexes.size() == static_cast<size_t>(side + 1) * (side + 1));
+
+	for (uint32_t i = 0; i < numVertexes; ++i) {
+		const FullVertex& welded = vertexes[nearby.Vertexes[nearby.Remap[i]]];
+		CHECK(std::fabs(welded.Position[0] - vertexes[i].Position[0]) <= epsilons.Position);
+		CHECK(std::fabs(welded.Position[1] - vertexes[i].Position[1]) <= epsilons.Position);
+	}
+
+	auto report = [&](const char* name, size_t numWelded, double seconds) {
+		std::printf(
+			"%s: %zu vertexes left, %.1f MB saved, %.1f ms, %.1f Mvertexes/s\n",
+			name,
+			numWelded,
+			(numVertexes - numWelded) * sizeof(FullVertex) / 1048576.0,
+			seconds * 1e3,
+			numVertexes / seconds * 1e-6
+		);
+	};
+
+	std::printf("welding of %u vertexes\n", numVertexes);
+	report("exact", exact.Vertexes.size(), exactSeconds);
+	report("epsilon", nearby.Vertexes.size(), nearbySeconds);
+	report("std::unordered_map exact", numReferenceVertexes, referenceSeconds);
+
+	return 0;
+}
\ No newline at end of file